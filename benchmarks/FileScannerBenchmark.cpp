@@ -0,0 +1,284 @@
+/**
+ * @file FileScannerBenchmark.cpp
+ * @brief Scaling benchmark cho FileScanner — so sánh 1/2/4/8 worker threads,
+ *        và thống kê từng stage của pipelined scan (walk → tag readers → sink).
+ *        Trên Linux: đếm syscall/file của từng directory backend (ptrace),
+ *        và so sánh đọc tag blocking với io_uring prefetch.
+ *
+ * Prefetch chỉ có lợi khi thiết bị có độ trễ (USB, HDD). Để đo trên thiết bị
+ * giả lập độ trễ (cần root), ví dụ dm-delay 20ms trên một loop device:
+ *   losetup /dev/loop0 lib.img
+ *   echo "0 $(blockdev --getsz /dev/loop0) delay /dev/loop0 0 20" | dmsetup create slow
+ *   mount /dev/mapper/slow /mnt/slow && echo 3 > /proc/sys/vm/drop_caches
+ *   FileScannerBenchmark /mnt/slow 1
+ *
+ * Usage: FileScannerBenchmark [libraryPath] [repeat]
+ * Không truyền path: tự tạo cây thư mục giả trong temp (artist/album/track).
+ */
+
+#include "services/FileScanner.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <map>
+
+#ifdef __linux__
+#include <csignal>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+static fs::path createSyntheticTree(int artists, int albumsPerArtist, int tracksPerAlbum)
+{
+    fs::path root = fs::temp_directory_path() / "MediaPlayerBench_FileScanner";
+    fs::remove_all(root);
+
+    for (int a = 0; a < artists; ++a)
+    {
+        for (int b = 0; b < albumsPerArtist; ++b)
+        {
+            fs::path album = root / ("artist_" + std::to_string(a)) / ("album_" + std::to_string(b));
+            fs::create_directories(album);
+
+            for (int t = 0; t < tracksPerAlbum; ++t)
+            {
+                std::ofstream(album / ("track_" + std::to_string(t) + ".mp3")) << "bench";
+            }
+            std::ofstream(album / "cover.jpg") << "jpg";
+        }
+    }
+
+    return root;
+}
+
+#ifdef __linux__
+// Chạy scan trong process con và đếm syscall (mọi thread) theo số hiệu syscall
+static std::map<uint64_t, uint64_t> traceScanSyscalls(const fs::path& root, services::DirectoryBackend backend)
+{
+    std::map<uint64_t, uint64_t> counts;
+
+    pid_t child = fork();
+    if (child == 0)
+    {
+        ptrace(PTRACE_TRACEME, 0, nullptr, nullptr);
+        raise(SIGSTOP);
+
+        services::FileScanner scanner;
+        scanner.setThreadCount(1);
+        scanner.setMetadataWorkerCount(0);
+        scanner.setDirectoryBackend(backend);
+        scanner.scanDirectorySync(root.string());
+        _exit(0);
+    }
+
+    int status = 0;
+    waitpid(child, &status, 0);
+    ptrace(PTRACE_SETOPTIONS, child, nullptr,
+           PTRACE_O_TRACESYSGOOD | PTRACE_O_TRACECLONE | PTRACE_O_EXITKILL);
+    ptrace(PTRACE_SYSCALL, child, nullptr, nullptr);
+
+    while (true)
+    {
+        pid_t tid = waitpid(-1, &status, __WALL);
+        if (tid < 0)
+        {
+            break;
+        }
+        if (WIFEXITED(status) || WIFSIGNALED(status))
+        {
+            if (tid == child) break;
+            continue;
+        }
+
+        int signal = WSTOPSIG(status);
+        int inject = 0;
+
+        if (signal == (SIGTRAP | 0x80))
+        {
+            __ptrace_syscall_info info{};
+            if (ptrace(PTRACE_GET_SYSCALL_INFO, tid, sizeof(info), &info) > 0 &&
+                info.op == PTRACE_SYSCALL_INFO_ENTRY)
+            {
+                counts[info.entry.nr]++;
+            }
+        }
+        else if (signal != SIGTRAP && signal != SIGSTOP)
+        {
+            inject = signal;
+        }
+
+        ptrace(PTRACE_SYSCALL, tid, nullptr, reinterpret_cast<void*>(static_cast<intptr_t>(inject)));
+    }
+
+    return counts;
+}
+
+static void printSyscallsPerFile(const fs::path& root)
+{
+    services::FileScanner counter;
+    size_t files = counter.scanDirectorySync(root.string()).size();
+    if (files == 0)
+    {
+        return;
+    }
+
+    auto sum = [](const std::map<uint64_t, uint64_t>& counts, std::initializer_list<long> numbers)
+    {
+        uint64_t total = 0;
+        for (long nr : numbers)
+        {
+            if (nr < 0) continue;
+            auto it = counts.find(static_cast<uint64_t>(nr));
+            if (it != counts.end()) total += it->second;
+        }
+        return total;
+    };
+
+#ifdef SYS_stat
+    const long statNr = SYS_stat;
+    const long lstatNr = SYS_lstat;
+#else
+    const long statNr = -1;
+    const long lstatNr = -1;
+#endif
+
+    std::cout << "\nSyscalls per file (1 thread, inline tags, " << files << " files)\n";
+    std::cout << std::left << std::setw(12) << "backend"
+              << std::setw(10) << "total"
+              << std::setw(10) << "stat"
+              << std::setw(10) << "open"
+              << "getdents\n";
+
+    for (auto backend : { services::DirectoryBackend::PORTABLE, services::DirectoryBackend::GETDENTS })
+    {
+        auto counts = traceScanSyscalls(root, backend);
+        uint64_t total = 0;
+        for (const auto& pair : counts) total += pair.second;
+
+        double perFile = static_cast<double>(files);
+        std::cout << std::left << std::setw(12) << (backend == services::DirectoryBackend::PORTABLE ? "portable" : "getdents")
+                  << std::setw(10) << std::fixed << std::setprecision(2) << total / perFile
+                  << std::setw(10) << sum(counts, { statNr, lstatNr, SYS_fstat, SYS_newfstatat, SYS_statx }) / perFile
+                  << std::setw(10) << sum(counts, { SYS_openat }) / perFile
+                  << sum(counts, { SYS_getdents64 }) / perFile << "\n";
+    }
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    bool synthetic = argc < 2;
+    fs::path root = synthetic ? createSyntheticTree(40, 10, 12) : fs::path(argv[1]);
+    int repeat = argc > 2 ? std::max(1, std::stoi(argv[2])) : 3;
+
+    std::cout << "Scanning " << root.string() << " (best of " << repeat << ")\n";
+    std::cout << std::left << std::setw(10) << "threads"
+              << std::setw(12) << "files"
+              << std::setw(12) << "ms"
+              << std::setw(14) << "files/s"
+              << "speedup\n";
+
+    double baselineMs = 0.0;
+
+    for (int threads : { 1, 2, 4, 8 })
+    {
+        double bestMs = 0.0;
+        size_t found = 0;
+
+        for (int r = 0; r < repeat; ++r)
+        {
+            services::FileScanner scanner;
+            scanner.setThreadCount(threads);
+            scanner.setMetadataWorkerCount(0);
+
+            auto start = std::chrono::steady_clock::now();
+            auto files = scanner.scanDirectorySync(root.string());
+            auto end = std::chrono::steady_clock::now();
+
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (r == 0 || ms < bestMs)
+            {
+                bestMs = ms;
+            }
+            found = files.size();
+        }
+
+        if (threads == 1)
+        {
+            baselineMs = bestMs;
+        }
+
+        std::cout << std::left << std::setw(10) << threads
+                  << std::setw(12) << found
+                  << std::setw(12) << std::fixed << std::setprecision(1) << bestMs
+                  << std::setw(14) << std::setprecision(0) << (found / (bestMs / 1000.0))
+                  << std::setprecision(2) << (baselineMs / bestMs) << "x\n";
+    }
+
+    // Pipelined scan: in/out từng stage + thời gian blocked/starved
+    std::cout << "\nPipelined (walk threads x tag readers)\n";
+    std::cout << std::left << std::setw(10) << "config"
+              << std::setw(10) << "ms"
+              << std::setw(10) << "firstMs"
+              << std::setw(12) << "walk/s"
+              << std::setw(12) << "tags/s"
+              << std::setw(14) << "walkBlocked"
+              << std::setw(14) << "readStarved"
+              << "bound\n";
+
+    for (auto config : { std::make_pair(1, 2), std::make_pair(1, 4), std::make_pair(4, 4), std::make_pair(4, 8) })
+    {
+        services::FileScanner scanner;
+        scanner.setThreadCount(config.first);
+        scanner.setMetadataWorkerCount(config.second);
+        scanner.scanDirectorySync(root.string());
+
+        auto stats = scanner.getLastPipelineStats();
+        std::cout << std::left << std::setw(10) << (std::to_string(config.first) + "x" + std::to_string(config.second))
+                  << std::setw(10) << std::fixed << std::setprecision(1) << stats.elapsedSeconds * 1000.0
+                  << std::setw(10) << stats.firstBatchSeconds * 1000.0
+                  << std::setw(12) << std::setprecision(0) << stats.discovery.itemsPerSecond
+                  << std::setw(12) << stats.metadata.itemsPerSecond
+                  << std::setw(14) << std::setprecision(3) << stats.discovery.blockedSeconds
+                  << std::setw(14) << stats.metadata.starvedSeconds
+                  << (stats.isWalkBound() ? "walk" : "tags") << "\n";
+    }
+
+    // Tag reads: một file mỗi lần (blocking) với batch qua io_uring
+    std::cout << "\nTag reads (4x4)\n";
+    std::cout << std::left << std::setw(12) << "mode"
+              << std::setw(10) << "ms"
+              << "prefetched\n";
+
+    for (bool prefetch : { false, true })
+    {
+        services::FileScanner scanner;
+        scanner.setTagPrefetch(prefetch);
+        scanner.scanDirectorySync(root.string());
+
+        auto stats = scanner.getLastPipelineStats();
+        std::cout << std::left << std::setw(12) << (prefetch ? "io_uring" : "blocking")
+                  << std::setw(10) << std::fixed << std::setprecision(1) << stats.elapsedSeconds * 1000.0
+                  << scanner.getPrefetchedCount() << "\n";
+    }
+
+#ifdef __linux__
+    printSyscallsPerFile(root);
+#endif
+
+    if (synthetic)
+    {
+        fs::remove_all(root);
+    }
+
+    return 0;
+}
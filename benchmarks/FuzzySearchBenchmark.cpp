@@ -0,0 +1,249 @@
+/**
+ * @file FuzzySearchBenchmark.cpp
+ * @brief Tìm kiếm chịu lỗi gõ trên một thư viện lớn, từng phím một như khi
+ *        người dùng gõ: mỗi phím dùng lại kết quả phím trước (như
+ *        LibraryController làm) so với tìm lại từ đầu. Kết quả của mỗi phím
+ *        được đối chiếu với lượt tìm từ đầu, và kết quả cuối của mỗi câu gõ
+ *        với một lượt xếp hạng đầy đủ bằng bảng quy hoạch động.
+ *
+ * Usage: FuzzySearchBenchmark [tracks] [rounds]
+ */
+
+#include "models/FuzzySearch.h"
+#include "models/SearchIndex.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace media_player;
+
+namespace
+{
+
+const char* WORDS[] = { "Tình", "Yêu", "Đêm", "Mưa", "Anh", "Em", "Người", "Ánh", "Sao", "Biển",
+                        "Love", "Night", "Blue", "Summer", "Heart", "Road", "Remix", "Live", "Hello",
+                        "Yesterday", "Rolling", "Stone", "Queen", "Dream", "River", "Fire", "Rain" };
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+const char* ARTISTS[] = { "The Beatles", "Adele", "Sơn Tùng M-TP", "Coldplay", "Mỹ Tâm", "Queen", "Đen Vâu",
+                          "Taylor Swift", "Hà Anh Tuấn", "Radiohead", "Bích Phương", "Muse" };
+constexpr size_t ARTIST_COUNT = sizeof(ARTISTS) / sizeof(ARTISTS[0]);
+
+models::MediaFileModel makeTrack(size_t i)
+{
+    models::MediaFileModel media("/music/" + std::to_string(i) + ".mp3", 1, std::filesystem::file_time_type());
+    media.setTitle(std::string(WORDS[(i * 7) % WORD_COUNT]) + " " + WORDS[(i / 3) % WORD_COUNT] + " " +
+                   std::to_string(i % 9973));
+    media.setArtist(ARTISTS[(i / 5) % ARTIST_COUNT]);
+    media.setAlbum(std::string(WORDS[(i / 17) % WORD_COUNT]) + " " + WORDS[(i / 29) % WORD_COUNT]);
+    return media;
+}
+
+// Số lần sửa ít nhất để term thành một chuỗi con của text, và vị trí kết
+// thúc đầu tiên đạt được số đó
+int referenceDistance(const std::string& term, std::string_view text, size_t& end)
+{
+    std::vector<int> column(term.size() + 1);
+    for (size_t i = 0; i <= term.size(); ++i)
+    {
+        column[i] = static_cast<int>(i);
+    }
+
+    int best = column.back();
+    end = 0;
+    for (size_t j = 0; j < text.size(); ++j)
+    {
+        int diagonal = column[0];
+        for (size_t i = 1; i <= term.size(); ++i)
+        {
+            int up = column[i];
+            column[i] = std::min({ up + 1, column[i - 1] + 1, diagonal + (term[i - 1] == text[j] ? 0 : 1) });
+            diagonal = up;
+        }
+        if (column.back() < best)
+        {
+            best = column.back();
+            end = j + 1;
+        }
+    }
+    return best;
+}
+
+// Xếp hạng đầy đủ, từng bản ghi, từng từ của từng trường
+std::vector<models::FuzzyMatch> referenceRanking(const models::SearchIndex& index, const std::string& query,
+                                                 const models::FuzzySearch::PlayCounts& plays, size_t limit)
+{
+    using models::FuzzySearch;
+
+    std::vector<std::string> terms;
+    std::string normalized = models::SearchIndex::normalize(query);
+    for (size_t start = 0; start < normalized.size();)
+    {
+        size_t end = std::min(normalized.find(' ', start), normalized.size());
+        if (end > start)
+        {
+            terms.push_back(normalized.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+
+    std::vector<models::FuzzyMatch> ranking;
+    for (uint32_t position = 0; position < index.size(); ++position)
+    {
+        int32_t total = 0;
+        bool all = !terms.empty();
+        for (size_t t = 0; t < terms.size() && all; ++t)
+        {
+            bool found = false;
+            int32_t best = 0;
+            for (size_t f = 0; f < models::SearchIndex::FIELD_COUNT; ++f)
+            {
+                std::string_view field = index.getField(position, f);
+                for (size_t start = 0; start < field.size();)
+                {
+                    size_t stop = std::min(field.find(' ', start), field.size());
+                    size_t end;
+                    int distance = referenceDistance(terms[t], field.substr(start, stop - start), end);
+                    if (stop > start && distance <= FuzzySearch::maxDistance(terms[t].size()))
+                    {
+                        size_t offset = start + (end > terms[t].size() ? end - terms[t].size() : 0);
+                        int32_t score = FuzzySearch::FIELD_WEIGHT[f] - FuzzySearch::EDIT_PENALTY * distance -
+                                        static_cast<int32_t>(std::min<size_t>(offset, FuzzySearch::MAX_OFFSET_PENALTY));
+                        if (!found || score > best)
+                        {
+                            best = score;
+                            found = true;
+                        }
+                    }
+                    start = stop + 1;
+                }
+            }
+            all = found;
+            total += best;
+        }
+        if (all)
+        {
+            auto it = plays.find(position);
+            ranking.push_back(
+                models::FuzzyMatch{ position, total + (it == plays.end() ? 0 : FuzzySearch::playBonus(it->second)) });
+        }
+    }
+
+    std::sort(ranking.begin(), ranking.end(), [](const models::FuzzyMatch& a, const models::FuzzyMatch& b)
+    {
+        return a.score > b.score || (a.score == b.score && a.position < b.position);
+    });
+    ranking.resize(std::min(limit, ranking.size()));
+    return ranking;
+}
+
+bool sameMatches(const std::vector<models::FuzzyMatch>& a, const std::vector<models::FuzzyMatch>& b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const models::FuzzyMatch& x, const models::FuzzyMatch& y)
+    {
+        return x.position == y.position && x.score == y.score;
+    });
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? static_cast<size_t>(std::max(1, std::stoi(argv[1]))) : 100000;
+    int rounds = argc > 2 ? std::max(1, std::stoi(argv[2])) : 5;
+
+    std::vector<models::MediaFileModel> tracks;
+    tracks.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        tracks.push_back(makeTrack(i));
+    }
+    models::SearchIndex index;
+    index.build(tracks);
+
+    models::FuzzySearch::PlayCounts plays;
+    for (size_t i = 0; i < count; i += 37)
+    {
+        plays[static_cast<uint32_t>(i)] = static_cast<uint32_t>(1 + (i * 13) % 200);
+    }
+
+    const std::string TYPED[] = { "beatels", "adel helo", "son tung", "yestrday beatles", "colplay dream" };
+    const size_t limit = models::FuzzySearch::DEFAULT_LIMIT;
+    models::FuzzySearch fuzzy;
+    size_t checksum = 0;
+
+    // Sau mỗi thay đổi của chỉ mục, LibraryModel chỉ giữ khóa chỉ mục lúc
+    // sao chép các trường; việc gom từ chạy ngoài khóa
+    auto start = std::chrono::steady_clock::now();
+    models::FuzzyFields fields = models::FuzzySearch::copyFields(index);
+    double copyMs = elapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    fuzzy.gatherWords(fields);
+    double gatherMs = elapsedMs(start);
+
+    std::cout << count << " tracks, fields copied in " << std::fixed << std::setprecision(3) << copyMs
+              << " ms, words gathered in " << gatherMs << " ms\ntop " << limit << ", best of " << rounds << " rounds, ms per keystroke\n\n";
+    std::cout << std::left << std::setw(20) << "typed" << std::setw(10) << "matches" << std::setw(12) << "fresh"
+              << std::setw(12) << "typing" << "\n";
+
+    double worstTyping = 0;
+    for (const auto& query : TYPED)
+    {
+        for (size_t length = 1; length <= query.size(); ++length)
+        {
+            std::string typed = query.substr(0, length);
+            std::string before = query.substr(0, length - 1);
+
+            double freshMs = 1e9;
+            double typingMs = 1e9;
+            models::FuzzyResult fresh;
+            models::FuzzyResult incremental;
+            for (int r = 0; r < rounds; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                fresh = fuzzy.search(index, typed, models::SearchField::TAGS, plays, limit);
+                freshMs = std::min(freshMs, elapsedMs(start));
+
+                // Chỉ đo phím dùng lại kết quả, không đo phím trước nó
+                models::FuzzyResult previous = fuzzy.search(index, before, models::SearchField::TAGS, plays, limit);
+                start = std::chrono::steady_clock::now();
+                incremental = fuzzy.search(index, typed, models::SearchField::TAGS, plays, limit, &previous);
+                typingMs = std::min(typingMs, elapsedMs(start));
+            }
+
+            if (!sameMatches(incremental.matches, fresh.matches))
+            {
+                std::cout << "\nMismatch while typing \"" << typed << "\"\n";
+                return 1;
+            }
+            checksum += fresh.matches.size();
+            worstTyping = std::max(worstTyping, typingMs);
+
+            std::cout << std::left << std::fixed << std::setprecision(3) << std::setw(20) << ("\"" + typed + "\"")
+                      << std::setw(10) << fresh.matches.size() << std::setw(12) << freshMs << std::setw(12)
+                      << typingMs << "\n";
+        }
+
+        models::FuzzyResult final = fuzzy.search(index, query, models::SearchField::TAGS, plays, limit);
+        if (!sameMatches(final.matches, referenceRanking(index, query, plays, limit)))
+        {
+            std::cout << "\nMismatch with the full ranking for \"" << query << "\"\n";
+            return 1;
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << "worst keystroke " << worstTyping << " ms\nchecksum " << checksum << "\n";
+    return 0;
+}
@@ -0,0 +1,221 @@
+/**
+ * @file LibraryIndexBenchmark.cpp
+ * @brief So sánh cache của LibraryRepository trước và sau khi có LibraryIndex:
+ *        std::map khóa bằng chuỗi "media_<hash>" (quét toàn bộ cho thống kê và
+ *        truy vấn theo loại) với bảng băm địa chỉ mở khóa 64-bit, chỉ mục phụ
+ *        theo loại/nghệ sĩ/album và tổng được cập nhật theo từng thay đổi.
+ *        Đo ở 10k/100k/1M mục; 20% là .flac (UNSUPPORTED) để truy vấn theo loại
+ *        trả về một phần nhỏ thư viện.
+ *
+ * Usage: LibraryIndexBenchmark [maxEntries] [lookups]
+ */
+
+#include "repositories/LibraryIndex.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+namespace
+{
+
+std::string trackPath(size_t i)
+{
+    return "/music/album_" + std::to_string(i % 1000) + "/track_" + std::to_string(i) +
+           (i % 5 == 0 ? ".flac" : ".mp3");
+}
+
+models::MediaFileModel makeTrack(size_t i)
+{
+    models::MediaFileModel media(trackPath(i), 4 * 1024 * 1024 + i % 4096,
+                                 fs::file_time_type(fs::file_time_type::duration(1000000 + i)));
+    media.setTitle("Track " + std::to_string(i));
+    media.setArtist("Artist " + std::to_string(i % 2000));
+    media.setAlbum("Album " + std::to_string(i % 1000));
+    media.setDuration(static_cast<int>(180 + i % 120));
+    return media;
+}
+
+// Cách LibraryRepository tạo id trước đây
+std::string mapKey(const std::string& path)
+{
+    return "media_" + std::to_string(std::hash<std::string>{}(path));
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Result
+{
+    double insertMs = 0.0;
+    double lookupNs = 0.0;      // Mỗi lần tra theo đường dẫn
+    double statsUs = 0.0;       // countByType + getTotalSize
+    double typeQueryMs = 0.0;   // Thu thập các mục UNSUPPORTED
+    double eraseMs = 0.0;       // Xóa 10% mục
+    size_t checksum = 0;        // Giữ kết quả để trình biên dịch không bỏ phép đo
+};
+
+Result benchMap(size_t entries, const std::vector<std::string>& probes)
+{
+    Result result;
+    std::map<std::string, models::MediaFileModel> cache;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entries; ++i)
+    {
+        models::MediaFileModel media = makeTrack(i);
+        std::string key = mapKey(media.getFilePath());
+        cache[key] = std::move(media);
+    }
+    result.insertMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& path : probes)
+    {
+        result.checksum += cache.count(mapKey(path));
+    }
+    result.lookupNs = elapsedMs(start) * 1e6 / probes.size();
+
+    start = std::chrono::steady_clock::now();
+    size_t unsupported = 0;
+    long long totalSize = 0;
+    for (const auto& pair : cache)
+    {
+        unsupported += pair.second.getType() == models::MediaType::UNSUPPORTED;
+    }
+    for (const auto& pair : cache)
+    {
+        totalSize += pair.second.getFileSize();
+    }
+    result.statsUs = elapsedMs(start) * 1e3;
+    result.checksum += unsupported + static_cast<size_t>(totalSize);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<const models::MediaFileModel*> matches;
+    for (const auto& pair : cache)
+    {
+        if (pair.second.getType() == models::MediaType::UNSUPPORTED)
+        {
+            matches.push_back(&pair.second);
+        }
+    }
+    result.typeQueryMs = elapsedMs(start);
+    result.checksum += matches.size();
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entries; i += 10)
+    {
+        cache.erase(mapKey(trackPath(i)));
+    }
+    result.eraseMs = elapsedMs(start);
+
+    return result;
+}
+
+Result benchIndex(size_t entries, const std::vector<std::string>& probes)
+{
+    Result result;
+    repositories::LibraryIndex cache;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entries; ++i)
+    {
+        cache.put(makeTrack(i));
+    }
+    result.insertMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& path : probes)
+    {
+        result.checksum += cache.find(path) != repositories::LibraryIndex::npos;
+    }
+    result.lookupNs = elapsedMs(start) * 1e6 / probes.size();
+
+    start = std::chrono::steady_clock::now();
+    size_t unsupported = cache.countByType(models::MediaType::UNSUPPORTED);
+    uint64_t totalSize = cache.getTotalSize();
+    result.statsUs = elapsedMs(start) * 1e3;
+    result.checksum += unsupported + static_cast<size_t>(totalSize);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<const models::MediaFileModel*> matches;
+    const auto& positions = cache.findByType(models::MediaType::UNSUPPORTED);
+    matches.reserve(positions.size());
+    for (uint32_t position : positions)
+    {
+        matches.push_back(&cache.at(position));
+    }
+    result.typeQueryMs = elapsedMs(start);
+    result.checksum += matches.size();
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < entries; i += 10)
+    {
+        cache.erase(trackPath(i));
+    }
+    result.eraseMs = elapsedMs(start);
+
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t maxEntries = argc > 1 ? std::max(1, std::stoi(argv[1])) : 1000000;
+    size_t lookups = argc > 2 ? std::max(1, std::stoi(argv[2])) : 200000;
+
+    std::cout << std::left << std::setw(10) << "entries" << std::setw(14) << "cache"
+              << std::setw(12) << "insert ms" << std::setw(14) << "lookup ns/op"
+              << std::setw(12) << "stats us" << std::setw(14) << "by type ms" << "erase 10% ms\n";
+
+    for (size_t entries = 10000; entries <= maxEntries; entries *= 10)
+    {
+        // Một nửa số lần tra trúng, một nửa trượt
+        std::mt19937_64 random(entries);
+        std::vector<std::string> probes;
+        probes.reserve(lookups);
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            size_t track = random() % entries;
+            probes.push_back(i % 2 == 0 ? trackPath(track) : "/music/missing/" + std::to_string(track) + ".mp3");
+        }
+
+        Result before = benchMap(entries, probes);
+        Result after = benchIndex(entries, probes);
+
+        auto row = [entries](const char* name, const Result& result)
+        {
+            std::cout << std::left << std::setw(10) << entries << std::setw(14) << name << std::fixed
+                      << std::setprecision(1) << std::setw(12) << result.insertMs
+                      << std::setw(14) << result.lookupNs << std::setw(12) << result.statsUs
+                      << std::setprecision(2) << std::setw(14) << result.typeQueryMs
+                      << std::setprecision(1) << result.eraseMs << "\n";
+        };
+
+        row("std::map", before);
+        row("LibraryIndex", after);
+
+        if (before.checksum != after.checksum)
+        {
+            std::cout << "Mismatch between caches at " << entries << " entries\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
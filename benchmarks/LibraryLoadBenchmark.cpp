@@ -0,0 +1,203 @@
+/**
+ * @file LibraryLoadBenchmark.cpp
+ * @brief Đo thời gian khởi động thư viện: library.dat dạng text cũ (stat từng
+ *        file khi nạp) so với snapshot nhị phân mmap (đọc tại chỗ, không stat),
+ *        và chi phí ghi một lần quét lại: journal phần thay đổi so với ghi lại cả file.
+ *        Các file media là file rỗng trên thư mục tạm, nên bản text đo chi phí
+ *        syscall với cache inode đã nóng — trên đĩa thật còn chậm hơn nhiều.
+ *
+ * Usage: LibraryLoadBenchmark [tracks] [repeat]
+ */
+
+#include "repositories/LibraryRepository.h"
+#include "repositories/LibrarySnapshot.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+namespace
+{
+
+double bestMs(int repeat, const std::function<void()>& pass)
+{
+    double best = 0.0;
+    for (int r = 0; r < repeat; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        pass();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0 || ms < best)
+        {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    int tracks = argc > 1 ? std::max(1, std::stoi(argv[1])) : 100000;
+    int repeat = argc > 2 ? std::max(1, std::stoi(argv[2])) : 3;
+
+    fs::path root = fs::temp_directory_path() / "MediaPlayerBench_LibraryLoad";
+    fs::remove_all(root);
+    fs::create_directories(root / "music");
+
+    // Thư viện tổng hợp: 100 thư mục album, tag đầy đủ
+    std::vector<models::MediaFileModel> media;
+    media.reserve(tracks);
+    for (int i = 0; i < tracks; ++i)
+    {
+        fs::path dir = root / "music" / ("album_" + std::to_string(i % 100));
+        if (i < 100)
+        {
+            fs::create_directories(dir);
+        }
+        fs::path path = dir / ("track_" + std::to_string(i) + ".mp3");
+        std::ofstream(path).put('x');
+
+        models::MediaFileModel item(path.string(), 4 * 1024 * 1024, fs::file_time_type::clock::now());
+        item.setTitle("Track " + std::to_string(i));
+        item.setArtist("Artist " + std::to_string(i % 500));
+        item.setAlbum("Album " + std::to_string(i % 100));
+        item.setDuration(180 + i % 120);
+        media.push_back(std::move(item));
+    }
+
+    std::string legacyStorage = (root / "legacy").string();
+    std::string snapshotStorage = (root / "snapshot").string();
+    fs::create_directories(legacyStorage);
+
+    // library.dat như trước khi có snapshot
+    {
+        std::ofstream file(legacyStorage + "/library.dat");
+        file << "LIBRARY_VERSION:1.0\nCOUNT:" << media.size() << "\nENTRIES:\n";
+        for (const auto& item : media)
+        {
+            file << item.serialize() << "\n";
+        }
+    }
+
+    double saveMs = bestMs(repeat, [&]()
+    {
+        repositories::LibraryRepository repo(snapshotStorage);
+        repo.clear();
+        repo.saveAll(media);
+        repo.saveToDisk();
+    });
+
+    // Chỉ đo constructor (nạp + replay journal); destructor nằm ngoài phép đo
+    auto loadMs = [repeat](const std::string& storage, const std::function<void()>& prepare, size_t& count)
+    {
+        double best = 0.0;
+        for (int r = 0; r < repeat; ++r)
+        {
+            prepare();
+
+            auto start = std::chrono::steady_clock::now();
+            auto repo = std::make_unique<repositories::LibraryRepository>(storage);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            count = repo->count();
+            best = r == 0 ? ms : std::min(best, ms);
+        }
+        return best;
+    };
+
+    // Bản text được chép lại trước mỗi lần đo vì lần nạp đầu đã chuyển nó sang snapshot
+    // (thời gian chuyển đổi tính vào dòng này)
+    fs::path legacyText = root / "library.txt";
+    fs::copy_file(legacyStorage + "/library.dat", legacyText);
+    size_t legacyCount = 0;
+    double legacyMs = loadMs(legacyStorage, [&]()
+    {
+        fs::copy_file(legacyText, legacyStorage + "/library.dat", fs::copy_options::overwrite_existing);
+    }, legacyCount);
+
+    size_t mapped = 0;
+    double mapMs = bestMs(repeat, [&]()
+    {
+        repositories::LibrarySnapshot snapshot;
+        snapshot.open(snapshotStorage + "/library.dat");
+        mapped = 0;
+        for (size_t i = 0; i < snapshot.size(); ++i)
+        {
+            mapped += snapshot.path(i).size() > 0;
+        }
+    });
+
+    size_t snapshotCount = 0;
+    double snapshotMs = loadMs(snapshotStorage, []() {}, snapshotCount);
+
+    // Quét lại với 1% track đổi tag: chỉ phần khác biệt vào journal,
+    // so với ghi lại toàn bộ snapshot như trước
+    std::vector<models::MediaFileModel> rescanned = media;
+    size_t changed = 0;
+    for (size_t i = 0; i < rescanned.size(); i += 100)
+    {
+        rescanned[i].setTitle("Retagged " + std::to_string(i));
+        changed++;
+    }
+
+    double journalMs = 0.0;
+    double rewriteMs = 0.0;
+    uint64_t journalBytes = 0;
+    {
+        repositories::LibraryRepository repo(snapshotStorage);
+        repo.setCompactThreshold(UINT64_MAX);
+
+        auto start = std::chrono::steady_clock::now();
+        repo.replaceAll(rescanned);
+        repo.flush();
+        journalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        journalBytes = repo.getJournalSize();
+
+        start = std::chrono::steady_clock::now();
+        repo.saveToDisk();
+        rewriteMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    uintmax_t snapshotBytes = fs::file_size(snapshotStorage + "/library.dat");
+
+    std::cout << "Library: " << tracks << " tracks (best of " << repeat << "), snapshot "
+              << std::fixed << std::setprecision(1) << snapshotBytes / (1024.0 * 1024.0) << " MiB\n";
+    std::cout << std::left << std::setw(26) << "step" << std::setw(10) << "tracks" << "ms\n";
+
+    auto row = [](const char* name, size_t count, double ms)
+    {
+        std::cout << std::left << std::setw(26) << name << std::setw(10) << count
+                  << std::fixed << std::setprecision(1) << ms << "\n";
+    };
+
+    row("snapshot save", media.size(), saveMs);
+    row("legacy text load (stat)", legacyCount, legacyMs);
+    row("snapshot mmap + scan", mapped, mapMs);
+    row("snapshot load (repo)", snapshotCount, snapshotMs);
+    row("rescan 1% (diff+journal)", changed, journalMs);
+    row("full rewrite (saveToDisk)", media.size(), rewriteMs);
+
+    std::cout << "Rescan writes " << std::setprecision(1) << journalBytes / 1024.0
+              << " KiB of journal instead of the whole snapshot\n";
+
+    if (snapshotMs > 0)
+    {
+        std::cout << "Load speedup: " << std::setprecision(1) << legacyMs / snapshotMs << "x\n";
+    }
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * @file LibraryModelBenchmark.cpp
+ * @brief Đo LibraryModel khi nạp kết quả quét lớn (mặc định tới 80k bài):
+ *        trước đây mỗi addMedia/getMediaByPath/removeMedia quét tuyến tính
+ *        danh sách nên nạp từng bài là O(n²); nay chỉ mục đường dẫn -> vị trí
+ *        đi cùng mỗi snapshot và addMediaBatch(&&) chuyển (move) bản ghi vào.
+ *        Cách cũ được tái hiện bằng vector + so sánh tuyến tính; vì O(n²) nên
+ *        chỉ chạy tới linearLimit mục. Cột "staged" nạp theo lô như lúc quét
+ *        nhưng qua stageChanges: chỉ publish khi phần chờ đạt nửa thư viện.
+ *
+ * Usage: LibraryModelBenchmark [maxTracks] [linearLimit]
+ */
+
+#include "models/LibraryModel.h"
+#include "models/MediaFileModel.h"
+#include "config/AppConfig.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+namespace
+{
+
+std::string trackPath(size_t i)
+{
+    return "/music/album_" + std::to_string(i % 1000) + "/track_" + std::to_string(i) + ".mp3";
+}
+
+std::vector<models::MediaFileModel> makeTracks(size_t count)
+{
+    std::vector<models::MediaFileModel> tracks;
+    tracks.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        models::MediaFileModel media(trackPath(i), 4 * 1024 * 1024 + i % 4096,
+                                     fs::file_time_type(fs::file_time_type::duration(1000000 + i)));
+        media.setTitle("Track " + std::to_string(i));
+        media.setArtist("Artist " + std::to_string(i % 2000));
+        media.setAlbum("Album " + std::to_string(i % 1000));
+        tracks.push_back(std::move(media));
+    }
+    return tracks;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// LibraryModel trước khi có chỉ mục: kiểm tra trùng và tra cứu tuyến tính
+class LinearLibrary
+{
+public:
+    void addMedia(const models::MediaFileModel& media)
+    {
+        for (const auto& item : m_mediaList)
+        {
+            if (item.getFilePath() == media.getFilePath())
+            {
+                return;
+            }
+        }
+        m_mediaList.push_back(media);
+    }
+
+    std::optional<models::MediaFileModel> getMediaByPath(const std::string& filePath) const
+    {
+        for (const auto& media : m_mediaList)
+        {
+            if (media.getFilePath() == filePath)
+            {
+                return media;
+            }
+        }
+        return std::nullopt;
+    }
+
+    size_t size() const
+    {
+        return m_mediaList.size();
+    }
+
+private:
+    std::vector<models::MediaFileModel> m_mediaList;
+};
+
+struct Result
+{
+    double ingestMs = -1.0;     // Nạp toàn bộ kết quả quét
+    double streamedMs = -1.0;   // Nạp theo lô SCAN_BATCH_SIZE, mỗi lô một lần publish
+    double coalescedMs = -1.0;  // Gộp 16 lô mỗi lần publish
+    double stagedMs = -1.0;     // Lô SCAN_BATCH_SIZE qua stageChanges, như Application
+    size_t publishes = 0;       // Số lần publish của cột staged
+    bool stagedComplete = true; // Sau publish cuối, staged có đủ mọi bài
+    double lookupUs = -1.0;     // Mỗi lần getMediaByPath
+    double removeMs = -1.0;     // removeMedia 100 bài
+    size_t checksum = 0;
+};
+
+Result benchLinear(const std::vector<models::MediaFileModel>& tracks, const std::vector<std::string>& probes)
+{
+    Result result;
+    LinearLibrary library;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& media : tracks)
+    {
+        library.addMedia(media);
+    }
+    result.ingestMs = elapsedMs(start);
+    result.checksum += library.size();
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& path : probes)
+    {
+        result.checksum += library.getMediaByPath(path).has_value();
+    }
+    result.lookupUs = elapsedMs(start) * 1e3 / probes.size();
+
+    return result;
+}
+
+Result benchIndexed(const std::vector<models::MediaFileModel>& tracks, const std::vector<std::string>& probes)
+{
+    Result result;
+    size_t batchSize = static_cast<size_t>(config::AppConfig::SCAN_BATCH_SIZE);
+
+    {
+        models::LibraryModel model;
+        std::vector<models::MediaFileModel> copy = tracks;
+
+        auto start = std::chrono::steady_clock::now();
+        model.addMediaBatch(std::move(copy));
+        result.ingestMs = elapsedMs(start);
+        result.checksum += model.getMediaCount();
+
+        start = std::chrono::steady_clock::now();
+        for (const auto& path : probes)
+        {
+            result.checksum += model.getMediaByPath(path).has_value();
+        }
+        result.lookupUs = elapsedMs(start) * 1e3 / probes.size();
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < 100; ++i)
+        {
+            model.removeMedia(trackPath(i * (tracks.size() / 100)));
+        }
+        result.removeMs = elapsedMs(start);
+    }
+
+    for (size_t perPublish : { batchSize, batchSize * 16 })
+    {
+        models::LibraryModel model;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t first = 0; first < tracks.size(); first += perPublish)
+        {
+            size_t last = std::min(first + perPublish, tracks.size());
+            model.addMediaBatch(std::vector<models::MediaFileModel>(tracks.begin() + first, tracks.begin() + last));
+        }
+        (perPublish == batchSize ? result.streamedMs : result.coalescedMs) = elapsedMs(start);
+    }
+
+    {
+        models::LibraryModel model;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t first = 0; first < tracks.size(); first += batchSize)
+        {
+            size_t last = std::min(first + batchSize, tracks.size());
+            std::vector<models::LibraryEdit> edits;
+            edits.reserve(last - first);
+            for (size_t i = first; i < last; ++i)
+            {
+                edits.push_back(models::LibraryEdit{ models::LibraryEdit::Type::PUT, tracks[i].getFilePath(), tracks[i] });
+            }
+            result.publishes += model.stageChanges(std::move(edits)) > 0;
+        }
+        result.publishes += model.publishStaged() > 0;
+        result.stagedMs = elapsedMs(start);
+
+        result.stagedComplete = model.getMediaCount() == tracks.size();
+    }
+
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t maxTracks = argc > 1 ? std::max(1, std::stoi(argv[1])) : 80000;
+    size_t linearLimit = argc > 2 ? std::max(0, std::stoi(argv[2])) : 20000;
+
+    std::cout << std::left << std::setw(8) << "tracks" << std::setw(14) << "model"
+              << std::setw(12) << "ingest ms" << std::setw(14) << "streamed ms"
+              << std::setw(15) << "coalesced ms" << std::setw(12) << "staged ms" << std::setw(11) << "publishes"
+              << std::setw(12) << "lookup us" << "remove x100 ms\n";
+
+    auto cell = [](int width, double value)
+    {
+        if (value < 0.0)
+        {
+            std::cout << std::setw(width) << "-";
+        }
+        else
+        {
+            std::cout << std::setw(width) << value;
+        }
+    };
+
+    for (size_t tracks = 10000; tracks <= maxTracks; tracks *= 2)
+    {
+        std::vector<models::MediaFileModel> media = makeTracks(tracks);
+
+        // Một nửa số lần tra trúng, một nửa trượt
+        std::vector<std::string> probes;
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            probes.push_back(i % 2 == 0 ? trackPath(i * 7919 % tracks) : "/music/missing/" + std::to_string(i) + ".mp3");
+        }
+
+        auto row = [&cell, tracks](const char* name, const Result& result)
+        {
+            std::cout << std::left << std::setw(8) << tracks << std::setw(14) << name << std::fixed
+                      << std::setprecision(1);
+            cell(12, result.ingestMs);
+            cell(14, result.streamedMs);
+            cell(15, result.coalescedMs);
+            cell(12, result.stagedMs);
+            if (result.publishes == 0)
+            {
+                std::cout << std::setw(11) << "-";
+            }
+            else
+            {
+                std::cout << std::setw(11) << result.publishes;
+            }
+            std::cout << std::setprecision(3);
+            cell(12, result.lookupUs);
+            std::cout << std::setprecision(1);
+            cell(0, result.removeMs);
+            std::cout << "\n";
+        };
+
+        Result after = benchIndexed(media, probes);
+        if (!after.stagedComplete)
+        {
+            std::cout << "Staged ingest lost tracks at " << tracks << " tracks\n";
+            return 1;
+        }
+
+        if (tracks <= linearLimit)
+        {
+            Result before = benchLinear(media, probes);
+            row("linear scan", before);
+            if (before.checksum != after.checksum)
+            {
+                std::cout << "Mismatch between models at " << tracks << " tracks\n";
+                return 1;
+            }
+        }
+
+        row("path index", after);
+    }
+
+    return 0;
+}
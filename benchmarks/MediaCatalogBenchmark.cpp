@@ -0,0 +1,170 @@
+/**
+ * @file MediaCatalogBenchmark.cpp
+ * @brief Đo bộ nhớ và thời gian khi cùng một danh sách bài (mặc định 20k) nằm
+ *        trong hàng đợi và nhiều playlist: trước đây mỗi nơi giữ bản sao
+ *        MediaFileModel riêng, nay giữ MediaHandle trỏ vào bản ghi duy nhất
+ *        của MediaCatalog. Heap được đếm bằng operator new thay thế.
+ *
+ * Usage: MediaCatalogBenchmark [tracks] [playlists]
+ */
+
+#include "models/MediaCatalog.h"
+#include "models/MediaFileModel.h"
+#include "models/PlaylistModel.h"
+#include "models/QueueModel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+namespace
+{
+
+std::atomic<long long> g_heapBytes(0);
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+    g_heapBytes += static_cast<long long>(malloc_usable_size(pointer));
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer)
+    {
+        g_heapBytes -= static_cast<long long>(malloc_usable_size(pointer));
+        std::free(pointer);
+    }
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+namespace
+{
+
+std::vector<models::MediaFileModel> makeTracks(size_t count)
+{
+    std::vector<models::MediaFileModel> tracks;
+    tracks.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        models::MediaFileModel media("/home/user/Music/Album " + std::to_string(i / 12) + "/" +
+                                     std::to_string(i % 12 + 1) + " - Song Title Number " +
+                                     std::to_string(i) + ".mp3",
+                                     4 * 1024 * 1024, fs::file_time_type(fs::file_time_type::duration(1000 + i)));
+        media.setTitle("Song Title Number " + std::to_string(i));
+        media.setArtist("Artist Name " + std::to_string(i / 120));
+        media.setAlbum("Album " + std::to_string(i / 12));
+        tracks.push_back(std::move(media));
+    }
+    return tracks;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Result
+{
+    double heapMb = 0.0;
+    double buildMs = 0.0;
+    double enqueueMs = 0.0;     // Đưa một playlist vào hàng đợi
+};
+
+// Mỗi nơi một bản sao, như QueueModel/PlaylistModel trước đây
+Result benchCopies(const std::vector<models::MediaFileModel>& tracks, size_t playlists)
+{
+    Result result;
+    long long before = g_heapBytes;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::vector<models::MediaFileModel>> lists(playlists, tracks);
+    result.buildMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<models::MediaFileModel> queue(lists[0].begin(), lists[0].end());
+    result.enqueueMs = elapsedMs(start);
+
+    result.heapMb = static_cast<double>(g_heapBytes - before) / (1024.0 * 1024.0);
+    return result;
+}
+
+Result benchHandles(const std::vector<models::MediaFileModel>& tracks, size_t playlists)
+{
+    Result result;
+    long long before = g_heapBytes;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<models::PlaylistModel> lists(playlists, models::PlaylistModel("Bench"));
+    for (auto& playlist : lists)
+    {
+        for (const auto& media : tracks)
+        {
+            playlist.addItem(media);
+        }
+    }
+    result.buildMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    models::QueueModel queue;
+    for (const auto& handle : lists[0].getHandles())
+    {
+        queue.addToEnd(handle);
+    }
+    result.enqueueMs = elapsedMs(start);
+
+    result.heapMb = static_cast<double>(g_heapBytes - before) / (1024.0 * 1024.0);
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t trackCount = argc > 1 ? static_cast<size_t>(std::max(1, std::stoi(argv[1]))) : 20000;
+    size_t playlists = argc > 2 ? static_cast<size_t>(std::max(1, std::stoi(argv[2]))) : 3;
+
+    std::vector<models::MediaFileModel> tracks = makeTracks(trackCount);
+
+    std::cout << trackCount << " tracks in the queue and " << playlists << " playlists\n";
+    std::cout << std::left << std::setw(10) << "holders" << std::setw(12) << "heap MB"
+              << std::setw(12) << "build ms" << "enqueue ms\n";
+
+    auto row = [](const char* name, const Result& result)
+    {
+        std::cout << std::left << std::setw(10) << name << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.heapMb << std::setw(12) << result.buildMs
+                  << result.enqueueMs << "\n";
+    };
+
+    Result copies = benchCopies(tracks, playlists);
+    row("copies", copies);
+    Result handles = benchHandles(tracks, playlists);
+    row("handles", handles);
+
+    std::cout << "reduction: " << std::setprecision(2) << copies.heapMb / handles.heapMb << "x\n";
+
+    return 0;
+}
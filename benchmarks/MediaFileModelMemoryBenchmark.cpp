@@ -0,0 +1,229 @@
+/**
+ * @file MediaFileModelMemoryBenchmark.cpp
+ * @brief Đo bộ nhớ mỗi bản ghi của thư viện 100k bài: bố cục cũ của
+ *        MediaFileModel (sáu std::string riêng: đường dẫn, tên file, phần mở
+ *        rộng, tiêu đề, nghệ sĩ, album) so với bố cục gọn (đường dẫn lưu một
+ *        lần, tên file/phần mở rộng/thư mục là offset, nghệ sĩ/album intern
+ *        qua StringPool). Heap được đếm bằng operator new thay thế, tính theo
+ *        kích thước khối thực mà malloc cấp (malloc_usable_size).
+ *
+ * Usage: MediaFileModelMemoryBenchmark [tracks] [artists]
+ */
+
+#include "models/MediaFileModel.h"
+#include "utils/StringPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+// ============================================================================
+// Đếm heap
+// ============================================================================
+
+namespace
+{
+
+std::atomic<long long> g_heapBytes(0);
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    void* pointer = std::malloc(size == 0 ? 1 : size);
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+    g_heapBytes += static_cast<long long>(malloc_usable_size(pointer));
+    return pointer;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if (pointer)
+    {
+        g_heapBytes -= static_cast<long long>(malloc_usable_size(pointer));
+        std::free(pointer);
+    }
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+namespace
+{
+
+// Bố cục MediaFileModel trước khi gọn lại
+struct LegacyMediaFileModel
+{
+    std::string filePath;
+    std::string fileName;
+    std::string extension;
+    models::MediaType type = models::MediaType::AUDIO;
+    size_t fileSize = 0;
+    fs::file_time_type lastModified;
+    std::string title;
+    std::string artist;
+    std::string album;
+    int duration = 0;
+};
+
+struct Track
+{
+    std::string path;
+    std::string title;
+    std::string artist;
+    std::string album;
+};
+
+// Thư viện giống thật: mỗi nghệ sĩ vài album, mỗi album ~12 bài
+Track makeTrack(size_t i, size_t artists)
+{
+    size_t album = i / 12;
+    size_t artist = album % artists;
+    Track track;
+    track.artist = "Artist Name " + std::to_string(artist);
+    track.album = "Album Title " + std::to_string(album);
+    track.title = "Song Title Number " + std::to_string(i);
+    track.path = "/home/user/Music/" + track.artist + "/" + track.album + "/" +
+                 std::to_string(i % 12 + 1) + " - " + track.title + ".mp3";
+    return track;
+}
+
+struct Measurement
+{
+    double recordBytes = 0.0;   // sizeof
+    double heapBytes = 0.0;     // Heap riêng của mỗi bản ghi
+    double sharedBytes = 0.0;   // Heap của StringPool, chia đều
+    double buildMs = 0.0;
+};
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+Measurement measureLegacy(const std::vector<Track>& tracks)
+{
+    Measurement result;
+    std::vector<LegacyMediaFileModel> records;
+    records.reserve(tracks.size());
+
+    long long before = g_heapBytes;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& track : tracks)
+    {
+        LegacyMediaFileModel media;
+        media.filePath = track.path;
+        size_t slash = media.filePath.find_last_of('/');
+        media.fileName = media.filePath.substr(slash + 1);
+        media.extension = media.fileName.substr(media.fileName.find_last_of('.'));
+        media.title = track.title;
+        media.artist = track.artist;
+        media.album = track.album;
+        records.push_back(std::move(media));
+    }
+    result.buildMs = elapsedMs(start);
+
+    result.recordBytes = sizeof(LegacyMediaFileModel);
+    result.heapBytes = static_cast<double>(g_heapBytes - before) / tracks.size();
+    return result;
+}
+
+Measurement measureCompact(const std::vector<Track>& tracks)
+{
+    Measurement result;
+    std::vector<models::MediaFileModel> records;
+    records.reserve(tracks.size());
+
+    long long before = g_heapBytes;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& track : tracks)
+    {
+        models::MediaFileModel media(track.path, 4 * 1024 * 1024, fs::file_time_type());
+        media.setTitle(track.title);
+        media.setArtist(track.artist);
+        media.setAlbum(track.album);
+        records.push_back(std::move(media));
+    }
+    result.buildMs = elapsedMs(start);
+
+    // Chuỗi của pool chỉ cấp một lần; tính riêng để thấy phần chia sẻ
+    long long total = g_heapBytes - before;
+    long long pooled = 0;
+    std::vector<const std::string*> seen;
+    for (const auto& media : records)
+    {
+        for (const std::string* value : { &media.getArtist(), &media.getAlbum() })
+        {
+            seen.push_back(value);
+        }
+    }
+    std::sort(seen.begin(), seen.end());
+    seen.erase(std::unique(seen.begin(), seen.end()), seen.end());
+    for (const std::string* value : seen)
+    {
+        // Chuỗi, phần tử deque và nút chỉ mục của pool
+        pooled += static_cast<long long>(value->capacity() > 15 ? value->capacity() + 1 : 0) + 32 + 48;
+    }
+
+    result.recordBytes = sizeof(models::MediaFileModel);
+    result.sharedBytes = static_cast<double>(pooled) / tracks.size();
+    result.heapBytes = static_cast<double>(total - pooled) / tracks.size();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t trackCount = argc > 1 ? static_cast<size_t>(std::max(1, std::stoi(argv[1]))) : 100000;
+    size_t artists = argc > 2 ? static_cast<size_t>(std::max(1, std::stoi(argv[2]))) : 800;
+
+    std::vector<Track> tracks;
+    tracks.reserve(trackCount);
+    for (size_t i = 0; i < trackCount; ++i)
+    {
+        tracks.push_back(makeTrack(i, artists));
+    }
+
+    Measurement before = measureLegacy(tracks);
+    Measurement after = measureCompact(tracks);
+
+    auto row = [](const char* name, const Measurement& m)
+    {
+        double total = m.recordBytes + m.heapBytes + m.sharedBytes;
+        std::cout << std::left << std::setw(10) << name << std::fixed << std::setprecision(1)
+                  << std::setw(12) << m.recordBytes << std::setw(12) << m.heapBytes
+                  << std::setw(12) << m.sharedBytes << std::setw(12) << total << m.buildMs << "\n";
+        return total;
+    };
+
+    std::cout << trackCount << " tracks, " << artists << " artists, " << (trackCount + 11) / 12
+              << " albums\n";
+    std::cout << std::left << std::setw(10) << "layout" << std::setw(12) << "sizeof"
+              << std::setw(12) << "heap/rec" << std::setw(12) << "pool/rec" << std::setw(12)
+              << "total/rec" << "build ms\n";
+
+    double legacyTotal = row("legacy", before);
+    double compactTotal = row("compact", after);
+
+    std::cout << "reduction: " << std::setprecision(2) << legacyTotal / compactTotal << "x\n";
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * @file SearchIndexBenchmark.cpp
+ * @brief Thời gian mỗi lần gõ phím khi tìm trong thư viện: cách lọc cũ của
+ *        LibraryScreen (hạ chữ title/artist/album của mọi bài rồi tìm chuỗi
+ *        con, mỗi khung hình) so với SearchIndex tra trigram, có và không
+ *        thu hẹp từ kết quả của lần gõ trước. Truy vấn được gõ từng ký tự.
+ *
+ * Usage: SearchIndexBenchmark [tracks]
+ */
+
+#include "models/SearchIndex.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+namespace
+{
+
+const char* WORDS[] = { "Love", "Night", "Blue", "Summer", "Heart", "Fire", "Dream", "River",
+                        "Song", "Light", "Rain", "Gold", "Stone", "Wild", "Home", "Road" };
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+models::MediaFileModel makeTrack(size_t i)
+{
+    models::MediaFileModel media("/music/album_" + std::to_string(i % 5000) + "/track_" + std::to_string(i) + ".mp3",
+                                 4 * 1024 * 1024, fs::file_time_type());
+    media.setTitle(std::string(WORDS[i % WORD_COUNT]) + " " + WORDS[(i / 7) % WORD_COUNT] + " " + std::to_string(i));
+    media.setArtist("Artist " + std::to_string(i % 3000));
+    media.setAlbum(std::string(WORDS[(i / 3) % WORD_COUNT]) + " Album " + std::to_string(i % 5000));
+    return media;
+}
+
+std::string lower(std::string text)
+{
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+// Cách lọc cũ của LibraryScreen
+size_t linearSearch(const std::vector<models::MediaFileModel>& list, const std::string& query)
+{
+    std::string needle = lower(query);
+    size_t count = 0;
+
+    for (const auto& media : list)
+    {
+        if (lower(media.getTitle()).find(needle) != std::string::npos ||
+            lower(media.getArtist()).find(needle) != std::string::npos ||
+            lower(media.getAlbum()).find(needle) != std::string::npos)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t tracks = argc > 1 ? static_cast<size_t>(std::max(1, std::stoi(argv[1]))) : 100000;
+
+    std::vector<models::MediaFileModel> list;
+    list.reserve(tracks);
+    for (size_t i = 0; i < tracks; ++i)
+    {
+        list.push_back(makeTrack(i));
+    }
+
+    models::SearchIndex index;
+    auto start = std::chrono::steady_clock::now();
+    index.build(list);
+    std::cout << tracks << " tracks, index built in " << std::fixed << std::setprecision(1) << elapsedMs(start)
+              << " ms\n\n";
+
+    std::cout << std::left << std::setw(16) << "query" << std::setw(10) << "matches" << std::setw(14) << "linear ms"
+              << std::setw(14) << "trigram ms" << "narrowed ms\n";
+
+    for (const std::string typed : { "summer rain", "artist 42", "gold album 12" })
+    {
+        models::SearchResult previous;
+
+        for (size_t length = 1; length <= typed.size(); ++length)
+        {
+            std::string query = typed.substr(0, length);
+
+            start = std::chrono::steady_clock::now();
+            size_t expected = linearSearch(list, query);
+            double linearMs = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            models::SearchResult fresh = index.search(query, models::SearchField::TAGS);
+            double freshMs = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            previous = index.search(query, models::SearchField::TAGS, &previous);
+            double narrowedMs = elapsedMs(start);
+
+            if (fresh.positions.size() != expected || previous.positions != fresh.positions)
+            {
+                std::cout << "Mismatch for \"" << query << "\"\n";
+                return 1;
+            }
+
+            std::cout << std::left << std::setw(16) << ("\"" + query + "\"") << std::setw(10) << expected
+                      << std::setprecision(3) << std::setw(14) << linearMs << std::setw(14) << freshMs
+                      << narrowedMs << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    return 0;
+}
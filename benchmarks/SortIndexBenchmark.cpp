@@ -0,0 +1,167 @@
+/**
+ * @file SortIndexBenchmark.cpp
+ * @brief Chi phí sắp xếp thư viện trong LibraryScreen: stable_sort mỗi khung
+ *        hình với comparator tạo chuỗi tạm (cách cũ) so với SortIndex giữ sẵn
+ *        thứ tự theo khóa collation — lần sắp xếp đầu, đổi cột/chiều (chỉ
+ *        duyệt thứ tự có sẵn) và gộp một lô bản ghi mới thay vì sắp xếp lại.
+ *
+ * Usage: SortIndexBenchmark [tracks] [batch]
+ */
+
+#include "models/SortIndex.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+
+namespace
+{
+
+const char* WORDS[] = { "Tình", "Yêu", "Đêm", "Mưa", "Anh", "Em", "Người", "Ánh", "Sao", "Biển",
+                        "Love", "Night", "Blue", "Summer", "Heart", "Road" };
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+models::MediaFileModel makeTrack(size_t i)
+{
+    models::MediaFileModel media("/music/album_" + std::to_string(i % 5000) + "/track_" + std::to_string(i) + ".mp3",
+                                 4 * 1024 * 1024, fs::file_time_type());
+    media.setTitle(std::string(WORDS[(i * 7) % WORD_COUNT]) + " " + WORDS[(i / 3) % WORD_COUNT] + " " +
+                   std::to_string(i % 977));
+    media.setArtist("Nghệ sĩ " + std::to_string(i % 3000));
+    media.setAlbum(std::string(WORDS[(i / 5) % WORD_COUNT]) + " " + std::to_string(i % 5000));
+    media.setDuration(static_cast<int>(120 + (i * 31) % 300));
+    return media;
+}
+
+// Cách sắp xếp cũ của LibraryScreen, chạy lại mỗi khung hình
+std::vector<size_t> sortPerFrame(const std::vector<models::MediaFileModel>& list, int sortField, bool ascending)
+{
+    std::vector<size_t> indices(list.size());
+    std::iota(indices.begin(), indices.end(), 0);
+
+    std::stable_sort(indices.begin(), indices.end(), [&](size_t a, size_t b)
+    {
+        const auto& mA = list[a];
+        const auto& mB = list[b];
+        int cmp = 0;
+        if (sortField == 0)
+        {
+            std::string tA = mA.getTitle().empty() ? std::string(mA.getFileName()) : mA.getTitle();
+            std::string tB = mB.getTitle().empty() ? std::string(mB.getFileName()) : mB.getTitle();
+            cmp = tA.compare(tB);
+        }
+        else if (sortField == 1)
+        {
+            cmp = mA.getArtist().compare(mB.getArtist());
+        }
+        else
+        {
+            cmp = (mA.getDuration() < mB.getDuration()) ? -1 : ((mA.getDuration() > mB.getDuration()) ? 1 : 0);
+        }
+        return ascending ? (cmp < 0) : (cmp > 0);
+    });
+
+    return indices;
+}
+
+// Dòng hiển thị lấy từ thứ tự có sẵn, như LibraryScreen::updateRows
+std::vector<size_t> rowsOf(const models::SortOrder& order, bool ascending)
+{
+    std::vector<size_t> rows;
+    rows.reserve(order->size());
+    if (ascending)
+    {
+        rows.assign(order->begin(), order->end());
+    }
+    else
+    {
+        rows.assign(order->rbegin(), order->rend());
+    }
+    return rows;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t tracks = argc > 1 ? static_cast<size_t>(std::max(1, std::stoi(argv[1]))) : 100000;
+    size_t batch = argc > 2 ? static_cast<size_t>(std::max(1, std::stoi(argv[2]))) : 1000;
+
+    std::vector<models::MediaFileModel> list;
+    list.reserve(tracks + batch);
+    for (size_t i = 0; i < tracks; ++i)
+    {
+        list.push_back(makeTrack(i));
+    }
+
+    const models::SortCriteria CRITERIA[] = { models::SortCriteria::TITLE, models::SortCriteria::ARTIST,
+                                              models::SortCriteria::DURATION };
+    const char* NAMES[] = { "title", "artist", "duration" };
+    size_t checksum = 0;
+
+    std::cout << tracks << " tracks, batches of " << batch << "\n\n";
+    std::cout << std::left << std::setw(10) << "column" << std::setw(18) << "per frame ms" << std::setw(18)
+              << "first sort ms" << std::setw(18) << "switch ms" << std::setw(18) << "merge batch ms"
+              << "resort ms\n";
+
+    for (int field = 0; field < 3; ++field)
+    {
+        auto start = std::chrono::steady_clock::now();
+        checksum += sortPerFrame(list, field, false).front();
+        double perFrameMs = elapsedMs(start);
+
+        models::SortIndex index;
+        start = std::chrono::steady_clock::now();
+        models::SortOrder order = index.getOrder(CRITERIA[field], list);
+        double firstMs = elapsedMs(start);
+
+        // Đổi cột hoặc chiều: thứ tự đã có, chỉ duyệt lại
+        start = std::chrono::steady_clock::now();
+        checksum += rowsOf(index.getOrder(CRITERIA[field], list), false).front();
+        double switchMs = elapsedMs(start);
+
+        // Một lô bản quét mới đến
+        std::vector<models::MediaFileModel> grown = list;
+        for (size_t i = 0; i < batch; ++i)
+        {
+            grown.push_back(makeTrack(tracks + i));
+        }
+
+        start = std::chrono::steady_clock::now();
+        index.append(grown, tracks);
+        double mergeMs = elapsedMs(start);
+
+        models::SortIndex fresh;
+        start = std::chrono::steady_clock::now();
+        models::SortOrder resorted = fresh.getOrder(CRITERIA[field], grown);
+        double resortMs = elapsedMs(start);
+
+        if (*resorted != *index.getOrder(CRITERIA[field], grown))
+        {
+            std::cout << "Merged order differs from a full sort for " << NAMES[field] << "\n";
+            return 1;
+        }
+
+        std::cout << std::left << std::fixed << std::setprecision(3) << std::setw(10) << NAMES[field]
+                  << std::setw(18) << perFrameMs << std::setw(18) << firstMs << std::setw(18) << switchMs
+                  << std::setw(18) << mergeMs << resortMs << "\n";
+        checksum += order->size();
+    }
+
+    std::cout << "\nchecksum " << checksum << "\n";
+    return 0;
+}
@@ -0,0 +1,159 @@
+/**
+ * @file TextSearchBenchmark.cpp
+ * @brief Lọc danh sách tên theo chuỗi con: cách cũ (hạ chữ từng tên vào chuỗi
+ *        tạm rồi std::string::find, như PlaylistRepository::searchByName và
+ *        ExploreController::getFilteredFolders trước đây) so với một lượt quét
+ *        TextArena đã chuẩn hóa sẵn, lần lượt với từng kernel TextSearch.
+ *
+ * Usage: TextSearchBenchmark [titles] [rounds]
+ */
+
+#include "utils/TextArena.h"
+#include "utils/TextSearch.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace media_player;
+
+namespace
+{
+
+const char* WORDS[] = { "Tình", "Yêu", "Đêm", "Mưa", "Anh", "Em", "Người", "Ánh", "Sao", "Biển",
+                        "Love", "Night", "Blue", "Summer", "Heart", "Road", "Remix", "Live" };
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+std::string makeTitle(size_t i)
+{
+    return std::string(WORDS[(i * 7) % WORD_COUNT]) + " " + WORDS[(i / 3) % WORD_COUNT] + " " +
+           WORDS[(i / 11) % WORD_COUNT] + " " + std::to_string(i % 9973);
+}
+
+std::string lowerAscii(std::string text)
+{
+    for (char& c : text)
+    {
+        c = utils::TextSearch::lowerAscii(c);
+    }
+    return text;
+}
+
+// Cách cũ: mỗi tên một bản sao hạ chữ
+size_t filterCopies(const std::vector<std::string>& titles, const std::string& query)
+{
+    std::string lowerQuery = query;
+    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+
+    size_t count = 0;
+    for (const auto& title : titles)
+    {
+        std::string lowerName = title;
+        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+        if (lowerName.find(lowerQuery) != std::string::npos)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t filterArena(const utils::TextArena& arena, const std::string& query)
+{
+    size_t count = 0;
+    arena.scan(lowerAscii(query), [&](uint32_t, size_t)
+    {
+        count++;
+        return true;
+    });
+    return count;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    size_t count = argc > 1 ? static_cast<size_t>(std::max(1, std::stoi(argv[1]))) : 1000000;
+    int rounds = argc > 2 ? std::max(1, std::stoi(argv[2])) : 5;
+
+    std::vector<std::string> titles;
+    utils::TextArena arena;
+    titles.reserve(count);
+    arena.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        titles.push_back(makeTitle(i));
+        arena.add(lowerAscii(titles.back()));
+    }
+
+    const std::string QUERIES[] = { "e", "lo", "night", "Summer Remix", "zzz", "biển 42" };
+    const utils::TextSearch::Kernel KERNELS[] = { utils::TextSearch::Kernel::SCALAR, utils::TextSearch::Kernel::SSE2,
+                                                  utils::TextSearch::Kernel::AVX2 };
+    const utils::TextSearch::Kernel initial = utils::TextSearch::getKernel();
+    size_t checksum = 0;
+
+    std::cout << count << " titles, best of " << rounds << " rounds, ms per filter\n\n";
+    std::cout << std::left << std::setw(16) << "query" << std::setw(10) << "matches" << std::setw(12) << "copies";
+    for (auto kernel : KERNELS)
+    {
+        if (utils::TextSearch::setKernel(kernel))
+        {
+            std::cout << std::setw(12) << utils::TextSearch::getKernelName();
+        }
+    }
+    std::cout << "\n";
+
+    for (const auto& query : QUERIES)
+    {
+        double copiesMs = 1e9;
+        size_t expected = 0;
+        for (int r = 0; r < rounds; ++r)
+        {
+            auto start = std::chrono::steady_clock::now();
+            expected = filterCopies(titles, query);
+            copiesMs = std::min(copiesMs, elapsedMs(start));
+        }
+
+        std::cout << std::left << std::fixed << std::setprecision(3) << std::setw(16) << ("\"" + query + "\"")
+                  << std::setw(10) << expected << std::setw(12) << copiesMs;
+
+        for (auto kernel : KERNELS)
+        {
+            if (!utils::TextSearch::setKernel(kernel))
+            {
+                continue;
+            }
+
+            double arenaMs = 1e9;
+            for (int r = 0; r < rounds; ++r)
+            {
+                auto start = std::chrono::steady_clock::now();
+                size_t matches = filterArena(arena, query);
+                arenaMs = std::min(arenaMs, elapsedMs(start));
+
+                if (matches != expected)
+                {
+                    std::cout << "\nMismatch for \"" << query << "\" with " << utils::TextSearch::getKernelName()
+                              << ": " << matches << " != " << expected << "\n";
+                    return 1;
+                }
+                checksum += matches;
+            }
+            std::cout << std::setw(12) << arenaMs;
+        }
+        std::cout << "\n";
+    }
+
+    utils::TextSearch::setKernel(initial);
+    std::cout << "\nchecksum " << checksum << "\n";
+    return 0;
+}
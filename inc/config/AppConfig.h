@@ -4,6 +4,7 @@
 // System includes
 #include <string>
 #include <vector>
+#include <cstdint>
 
 namespace media_player 
 {
@@ -18,6 +19,33 @@ public:
     // File system
     static constexpr int MAX_ITEMS_PER_PAGE = 25;
     static constexpr int MAX_SCAN_DEPTH = 10;
+    static constexpr int SCAN_THREAD_COUNT = 4;
+    static constexpr int SCAN_METADATA_WORKERS = 4;
+    static constexpr int SCAN_QUEUE_CAPACITY = 1024;
+    static constexpr int SCAN_BATCH_SIZE = 256;
+    static constexpr bool SCAN_TAG_PREFETCH = true;         // io_uring head/tail reads ahead of TagLib
+    static constexpr int SCAN_PREFETCH_BATCH = 32;          // Files per io_uring submission round
+    static constexpr int SCAN_PREFETCH_HEAD_BYTES = 32 * 1024;
+    static constexpr int SCAN_PREFETCH_TAIL_BYTES = 4 * 1024;
+    static constexpr bool SCAN_NATIVE_TAGS = true;          // Built-in MP3/WAV tag parser before TagLib
+    
+    // Scan I/O budget (0: unlimited); the playback budget applies while a track
+    // streams from the device being scanned
+    static constexpr uint64_t SCAN_IO_BYTES_PER_SEC = 0;
+    static constexpr uint64_t SCAN_IO_OPS_PER_SEC = 0;
+    static constexpr uint64_t SCAN_IO_PLAYBACK_BYTES_PER_SEC = 2 * 1024 * 1024;
+    static constexpr uint64_t SCAN_IO_PLAYBACK_OPS_PER_SEC = 100;
+    static constexpr bool SCAN_IO_IDLE_PRIORITY = true;     // ioprio idle class for scan threads
+    static constexpr bool SCAN_DROP_PAGE_CACHE = true;      // fadvise(DONTNEED) after reading tags
+    
+    // Library persistence: mutations go to library.journal, which is folded
+    // into library.dat by a background compactor once it reaches this size
+    static constexpr uint64_t LIBRARY_JOURNAL_COMPACT_BYTES = 4 * 1024 * 1024;
+    
+    // Repository writes run on a background thread once a repository has been
+    // quiet this long, and at the latest this long after its first change
+    static constexpr int PERSIST_COALESCE_MS = 500;
+    static constexpr int PERSIST_MAX_DELAY_MS = 2000;
     
     // Supported formats
     // Supported formats
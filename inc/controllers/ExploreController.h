@@ -170,6 +170,8 @@ private:
     std::shared_ptr<QueueController> m_queueController;           ///< Queue management
     std::shared_ptr<PlaybackController> m_playbackController;     ///< Playback control
     std::shared_ptr<PlaylistController> m_playlistController;     ///< Playlist management
+    
+    mutable models::SearchResult m_lastFileSearch;                ///< Kết quả lọc file lần trước, để thu hẹp khi gõ thêm
 };
 
 } // namespace controllers
@@ -6,9 +6,13 @@
 #include <vector>
 #include <string>
 #include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 // Project includes
 #include "models/LibraryModel.h"
+#include "models/HistoryModel.h"
 #include "models/MediaFileModel.h"
 #include "repositories/LibraryRepository.h"
 #include "services/IMetadataReader.h"
@@ -19,13 +23,23 @@ namespace media_player
 namespace controllers 
 {
 
+// A fuzzy search done on the worker, with the query as it was asked
+struct FuzzySearchAnswer 
+{
+    std::string query;
+    models::SearchFieldMask fields = 0;
+    models::LibraryFuzzySearch search;
+};
+
 class LibraryController 
 {
 public:
+    // historyModel supplies play counts for ranking fuzzy matches
     LibraryController(
         std::shared_ptr<models::LibraryModel> libraryModel,
         std::shared_ptr<repositories::LibraryRepository> libraryRepo,
-        std::shared_ptr<services::IMetadataReader> metadataReader
+        std::shared_ptr<services::IMetadataReader> metadataReader,
+        std::shared_ptr<models::HistoryModel> historyModel = nullptr
     );
 
     // Metadata
@@ -37,14 +51,25 @@ public:
     
     // View library
     std::vector<models::MediaFileModel> getAllMedia() const;
+    models::MediaSnapshot getSnapshot() const;
     std::vector<models::MediaFileModel> getPage(size_t pageNumber, size_t itemsPerPage) const;
     
     // Filtering
     std::vector<models::MediaFileModel> getAudioFiles() const;
     std::vector<models::MediaFileModel> getVideoFiles() const;
     std::vector<models::MediaFileModel> search(const std::string& query) const;
+    models::LibrarySearch search(const std::string& query, models::SearchFieldMask fields,
+                                 const models::LibrarySearch* previous = nullptr,
+                                 std::optional<models::SortCriteria> sortBy = std::nullopt) const;
+    
+    // Typo-tolerant search, run on a worker thread so rendering never waits
+    // for it; the latest request wins and asking again for the same query
+    // is free. The answer names the query it is for, null until the first.
+    void requestFuzzySearch(const std::string& query, models::SearchFieldMask fields);
+    std::shared_ptr<const FuzzySearchAnswer> getFuzzyAnswer() const;
     
     // Sorting
+    models::LibraryOrder getSortOrder(models::SortCriteria criteria) const;
     std::vector<models::MediaFileModel> sortByTitle(bool ascending = true) const;
     std::vector<models::MediaFileModel> sortByArtist(bool ascending = true) const;
     std::vector<models::MediaFileModel> sortByAlbum(bool ascending = true) const;
@@ -55,9 +80,22 @@ public:
     size_t getVideoCount() const;
     
 private:
+    void runFuzzySearches();
+    
     std::shared_ptr<models::LibraryModel> m_libraryModel;
     std::shared_ptr<repositories::LibraryRepository> m_libraryRepo;
     std::shared_ptr<services::IMetadataReader> m_metadataReader;
+    std::shared_ptr<models::HistoryModel> m_historyModel;
+    
+    // Fuzzy search worker, started by the first request
+    std::thread m_fuzzyThread;
+    mutable std::mutex m_fuzzyMutex;
+    std::condition_variable m_fuzzyWake;
+    std::optional<FuzzySearchAnswer> m_fuzzyRequest;    // Asked for, not yet picked up
+    std::string m_fuzzyQuery;                           // Last asked for
+    models::SearchFieldMask m_fuzzyFields = 0;
+    std::shared_ptr<const FuzzySearchAnswer> m_fuzzyAnswer;
+    bool m_fuzzyStop = false;
 };
 
 } // namespace controllers
@@ -11,6 +11,7 @@
 
 // Project includes
 #include "services/FileScanner.h"
+#include "services/LibraryWatcher.h"
 #include "repositories/LibraryRepository.h"
 #include "models/LibraryModel.h"
 
@@ -48,6 +49,10 @@ public:
     // Configuration
     void setMediaRoot(const std::string& path);
 
+    // Live updates: apply watcher changes to the model and repository.
+    // Returns the number of library entries added, updated or removed.
+    size_t applyLibraryChanges(const std::vector<services::LibraryChange>& changes);
+    
     // Status
     bool isScanning() const;
     std::string getCurrentSourcePath() const;
@@ -4,6 +4,7 @@
 // System includes
 #include <memory>
 #include <atomic>
+#include <chrono>
 
 // SDL includes
 #include <SDL2/SDL.h>
@@ -25,8 +26,12 @@
 #include "controllers/HistoryController.h"
 #include "controllers/ExploreController.h"
 #include "services/FileScanner.h"
+#include "services/LibraryWatcher.h"
+#include "services/MediaValidator.h"
+#include "utils/ThreadSafeQueue.h"
 #include "ui/ImGuiManager.h"
 #include "repositories/HistoryRepository.h"
+#include "repositories/ScanManifestRepository.h"
 
 namespace media_player 
 {
@@ -51,6 +56,10 @@ public:
     // Singleton access
     static Application& getInstance();
     
+    // Milliseconds from the start of the last scan to its first listed track;
+    // -1 until a track has arrived
+    int getTimeToFirstTrackMs() const;
+    
 private:
     // Initialization helpers
     bool initializeSDL();
@@ -74,6 +83,22 @@ private:
     void startScan(const std::string& path);
     void resetAndRescan(const std::string& path);
     
+    // Live library updates from LibraryWatcher, applied on the main thread
+    void applyPendingLibraryChanges();
+    
+    // Existence check of everything loaded at startup, once the UI is up;
+    // missing files are marked stale on the main thread
+    void startValidation();
+    void applyValidationResults();
+    
+    // Batches of a running scan, applied on the main thread as they arrive
+    void applyPendingScanBatches();
+    
+    // Once a scan completes: records of files it did not find leave the library
+    void removeUnscannedMedia();
+    void refreshLibraryViews();
+    bool isLibraryEmpty() const;
+    
     // Controllers (shared ownership)
     std::shared_ptr<controllers::MainController> m_mainController;
     std::shared_ptr<controllers::PlaybackController> m_playbackController;
@@ -93,6 +118,27 @@ private:
     std::shared_ptr<services::FileScanner> m_fileScanner;
     std::shared_ptr<repositories::HistoryRepository> m_historyRepo;
     std::shared_ptr<repositories::LibraryRepository> m_libraryRepo; // Added for persistence access in startScan
+    std::shared_ptr<repositories::ScanManifestRepository> m_scanManifest; // Tags of unchanged files for rescans
+    
+    // Watcher thread -> main thread; declared before the watcher so it outlives it
+    utils::ThreadSafeQueue<std::vector<services::LibraryChange>> m_libraryChanges;
+    std::unique_ptr<services::LibraryWatcher> m_libraryWatcher;
+    std::string m_scanRootPath;
+    
+    // Validator thread -> main thread: paths found missing after startup.
+    // Declared before the validator so it outlives it.
+    utils::ThreadSafeQueue<std::vector<std::string>> m_missingPaths;
+    std::unique_ptr<services::MediaValidator> m_mediaValidator;
+    bool m_validationStarted = false;
+    
+    // Scan thread -> main thread, so tracks show up while the scan is running
+    utils::ThreadSafeQueue<std::vector<models::MediaFileModel>> m_scanBatches;
+    std::chrono::steady_clock::time_point m_scanStartTime;
+    std::chrono::steady_clock::time_point m_lastViewRefresh;
+    std::chrono::steady_clock::time_point m_lastScanPublish;
+    size_t m_scanTracksShown = 0;
+    int m_timeToFirstTrackMs = -1;
+    bool m_libraryViewStale = false;
     
     // Hardware controller for S32K144 communication
     std::shared_ptr<controllers::HardwareController> m_hardwareController;
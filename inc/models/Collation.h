@@ -0,0 +1,43 @@
+#ifndef COLLATION_H
+#define COLLATION_H
+
+// System includes
+#include <string>
+#include <string_view>
+
+namespace media_player 
+{
+namespace models 
+{
+
+// Sort keys for display text. Comparing two keys with std::string::compare
+// orders their texts the way a Vietnamese reader expects:
+//  - letters follow the Vietnamese alphabet (a ă â b c d đ e ê ... o ô ơ ... u ư),
+//    with f, j, w and z where English puts them
+//  - case and tone marks only break ties, tones in dictionary order
+//    (a à ả ã á ạ), then lowercase before uppercase
+//  - runs of digits compare by value, so "Track 2" comes before "Track 10"
+//  - spaces and punctuation come before digits, digits before letters, and
+//    scripts without a table here after them, by code point
+// Text is read as UTF-8; precomposed and combining tone marks give the same
+// key, and bytes that are not valid UTF-8 are taken as Latin-1.
+//
+// fold() gives the search form of a text from the same tables: letters
+// lowercased and stripped of tones and marks (ă â → a, đ → d, ư → u),
+// combining marks dropped, everything else kept as it was, so "son tung"
+// is found in "Sơn Tùng".
+class Collation 
+{
+public:
+    static std::string key(std::string_view text);
+    
+    static std::string fold(std::string_view text);
+    
+    // Appends the folded text to out
+    static void fold(std::string_view text, std::string& out);
+};
+
+} // namespace models
+} // namespace media_player
+
+#endif // COLLATION_H
@@ -7,6 +7,8 @@
 
 // Project includes
 #include "MediaFileModel.h"
+#include "SearchIndex.h"
+#include "utils/TextArena.h"
 
 namespace media_player 
 {
@@ -98,6 +100,11 @@ public:
      */
     const std::vector<FolderEntry>& getCurrentFolders() const;
     
+    /**
+     * @brief Tên subfolder đã chuẩn hóa, id trùng vị trí trong getCurrentFolders().
+     */
+    const utils::TextArena& getFolderNames() const;
+    
     /**
      * @brief Cập nhật danh sách file media cho folder hiện tại.
      */
@@ -108,6 +115,12 @@ public:
      */
     const std::vector<MediaFileModel>& getCurrentFiles() const;
     
+    /**
+     * @brief Chỉ mục tìm kiếm trigram của danh sách file hiện tại.
+     * Dựng lại mỗi khi setCurrentFiles được gọi.
+     */
+    const SearchIndex& getFileIndex() const;
+    
     /**
      * @brief Lấy file tại index cụ thể.
      * @return Pointer tới file, nullptr nếu index không hợp lệ.
@@ -118,8 +131,9 @@ public:
     
     /**
      * @brief Cập nhật cache toàn bộ media list.
+     * Giữ chung snapshot của thư viện, không sao chép.
      */
-    void setAllMedia(const std::vector<MediaFileModel>& allMedia);
+    void setAllMedia(MediaSnapshot allMedia);
     
     /**
      * @brief Lấy toàn bộ media list (đã cache).
@@ -144,8 +158,10 @@ private:
     std::vector<std::string> m_pathStack; ///< Lịch sử navigation
     
     std::vector<FolderEntry> m_currentFolders;       ///< Subfolder hiện tại
+    utils::TextArena m_folderNames;                  ///< Tên đã chuẩn hóa của m_currentFolders
     std::vector<MediaFileModel> m_currentFiles;      ///< File nhạc hiện tại
-    std::vector<MediaFileModel> m_allMedia;          ///< Cache toàn bộ media
+    SearchIndex m_fileIndex;                         ///< Chỉ mục tìm kiếm của m_currentFiles
+    MediaSnapshot m_allMedia = std::make_shared<const std::vector<MediaFileModel>>(); ///< Cache toàn bộ media
 };
 
 } // namespace models
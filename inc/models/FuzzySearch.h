@@ -0,0 +1,184 @@
+#ifndef FUZZY_SEARCH_H
+#define FUZZY_SEARCH_H
+
+// System includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "SearchIndex.h"
+
+namespace media_player 
+{
+namespace models 
+{
+
+struct FuzzyMatch 
+{
+    uint32_t position;
+    int32_t score;
+};
+
+// One term of a query: the words it matched, and the records matching it
+// and all the terms before it, by ascending position, with the score of
+// those terms
+struct FuzzyTerm 
+{
+    std::string text;
+    std::shared_ptr<const std::vector<uint32_t>> words;
+    std::shared_ptr<const std::vector<FuzzyMatch>> hits;
+};
+
+struct FuzzyResult 
+{
+    std::string query;                  // Normalized
+    SearchFieldMask fields = 0;
+    uint64_t version = 0;               // Index state the positions belong to
+    std::vector<FuzzyMatch> matches;    // Best first, play bonus included
+    std::vector<FuzzyTerm> terms;       // Picked up again by the next keystroke
+};
+
+// Normalized fields of every record of a SearchIndex, copied out so words
+// can be gathered from them while the index goes on changing
+struct FuzzyFields 
+{
+    uint64_t version = 0;               // Of the index copied
+    std::string text;                   // All fields, '\0' after each
+    std::vector<uint32_t> ends;         // End of each field in text, FIELD_COUNT per record
+    
+    uint64_t getVersion() const 
+    {
+        return version;
+    }
+    
+    size_t size() const 
+    {
+        return ends.size() / SearchIndex::FIELD_COUNT;
+    }
+    
+    std::string_view getField(size_t position, size_t field) const;
+};
+
+// A pattern of up to 64 bytes for Myers' bit-parallel edit distance: each
+// byte of text costs a handful of word operations, and the search gives the
+// fewest insertions, deletions and substitutions that turn the pattern into
+// some substring of the text.
+class FuzzyPattern 
+{
+public:
+    static constexpr size_t MAX_LENGTH = 64;
+    
+    // Longer text is cut to MAX_LENGTH bytes
+    explicit FuzzyPattern(std::string_view text);
+    
+    size_t size() const 
+    {
+        return m_length;
+    }
+    
+    // Fewest edits over all substrings of text; end is set one past the
+    // first substring that needs that few
+    int search(std::string_view text, size_t& end) const;
+    
+private:
+    uint64_t m_masks[256];      // Bit i set where the pattern holds that byte
+    uint64_t m_last;
+    size_t m_length;
+};
+
+// Typo-tolerant search over the records of a SearchIndex. Every term of the
+// query has to be found, within a few edits (see maxDistance), in a word of
+// one of the fields asked for. A record scores, for each term, the weight of
+// the best field it was found in (title over artist over album over file
+// name) less a penalty per edit and for how far into the field the match
+// starts, plus a bonus for how often it was played. Only the best `limit`
+// are kept.
+//
+// Tags repeat all over a library, so terms are tried on its distinct words,
+// each listing where it occurs. The words are gathered by the first search
+// and again by the first one after the index changed. Typing picks up the
+// previous result: unchanged terms keep their hits, a new term only keeps
+// the records that matched the terms before it, and a term that grew only
+// tries the words it matched before while it allows as many edits. Like
+// SortIndex, the owner locks around it; an owner that also locks the index
+// can hold that lock only to copy the fields, and gather words from the copy.
+class FuzzySearch 
+{
+public:
+    // Times played by position in the index
+    using PlayCounts = std::unordered_map<uint32_t, uint32_t>;
+    
+    static constexpr size_t DEFAULT_LIMIT = 100;
+    static constexpr int32_t FIELD_WEIGHT[SearchIndex::FIELD_COUNT] = { 300, 200, 100, 50 };
+    static constexpr int32_t EDIT_PENALTY = 120;
+    static constexpr int32_t MAX_OFFSET_PENALTY = 20;   // One per byte into the field
+    static constexpr int32_t PLAY_BONUS = 30;           // Per doubling of the play count
+    
+    // Edits a term of this length may need: none below 4 bytes, 1 below 7,
+    // 2 beyond, so short terms do not match almost anything
+    static int maxDistance(size_t termLength);
+    
+    static int32_t playBonus(uint32_t plays);
+    
+    // Gathers the words of index first if they are not of its version
+    FuzzyResult search(const SearchIndex& index, const std::string& query, SearchFieldMask fields,
+                       const PlayCounts& plays, size_t limit = DEFAULT_LIMIT, const FuzzyResult* previous = nullptr);
+    
+    // Same over the words gathered last, with positions of their version
+    FuzzyResult search(const std::string& query, SearchFieldMask fields, const PlayCounts& plays,
+                       size_t limit = DEFAULT_LIMIT, const FuzzyResult* previous = nullptr);
+    
+    static FuzzyFields copyFields(const SearchIndex& index);
+    void gatherWords(const FuzzyFields& fields);
+    
+    bool hasWords(uint64_t version) const 
+    {
+        return !m_wordEnds.empty() && m_version == version;
+    }
+    
+private:
+    // Where a word is, in which field of which record
+    struct Occurrence 
+    {
+        uint32_t position;
+        uint8_t field;
+        uint8_t offset;     // Bytes into the field, at most MAX_OFFSET_PENALTY
+    };
+    
+    // Fields is a SearchIndex or FuzzyFields
+    template<typename Fields>
+    void gather(const Fields& fields);
+    
+    std::string_view getWord(uint32_t word) const 
+    {
+        return std::string_view(m_words.data() + m_wordEnds[word], m_wordEnds[word + 1] - m_wordEnds[word]);
+    }
+    
+    // Sets m_scores to the best score of the term in each record, NO_SCORE
+    // where it is not found, and returns the words it matched. Only the
+    // given words are tried, if any.
+    std::vector<uint32_t> scoreTerm(const std::string& term, SearchFieldMask fields,
+                                    const std::vector<uint32_t>* words);
+    
+    static constexpr int32_t NO_SCORE = INT32_MIN;
+    
+    // Words of the index as of m_version, back to back
+    uint64_t m_version = 0;
+    std::string m_words;
+    std::vector<uint32_t> m_wordEnds;               // Starts with 0, then the end of each word
+    std::vector<uint64_t> m_wordBytes;              // Bytes each word holds, see bytesOf
+    std::vector<Occurrence> m_occurrences;          // By word, then by position
+    std::vector<uint32_t> m_occurrenceEnds;         // Likewise, for m_occurrences
+    
+    std::vector<int32_t> m_scores;                  // By position, for the term at hand
+};
+
+} // namespace models
+} // namespace media_player
+
+#endif // FUZZY_SEARCH_H
@@ -9,9 +9,12 @@
 #include <deque>
 #include <chrono>
 #include <memory>
+#include <unordered_map>
+#include <cstdint>
 
 // Project includes
 #include "models/MediaFileModel.h"
+#include "models/MediaCatalog.h"
 
 namespace media_player 
 {
@@ -158,6 +161,12 @@ public:
      */
     bool wasRecentlyPlayed(const std::string& filePath, int withinMinutes = 30) const;
     
+    /**
+     * @brief Counts how often each media file appears in the history.
+     * @return Number of entries per media id, for ranking search results
+     */
+    std::unordered_map<MediaId, uint32_t> getPlayCounts() const;
+    
     // ==================== State Queries ====================
     
     /**
@@ -193,8 +202,23 @@ public:
     bool saveToRepository();
 
 private:
+    /**
+     * @brief Stored form of a HistoryEntry: the media is a catalog handle, so
+     *        repeated plays share one record and see tag edits.
+     */
+    struct PlayedEntry 
+    {
+        MediaHandle media;
+        std::chrono::system_clock::time_point playedAt;
+        
+        HistoryEntry toEntry() const 
+        {
+            return HistoryEntry(media.materialize(), playedAt);
+        }
+    };
+    
     std::shared_ptr<repositories::HistoryRepository> m_repository;  ///< Repository for persistence
-    std::deque<HistoryEntry> m_history;                             ///< In-memory history storage
+    std::deque<PlayedEntry> m_history;                              ///< In-memory history storage
     size_t m_maxEntries;                                            ///< Maximum entries to keep
     mutable std::mutex m_mutex;                                     ///< Mutex for thread safety
 };
@@ -5,57 +5,154 @@
 #include <vector>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <cstdint>
+#include <unordered_map>
+#include <functional>
 
 // Project includes
 #include "MediaFileModel.h"
+#include "MediaId.h"
+#include "SearchIndex.h"
+#include "SortIndex.h"
+#include "FuzzySearch.h"
 
 namespace media_player 
 {
 namespace models 
 {
 
-enum class SortCriteria 
+// Outcome of LibraryModel::search: positions in the snapshot they were found in
+struct LibrarySearch 
 {
-    TITLE,
-    ARTIST,
-    ALBUM,
-    FILE_NAME,
-    DATE_ADDED
+    MediaSnapshot media;
+    SearchResult result;
+    SortOrder order;        // Of media, when a sort was asked for
 };
 
+// Outcome of LibraryModel::fuzzySearch, positions likewise in media
+struct LibraryFuzzySearch 
+{
+    MediaSnapshot media;
+    FuzzyResult result;
+};
+
+// One change of a batch given to LibraryModel::applyChanges
+struct LibraryEdit 
+{
+    enum class Type 
+    {
+        PUT,            // media is added, or replaces the record of its path
+        REMOVE,         // The record of path
+        REMOVE_UNDER    // Every record under the directory path
+    };
+    
+    Type type;
+    std::string path;
+    std::optional<MediaFileModel> media;
+};
+
+// A sort order together with the snapshot its positions refer to
+struct LibraryOrder 
+{
+    MediaSnapshot media;
+    SortOrder positions;
+};
+
+// The library is published as an immutable snapshot together with a
+// path -> position index over it. Readers take the current one and iterate it
+// without locks or copies; writers are serialized, build the next list and
+// index off to the side and swap them in atomically.
 class LibraryModel 
 {
 public:
-    LibraryModel() = default;
+    LibraryModel();
     
     // Add/Remove
     void addMedia(const MediaFileModel& media);
     void addMediaBatch(const std::vector<MediaFileModel>& mediaList);
+    void addMediaBatch(std::vector<MediaFileModel>&& mediaList);
     bool removeMedia(const std::string& filePath);
+    size_t removeMediaUnder(const std::string& dirPath);
     bool updateMedia(const std::string& filePath, const MediaFileModel& updatedMedia);
     void clear();
     
+    // Applies edits in order, in one publish: the list and index are copied
+    // once for the whole batch rather than once per change. Returns how many
+    // records were put or removed.
+    size_t applyChanges(const std::vector<LibraryEdit>& edits);
+    size_t applyChanges(std::vector<LibraryEdit>&& edits);    // Media of PUT edits moved in
+    
+    // For edits streaming in every frame (a running scan). A publish copies
+    // the whole list and path index, so edits are held back until they are
+    // at least half the size of the published list: over a whole scan each
+    // record is then copied a bounded number of times rather than once per
+    // frame. Staged edits are not visible until published. Both return how
+    // many records were put or removed, 0 while edits stay staged.
+    size_t stageChanges(std::vector<LibraryEdit>&& edits);
+    size_t publishStaged();
+    size_t getStagedCount() const;
+    void dropStaged();
+    
+    // Flags the records of paths found missing, in one publish.
+    // Returns how many records changed.
+    size_t markStale(const std::vector<std::string>& missingPaths);
+    
+    // Replaces the whole library in one publish; duplicate paths are dropped.
+    // Like clear() and setSnapshot(), drops staged edits.
+    void replaceAll(const std::vector<MediaFileModel>& mediaList);
+    
+    // Publishes snapshot as is, shared with whoever else holds it.
+    // Its paths must be unique (a repository snapshot qualifies).
+    void setSnapshot(MediaSnapshot snapshot);
+    
+    // Current library; unchanged for as long as the caller holds it
+    MediaSnapshot getSnapshot() const;
+    
     // Query
     size_t getMediaCount() const 
     { 
-        return m_mediaList.size(); 
+        return getSnapshot()->size(); 
     }
     
     bool isEmpty() const 
     { 
-        return m_mediaList.empty(); 
+        return getSnapshot()->empty(); 
     }
     
+    // Copies the library; prefer getSnapshot()
     std::vector<MediaFileModel> getAllMedia() const 
     { 
-        return m_mediaList; 
+        return *getSnapshot(); 
     }
     
     std::optional<MediaFileModel> getMediaByPath(const std::string& filePath) const;
+    bool contains(const std::string& filePath) const;
+    size_t getStaleCount() const;
     
     // Filtering and sorting
     std::vector<MediaFileModel> search(const std::string& query) const;
+    
+    // Tracks whose fields contain query, from the trigram index. While the
+    // user types, passing the previous result narrows it down. With sortBy
+    // the order of the same snapshot comes along.
+    LibrarySearch search(const std::string& query, SearchFieldMask fields,
+                         const LibrarySearch* previous = nullptr,
+                         std::optional<SortCriteria> sortBy = std::nullopt) const;
+    
+    // Best `limit` tracks for a query typed with mistakes, see FuzzySearch;
+    // tracks played more often rank higher. While the user types, passing
+    // the previous result saves redoing the terms already matched.
+    LibraryFuzzySearch fuzzySearch(const std::string& query, SearchFieldMask fields,
+                                   const std::unordered_map<MediaId, uint32_t>& playCounts,
+                                   size_t limit = FuzzySearch::DEFAULT_LIMIT,
+                                   const LibraryFuzzySearch* previous = nullptr) const;
+    
+    // Kept sorted as the library changes: the first call for a criterion
+    // sorts, later ones hand back the maintained order
+    LibraryOrder getSortOrder(SortCriteria criteria) const;
+    
     std::vector<MediaFileModel> getSorted(SortCriteria criteria, bool ascending = true) const;
     std::vector<MediaFileModel> getPage(size_t pageNumber, size_t itemsPerPage) const;
     
@@ -65,9 +162,51 @@ public:
     long long getTotalSize() const;
     
 private:
-    bool matchesQuery(const MediaFileModel& media, const std::string& query) const;
+    // Keyed by media id, as the library repository is: copying it for every
+    // publish costs no string allocations. Paths sharing an id get an entry
+    // each and are told apart by the path.
+    using PathIndex = std::unordered_multimap<MediaId, uint32_t>;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    
+    // One published version of the library
+    struct State 
+    {
+        MediaSnapshot media;
+        PathIndex positions;
+    };
+    
+    std::shared_ptr<const State> getState() const;
+    
+    // Caller holds m_writeMutex. Applies edit to the search and sort indexes
+    // and swaps in the new state together, so both see matching positions.
+    using IndexEdit = std::function<void(SearchIndex&, SortIndex&, const std::vector<MediaFileModel>&)>;
+    void publish(std::vector<MediaFileModel> mediaList, PathIndex positions, const IndexEdit& edit = nullptr);
+    static PathIndex buildIndex(const std::vector<MediaFileModel>& mediaList);
+    
+    // Position of filePath in state, npos if absent
+    static size_t findPosition(const State& state, const std::string& filePath);
+    static size_t findPosition(const PathIndex& positions, const std::vector<MediaFileModel>& mediaList,
+                               const std::string& filePath);
+    
+    // Only accessed through std::atomic_load / std::atomic_store
+    std::shared_ptr<const State> m_state;
+    std::mutex m_writeMutex;
+    
+    // Edits waiting for stageChanges to publish them; taken before m_writeMutex
+    std::vector<LibraryEdit> m_staged;
+    mutable std::mutex m_stageMutex;
+    
+    // Both mirror the published list; held briefly by publish, search,
+    // fuzzySearch and getSortOrder. Sort orders are built on first use,
+    // hence mutable.
+    mutable std::mutex m_indexMutex;
+    SearchIndex m_searchIndex;
+    mutable SortIndex m_sortIndex;
     
-    std::vector<MediaFileModel> m_mediaList;
+    // Words of fuzzy search, gathered from a copy of the index fields after
+    // each change of the index; taken before m_indexMutex
+    mutable std::mutex m_fuzzyMutex;
+    mutable FuzzySearch m_fuzzySearch;
 };
 
 } // namespace models
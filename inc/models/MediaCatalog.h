@@ -0,0 +1,144 @@
+#ifndef MEDIA_CATALOG_H
+#define MEDIA_CATALOG_H
+
+// System includes
+#include <string>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Project includes
+#include "MediaFileModel.h"
+#include "MediaId.h"
+
+namespace media_player 
+{
+namespace models 
+{
+
+class MediaCatalog;
+
+// Reference to the catalog's record of one track. Copying a handle costs a
+// reference count, and every holder sees the record the catalog holds now,
+// so an edit published through the catalog reaches all of them at once.
+class MediaHandle 
+{
+public:
+    MediaHandle() = default;
+    
+    explicit operator bool() const 
+    {
+        return m_slot != nullptr;
+    }
+    
+    // Current record; unchanged for as long as the caller holds it
+    std::shared_ptr<const MediaFileModel> get() const;
+    
+    // Copy of the current record, empty for a null handle
+    MediaFileModel materialize() const;
+    
+    // The path never changes for a handle, so this needs no copy
+    const std::string& getFilePath() const;
+    
+    // Id of that path; null for a null handle
+    MediaId getId() const 
+    {
+        return m_slot ? m_slot->id : MediaId();
+    }
+    
+    // Compares the id first, so most mismatches skip the path compare
+    bool refersTo(MediaId id, const std::string& filePath) const 
+    {
+        return m_slot && m_slot->id == id && getFilePath() == filePath;
+    }
+    
+    bool operator==(const MediaHandle& other) const 
+    {
+        return m_slot == other.m_slot;
+    }
+    
+    bool operator!=(const MediaHandle& other) const 
+    {
+        return m_slot != other.m_slot;
+    }
+    
+private:
+    friend class MediaCatalog;
+    
+    struct Slot 
+    {
+        // First record of the slot, kept for its path, which every later
+        // record shares, so the path is stored once
+        std::shared_ptr<const MediaFileModel> origin;
+        std::shared_ptr<const MediaFileModel> record;  // Swapped atomically
+        MediaId id;
+    };
+    
+    explicit MediaHandle(std::shared_ptr<Slot> slot)
+        : m_slot(std::move(slot)) 
+    {
+    }
+    
+    std::shared_ptr<Slot> m_slot;
+};
+
+// Owns one record per file path for the queue, playlists and history, which
+// keep handles instead of their own copies. Entries live as long as some
+// handle does. Handles read without locking; intern/update/find lock.
+class MediaCatalog 
+{
+public:
+    MediaCatalog() = default;
+    
+    MediaCatalog(const MediaCatalog&) = delete;
+    MediaCatalog& operator=(const MediaCatalog&) = delete;
+    
+    // Catalog used by the models
+    static std::shared_ptr<MediaCatalog> getShared();
+    
+    // Handle to the record of media's path. The catalog keeps the record it
+    // holds unless media was modified on disk later (or the held one is
+    // stale), so an old copy never undoes an edit while a scanned record
+    // replaces a bare restored path.
+    MediaHandle intern(const MediaFileModel& media);
+    
+    // Publishes media as the record of its path to every holder.
+    // False if nothing holds that path.
+    bool update(const MediaFileModel& media);
+    
+    // Flags the held records of missing paths stale; returns how many changed
+    size_t markStale(const std::vector<std::string>& missingPaths);
+    
+    // Null handle if nothing holds filePath
+    MediaHandle find(const std::string& filePath) const;
+    
+    // Paths currently held, e.g. to check they still exist
+    std::vector<std::string> getFilePaths() const;
+    
+    // Paths currently held
+    size_t size() const;
+    
+private:
+    using Slot = MediaHandle::Slot;
+    
+    // Keyed by media id, so the map holds no path copies; slots sharing an
+    // id are told apart by their path
+    using SlotMap = std::unordered_multimap<MediaId, std::weak_ptr<Slot>>;
+    
+    // Live slot of filePath, or null
+    std::shared_ptr<Slot> findSlot(MediaId id, const std::string& filePath) const;
+    
+    // Drops entries whose last handle is gone, once the map has doubled
+    void pruneIfDue();
+    
+    mutable std::mutex m_mutex;
+    SlotMap m_slots;
+    size_t m_pruneAt = 64;
+};
+
+} // namespace models
+} // namespace media_player
+
+#endif // MEDIA_CATALOG_H
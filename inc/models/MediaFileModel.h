@@ -3,16 +3,22 @@
 
 // System includes
 #include <string>
+#include <string_view>
+#include <cstdint>
 #include <chrono>
 #include <memory>
+#include <vector>
 #include <filesystem>
 
+// Project includes
+#include "utils/StringPool.h"
+
 namespace media_player 
 {
 namespace models 
 {
 
-enum class MediaType 
+enum class MediaType : uint8_t 
 {
     AUDIO,
     VIDEO,
@@ -20,27 +26,40 @@ enum class MediaType
     UNKNOWN
 };
 
+// One library record. The path is stored once and file name, extension and
+// directory are views into it; artist and album come from the string pool, so
+// the thousands of tracks sharing them hold a pointer each.
 class MediaFileModel 
 {
 public:
     // Constructors
     MediaFileModel();
+    // No I/O: size and mtime stay unknown (0) until a scan fills them in
     explicit MediaFileModel(const std::string& filePath);
+    // Size and mtime already known (e.g. from the scanner's directory listing)
+    MediaFileModel(const std::string& filePath, size_t fileSize, 
+                   std::filesystem::file_time_type lastModified);
     
     // Getters
-    std::string getFilePath() const 
+    const std::string& getFilePath() const 
     { 
         return m_filePath; 
     }
     
-    std::string getFileName() const 
+    std::string_view getFileName() const 
     { 
-        return m_fileName; 
+        return std::string_view(m_filePath).substr(m_fileNameOffset); 
     }
     
-    std::string getExtension() const 
+    std::string_view getExtension() const 
     { 
-        return m_extension; 
+        return std::string_view(m_filePath).substr(m_extensionOffset); 
+    }
+    
+    // Path up to and including the last '/'
+    std::string_view getDirectory() const 
+    { 
+        return std::string_view(m_filePath).substr(0, m_fileNameOffset); 
     }
     
     MediaType getType() const 
@@ -53,21 +72,37 @@ public:
         return m_fileSize; 
     }
     
+    std::filesystem::file_time_type getLastModified() const 
+    { 
+        return m_lastModified; 
+    }
+    
     // Metadata getters
-    std::string getTitle() const { return m_title; }
-    std::string getArtist() const { return m_artist; }
-    std::string getAlbum() const { return m_album; }
+    const std::string& getTitle() const { return m_title; }
+    const std::string& getArtist() const { return *m_artist; }
+    const std::string& getAlbum() const { return *m_album; }
     int getDuration() const { return m_duration; }
     
     // Metadata setters
-    void setTitle(const std::string& title) { m_title = title; }
-    void setArtist(const std::string& artist) { m_artist = artist; }
-    void setAlbum(const std::string& album) { m_album = album; }
+    void setTitle(std::string_view title) { m_title.assign(title); }
+    void setArtist(std::string_view artist) { m_artist = &utils::StringPool::intern(artist); }
+    void setAlbum(std::string_view album) { m_album = &utils::StringPool::intern(album); }
     void setDuration(int duration) { m_duration = duration; }
     
-    // Validation
+    // Validation. isValid() stats the file; loaders leave that to
+    // MediaValidator, which marks missing records stale in the background.
     bool isValid() const;
     
+    bool isStale() const 
+    { 
+        return m_stale; 
+    }
+    
+    void setStale(bool stale) 
+    { 
+        m_stale = stale; 
+    }
+    
     bool isAudio() const 
     { 
         return m_type == MediaType::AUDIO; 
@@ -102,19 +137,25 @@ private:
     MediaType determineMediaType() const;
     
     std::string m_filePath;
-    std::string m_fileName;
-    std::string m_extension;
-    MediaType m_type;
     size_t m_fileSize;
     std::filesystem::file_time_type m_lastModified;
     
     // Metadata fields
     std::string m_title;
-    std::string m_artist;
-    std::string m_album;
+    const std::string* m_artist;
+    const std::string* m_album;
     int m_duration = 0;
+    
+    // Offsets into m_filePath (its size when there is no extension)
+    uint32_t m_fileNameOffset;
+    uint32_t m_extensionOffset;
+    MediaType m_type;
+    bool m_stale = false;   // File was missing when last checked
 };
 
+// Immutable list of media shared between its holders; read without locking
+using MediaSnapshot = std::shared_ptr<const std::vector<MediaFileModel>>;
+
 } // namespace models
 } // namespace media_player
 
@@ -0,0 +1,88 @@
+#ifndef MEDIA_ID_H
+#define MEDIA_ID_H
+
+// System includes
+#include <string>
+#include <optional>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace media_player 
+{
+namespace models 
+{
+
+// Identity of a media file: the 64-bit XXH64 hash (seed 0) of its path.
+// Unlike std::hash the value is the same in every build and on every
+// platform, so ids can be persisted and compared across runs. Two paths may
+// share an id; lookups that know the path compare it as well.
+class MediaId 
+{
+public:
+    constexpr MediaId()
+        : m_value(0) 
+    {
+    }
+    
+    constexpr explicit MediaId(uint64_t value)
+        : m_value(value) 
+    {
+    }
+    
+    static MediaId fromPath(const std::string& filePath) 
+    {
+        return fromPath(filePath.data(), filePath.size());
+    }
+    
+    static MediaId fromPath(const char* data, size_t length);
+    
+    // "media_" followed by the value in decimal
+    std::string toString() const;
+    
+    // Inverse of toString; nullopt for anything else
+    static std::optional<MediaId> parse(const std::string& text);
+    
+    constexpr uint64_t value() const 
+    {
+        return m_value;
+    }
+    
+    constexpr bool operator==(const MediaId& other) const 
+    {
+        return m_value == other.m_value;
+    }
+    
+    constexpr bool operator!=(const MediaId& other) const 
+    {
+        return m_value != other.m_value;
+    }
+    
+    constexpr bool operator<(const MediaId& other) const 
+    {
+        return m_value < other.m_value;
+    }
+    
+private:
+    uint64_t m_value;
+};
+
+} // namespace models
+} // namespace media_player
+
+namespace std 
+{
+
+// The id is already a well-mixed hash
+template<>
+struct hash<media_player::models::MediaId> 
+{
+    size_t operator()(const media_player::models::MediaId& id) const noexcept 
+    {
+        return static_cast<size_t>(id.value());
+    }
+};
+
+} // namespace std
+
+#endif // MEDIA_ID_H
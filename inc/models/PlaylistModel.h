@@ -10,6 +10,7 @@
 
 // Project includes
 #include "MediaFileModel.h"
+#include "MediaCatalog.h"
 
 namespace media_player 
 {
@@ -50,14 +51,18 @@ public:
     
     int getTotalDuration() const;
     
-    // Item management
+    // Item management; items are catalog handles, so copies of a playlist
+    // share them and see records updated through MediaCatalog
     void addItem(const MediaFileModel& media);
+    void addItem(const MediaHandle& media);
     bool removeItem(size_t index);
     bool removeItem(const std::string& filePath);
     void clear();
     
-    // Access items
-    std::vector<MediaFileModel> getItems() const 
+    // Access items; getItems() copies the current records
+    std::vector<MediaFileModel> getItems() const;
+    
+    const std::vector<MediaHandle>& getHandles() const 
     { 
         return m_items; 
     }
@@ -80,7 +85,7 @@ private:
     
     std::string m_id;
     std::string m_name;
-    std::vector<MediaFileModel> m_items;
+    std::vector<MediaHandle> m_items;
     std::chrono::system_clock::time_point m_createdAt;
     std::chrono::system_clock::time_point m_modifiedAt;
 };
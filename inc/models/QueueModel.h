@@ -8,6 +8,7 @@
 
 // Project includes
 #include "MediaFileModel.h"
+#include "MediaCatalog.h"
 
 namespace media_player 
 {
@@ -21,10 +22,14 @@ class QueueModel
 public:
     QueueModel() = default;
     
-    // Queue operations
+    // Queue operations; items are held as catalog handles, so a record
+    // updated through MediaCatalog shows up here without re-adding it
     void addToEnd(const MediaFileModel& media);
     void addNext(const MediaFileModel& media);
     void addAt(const MediaFileModel& media, size_t position);
+    void addToEnd(const MediaHandle& media);
+    void addNext(const MediaHandle& media);
+    void addAt(const MediaHandle& media, size_t position);
     
     bool removeAt(size_t index);
     bool removeByPath(const std::string& filePath);
@@ -58,8 +63,12 @@ public:
     
     bool hasNext() const;
     bool hasPrevious() const;
+    bool contains(const std::string& filePath) const;
     
-    std::vector<MediaFileModel> getAllItems() const 
+    // Copies of the current records
+    std::vector<MediaFileModel> getAllItems() const;
+    
+    std::vector<MediaHandle> getHandles() const 
     { 
         return m_items; 
     }
@@ -99,7 +108,7 @@ private:
     void updateShuffleOrder();
     size_t getActualIndex(size_t logicalIndex) const;
     
-    std::vector<MediaFileModel> m_items;
+    std::vector<MediaHandle> m_items;
     std::vector<size_t> m_shuffleOrder;
     size_t m_currentIndex = 0;
     bool m_shuffleEnabled = false;
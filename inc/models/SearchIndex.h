@@ -0,0 +1,139 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+// System includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "MediaFileModel.h"
+#include "utils/TextArena.h"
+
+namespace media_player 
+{
+namespace models 
+{
+
+// Fields a search looks at, combined into a mask
+using SearchFieldMask = uint8_t;
+
+struct SearchField 
+{
+    static constexpr SearchFieldMask TITLE = 1 << 0;      // Title, or the file name without one
+    static constexpr SearchFieldMask ARTIST = 1 << 1;
+    static constexpr SearchFieldMask ALBUM = 1 << 2;
+    static constexpr SearchFieldMask FILE_NAME = 1 << 3;
+    static constexpr SearchFieldMask TAGS = TITLE | ARTIST | ALBUM;
+};
+
+struct SearchResult 
+{
+    std::string query;                  // Normalized
+    SearchFieldMask fields = 0;
+    uint64_t version = 0;               // Index state the positions belong to
+    std::vector<uint32_t> positions;    // Ascending
+};
+
+// Trigram inverted index over the normalized title, artist, album and file
+// name of a list of records, addressed by their positions in the owner's list.
+// The owner mirrors every change of its list here; the index is not locked.
+// The normalized text lives in one arena, which queries too short for a
+// trigram scan in a single pass. Records are folded once, when they come in;
+// a search only folds its query.
+//
+// Posting entries pack a document id with the fields the trigram occurs in.
+// Removing or rewriting a document leaves its old entries behind: every
+// candidate is checked against the document's text, so stale entries only
+// cost time, and the postings are rebuilt once they are mostly stale.
+class SearchIndex 
+{
+public:
+    // Title, artist, album, file name: field f is bit f of a SearchFieldMask
+    static constexpr size_t FIELD_COUNT = 4;
+    
+    SearchIndex();
+    
+    // Case and accents folded, as Collation::fold
+    static std::string normalize(const std::string& text);
+    
+    size_t size() const 
+    {
+        return m_order.size();
+    }
+    
+    // Changes on every mutation; results of another version are not refined
+    uint64_t getVersion() const 
+    {
+        return m_version;
+    }
+    
+    void clear();
+    void reserve(size_t count);
+    void build(const std::vector<MediaFileModel>& mediaList);
+    
+    void append(const MediaFileModel& media);
+    void assign(size_t position, const MediaFileModel& media);
+    
+    // Later positions move up by one
+    void erase(size_t position);
+    
+    // Same for several ascending positions, in one pass
+    void erase(const std::vector<uint32_t>& positions);
+    
+    // The last record moves into position instead, as in LibraryIndex
+    void eraseSwap(size_t position);
+    
+    // Positions whose fields contain query. An empty query matches everything.
+    // A previous result of this index version, with the same fields and a
+    // query contained in this one, is narrowed down when it holds fewer
+    // candidates than the rarest trigram of the query.
+    SearchResult search(const std::string& query, SearchFieldMask fields,
+                        const SearchResult* previous = nullptr) const;
+    
+    // Normalized text of one field of the record at position
+    std::string_view getField(size_t position, size_t field) const;
+    
+    // Every field of every record in one copy, by position: each field is
+    // followed by '\0', and ends holds where each one stops
+    void copyText(std::string& text, std::vector<uint32_t>& ends) const;
+    
+private:
+    static constexpr uint32_t FREE = UINT32_MAX;
+    static constexpr uint32_t FIELD_BITS = 4;
+    
+    // Text of a document in m_text: normalized fields, '\0' after each
+    struct Document 
+    {
+        uint32_t ends[FIELD_COUNT];     // End of each field in the text
+        uint32_t position;              // FREE when the id is unused
+        uint32_t trigramCount;          // Live postings of this document
+    };
+    
+    using Postings = std::vector<uint32_t>;
+    
+    uint32_t allocate(const MediaFileModel& media, uint32_t position);
+    void release(uint32_t id);
+    static std::string textOf(const MediaFileModel& media, uint32_t (&ends)[FIELD_COUNT]);
+    void post(uint32_t id);
+    void rebuildPostingsIfStale();
+    void touch();
+    
+    bool matches(uint32_t id, const std::string& query, SearchFieldMask fields) const;
+    
+    utils::TextArena m_text;             // Ids are the document ids
+    std::vector<Document> m_documents;   // By id
+    std::vector<uint32_t> m_order;       // Position -> id
+    std::unordered_map<uint32_t, Postings> m_postings;   // Trigram -> entries
+    size_t m_postedCount;                // Entries in m_postings
+    size_t m_liveCount;                  // Of which belong to current text
+    uint64_t m_version;
+};
+
+} // namespace models
+} // namespace media_player
+
+#endif // SEARCH_INDEX_H
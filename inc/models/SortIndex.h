@@ -0,0 +1,79 @@
+#ifndef SORT_INDEX_H
+#define SORT_INDEX_H
+
+// System includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "MediaFileModel.h"
+
+namespace media_player 
+{
+namespace models 
+{
+
+enum class SortCriteria 
+{
+    TITLE,
+    ARTIST,
+    ALBUM,
+    FILE_NAME,
+    DATE_ADDED,
+    DURATION
+};
+
+// Positions of a list in ascending order; read backwards for descending.
+// Never changed once handed out.
+using SortOrder = std::shared_ptr<const std::vector<uint32_t>>;
+
+// Sorted permutations of a list of records, one per SortCriteria, kept up
+// to date as the owner's list changes. A criterion costs nothing until its
+// order is first asked for; from then on its collation keys are kept per
+// record and edits are merged into the order instead of sorting it again.
+// Ties keep list order, so DATE_ADDED is the list order itself. Like
+// SearchIndex, the owner mirrors every change here and locks around it.
+class SortIndex 
+{
+public:
+    SortIndex();
+    
+    void clear();
+    
+    // list is the owner's list after the change in every call below
+    void build(const std::vector<MediaFileModel>& list);
+    void append(const std::vector<MediaFileModel>& list, size_t first);
+    void assign(const std::vector<MediaFileModel>& list, size_t position);
+    
+    // positions are ascending and refer to the list before the change. A
+    // batch of changes may erase first and append after, passing the final
+    // list to both.
+    void erase(const std::vector<MediaFileModel>& list, const std::vector<uint32_t>& positions);
+    
+    SortOrder getOrder(SortCriteria criteria, const std::vector<MediaFileModel>& list);
+    
+private:
+    static constexpr size_t CRITERIA_COUNT = 6;
+    
+    struct Order 
+    {
+        bool active = false;
+        std::vector<std::string> keys;      // By position; empty for DATE_ADDED
+        SortOrder positions;
+    };
+    
+    static std::string keyOf(SortCriteria criteria, const MediaFileModel& media);
+    static SortOrder identity(size_t size);
+    
+    void sortAll(SortCriteria criteria, const std::vector<MediaFileModel>& list);
+    
+    Order m_orders[CRITERIA_COUNT];
+};
+
+} // namespace models
+} // namespace media_player
+
+#endif // SORT_INDEX_H
@@ -8,9 +8,12 @@
 #include <mutex>
 #include <deque>
 #include <chrono>
+#include <memory>
 
 // Project includes
 #include "models/MediaFileModel.h"
+#include "models/MediaCatalog.h"
+#include "repositories/PersistenceService.h"
 
 namespace media_player 
 {
@@ -29,10 +32,13 @@ struct PlaybackHistoryEntry
     }
 };
 
+// Changes are written to history.dat by the persistence service in the
+// background; saveToDisk() and the destructor flush what is still pending.
 class HistoryRepository 
 {
 public:
-    explicit HistoryRepository(const std::string& storagePath, size_t maxEntries = 100);
+    explicit HistoryRepository(const std::string& storagePath, size_t maxEntries = 100,
+                               std::shared_ptr<PersistenceService> persistence = nullptr);
     ~HistoryRepository();
     
     // History operations
@@ -58,9 +64,27 @@ public:
     
     // Persistence
     bool loadFromDisk();
+    
+    // Writes history.dat now, on the calling thread
     bool saveToDisk();
     
 private:
+    // Entries are kept as catalog handles and copied out on read
+    struct StoredEntry 
+    {
+        models::MediaHandle media;
+        std::chrono::system_clock::time_point playedAt;
+        
+        PlaybackHistoryEntry toEntry() const 
+        {
+            PlaybackHistoryEntry entry(media.materialize());
+            entry.playedAt = playedAt;
+            return entry;
+        }
+    };
+    
+    // Schedules a background write of history.dat
+    void markDirty();
     bool serializeHistory();
     bool deserializeHistory();
     
@@ -68,9 +92,11 @@ private:
     std::string getHistoryFilePath() const;
     
     std::string m_storagePath;
-    std::deque<PlaybackHistoryEntry> m_history;
+    std::deque<StoredEntry> m_history;
     size_t m_maxEntries;
     mutable std::mutex m_mutex;
+    
+    std::shared_ptr<PersistenceService> m_persistence;
 };
 
 } // namespace repositories
@@ -0,0 +1,161 @@
+#ifndef LIBRARY_INDEX_H
+#define LIBRARY_INDEX_H
+
+// System includes
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// Project includes
+#include "models/MediaFileModel.h"
+#include "models/MediaId.h"
+#include "models/SearchIndex.h"
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+// In-memory store of the library, keyed by media id (the 64-bit hash of the
+// file path). Paths that share an id still get an entry each: lookups by path
+// compare the path, while find(id) returns the first entry with that id.
+//
+// Entries live in one dense array; an open-addressing table (linear probing,
+// backward-shift deletion) maps hashes to positions. Secondary indexes by type,
+// artist and album and the size/type aggregates are updated on every mutation.
+// Erasing moves the last entry into the hole, so positions are only valid
+// until the next erase.
+class LibraryIndex 
+{
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    
+    LibraryIndex();
+    
+    size_t size() const 
+    {
+        return m_media.size();
+    }
+    
+    bool empty() const 
+    {
+        return m_media.empty();
+    }
+    
+    void reserve(size_t count);
+    void clear();
+    
+    // Position of the entry, npos if absent
+    size_t find(models::MediaId id) const;
+    size_t find(const std::string& filePath) const;
+    size_t find(models::MediaId id, const std::string& filePath) const;
+    
+    const models::MediaFileModel& at(size_t position) const 
+    {
+        return m_media[position];
+    }
+    
+    // Dense array, in no particular order
+    const std::vector<models::MediaFileModel>& entries() const 
+    {
+        return m_media;
+    }
+    
+    // Inserts or replaces the entry of media.getFilePath().
+    // Returns its position and whether it was inserted.
+    std::pair<size_t, bool> put(models::MediaFileModel media);
+    
+    // Same with the id of the path already known
+    std::pair<size_t, bool> put(models::MediaId id, models::MediaFileModel media);
+    
+    // Replaces the entry at position, which must have the same path
+    void assign(size_t position, models::MediaFileModel media);
+    
+    bool erase(const std::string& filePath);
+    void eraseAt(size_t position);
+    
+    // Erases every entry whose path starts with prefix
+    size_t eraseUnder(const std::string& prefix);
+    
+    // Secondary indexes: positions of matching entries
+    const std::vector<uint32_t>& findByType(models::MediaType type) const;
+    const std::vector<uint32_t>& findByArtist(const std::string& artist) const;
+    const std::vector<uint32_t>& findByAlbum(const std::string& album) const;
+    
+    // Aggregates, kept current by every mutation
+    size_t countByType(models::MediaType type) const 
+    {
+        return findByType(type).size();
+    }
+    
+    uint64_t getTotalSize() const 
+    {
+        return m_totalSize;
+    }
+    
+    // Positions whose fields contain query. The trigram index behind it is
+    // built on the first call and kept current from then on.
+    models::SearchResult search(const std::string& query, models::SearchFieldMask fields);
+    
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    static constexpr size_t TYPE_COUNT = static_cast<size_t>(models::MediaType::UNKNOWN) + 1;
+    
+    // Upper hash bits let most probes skip the entry array
+    struct Slot 
+    {
+        uint32_t tag;
+        uint32_t position;
+    };
+    
+    using Postings = std::vector<uint32_t>;
+    using NameIndex = std::unordered_map<std::string, Postings>;
+    
+    // Where an entry sits in each secondary index; map values do not move
+    // on rehash, so the name postings are held by pointer
+    struct Links 
+    {
+        Postings* artist;
+        Postings* album;
+        uint32_t typeIndex;
+        uint32_t artistIndex;
+        uint32_t albumIndex;
+    };
+    
+    // Slot of the entry with hash and, unless null, filePath
+    size_t findSlot(uint64_t hash, const std::string* filePath) const;
+    // Slot pointing at an existing position
+    size_t slotOf(uint32_t position) const;
+    void insertSlot(uint64_t hash, uint32_t position);
+    void eraseSlot(size_t slot);
+    void rehash(size_t capacity);
+    
+    void link(uint32_t position);
+    void unlink(uint32_t position);
+    void removePosting(Postings& postings, uint32_t index, uint32_t Links::*field);
+    
+    std::vector<Slot> m_slots;
+    size_t m_mask;
+    
+    // Dense entry array and per-entry bookkeeping, indexed by position
+    std::vector<models::MediaFileModel> m_media;
+    std::vector<uint64_t> m_hashes;
+    std::vector<Links> m_links;
+    
+    Postings m_byType[TYPE_COUNT];
+    NameIndex m_byArtist;
+    NameIndex m_byAlbum;
+    uint64_t m_totalSize;
+    
+    // Null until the first search
+    std::unique_ptr<models::SearchIndex> m_text;
+};
+
+} // namespace repositories
+} // namespace media_player
+
+#endif // LIBRARY_INDEX_H
@@ -0,0 +1,94 @@
+#ifndef LIBRARY_JOURNAL_H
+#define LIBRARY_JOURNAL_H
+
+// System includes
+#include <string>
+#include <cstdint>
+#include <functional>
+
+// Project includes
+#include "models/MediaFileModel.h"
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+enum class LibraryJournalOp : uint8_t 
+{
+    PUT = 1,            // Insert or replace the entry of media.getFilePath()
+    REMOVE = 2,         // Remove the entry of path
+    REMOVE_UNDER = 3,   // Remove every entry under the directory path
+    CLEAR = 4
+};
+
+struct LibraryJournalEntry 
+{
+    LibraryJournalOp op = LibraryJournalOp::CLEAR;
+    models::MediaFileModel media;
+    std::string path;
+};
+
+// Write-ahead log of library mutations, replayed on top of library.dat.
+//
+// After a short file header, every record is [payload length][checksum][payload],
+// so a record torn by a crash is detected and replay stops in front of it.
+// Records of one call are encoded into a buffer and appended with one write.
+class LibraryJournal 
+{
+public:
+    explicit LibraryJournal(const std::string& filePath);
+    ~LibraryJournal();
+    
+    LibraryJournal(const LibraryJournal&) = delete;
+    LibraryJournal& operator=(const LibraryJournal&) = delete;
+    
+    static void encodePut(std::string& buffer, const models::MediaFileModel& media);
+    static void encodeRemove(std::string& buffer, const std::string& filePath);
+    static void encodeRemoveUnder(std::string& buffer, const std::string& dirPath);
+    static void encodeClear(std::string& buffer);
+    
+    // Appends encoded records, creating the file on first use
+    bool append(const std::string& buffer);
+    
+    // Closes the file; the next append reopens it (or creates a new one
+    // if it was renamed away in the meantime)
+    void close();
+    
+    // Bytes in the file, header included; 0 if it does not exist yet
+    uint64_t size() const 
+    {
+        return m_size;
+    }
+    
+    const std::string& getFilePath() const 
+    {
+        return m_filePath;
+    }
+    
+    // Renames the file away (for compaction); the next append starts a new one
+    bool rotateTo(const std::string& toPath);
+    
+    // Deletes the file once its records are in the snapshot
+    void discard();
+    
+    // Drops a torn tail left by a crash, so new records are not appended
+    // behind bytes replay would stop at
+    bool truncate(uint64_t validBytes);
+    
+    // Calls apply for each intact record in order. Returns the length of the
+    // intact prefix (0 for a missing file or a foreign header).
+    static uint64_t replay(const std::string& filePath, const std::function<void(const LibraryJournalEntry&)>& apply);
+    
+private:
+    bool openForAppend();
+    
+    std::string m_filePath;
+    int m_fd;
+    uint64_t m_size;
+};
+
+} // namespace repositories
+} // namespace media_player
+
+#endif // LIBRARY_JOURNAL_H
@@ -6,24 +6,37 @@
 #include <vector>
 #include <optional>
 #include <mutex>
-#include <map>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 
 // Project includes
 #include "IRepository.h"
 #include "models/MediaFileModel.h"
+#include "models/MediaId.h"
+#include "repositories/LibraryIndex.h"
+#include "repositories/LibraryJournal.h"
+#include "repositories/PersistenceService.h"
 
 namespace media_player 
 {
 namespace repositories 
 {
 
+// Library cache persisted as library.dat (a snapshot) plus library.journal.
+// Mutations queue journal records that the persistence service appends in the
+// background; a compactor thread folds the journal into a new snapshot once it
+// outgrows its threshold. Loading replays the journal on top of the snapshot.
 class LibraryRepository : public IRepository<models::MediaFileModel> 
 {
 public:
-    explicit LibraryRepository(const std::string& storagePath);
+    explicit LibraryRepository(const std::string& storagePath,
+                               std::shared_ptr<PersistenceService> persistence = nullptr);
     ~LibraryRepository();
     
-    // IRepository interface implementation
+    // IRepository interface implementation; ids are MediaId::toString()
     bool save(const models::MediaFileModel& media) override;
     std::optional<models::MediaFileModel> findById(const std::string& id) override;
     std::vector<models::MediaFileModel> findAll() override;
@@ -31,35 +44,101 @@ public:
     bool remove(const std::string& id) override;
     bool exists(const std::string& id) override;
     
+    // Same lookups without the id text; with paths sharing an id, the first
+    std::optional<models::MediaFileModel> findById(models::MediaId id);
+    bool remove(models::MediaId id);
+    bool exists(models::MediaId id);
+    
     bool saveAll(const std::vector<models::MediaFileModel>& mediaList) override;
     void clear() override;
     
+    // Makes the library equal to mediaList, journaling only the entries that
+    // were added, changed or dropped (what a rescan needs)
+    virtual bool replaceAll(const std::vector<models::MediaFileModel>& mediaList);
+    
     size_t count() const override;
     
+    // The library as an immutable list, built on the first call after a
+    // change and then shared without locking until the next one
+    models::MediaSnapshot getSnapshot() const;
+    
     // Additional query methods
     std::optional<models::MediaFileModel> findByPath(const std::string& filePath);
     std::vector<models::MediaFileModel> findByType(models::MediaType type);
+    std::vector<models::MediaFileModel> findByArtist(const std::string& artist);
+    std::vector<models::MediaFileModel> findByAlbum(const std::string& album);
     std::vector<models::MediaFileModel> searchByFileName(const std::string& query);
     
-    // Statistics
+    // Removal by location (used by live library updates)
+    bool removeByPath(const std::string& filePath);
+    size_t removeUnderPath(const std::string& dirPath);
+    
+    // Statistics (maintained on every mutation, no scan)
     size_t countByType(models::MediaType type) const;
     long long getTotalSize() const;
     
     // Persistence
     bool loadFromDisk();
+    
+    // Appends the queued journal records now, on the calling thread
+    bool flush();
+    
+    // Writes the whole cache as a new snapshot and empties the journal
     bool saveToDisk();
     
+    // Folds the journal into the snapshot now, on the calling thread
+    bool compact();
+    
+    // Journal size that wakes the compactor (default LIBRARY_JOURNAL_COMPACT_BYTES)
+    void setCompactThreshold(uint64_t bytes);
+    uint64_t getJournalSize() const;
+    size_t getCompactionCount() const;
+    
 private:
     std::string getLibraryFilePath() const;
+    std::string getJournalFilePath() const;
+    std::string getCompactingJournalFilePath() const;
     bool serializeLibrary();
     bool deserializeLibrary();
+    bool deserializeLegacyLibrary();
+    
+    // Caller holds m_mutex; queues records for the background writer
+    void appendToJournal(const std::string& records);
+    bool writePendingRecords();
+    void applyEntry(LibraryIndex& cache, const LibraryJournalEntry& entry) const;
+    bool loadSnapshot(LibraryIndex& cache) const;
+    static bool sameEntry(const models::MediaFileModel& a, const models::MediaFileModel& b);
+    
+    void compactorLoop();
     
     void ensureStorageDirectoryExists();
-    std::string generateId(const std::string& filePath) const;
+    // Caller holds m_mutex
+    void invalidateSnapshot();
+    std::vector<models::MediaFileModel> collect(const std::vector<uint32_t>& positions) const;
     
     std::string m_storagePath;
-    std::map<std::string, models::MediaFileModel> m_cache;
+    LibraryIndex m_cache;
     mutable std::mutex m_mutex;
+    // Cleared under m_mutex by every change; only accessed atomically
+    mutable models::MediaSnapshot m_snapshot;
+    
+    LibraryJournal m_journal;
+    uint64_t m_compactThreshold;
+    std::string m_pendingRecords;          // Encoded, not yet in the journal
+    std::shared_ptr<PersistenceService> m_persistence;
+    
+    // Held while library.dat or the journal files are replaced (before m_journalMutex)
+    std::mutex m_fileMutex;
+    // Held while m_journal is used (before m_mutex)
+    mutable std::mutex m_journalMutex;
+    std::thread m_compactor;
+    std::condition_variable m_compactCondition;
+    bool m_compactRequested;
+    // library.dat could not be loaded (damaged, newer version); compaction
+    // leaves it alone until saveToDisk() writes a new one
+    bool m_snapshotUnreadable;
+    std::atomic<bool> m_stopCompactor;
+    std::atomic<size_t> m_compactions;
 };
 
 } // namespace repositories
@@ -0,0 +1,119 @@
+#ifndef LIBRARY_SNAPSHOT_H
+#define LIBRARY_SNAPSHOT_H
+
+// System includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "models/MediaFileModel.h"
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+// On-disk layout of library.dat (native byte order, checked by byteOrder):
+//
+//   LibrarySnapshotHeader
+//   LibrarySnapshotRecord[recordCount]   fixed width, 8-byte aligned
+//   string heap                          paths and tags, not NUL-terminated
+//
+// A record points into the heap by offset and length, so a mapped file is
+// read in place: nothing is parsed or copied until a field is asked for.
+struct LibrarySnapshotHeader 
+{
+    char magic[8];              // "MPLIBSNP"
+    uint32_t version;
+    uint32_t byteOrder;         // 0x01020304 as written
+    uint32_t headerSize;
+    uint32_t recordSize;
+    uint64_t recordCount;
+    uint64_t recordOffset;
+    uint64_t heapOffset;
+    uint64_t heapSize;
+};
+
+struct LibrarySnapshotRecord 
+{
+    uint64_t fileSize;
+    int64_t lastModified;       // file_time_type ticks
+    uint32_t pathOffset;
+    uint32_t pathLength;
+    uint32_t titleOffset;
+    uint32_t titleLength;
+    uint32_t artistOffset;
+    uint32_t artistLength;
+    uint32_t albumOffset;
+    uint32_t albumLength;
+    int32_t duration;
+    uint8_t type;               // models::MediaType
+    uint8_t reserved[3];
+};
+
+// Read-only view of a snapshot file mapped into memory
+class LibrarySnapshot 
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    
+    LibrarySnapshot();
+    ~LibrarySnapshot();
+    
+    LibrarySnapshot(const LibrarySnapshot&) = delete;
+    LibrarySnapshot& operator=(const LibrarySnapshot&) = delete;
+    
+    // Maps the file and checks the header and table bounds. False if the file
+    // is missing, not a snapshot, or from another version.
+    bool open(const std::string& filePath);
+    void close();
+    
+    bool isOpen() const 
+    {
+        return m_records != nullptr;
+    }
+    
+    size_t size() const 
+    {
+        return m_recordCount;
+    }
+    
+    const LibrarySnapshotRecord& record(size_t index) const 
+    {
+        return m_records[index];
+    }
+    
+    // Field of a record; empty if it points outside the heap
+    std::string_view text(uint32_t offset, uint32_t length) const;
+    
+    std::string_view path(size_t index) const 
+    {
+        return text(m_records[index].pathOffset, m_records[index].pathLength);
+    }
+    
+    // Rebuilds the model of a record without touching the file it names
+    models::MediaFileModel toMedia(size_t index) const;
+    
+    // Writes a snapshot next to filePath and renames it into place, so a
+    // crash never leaves a half-written library behind
+    static bool write(const std::string& filePath, const std::vector<const models::MediaFileModel*>& media);
+    
+    // Tells a snapshot from the legacy text library by its first bytes
+    static bool isSnapshotFile(const std::string& filePath);
+    
+private:
+    void* m_data;
+    size_t m_mappedSize;
+    const LibrarySnapshotRecord* m_records;
+    size_t m_recordCount;
+    const char* m_heap;
+    uint64_t m_heapSize;
+};
+
+} // namespace repositories
+} // namespace media_player
+
+#endif // LIBRARY_SNAPSHOT_H
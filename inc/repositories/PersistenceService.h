@@ -0,0 +1,90 @@
+#ifndef PERSISTENCE_SERVICE_H
+#define PERSISTENCE_SERVICE_H
+
+// System includes
+#include <string>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+// Background writer shared by the repositories.
+//
+// A repository marks a key dirty with the writer that persists it; the writer
+// runs on the service thread once the key has been quiet for the coalescing
+// delay (or the maximum delay has passed since it first became dirty), so a
+// burst of edits costs one write. A later mark replaces the pending writer.
+// Writers of one key never run concurrently.
+class PersistenceService 
+{
+public:
+    using WriteTask = std::function<bool()>;
+    using Clock = std::chrono::steady_clock;
+    
+    PersistenceService();
+    PersistenceService(std::chrono::milliseconds delay, std::chrono::milliseconds maxDelay);
+    
+    // Runs whatever is still pending before the thread stops
+    ~PersistenceService();
+    
+    PersistenceService(const PersistenceService&) = delete;
+    PersistenceService& operator=(const PersistenceService&) = delete;
+    
+    // Service used by repositories that were not given one
+    static std::shared_ptr<PersistenceService> getShared();
+    
+    void markDirty(const std::string& key, WriteTask writer);
+    
+    // Runs the pending writer of key on the calling thread (after waiting for
+    // a run already in progress). Returns its result, true if nothing was pending.
+    bool flush(const std::string& key);
+    
+    // Same for every pending key; false if any writer failed
+    bool flush();
+    
+    size_t getPendingCount() const;
+    size_t getWriteCount() const;
+    
+    // Writes contents to a temporary file next to path, syncs it and renames
+    // it over path, so readers see either the old or the new file
+    static bool writeFileAtomically(const std::string& path, const std::string& contents);
+    
+private:
+    struct Pending 
+    {
+        WriteTask writer;
+        Clock::time_point firstDirty;
+        Clock::time_point due;
+    };
+    
+    // Caller holds the lock; runs the writer without it
+    bool run(std::unique_lock<std::mutex>& lock, const std::string& key, WriteTask writer);
+    
+    void workerLoop();
+    
+    std::chrono::milliseconds m_delay;
+    std::chrono::milliseconds m_maxDelay;
+    
+    std::map<std::string, Pending> m_pending;
+    std::set<std::string> m_running;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop;
+    std::atomic<size_t> m_writes;
+    std::thread m_worker;
+};
+
+} // namespace repositories
+} // namespace media_player
+
+#endif // PERSISTENCE_SERVICE_H
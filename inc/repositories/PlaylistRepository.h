@@ -7,20 +7,26 @@
 #include <optional>
 #include <mutex>
 #include <map>
+#include <set>
+#include <memory>
 
 // Project includes
 #include "IRepository.h"
 #include "models/PlaylistModel.h"
+#include "repositories/PersistenceService.h"
 
 namespace media_player 
 {
 namespace repositories 
 {
 
+// Playlists changed in the cache are marked dirty and their .playlist files
+// are written (or deleted) in one background pass by the persistence service.
 class PlaylistRepository : public IRepository<models::PlaylistModel> 
 {
 public:
-    explicit PlaylistRepository(const std::string& storagePath);
+    explicit PlaylistRepository(const std::string& storagePath,
+                                std::shared_ptr<PersistenceService> persistence = nullptr);
     ~PlaylistRepository();
     
     // IRepository interface implementation
@@ -42,11 +48,17 @@ public:
     
     // Persistence
     bool loadFromDisk();
+    
+    // Writes every playlist now, on the calling thread
     bool saveToDisk();
     
 private:
+    // Caller holds m_mutex
+    void markDirty(const std::string& id);
+    bool writeDirtyPlaylists();
+    
     std::string getPlaylistFilePath(const std::string& id) const;
-    bool serializePlaylist(const models::PlaylistModel& playlist, const std::string& filePath);
+    std::string serializePlaylist(const models::PlaylistModel& playlist) const;
     std::optional<models::PlaylistModel> deserializePlaylist(const std::string& filePath);
     
     void ensureStorageDirectoryExists();
@@ -54,6 +66,9 @@ private:
     std::string m_storagePath;
     std::map<std::string, models::PlaylistModel> m_cache;
     mutable std::recursive_mutex m_mutex;  // Use recursive_mutex to prevent deadlocks
+    
+    std::set<std::string> m_dirtyIds;      // Written or deleted by the next background pass
+    std::shared_ptr<PersistenceService> m_persistence;
 };
 
 } // namespace repositories
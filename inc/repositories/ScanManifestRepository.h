@@ -0,0 +1,79 @@
+#ifndef SCAN_MANIFEST_REPOSITORY_H
+#define SCAN_MANIFEST_REPOSITORY_H
+
+// System includes
+#include <string>
+#include <vector>
+#include <optional>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+
+// Project includes
+#include "models/MediaFileModel.h"
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+// What the scanner knew about a file the last time it read its tags
+struct ScanManifestEntry 
+{
+    std::string filePath;
+    uintmax_t fileSize = 0;
+    int64_t lastModified = 0;   // file_time_type ticks
+    std::string title;
+    std::string artist;
+    std::string album;
+    int duration = 0;
+    
+    static ScanManifestEntry fromMedia(const models::MediaFileModel& media);
+    
+    // Same size and mtime as the file on disk: cached tags are still valid
+    bool matches(const models::MediaFileModel& media) const;
+    void applyTo(models::MediaFileModel& media) const;
+};
+
+class ScanManifestRepository 
+{
+public:
+    explicit ScanManifestRepository(const std::string& storagePath);
+    ~ScanManifestRepository();
+    
+    std::optional<ScanManifestEntry> find(const std::string& filePath) const;
+    void put(const ScanManifestEntry& entry);
+    
+    /** Replace every entry under rootPath with the given ones (deleted files drop out). */
+    void replaceRoot(const std::string& rootPath, const std::vector<ScanManifestEntry>& entries);
+    
+    /** Drop every entry under rootPath whose path is not in paths (entries put during a scan stay). */
+    void retainRoot(const std::string& rootPath, const std::vector<std::string>& paths);
+    
+    /** Number of entries under rootPath (seeds the progress total of a rescan). */
+    size_t countUnder(const std::string& rootPath) const;
+    
+    void clear();
+    size_t count() const;
+    
+    // Persistence
+    bool loadFromDisk();
+    bool saveToDisk();
+    
+private:
+    bool serializeManifest();
+    bool deserializeManifest();
+    
+    void ensureStorageDirectoryExists();
+    std::string getManifestFilePath() const;
+    static std::string rootPrefix(const std::string& rootPath);
+    
+    std::string m_storagePath;
+    std::unordered_map<std::string, ScanManifestEntry> m_entries;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace repositories
+} // namespace media_player
+
+#endif // SCAN_MANIFEST_REPOSITORY_H
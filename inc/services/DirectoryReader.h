@@ -0,0 +1,72 @@
+#ifndef DIRECTORY_READER_H
+#define DIRECTORY_READER_H
+
+// System includes
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <filesystem>
+
+namespace media_player 
+{
+namespace services 
+{
+
+// Size and mtime of a file, taken while listing its directory
+struct FileStat 
+{
+    uintmax_t size = 0;
+    std::filesystem::file_time_type lastModified;
+};
+
+enum class DirectoryBackend 
+{
+    PORTABLE,   // std::filesystem; files are stat'ed one by one when read
+    GETDENTS    // Linux: getdents64 + d_type, one fstatat per candidate file
+};
+
+// Lists one directory for the scanner: visible subdirectories, and the
+// files accepted by the filter. Hidden directories are skipped.
+class DirectoryReader 
+{
+public:
+    using FileFilter = std::function<bool(const std::string& fileName)>;
+    using DirectoryCallback = std::function<void(const std::string& dirPath)>;
+    // stat is null when the backend did not stat the file
+    using FileCallback = std::function<void(const std::string& filePath, const FileStat* stat)>;
+    
+    explicit DirectoryReader(DirectoryBackend backend = defaultBackend());
+    
+    // Returns false if the directory could not be opened
+    bool read(const std::string& dirPath,
+              const FileFilter& filter,
+              const DirectoryCallback& onDirectory,
+              const FileCallback& onFile) const;
+    
+    DirectoryBackend getBackend() const 
+    {
+        return m_backend;
+    }
+    
+    static DirectoryBackend defaultBackend();
+    static bool isAvailable(DirectoryBackend backend);
+    
+    // One stat of a single file; false if it is missing or not a regular file
+    static bool statFile(const std::string& filePath, FileStat& result);
+    
+    // Unix time (as in struct stat / statx) to the value fs::last_write_time returns
+    static std::filesystem::file_time_type toFileTime(int64_t seconds, int64_t nanoseconds);
+    
+private:
+    bool readPortable(const std::string& dirPath, const FileFilter& filter,
+                      const DirectoryCallback& onDirectory, const FileCallback& onFile) const;
+    bool readGetdents(const std::string& dirPath, const FileFilter& filter,
+                      const DirectoryCallback& onDirectory, const FileCallback& onFile) const;
+    
+    DirectoryBackend m_backend;
+};
+
+} // namespace services
+} // namespace media_player
+
+#endif // DIRECTORY_READER_H
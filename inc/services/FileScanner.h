@@ -7,16 +7,61 @@
 #include <thread>
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <map>
 
 // Project includes
 #include "IFileScanner.h"
+#include "services/DirectoryReader.h"
+#include "services/ScanIoScheduler.h"
 #include "models/MediaFileModel.h"
+#include "repositories/ScanManifestRepository.h"
+
+namespace TagLib 
+{
+class FileRef;
+}
 
 namespace media_player 
 {
 namespace services 
 {
 
+class TagPrefetcher;
+class TagByteSource;
+
+// Counters for one stage of the pipelined scan
+struct ScanStageStats
+{
+    uint64_t itemsOut = 0;          // Items handed to the next stage
+    double blockedSeconds = 0.0;    // Waiting on a full downstream queue (backpressure)
+    double starvedSeconds = 0.0;    // Waiting on an empty upstream queue
+    double itemsPerSecond = 0.0;
+};
+
+// Stats of the last pipelined scan: walk -> tag readers -> batching sink.
+// Blocked/starved times are summed over all threads of a stage.
+struct ScanPipelineStats
+{
+    ScanStageStats discovery;
+    ScanStageStats metadata;
+    ScanStageStats sink;
+    size_t pathQueueHighWater = 0;
+    size_t mediaQueueHighWater = 0;
+    uint64_t batchCount = 0;
+    double firstBatchSeconds = 0.0;     // Scan start until the first batch was handed out
+    double elapsedSeconds = 0.0;
+    
+    // Tag readers waited on the walk longer than the walk waited on them
+    bool isWalkBound() const
+    {
+        return metadata.starvedSeconds > discovery.blockedSeconds;
+    }
+};
+
 class FileScanner : public IFileScanner 
 {
 public:
@@ -36,34 +81,149 @@ public:
     void setCompleteCallback(ScanCompleteCallback callback) override;
     
     void setMaxDepth(int depth) override;
+    int getMaxDepth() const;
     void setFileExtensions(const std::vector<std::string>& extensions) override;
     
+    // Number of traversal workers; 1 keeps the single-threaded depth-first walk
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+    
+    // How directories are listed; GETDENTS stats each media file once, during the walk
+    void setDirectoryBackend(DirectoryBackend backend);
+    DirectoryBackend getDirectoryBackend() const;
+    
+    // Pipelined scans read tag headers of several files per io_uring round (Linux);
+    // falls back to blocking TagLib reads where io_uring is unavailable
+    void setTagPrefetch(bool enabled);
+    bool isTagPrefetchEnabled() const;
+    int getPrefetchedCount() const;
+    
+    // MP3/WAV tags are read by NativeTagParser first; TagLib only when it declines
+    void setNativeTagParser(bool enabled);
+    bool isNativeTagParserEnabled() const;
+    int getNativeTagCount() const;
+    
+    // Scan I/O budget; duringPlayback applies while the probed file lives on the scanned device
+    void setIoLimits(const ScanIoLimits& limits, const ScanIoLimits& duringPlayback);
+    void setPlaybackProbe(PlaybackProbe probe);
+    bool isIoBackingOff() const;
+    double getIoThrottledSeconds() const;
+    
+    // Scan threads run in the idle I/O class and evict the pages of files they read
+    void setIdleIoPriority(bool enabled);
+    void setDropPageCache(bool enabled);
+    
+    // Number of tag reading workers behind the walk; 0 reads tags inline in the walk
+    void setMetadataWorkerCount(int workerCount);
+    int getMetadataWorkerCount() const;
+    
+    // Pipelined scans deliver results in batches on the scanning thread. The
+    // callback then owns the records: they are not kept for scanDirectorySync
+    // or the complete callback, only their paths are.
+    void setBatchCallback(ScanBatchCallback callback);
+    void setBatchSize(size_t batchSize);
+    
+    // Paths of the records the last scan gave to the batch callback
+    std::vector<std::string> takeStreamedPaths();
+    
+    ScanPipelineStats getLastPipelineStats() const;
+    
+    // Files whose size and mtime match the manifest reuse its tags instead of TagLib
+    void setScanManifest(std::shared_ptr<repositories::ScanManifestRepository> manifest);
+    int getReusedTagCount() const;
+    
+    // Single file outside a scan (e.g. reported by LibraryWatcher); nullopt if not media
+    std::optional<models::MediaFileModel> scanFile(const std::string& filePath);
+    bool isValidMediaFile(const std::string& filePath) const;
+    
 private:
+    struct DirectoryTask
+    {
+        std::string path;
+        int depth;
+    };
+    
+    // A media file found by the walk, with its stat if the backend took one
+    struct ScanCandidate
+    {
+        std::string path;
+        std::optional<FileStat> stat;
+    };
+    
+    // Called for every media file found by the walk
+    using FileVisitor = std::function<void(size_t workerIndex, const std::string& filePath, const FileStat* stat)>;
+    
     void scanWorker(const std::string& rootPath);
-    void scanRecursive(const std::string& dirPath, int currentDepth);
+    void scanTree(const std::string& rootPath);
+    void scanInline(const std::string& rootPath);
+    void scanPipelined(const std::string& rootPath);
+    void walkTree(const std::string& rootPath, const FileVisitor& visitor);
+    void scanRecursive(const std::string& dirPath, int currentDepth, const FileVisitor& visitor);
+    void scanParallel(const std::string& rootPath, const FileVisitor& visitor);
+    std::optional<models::MediaFileModel> readMediaFile(const std::string& filePath, const FileStat* stat = nullptr);
+    void readMediaBatch(std::vector<ScanCandidate>& batch, TagPrefetcher* prefetcher,
+                        const std::function<void(models::MediaFileModel&&)>& sink);
+    bool reuseManifestTags(models::MediaFileModel& media);
+    bool readNativeTags(models::MediaFileModel& media, TagByteSource& source);
+    void chargeTagLibRead(const std::string& filePath);
+    bool shouldDropCache(const std::string& filePath) const;
+    void applyTags(models::MediaFileModel& media, TagLib::FileRef& file);
+    bool listDirectory(const std::string& dirPath, 
+                       const DirectoryReader::DirectoryCallback& onDirectory,
+                       const DirectoryReader::FileCallback& onFile);
+    void updateManifest(const std::string& rootPath);
+    void recordFound(const std::string& filePath);
+    void emitBatch(std::vector<models::MediaFileModel>& batch);
+    void sortFoundFiles();
     
-    bool isValidMediaFile(const std::string& filePath) const;
     bool hasValidExtension(const std::string& extension) const;
     std::string getFileExtension(const std::string& filePath) const;
     std::string toLowerCase(const std::string& str) const;
     
+    // Streaming total: seeded from the previous scan of the root, refined while walking
+    void beginProgress(const std::string& rootPath);
+    int estimateTotal() const;
     void notifyProgress(int count, const std::string& currentPath);
     void notifyComplete(const std::vector<models::MediaFileModel>& results);
     
     std::vector<std::string> m_validExtensions;
     int m_maxDepth;
+    int m_threadCount;
+    int m_metadataWorkerCount;
+    size_t m_batchSize;
+    DirectoryReader m_directoryReader;
+    bool m_tagPrefetch;
+    bool m_nativeTags;
+    bool m_idleIoPriority;
+    bool m_dropPageCache;
+    ScanIoScheduler m_ioScheduler;
     
     std::atomic<bool> m_isScanning;
     std::atomic<bool> m_shouldStop;
     std::unique_ptr<std::thread> m_scanThread;
     
     std::vector<models::MediaFileModel> m_foundFiles;
-    int m_scannedCount;
-    int m_totalFiles;
+    std::vector<std::string> m_streamedPaths;    // Records handed to m_batchCallback
+    std::atomic<int> m_scannedCount;
+    std::atomic<int> m_reusedCount;
+    std::atomic<int> m_prefetchedCount;
+    std::atomic<int> m_nativeCount;
+    std::atomic<int> m_previousTotal;
+    std::atomic<int> m_discoveredFiles;
+    std::atomic<int> m_dirsFound;
+    std::atomic<int> m_dirsVisited;
+    std::atomic<bool> m_walkDone;
+    std::map<std::string, int> m_lastScanCounts;
+    std::mutex m_progressMutex;
+    
+    std::shared_ptr<repositories::ScanManifestRepository> m_manifest;
+    ScanPipelineStats m_pipelineStats;
+    mutable std::mutex m_statsMutex;
     
     ScanProgressCallback m_progressCallback;
     ScanProgressCallback3 m_progressCallback3;
     ScanCompleteCallback m_completeCallback;
+    ScanBatchCallback m_batchCallback;
 };
 
 } // namespace services
@@ -18,6 +18,7 @@ namespace services
 using ScanProgressCallback = std::function<void(int currentCount, const std::string& currentPath)>;
 using ScanProgressCallback3 = std::function<void(int currentCount, int total, const std::string& currentPath)>;
 using ScanCompleteCallback = std::function<void(std::vector<models::MediaFileModel> results)>;
+using ScanBatchCallback = std::function<void(std::vector<models::MediaFileModel> batch)>;
 
 class IFileScanner 
 {
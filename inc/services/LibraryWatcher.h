@@ -0,0 +1,103 @@
+#ifndef LIBRARY_WATCHER_H
+#define LIBRARY_WATCHER_H
+
+// System includes
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <functional>
+
+// Project includes
+#include "services/FileScanner.h"
+#include "models/MediaFileModel.h"
+
+namespace media_player 
+{
+namespace services 
+{
+
+enum class LibraryChangeType 
+{
+    FILE_ADDED,
+    FILE_MODIFIED,
+    FILE_REMOVED,
+    DIRECTORY_REMOVED,  // Everything under path is gone (deleted or moved out)
+    RESCAN_NEEDED       // Kernel queue overflowed, events were lost
+};
+
+struct LibraryChange 
+{
+    LibraryChangeType type;
+    std::string path;
+    std::optional<models::MediaFileModel> media;    // Tags already read for ADDED/MODIFIED
+};
+
+using LibraryChangeCallback = std::function<void(std::vector<LibraryChange> changes)>;
+
+// Watches a scanned root with inotify and reports coalesced file changes.
+// Tags of added/modified files are read on the watcher thread, so the
+// receiver only has to apply the changes. Directories below the scanner's
+// depth limit are not watched, as they were never scanned.
+class LibraryWatcher 
+{
+public:
+    explicit LibraryWatcher(std::shared_ptr<FileScanner> fileScanner);
+    ~LibraryWatcher();
+    
+    LibraryWatcher(const LibraryWatcher&) = delete;
+    LibraryWatcher& operator=(const LibraryWatcher&) = delete;
+    
+    // Returns false if inotify is unavailable or the root is not a directory
+    bool start(const std::string& rootPath);
+    void stop();
+    bool isWatching() const;
+    
+    std::string getRootPath() const;
+    size_t getWatchCount() const;
+    
+    // Called on the watcher thread once a burst of events has settled
+    void setChangeCallback(LibraryChangeCallback callback);
+    
+    // Quiet period before a burst (e.g. an album copy) is reported
+    void setSettleDelay(int milliseconds);
+    
+private:
+    struct WatchedDirectory 
+    {
+        std::string path;
+        int depth;      // 0 for the root, as in FileScanner
+    };
+    
+    void watchLoop();
+    void readEvents(std::map<std::string, LibraryChange>& pending);
+    void addWatchRecursive(const std::string& dirPath, int depth, std::map<std::string, LibraryChange>* pending);
+    void removeWatchesUnder(const std::string& dirPath);
+    void flush(std::map<std::string, LibraryChange>& pending);
+    
+    static bool isUnder(const std::string& path, const std::string& dirPath);
+    
+    std::shared_ptr<FileScanner> m_fileScanner;
+    std::string m_rootPath;
+    int m_inotifyFd;
+    int m_settleDelayMs;
+    int m_maxDepth;                 // Scanner's limit when started
+    
+    std::map<int, WatchedDirectory> m_watchPaths;
+    mutable std::mutex m_mutex;
+    
+    std::thread m_watchThread;
+    std::atomic<bool> m_isWatching;
+    std::atomic<bool> m_shouldStop;
+    
+    LibraryChangeCallback m_changeCallback;
+};
+
+} // namespace services
+} // namespace media_player
+
+#endif // LIBRARY_WATCHER_H
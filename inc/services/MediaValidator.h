@@ -0,0 +1,78 @@
+#ifndef MEDIA_VALIDATOR_H
+#define MEDIA_VALIDATOR_H
+
+// System includes
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <functional>
+
+namespace media_player 
+{
+namespace services 
+{
+
+using ValidationCallback = std::function<void(std::vector<std::string> missingPaths)>;
+
+// Checks in the background that persisted entries (library, playlists,
+// history) still exist, so loading them needs no stat per entry. Paths are
+// stat'ed in batches spread over a few threads; the missing paths of each
+// batch are reported as soon as it is done.
+class MediaValidator 
+{
+public:
+    static constexpr size_t DEFAULT_THREAD_COUNT = 4;
+    static constexpr size_t DEFAULT_BATCH_SIZE = 1024;
+    
+    explicit MediaValidator(size_t threadCount = DEFAULT_THREAD_COUNT);
+    ~MediaValidator();
+    
+    MediaValidator(const MediaValidator&) = delete;
+    MediaValidator& operator=(const MediaValidator&) = delete;
+    
+    // Checks paths on the validator thread; false if a run is in progress
+    bool start(std::vector<std::string> paths);
+    
+    // Abandons the current run after the batch in flight
+    void stop();
+    
+    // Blocks until the current run has finished
+    void wait();
+    
+    bool isRunning() const;
+    
+    // Called on the validator thread for each batch with missing paths
+    void setResultCallback(ValidationCallback callback);
+    
+    void setBatchSize(size_t batchSize);
+    
+    // Totals of the current (or last) run
+    size_t getCheckedCount() const;
+    size_t getMissingCount() const;
+    
+    // Missing paths among paths, in their order, checked on the calling thread
+    // and the pool's workers
+    std::vector<std::string> findMissing(const std::vector<std::string>& paths) const;
+    
+private:
+    void run(std::vector<std::string> paths);
+    
+    size_t m_threadCount;
+    size_t m_batchSize;
+    
+    std::thread m_thread;
+    std::atomic<bool> m_isRunning;
+    std::atomic<bool> m_shouldStop;
+    std::atomic<size_t> m_checkedCount;
+    std::atomic<size_t> m_missingCount;
+    
+    mutable std::mutex m_mutex;
+    ValidationCallback m_resultCallback;
+};
+
+} // namespace services
+} // namespace media_player
+
+#endif // MEDIA_VALIDATOR_H
@@ -0,0 +1,118 @@
+#ifndef NATIVE_TAG_PARSER_H
+#define NATIVE_TAG_PARSER_H
+
+// System includes
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace media_player 
+{
+namespace services 
+{
+
+// Tags and audio properties, as the scanner and MetadataReader use them
+struct NativeTags 
+{
+    std::string title;
+    std::string artist;
+    std::string album;
+    std::string genre;
+    int year = 0;
+    int durationSeconds = 0;
+    int bitrateKbps = 0;
+    bool hasCoverArt = false;
+    size_t coverArtSize = 0;        // Picture bytes of the first APIC frame
+};
+
+// Random access to the bytes of one file
+class TagByteSource 
+{
+public:
+    virtual ~TagByteSource() = default;
+    
+    virtual uintmax_t size() = 0;
+    
+    // Pointer to [offset, offset + length), valid until the next call;
+    // nullptr if the range is not entirely inside the file
+    virtual const char* view(uintmax_t offset, size_t length) = 0;
+};
+
+// Reads a file in small windows, only where the parser looks. Ranges already
+// in memory (e.g. prefetched head and tail) are served without touching the file.
+class FileTagSource : public TagByteSource 
+{
+public:
+    explicit FileTagSource(const std::string& filePath);
+    FileTagSource(const std::string& filePath, uintmax_t fileSize);
+    ~FileTagSource() override;
+    
+    FileTagSource(const FileTagSource&) = delete;
+    FileTagSource& operator=(const FileTagSource&) = delete;
+    
+    // The bytes must outlive the source
+    void addPreloaded(uintmax_t offset, const std::vector<char>& bytes);
+    
+    // Evict the file's pages when done (scans read each file once)
+    void setDropCache(bool dropCache) 
+    {
+        m_dropCache = dropCache;
+    }
+    
+    uintmax_t size() override;
+    const char* view(uintmax_t offset, size_t length) override;
+    
+    // Bytes read from the file (preloaded ranges not counted)
+    uintmax_t getBytesRead() const 
+    {
+        return m_bytesRead;
+    }
+    
+    size_t getReadCount() const 
+    {
+        return m_readCount;
+    }
+    
+private:
+    struct Range 
+    {
+        uintmax_t offset;
+        const char* data;
+        size_t size;
+    };
+    
+    bool open();
+    
+    std::string m_filePath;
+    int m_fd;
+    bool m_openFailed;
+    bool m_dropCache;
+    bool m_hasSize;
+    uintmax_t m_size;
+    std::vector<Range> m_preloaded;
+    std::vector<char> m_window;
+    uintmax_t m_windowOffset;
+    uintmax_t m_bytesRead;
+    size_t m_readCount;
+};
+
+// Allocation-light reader for the formats the player plays: ID3v2.3/2.4 and
+// ID3v1 tags with Xing/VBRI/CBR durations for MP3, RIFF INFO (and "id3 "
+// chunks) with fmt/data durations for WAV. Anything it does not handle --
+// other formats, ID3v2.2, unsynchronised or compressed frames, APE tags,
+// no MPEG frame near the tag -- returns false so the caller can use TagLib.
+class NativeTagParser 
+{
+public:
+    // extension is lower case with the dot, e.g. ".mp3"
+    static bool parse(TagByteSource& source, const std::string& extension, NativeTags& tags);
+    static bool parseFile(const std::string& filePath, NativeTags& tags);
+    
+    static bool isSupportedExtension(const std::string& extension);
+};
+
+} // namespace services
+} // namespace media_player
+
+#endif // NATIVE_TAG_PARSER_H
@@ -0,0 +1,126 @@
+#ifndef SCAN_IO_SCHEDULER_H
+#define SCAN_IO_SCHEDULER_H
+
+// System includes
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace media_player 
+{
+namespace services 
+{
+
+// I/O rates a scan may use; 0 means unlimited
+struct ScanIoLimits 
+{
+    uint64_t bytesPerSecond = 0;
+    uint64_t opsPerSecond = 0;
+    
+    bool isUnlimited() const 
+    {
+        return bytesPerSecond == 0 && opsPerSecond == 0;
+    }
+};
+
+// File the player is streaming, or empty when nothing is playing
+using PlaybackProbe = std::function<std::string()>;
+
+// I/O budget of one scan: token buckets for bytes and operations, with a
+// tighter budget while playback streams from the device being scanned.
+// Threads charge what they read and sleep while the scan is over budget.
+class ScanIoScheduler 
+{
+public:
+    ScanIoScheduler();
+    
+    void setLimits(const ScanIoLimits& limits);
+    void setPlaybackLimits(const ScanIoLimits& limits);
+    void setPlaybackProbe(PlaybackProbe probe);
+    
+    // Resets the buckets and remembers the device of the scan root
+    void beginScan(const std::string& rootPath);
+    
+    // Charges I/O done by the caller and waits until the scan is back within
+    // budget. Returns false if stop was set while waiting.
+    bool charge(uint64_t bytes, uint64_t ops, const std::atomic<bool>& stop);
+    
+    // Playback is streaming from the scanned device (as of the last probe)
+    bool isBackingOff() const;
+    
+    // The file being played; its pages stay cached
+    bool isPlaybackFile(const std::string& filePath) const;
+    
+    // Time scan threads spent waiting for budget, summed over threads
+    double getThrottledSeconds() const;
+    
+    // Evict a file's pages after reading its tags (no-op where unsupported)
+    static void dropPageCache(int fd);
+    static void dropPageCache(const std::string& filePath);
+    
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    struct Bucket 
+    {
+        double tokens = 0.0;
+        uint64_t rate = 0;
+    };
+    
+    void refreshPlayback();
+    void applyLimits(const ScanIoLimits& limits, bool refill);
+    void refill(Clock::time_point now);
+    double waitSeconds() const;
+    
+    mutable std::mutex m_mutex;
+    ScanIoLimits m_limits;
+    ScanIoLimits m_playbackLimits;
+    PlaybackProbe m_probe;
+    
+    Bucket m_bytes;
+    Bucket m_ops;
+    Clock::time_point m_lastRefill;
+    Clock::time_point m_lastProbe;
+    bool m_probing;
+    
+    bool m_hasScanDevice;
+    uint64_t m_scanDevice;
+    std::string m_playbackPath;
+    bool m_backingOff;
+    
+    double m_throttledSeconds;
+};
+
+// Puts the calling thread (and threads it starts) in the idle I/O class,
+// so the kernel serves scan reads only when nobody else waits on the disk.
+// Restores the previous priority on destruction. Linux only, and only
+// honoured by I/O schedulers with priority classes (BFQ, CFQ).
+class IdleIoPriorityScope 
+{
+public:
+    explicit IdleIoPriorityScope(bool enabled);
+    ~IdleIoPriorityScope();
+    
+    IdleIoPriorityScope(const IdleIoPriorityScope&) = delete;
+    IdleIoPriorityScope& operator=(const IdleIoPriorityScope&) = delete;
+    
+    bool isActive() const 
+    {
+        return m_active;
+    }
+    
+    // Current I/O class of the calling thread (0 none, 1 RT, 2 BE, 3 idle); -1 if unknown
+    static int currentIoClass();
+    
+private:
+    bool m_active;
+    int m_previous;
+};
+
+} // namespace services
+} // namespace media_player
+
+#endif // SCAN_IO_SCHEDULER_H
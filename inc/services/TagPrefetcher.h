@@ -0,0 +1,114 @@
+#ifndef TAG_PREFETCHER_H
+#define TAG_PREFETCHER_H
+
+// System includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// TagLib includes
+#include <taglib/taglib.h>
+#include <taglib/tiostream.h>
+
+// Project includes
+#include "services/DirectoryReader.h"
+
+namespace media_player 
+{
+namespace services 
+{
+
+// The parts of a file where tags live, read ahead of the tag parser
+struct PrefetchedFile 
+{
+    std::string path;
+    bool hasStat = false;           // Set by the caller when the walk already stat'ed the file
+    FileStat stat;
+    bool dropCache = false;         // Evict the pages read once the file is closed
+    
+    bool ok = false;                // Opened and read; otherwise read it the blocking way
+    std::vector<char> head;         // Bytes [0, head.size())
+    std::vector<char> tail;         // Bytes [tailOffset, tailOffset + tail.size())
+    uintmax_t tailOffset = 0;
+};
+
+// Batches the open/statx/read syscalls of many files into a few io_uring
+// submissions, so slow devices see a deep queue instead of one small read
+// at a time. One instance per thread.
+class TagPrefetcher 
+{
+public:
+    TagPrefetcher(size_t headBytes, size_t tailBytes);
+    ~TagPrefetcher();
+    
+    TagPrefetcher(const TagPrefetcher&) = delete;
+    TagPrefetcher& operator=(const TagPrefetcher&) = delete;
+    
+    // False if io_uring is missing (old kernel, non-Linux, blocked by seccomp)
+    bool isAvailable() const;
+    
+    // Fills head/tail (and stat, if not known yet) of every file
+    void prefetch(std::vector<PrefetchedFile>& files);
+    
+private:
+    struct Ring;
+    
+    void prefetchChunk(PrefetchedFile* files, size_t count);
+    
+    std::unique_ptr<Ring> m_ring;
+    size_t m_headBytes;
+    size_t m_tailBytes;
+};
+
+// IOStream's integer types changed in TagLib 2
+#if TAGLIB_MAJOR_VERSION >= 2
+using TagLibSize = size_t;
+using TagLibOffset = TagLib::offset_t;
+using TagLibStart = TagLib::offset_t;
+#else
+using TagLibSize = unsigned long;
+using TagLibOffset = long;
+using TagLibStart = unsigned long;
+#endif
+
+// Read-only TagLib stream over a PrefetchedFile. Reads outside the
+// prefetched ranges (e.g. a large cover image) go to the file itself.
+class PrefetchedFileStream : public TagLib::IOStream 
+{
+public:
+    explicit PrefetchedFileStream(const PrefetchedFile& file);
+    ~PrefetchedFileStream() override;
+    
+    TagLib::FileName name() const override;
+    TagLib::ByteVector readBlock(TagLibSize length) override;
+    void writeBlock(const TagLib::ByteVector& data) override;
+    void insert(const TagLib::ByteVector& data, TagLibStart start = 0, TagLibSize replace = 0) override;
+    void removeBlock(TagLibStart start = 0, TagLibSize length = 0) override;
+    bool readOnly() const override;
+    bool isOpen() const override;
+    void seek(TagLibOffset offset, Position p = Beginning) override;
+    TagLibOffset tell() const override;
+    TagLibOffset length() override;
+    void truncate(TagLibOffset length) override;
+    
+    // Reads that missed the prefetched ranges
+    size_t getFallbackReads() const 
+    {
+        return m_fallbackReads;
+    }
+    
+private:
+    bool copyFrom(const std::vector<char>& buffer, uintmax_t bufferOffset,
+                  uintmax_t offset, size_t length, std::vector<char>& out) const;
+    
+    const PrefetchedFile& m_file;
+    uintmax_t m_position;
+    int m_fd;
+    size_t m_fallbackReads;
+};
+
+} // namespace services
+} // namespace media_player
+
+#endif // TAG_PREFETCHER_H
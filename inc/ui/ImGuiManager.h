@@ -167,7 +167,7 @@ struct UIState {
     bool showChangePathDialog = false;
     /** True when the initial "enter path to scan" screen is visible (so text goes to path input, not search). */
     bool pathInputScreenVisible = false;
-    /** True when scan progress dialog is visible (modal). */
+    /** True when scan progress dialog is visible (modal, only until the first tracks arrive). */
     bool scanDialogVisible = false;
 
     // USB Popup
@@ -203,6 +203,9 @@ public:
     void renderSidebar();
     void renderPlayerBar();
     void renderScanProgress(const std::string& path, int current, int total);
+    /** Non-modal scan indicator in the menu bar, once the library already has tracks to show.
+        firstTrackMs is the time the first track took to appear, or -1. */
+    void renderScanStatus(int current, int total, int firstTrackMs = -1);
     void renderPathInputScreen(const std::string& currentPathPlaceholder);
     void renderOverlays();
     
@@ -0,0 +1,204 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+// System includes
+#include <queue>
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <condition_variable>
+
+namespace media_player 
+{
+namespace utils 
+{
+
+// Blocking queue with a fixed capacity, used to join pipeline stages.
+// A full queue blocks the producer (backpressure); the time spent blocked on
+// either side is recorded so a pipeline can tell which stage is the bottleneck.
+template<typename T>
+class BoundedQueue 
+{
+public:
+    explicit BoundedQueue(size_t capacity)
+        : m_capacity(capacity > 0 ? capacity : 1)
+        , m_closed(false)
+        , m_highWaterMark(0)
+        , m_pushCount(0)
+        , m_popCount(0)
+        , m_pushWaitNs(0)
+        , m_popWaitNs(0) 
+    {
+    }
+    
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+    
+    // Blocks while the queue is full; returns false if the queue was closed
+    bool push(T&& item) 
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        
+        if (m_queue.size() >= m_capacity && !m_closed) 
+        {
+            auto start = std::chrono::steady_clock::now();
+            m_notFull.wait(lock, [this] 
+            {
+                return m_queue.size() < m_capacity || m_closed;
+            });
+            m_pushWaitNs += elapsedNs(start);
+        }
+        
+        if (m_closed) 
+        {
+            return false;
+        }
+        
+        m_queue.push(std::move(item));
+        m_pushCount++;
+        if (m_queue.size() > m_highWaterMark) 
+        {
+            m_highWaterMark = m_queue.size();
+        }
+        
+        lock.unlock();
+        m_notEmpty.notify_one();
+        return true;
+    }
+    
+    // Blocks until an item is available; nullopt once closed and drained
+    std::optional<T> waitAndPop() 
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        
+        if (m_queue.empty() && !m_closed) 
+        {
+            auto start = std::chrono::steady_clock::now();
+            m_notEmpty.wait(lock, [this] 
+            {
+                return !m_queue.empty() || m_closed;
+            });
+            m_popWaitNs += elapsedNs(start);
+        }
+        
+        if (m_queue.empty()) 
+        {
+            return std::nullopt;
+        }
+        
+        T item = std::move(m_queue.front());
+        m_queue.pop();
+        m_popCount++;
+        
+        lock.unlock();
+        m_notFull.notify_one();
+        return item;
+    }
+    
+    // Takes an item only if one is ready; lets a consumer fill a batch without waiting
+    std::optional<T> tryPop() 
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        
+        if (m_queue.empty()) 
+        {
+            return std::nullopt;
+        }
+        
+        T item = std::move(m_queue.front());
+        m_queue.pop();
+        m_popCount++;
+        
+        lock.unlock();
+        m_notFull.notify_one();
+        return item;
+    }
+    
+    // No more pushes; consumers drain what is left and then get nullopt
+    void close() 
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_closed = true;
+        }
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+    
+    bool isClosed() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_closed;
+    }
+    
+    size_t size() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_queue.size();
+    }
+    
+    size_t capacity() const 
+    {
+        return m_capacity;
+    }
+    
+    // Statistics
+    size_t getHighWaterMark() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_highWaterMark;
+    }
+    
+    uint64_t getPushCount() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pushCount;
+    }
+    
+    uint64_t getPopCount() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_popCount;
+    }
+    
+    // Total time producers spent blocked on a full queue
+    double getPushWaitSeconds() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_pushWaitNs / 1e9;
+    }
+    
+    // Total time consumers spent blocked on an empty queue
+    double getPopWaitSeconds() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_popWaitNs / 1e9;
+    }
+    
+private:
+    static uint64_t elapsedNs(std::chrono::steady_clock::time_point start) 
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::queue<T> m_queue;
+    size_t m_capacity;
+    bool m_closed;
+    
+    size_t m_highWaterMark;
+    uint64_t m_pushCount;
+    uint64_t m_popCount;
+    uint64_t m_pushWaitNs;
+    uint64_t m_popWaitNs;
+};
+
+} // namespace utils
+} // namespace media_player
+
+#endif // BOUNDED_QUEUE_H
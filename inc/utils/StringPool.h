@@ -0,0 +1,95 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+// System includes
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <functional>
+#include <cstddef>
+
+namespace media_player 
+{
+namespace utils 
+{
+
+// Process-wide pool of interned strings. Equal strings share one copy that
+// lives until exit, so the returned references never dangle; meant for values
+// that repeat across a library (artist, album, directory), not per-track ones.
+// Sharded so scanner threads interning tags in parallel rarely contend.
+class StringPool 
+{
+public:
+    static const std::string& intern(std::string_view value) 
+    {
+        if (value.empty()) 
+        {
+            return empty();
+        }
+        
+        size_t hash = std::hash<std::string_view>{}(value);
+        return instance().m_shards[hash % SHARD_COUNT].intern(value);
+    }
+    
+    static const std::string& empty() 
+    {
+        static const std::string* value = new std::string();
+        return *value;
+    }
+    
+    // Distinct strings held, for diagnostics
+    static size_t size() 
+    {
+        size_t count = 0;
+        
+        for (auto& shard : instance().m_shards) 
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            count += shard.strings.size();
+        }
+        
+        return count;
+    }
+    
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+    
+    struct Shard 
+    {
+        std::mutex mutex;
+        // Deque elements never move, so the keys can view them
+        std::deque<std::string> strings;
+        std::unordered_map<std::string_view, const std::string*> index;
+        
+        const std::string& intern(std::string_view value) 
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = index.find(value);
+            
+            if (it != index.end()) 
+            {
+                return *it->second;
+            }
+            
+            const std::string& stored = strings.emplace_back(value);
+            index.emplace(stored, &stored);
+            return stored;
+        }
+    };
+    
+    // Never destroyed: models held by other statics may still be read at exit
+    static StringPool& instance() 
+    {
+        static StringPool* pool = new StringPool();
+        return *pool;
+    }
+    
+    Shard m_shards[SHARD_COUNT];
+};
+
+} // namespace utils
+} // namespace media_player
+
+#endif // STRING_POOL_H
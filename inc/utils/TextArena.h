@@ -0,0 +1,220 @@
+#ifndef TEXT_ARENA_H
+#define TEXT_ARENA_H
+
+// System includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Project includes
+#include "TextSearch.h"
+
+namespace media_player 
+{
+namespace utils 
+{
+
+// Short texts packed back to back in one buffer, '\0' after each, so a
+// filter scans them with a single TextSearch pass instead of one call and
+// one allocation per record. Records keep their id while they are
+// rewritten; a rewrite appends the new text and leaves the old bytes as
+// garbage until enough of it piles up to compact the buffer.
+class TextArena 
+{
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    
+    TextArena()
+        : m_liveCount(0)
+        , m_garbage(0) 
+    {
+    }
+    
+    size_t size() const 
+    {
+        return m_liveCount;
+    }
+    
+    // Ids are handed out from 0 and reused after remove()
+    uint32_t add(std::string_view text) 
+    {
+        uint32_t id;
+        
+        if (!m_freeIds.empty()) 
+        {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        }
+        else 
+        {
+            id = static_cast<uint32_t>(m_records.size());
+            m_records.emplace_back();
+        }
+        
+        place(id, text);
+        m_liveCount++;
+        return id;
+    }
+    
+    // Views returned by get() before this may dangle afterwards
+    void assign(uint32_t id, std::string_view text) 
+    {
+        m_garbage += m_records[id].length + 1;
+        place(id, text);
+        compactIfWasteful();
+    }
+    
+    void remove(uint32_t id) 
+    {
+        m_garbage += m_records[id].length + 1;
+        m_records[id].offset = NONE;
+        m_freeIds.push_back(id);
+        m_liveCount--;
+        compactIfWasteful();
+    }
+    
+    std::string_view get(uint32_t id) const 
+    {
+        return std::string_view(m_bytes.data() + m_records[id].offset, m_records[id].length);
+    }
+    
+    void clear() 
+    {
+        m_bytes.clear();
+        m_records.clear();
+        m_freeIds.clear();
+        m_layout.clear();
+        m_liveCount = 0;
+        m_garbage = 0;
+    }
+    
+    void reserve(size_t count) 
+    {
+        m_records.reserve(count);
+        m_layout.reserve(count);
+    }
+    
+    // Calls onMatch(id, offset) for each occurrence of needle in a live
+    // record, in buffer order. Returning true skips the rest of that record.
+    // A needle holding '\0' matches nothing.
+    template<typename F>
+    void scan(std::string_view needle, F&& onMatch) const 
+    {
+        if (needle.find('\0') != std::string_view::npos) 
+        {
+            return;
+        }
+        
+        std::string_view bytes(m_bytes);
+        size_t from = 0;
+        size_t slot = 0;
+        
+        while (slot < m_layout.size()) 
+        {
+            size_t hit = TextSearch::find(bytes.substr(from), needle);
+            if (hit == TextSearch::npos) 
+            {
+                return;
+            }
+            hit += from;
+            
+            // Hits only move forward, and never span a terminator
+            while (slot + 1 < m_layout.size() && m_layout[slot + 1].offset <= hit) 
+            {
+                slot++;
+            }
+            
+            const Slot& current = m_layout[slot];
+            size_t end = current.offset + current.length + 1;
+            
+            if (m_records[current.id].offset != current.offset) 
+            {
+                from = end;
+                slot++;
+                continue;
+            }
+            
+            if (onMatch(current.id, hit - current.offset)) 
+            {
+                from = end;
+                slot++;
+            }
+            else 
+            {
+                from = hit + 1;
+            }
+        }
+    }
+    
+private:
+    // Compaction waits for this much garbage, and for half the buffer
+    static constexpr size_t MIN_GARBAGE = 64 * 1024;
+    
+    struct Record 
+    {
+        uint32_t offset = NONE;     // NONE once removed
+        uint32_t length = 0;
+    };
+    
+    // Every copy in the buffer, live or not, by offset
+    struct Slot 
+    {
+        uint32_t offset;
+        uint32_t length;
+        uint32_t id;
+    };
+    
+    void place(uint32_t id, std::string_view text) 
+    {
+        Record& record = m_records[id];
+        record.offset = static_cast<uint32_t>(m_bytes.size());
+        record.length = static_cast<uint32_t>(text.size());
+        
+        m_bytes.append(text.data(), text.size());
+        m_bytes.push_back('\0');
+        m_layout.push_back(Slot{ record.offset, record.length, id });
+    }
+    
+    void compactIfWasteful() 
+    {
+        if (m_garbage < MIN_GARBAGE || 2 * m_garbage < m_bytes.size()) 
+        {
+            return;
+        }
+        
+        std::string bytes;
+        bytes.reserve(m_bytes.size() - m_garbage);
+        size_t kept = 0;
+        
+        for (const Slot& slot : m_layout) 
+        {
+            Record& record = m_records[slot.id];
+            if (record.offset != slot.offset) 
+            {
+                continue;
+            }
+            
+            record.offset = static_cast<uint32_t>(bytes.size());
+            bytes.append(m_bytes, slot.offset, slot.length + 1);
+            m_layout[kept++] = Slot{ record.offset, slot.length, slot.id };
+        }
+        
+        m_bytes.swap(bytes);
+        m_layout.resize(kept);
+        m_garbage = 0;
+    }
+    
+    std::string m_bytes;
+    std::vector<Record> m_records;     // By id
+    std::vector<uint32_t> m_freeIds;
+    std::vector<Slot> m_layout;
+    size_t m_liveCount;
+    size_t m_garbage;                  // Bytes of dead copies in m_bytes
+};
+
+} // namespace utils
+} // namespace media_player
+
+#endif // TEXT_ARENA_H
@@ -0,0 +1,54 @@
+#ifndef TEXT_SEARCH_H
+#define TEXT_SEARCH_H
+
+// System includes
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace media_player 
+{
+namespace utils 
+{
+
+// Substring search for filtering. find() compares bytes exactly: callers
+// keep their text normalized (see TextArena) and normalize the query the same
+// way, so nothing is lowercased while searching. On x86 the kernel compares
+// the first and last byte of the needle against 32 (AVX2) or 16 (SSE2)
+// positions at once and only checks the middle where both hit; it is picked
+// once from what the CPU supports, with a scalar fallback elsewhere.
+class TextSearch 
+{
+public:
+    enum class Kernel 
+    {
+        SCALAR,
+        SSE2,
+        AVX2
+    };
+    
+    static constexpr size_t npos = std::string_view::npos;
+    
+    // Offset of the first needle in haystack, npos if none. An empty needle
+    // is found at 0.
+    static size_t find(std::string_view haystack, std::string_view needle);
+    
+    // ASCII case-insensitive; for short text that is not kept normalized
+    static bool containsIgnoreCase(std::string_view text, std::string_view needle);
+    
+    static char lowerAscii(char c) 
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+    
+    static Kernel getKernel();
+    static const char* getKernelName();
+    
+    // Switches kernels for tests and benchmarks; false if the CPU lacks it
+    static bool setKernel(Kernel kernel);
+};
+
+} // namespace utils
+} // namespace media_player
+
+#endif // TEXT_SEARCH_H
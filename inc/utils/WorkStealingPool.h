@@ -0,0 +1,241 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+// System includes
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <optional>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace media_player 
+{
+namespace utils 
+{
+
+// Per-worker task deque: the owner pops from the back (LIFO, cache friendly),
+// thieves take from the front (oldest, usually the largest subtree)
+template<typename T>
+class WorkStealingQueue 
+{
+public:
+    WorkStealingQueue() = default;
+    
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+    
+    void push(T&& item) 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_deque.push_back(std::move(item));
+    }
+    
+    std::optional<T> pop() 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_deque.empty()) 
+        {
+            return std::nullopt;
+        }
+        T item = std::move(m_deque.back());
+        m_deque.pop_back();
+        return item;
+    }
+    
+    std::optional<T> steal() 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_deque.empty()) 
+        {
+            return std::nullopt;
+        }
+        T item = std::move(m_deque.front());
+        m_deque.pop_front();
+        return item;
+    }
+    
+    bool empty() const 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_deque.empty();
+    }
+    
+private:
+    mutable std::mutex m_mutex;
+    std::deque<T> m_deque;
+};
+
+// Runs a self-expanding set of tasks (e.g. directories) on N workers.
+// A handler may spawn new tasks; run() returns once every task is done
+// or the cancel flag is raised. Workers with nothing to steal sleep until
+// a task is spawned. The first exception a handler throws stops the other
+// workers and is rethrown from run() once they are joined.
+template<typename Task>
+class WorkStealingPool 
+{
+public:
+    using Spawn = std::function<void(Task&&)>;
+    using Handler = std::function<void(size_t workerIndex, Task& task, const Spawn& spawn)>;
+    
+    explicit WorkStealingPool(size_t threadCount)
+        : m_threadCount(threadCount > 0 ? threadCount : 1)
+        , m_stealCount(0) 
+    {
+    }
+    
+    size_t getThreadCount() const 
+    {
+        return m_threadCount;
+    }
+    
+    // Number of tasks taken from another worker during the last run()
+    size_t getStealCount() const 
+    {
+        return m_stealCount;
+    }
+    
+    void run(std::vector<Task> seeds, const Handler& handler, const std::atomic<bool>* cancel = nullptr) 
+    {
+        std::vector<std::unique_ptr<WorkStealingQueue<Task>>> queues;
+        for (size_t i = 0; i < m_threadCount; ++i) 
+        {
+            queues.push_back(std::make_unique<WorkStealingQueue<Task>>());
+        }
+        
+        // Pending counts queued + running tasks. A child is counted before its
+        // parent finishes, so it only reaches zero when the whole tree is done.
+        std::atomic<size_t> pending(seeds.size());
+        m_stealCount = 0;
+        
+        for (size_t i = 0; i < seeds.size(); ++i) 
+        {
+            queues[i % m_threadCount]->push(std::move(seeds[i]));
+        }
+        
+        // Idle workers wait here; spawned counts the tasks handed out so far,
+        // so a spawn between a worker's last look and its wait is not missed
+        std::mutex idleMutex;
+        std::condition_variable idle;
+        size_t spawned = 0;
+        
+        std::atomic<bool> failed(false);
+        std::exception_ptr error;
+        
+        auto stopped = [&]() 
+        {
+            return failed.load() || (cancel && cancel->load());
+        };
+        
+        auto workerLoop = [&](size_t index) 
+        {
+            Spawn spawn = [&queues, &pending, &idleMutex, &idle, &spawned, index](Task&& child) 
+            {
+                pending.fetch_add(1);
+                queues[index]->push(std::move(child));
+                {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    spawned++;
+                }
+                idle.notify_one();
+            };
+            
+            while (true) 
+            {
+                if (stopped()) 
+                {
+                    return;
+                }
+                
+                size_t seen;
+                {
+                    std::lock_guard<std::mutex> lock(idleMutex);
+                    seen = spawned;
+                }
+                
+                std::optional<Task> task = queues[index]->pop();
+                
+                for (size_t k = 1; !task && k < m_threadCount; ++k) 
+                {
+                    task = queues[(index + k) % m_threadCount]->steal();
+                    if (task) 
+                    {
+                        m_stealCount.fetch_add(1);
+                    }
+                }
+                
+                if (task) 
+                {
+                    try 
+                    {
+                        handler(index, *task, spawn);
+                    }
+                    catch (...) 
+                    {
+                        std::lock_guard<std::mutex> lock(idleMutex);
+                        if (!error) 
+                        {
+                            error = std::current_exception();
+                        }
+                        failed = true;
+                        idle.notify_all();
+                        return;
+                    }
+                    
+                    if (pending.fetch_sub(1) == 1) 
+                    {
+                        std::lock_guard<std::mutex> lock(idleMutex);
+                        idle.notify_all();
+                    }
+                    continue;
+                }
+                
+                // The cancel flag is raised from outside without a notify, so
+                // a sleeping worker still looks at it now and then
+                std::unique_lock<std::mutex> lock(idleMutex);
+                idle.wait_for(lock, std::chrono::milliseconds(10), [&]() 
+                {
+                    return spawned != seen || pending.load() == 0 || stopped();
+                });
+                if (pending.load() == 0) 
+                {
+                    return;
+                }
+            }
+        };
+        
+        std::vector<std::thread> workers;
+        workers.reserve(m_threadCount - 1);
+        for (size_t i = 1; i < m_threadCount; ++i) 
+        {
+            workers.emplace_back(workerLoop, i);
+        }
+        
+        // Calling thread acts as worker 0
+        workerLoop(0);
+        
+        for (auto& worker : workers) 
+        {
+            worker.join();
+        }
+        
+        if (error) 
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    
+private:
+    size_t m_threadCount;
+    std::atomic<size_t> m_stealCount;
+};
+
+} // namespace utils
+} // namespace media_player
+
+#endif // WORK_STEALING_POOL_H
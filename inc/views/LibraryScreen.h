@@ -61,9 +61,18 @@ public:
     void addSelectedToQueue();
     void addAllToQueue();
     
+    // Library content changed underneath (live updates); keeps page and filters
+    void reloadMediaList();
+    
 private:
     void refreshMediaList();
     
+    // Rebuilds m_rows if the order, direction or matches differ from last time
+    void updateRows(const models::SortOrder& order, const models::SearchResult& matches);
+    
+    // Shows the ranking of a fuzzy search instead, unless already shown
+    void updateFuzzyRows(const std::shared_ptr<const controllers::FuzzySearchAnswer>& answer);
+    
     // Search & Filter State
     std::string m_searchQuery;
     int m_sortField; // 0=Title, 1=Artist, 2=Album, 3=Duration
@@ -84,7 +93,15 @@ private:
     std::shared_ptr<controllers::PlaybackController> m_playbackController;
     std::shared_ptr<controllers::PlaylistController> m_playlistController; // Added
     
-    std::vector<models::MediaFileModel> m_currentMediaList;
+    models::MediaSnapshot m_currentMediaList;
+    models::LibrarySearch m_search;     // Last search, narrowed as the query grows
+    
+    // Positions in m_currentMediaList as shown, and what they were built from
+    std::vector<size_t> m_rows;
+    models::SortOrder m_rowsOrder;
+    bool m_rowsAscending;
+    models::SearchResult m_rowsMatches;  // Without positions; no query when unfiltered
+    std::shared_ptr<const controllers::FuzzySearchAnswer> m_rowsFuzzy;  // Shown instead when set
     
     // UI State
     int m_currentPage;
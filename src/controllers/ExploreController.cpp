@@ -113,7 +113,7 @@ void ExploreController::refreshMediaList()
 {
     if (m_libraryController) 
     {
-        m_exploreModel->setAllMedia(m_libraryController->getAllMedia());
+        m_exploreModel->setAllMedia(m_libraryController->getSnapshot());
     }
     
     // Nếu chưa có current path, dùng root
@@ -140,21 +140,14 @@ std::vector<models::FolderEntry> ExploreController::getFilteredFolders(
         return allFolders;
     }
     
-    // Chuyển query sang lowercase để so sánh case-insensitive
-    std::string query = searchQuery;
-    std::transform(query.begin(), query.end(), query.begin(), ::tolower);
-    
+    // Tên folder đã được chuẩn hóa sẵn khi nạp, chỉ chuẩn hóa query
     std::vector<models::FolderEntry> filtered;
-    for (const auto& folder : allFolders) 
-    {
-        std::string lowerName = folder.name;
-        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-        
-        if (lowerName.find(query) != std::string::npos) 
+    m_exploreModel->getFolderNames().scan(models::SearchIndex::normalize(searchQuery),
+        [&](uint32_t id, size_t) 
         {
-            filtered.push_back(folder);
-        }
-    }
+            filtered.push_back(allFolders[id]);
+            return true;
+        });
     
     return filtered;
 }
@@ -162,41 +155,12 @@ std::vector<models::FolderEntry> ExploreController::getFilteredFolders(
 std::vector<size_t> ExploreController::getFilteredFileIndices(
     const std::string& searchQuery) const 
 {
-    const auto& allFiles = m_exploreModel->getCurrentFiles();
-    std::vector<size_t> indices;
-    
-    if (searchQuery.empty()) 
-    {
-        // Trả về tất cả indices
-        for (size_t i = 0; i < allFiles.size(); i++) 
-        {
-            indices.push_back(i);
-        }
-        return indices;
-    }
-    
-    // Lọc theo query (title hoặc artist)
-    std::string query = searchQuery;
-    std::transform(query.begin(), query.end(), query.begin(), ::tolower);
-    
-    for (size_t i = 0; i < allFiles.size(); i++) 
-    {
-        const auto& media = allFiles[i];
-        
-        std::string title = media.getTitle().empty() ? media.getFileName() : media.getTitle();
-        std::transform(title.begin(), title.end(), title.begin(), ::tolower);
-        
-        std::string artist = media.getArtist();
-        std::transform(artist.begin(), artist.end(), artist.begin(), ::tolower);
-        
-        if (title.find(query) != std::string::npos || 
-            artist.find(query) != std::string::npos) 
-        {
-            indices.push_back(i);
-        }
-    }
+    // Lọc theo query (title hoặc artist) qua chỉ mục trigram; gõ thêm ký tự
+    // thì chỉ thu hẹp kết quả lần trước
+    m_lastFileSearch = m_exploreModel->getFileIndex().search(
+        searchQuery, models::SearchField::TITLE | models::SearchField::ARTIST, &m_lastFileSearch);
     
-    return indices;
+    return std::vector<size_t>(m_lastFileSearch.positions.begin(), m_lastFileSearch.positions.end());
 }
 
 size_t ExploreController::getFolderCount() const 
@@ -403,8 +367,8 @@ void ExploreController::buildCurrentView()
     std::sort(files.begin(), files.end(),
         [](const models::MediaFileModel& a, const models::MediaFileModel& b) 
         {
-            std::string nameA = a.getTitle().empty() ? a.getFileName() : a.getTitle();
-            std::string nameB = b.getTitle().empty() ? b.getFileName() : b.getTitle();
+            std::string nameA = a.getTitle().empty() ? std::string(a.getFileName()) : a.getTitle();
+            std::string nameB = b.getTitle().empty() ? std::string(b.getFileName()) : b.getTitle();
             return nameA < nameB;
         });
     
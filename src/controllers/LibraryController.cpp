@@ -1,5 +1,6 @@
 // Project includes
 #include "controllers/LibraryController.h"
+#include "models/MediaCatalog.h"
 
 namespace media_player 
 {
@@ -9,11 +10,13 @@ namespace controllers
 LibraryController::LibraryController(
     std::shared_ptr<models::LibraryModel> libraryModel,
     std::shared_ptr<repositories::LibraryRepository> libraryRepo,
-    std::shared_ptr<services::IMetadataReader> metadataReader
+    std::shared_ptr<services::IMetadataReader> metadataReader,
+    std::shared_ptr<models::HistoryModel> historyModel
 )
     : m_libraryModel(libraryModel)
     , m_libraryRepo(libraryRepo)
     , m_metadataReader(metadataReader)
+    , m_historyModel(historyModel)
 {
 }
 
@@ -42,6 +45,8 @@ bool LibraryController::updateMetadata(const models::MediaFileModel& media, cons
         // updatedMedia.setGenre(newMetadata.getGenre());
         
         m_libraryModel->updateMedia(media.getFilePath(), updatedMedia);
+        // Queue, playlists and history hold catalog handles and see it at once
+        models::MediaCatalog::getShared()->update(updatedMedia);
         return true;
     }
     return false;
@@ -49,6 +54,16 @@ bool LibraryController::updateMetadata(const models::MediaFileModel& media, cons
 
 LibraryController::~LibraryController() 
 {
+    {
+        std::lock_guard<std::mutex> lock(m_fuzzyMutex);
+        m_fuzzyStop = true;
+    }
+    m_fuzzyWake.notify_all();
+    
+    if (m_fuzzyThread.joinable()) 
+    {
+        m_fuzzyThread.join();
+    }
 }
 
 std::vector<models::MediaFileModel> LibraryController::getAllMedia() const 
@@ -56,6 +71,11 @@ std::vector<models::MediaFileModel> LibraryController::getAllMedia() const
     return m_libraryModel->getAllMedia();
 }
 
+models::MediaSnapshot LibraryController::getSnapshot() const 
+{
+    return m_libraryModel->getSnapshot();
+}
+
 std::vector<models::MediaFileModel> LibraryController::getPage(size_t pageNumber, size_t itemsPerPage) const 
 {
     return m_libraryModel->getPage(pageNumber, itemsPerPage);
@@ -68,10 +88,10 @@ std::vector<models::MediaFileModel> LibraryController::getAudioFiles() const
 
 std::vector<models::MediaFileModel> LibraryController::getVideoFiles() const 
 {
-    auto allMedia = m_libraryModel->getAllMedia();
+    auto allMedia = m_libraryModel->getSnapshot();
     std::vector<models::MediaFileModel> videoFiles;
     
-    for (const auto& media : allMedia) 
+    for (const auto& media : *allMedia) 
     {
         if (media.isVideo()) 
         {
@@ -87,6 +107,81 @@ std::vector<models::MediaFileModel> LibraryController::search(const std::string&
     return m_libraryModel->search(query);
 }
 
+models::LibrarySearch LibraryController::search(const std::string& query, models::SearchFieldMask fields,
+                                                const models::LibrarySearch* previous,
+                                                std::optional<models::SortCriteria> sortBy) const 
+{
+    return m_libraryModel->search(query, fields, previous, sortBy);
+}
+
+void LibraryController::requestFuzzySearch(const std::string& query, models::SearchFieldMask fields) 
+{
+    std::lock_guard<std::mutex> lock(m_fuzzyMutex);
+    
+    // Asked already: only search again if the library changed since
+    if (m_fuzzyThread.joinable() && query == m_fuzzyQuery && fields == m_fuzzyFields) 
+    {
+        if (m_fuzzyRequest || !m_fuzzyAnswer || m_fuzzyAnswer->search.media == m_libraryModel->getSnapshot()) 
+        {
+            return;
+        }
+    }
+    
+    m_fuzzyQuery = query;
+    m_fuzzyFields = fields;
+    m_fuzzyRequest = FuzzySearchAnswer{ query, fields, {} };
+    
+    if (!m_fuzzyThread.joinable()) 
+    {
+        m_fuzzyThread = std::thread(&LibraryController::runFuzzySearches, this);
+    }
+    m_fuzzyWake.notify_one();
+}
+
+std::shared_ptr<const FuzzySearchAnswer> LibraryController::getFuzzyAnswer() const 
+{
+    std::lock_guard<std::mutex> lock(m_fuzzyMutex);
+    return m_fuzzyAnswer;
+}
+
+void LibraryController::runFuzzySearches() 
+{
+    std::unique_lock<std::mutex> lock(m_fuzzyMutex);
+    
+    while (true) 
+    {
+        m_fuzzyWake.wait(lock, [this] { return m_fuzzyStop || m_fuzzyRequest.has_value(); });
+        if (m_fuzzyStop) 
+        {
+            return;
+        }
+        
+        auto answer = std::make_shared<FuzzySearchAnswer>(std::move(*m_fuzzyRequest));
+        m_fuzzyRequest.reset();
+        std::shared_ptr<const FuzzySearchAnswer> previous = m_fuzzyAnswer;
+        lock.unlock();
+        
+        std::unordered_map<models::MediaId, uint32_t> playCounts;
+        if (m_historyModel) 
+        {
+            playCounts = m_historyModel->getPlayCounts();
+        }
+        
+        // The previous answer lets a keystroke reuse the work of the last one
+        answer->search = m_libraryModel->fuzzySearch(answer->query, answer->fields, playCounts,
+                                                     models::FuzzySearch::DEFAULT_LIMIT,
+                                                     previous ? &previous->search : nullptr);
+        
+        lock.lock();
+        m_fuzzyAnswer = std::move(answer);
+    }
+}
+
+models::LibraryOrder LibraryController::getSortOrder(models::SortCriteria criteria) const 
+{
+    return m_libraryModel->getSortOrder(criteria);
+}
+
 std::vector<models::MediaFileModel> LibraryController::sortByTitle(bool ascending) const 
 {
     return m_libraryModel->getSorted(models::SortCriteria::TITLE, ascending);
@@ -85,7 +85,7 @@ bool PlaybackController::play()
     
     // Always sync Metadata, even if engine is already loaded for this file
     const auto& media = *currentItem;
-    m_playbackStateModel->setCurrentTitle(media.getTitle().empty() ? media.getFileName() : media.getTitle());
+    m_playbackStateModel->setCurrentTitle(media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle());
     m_playbackStateModel->setCurrentArtist(media.getArtist().empty() ? "Unknown Artist" : media.getArtist());
     m_playbackStateModel->setCurrentMediaType(media.getType());
 
@@ -170,7 +170,7 @@ bool PlaybackController::togglePlayPause()
                 if (selectAndLoadEngine(*m_oneOffMedia))
                 {
                     m_playbackStateModel->setCurrentFilePath(m_oneOffMedia->getFilePath());
-                    m_playbackStateModel->setCurrentTitle(m_oneOffMedia->getTitle().empty() ? m_oneOffMedia->getFileName() : m_oneOffMedia->getTitle());
+                    m_playbackStateModel->setCurrentTitle(m_oneOffMedia->getTitle().empty() ? std::string(m_oneOffMedia->getFileName()) : m_oneOffMedia->getTitle());
                     m_playbackStateModel->setCurrentArtist(m_oneOffMedia->getArtist().empty() ? "Unknown Artist" : m_oneOffMedia->getArtist());
                     m_playbackStateModel->setCurrentMediaType(m_oneOffMedia->getType());
                     return m_currentEngine->play();
@@ -266,7 +266,7 @@ bool PlaybackController::playPrevious()
             if (!selectAndLoadEngine(prevEntry->media))
                 return false;
             m_playbackStateModel->setCurrentFilePath(prevEntry->media.getFilePath());
-            m_playbackStateModel->setCurrentTitle(prevEntry->media.getTitle().empty() ? prevEntry->media.getFileName() : prevEntry->media.getTitle());
+            m_playbackStateModel->setCurrentTitle(prevEntry->media.getTitle().empty() ? std::string(prevEntry->media.getFileName()) : prevEntry->media.getTitle());
             m_playbackStateModel->setCurrentArtist(prevEntry->media.getArtist().empty() ? "Unknown Artist" : prevEntry->media.getArtist());
             m_playbackStateModel->setCurrentMediaType(prevEntry->media.getType());
             m_playingFromHistory = true;
@@ -318,7 +318,7 @@ bool PlaybackController::playMediaWithoutQueue(const models::MediaFileModel& med
         return false;
     
     m_playbackStateModel->setCurrentFilePath(media.getFilePath());
-    m_playbackStateModel->setCurrentTitle(media.getTitle().empty() ? media.getFileName() : media.getTitle());
+    m_playbackStateModel->setCurrentTitle(media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle());
     m_playbackStateModel->setCurrentArtist(media.getArtist().empty() ? "Unknown Artist" : media.getArtist());
     m_playbackStateModel->setCurrentMediaType(media.getType());
     m_playingOneOffWithoutQueue = true;
@@ -514,7 +514,7 @@ void PlaybackController::onFinished()
                 if (selectAndLoadEngine(media))
                 {
                     m_playbackStateModel->setCurrentFilePath(media.getFilePath());
-                    m_playbackStateModel->setCurrentTitle(media.getTitle().empty() ? media.getFileName() : media.getTitle());
+                    m_playbackStateModel->setCurrentTitle(media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle());
                     m_playbackStateModel->setCurrentArtist(media.getArtist().empty() ? "Unknown Artist" : media.getArtist());
                     m_playbackStateModel->setCurrentMediaType(media.getType());
                     m_playingOneOffWithoutQueue = true;
@@ -18,29 +18,24 @@ QueueController::~QueueController()
 void QueueController::addToQueue(const models::MediaFileModel& media) 
 {
     // Check for duplicates
-    for (const auto& item : m_queueModel->getAllItems()) {
-        if (item.getFilePath() == media.getFilePath()) {
-            return; // Already in queue
-        }
+    if (m_queueModel->contains(media.getFilePath())) {
+        return; // Already in queue
     }
     m_queueModel->addToEnd(media);
 }
 
 void QueueController::addToQueueNext(const models::MediaFileModel& media) 
 {
-    for (const auto& item : m_queueModel->getAllItems()) {
-        if (item.getFilePath() == media.getFilePath()) {
-            return; 
-        }
+    if (m_queueModel->contains(media.getFilePath())) {
+        return; 
     }
     m_queueModel->addNext(media);
 }
 
 void QueueController::addPlaylistToQueue(const models::PlaylistModel& playlist) 
 {
-    auto items = playlist.getItems();
-    
-    for (const auto& item : items) 
+    // Shares the playlist's handles instead of copying its records
+    for (const auto& item : playlist.getHandles()) 
     {
         m_queueModel->addToEnd(item);
     }
@@ -50,14 +45,7 @@ void QueueController::addMultipleToQueue(const std::vector<models::MediaFileMode
 {
     for (const auto& media : mediaList) 
     {
-        bool exists = false;
-        for (const auto& item : m_queueModel->getAllItems()) {
-            if (item.getFilePath() == media.getFilePath()) {
-                exists = true;
-                break;
-            }
-        }
-        if (!exists) {
+        if (!m_queueModel->contains(media.getFilePath())) {
             m_queueModel->addToEnd(media);
         }
     }
@@ -218,13 +218,9 @@ void SourceController::onScanProgress(int count, const std::string& path)
 void SourceController::onScanComplete(std::vector<models::MediaFileModel> results) 
 {
     
-    // Clear old library
-    m_libraryModel->clear();
-    m_libraryRepo->clear();
-    
-    // Add to library
-    m_libraryModel->addMediaBatch(results);
-    m_libraryRepo->saveAll(results);
+    // Replace the library in one publish; the repository journals only what the scan changed
+    m_libraryModel->replaceAll(results);
+    m_libraryRepo->replaceAll(results);
     
     if (m_completeCallback) 
     {
@@ -232,6 +228,46 @@ void SourceController::onScanComplete(std::vector<models::MediaFileModel> result
     }
 }
 
+size_t SourceController::applyLibraryChanges(const std::vector<services::LibraryChange>& changes) 
+{
+    // The model takes the whole batch in one publish; the repository
+    // journals each change
+    std::vector<models::LibraryEdit> edits;
+    edits.reserve(changes.size());
+    
+    for (const auto& change : changes) 
+    {
+        switch (change.type) 
+        {
+            case services::LibraryChangeType::FILE_ADDED:
+            case services::LibraryChangeType::FILE_MODIFIED:
+                if (!change.media) 
+                {
+                    break;
+                }
+                edits.push_back({ models::LibraryEdit::Type::PUT, change.path, change.media });
+                m_libraryRepo->save(*change.media);
+                break;
+                
+            case services::LibraryChangeType::FILE_REMOVED:
+                edits.push_back({ models::LibraryEdit::Type::REMOVE, change.path, std::nullopt });
+                m_libraryRepo->removeByPath(change.path);
+                break;
+                
+            case services::LibraryChangeType::DIRECTORY_REMOVED:
+                edits.push_back({ models::LibraryEdit::Type::REMOVE_UNDER, change.path, std::nullopt });
+                m_libraryRepo->removeUnderPath(change.path);
+                break;
+                
+            case services::LibraryChangeType::RESCAN_NEEDED:
+                // Nothing to apply; the owner of the scan decides when to rescan
+                break;
+        }
+    }
+    
+    return m_libraryModel->applyChanges(edits);
+}
+
     // Add system includes for filesystem if needed
     // #include <filesystem>  <-- Ensure this is available in the file or project
 
@@ -2,6 +2,7 @@
 #include "core/Application.h"
 #include "config/AppConfig.h"
 #include "ui/ImGuiManager.h"
+#include "utils/Log.h"
 
 // All models
 #include "models/QueueModel.h"
@@ -9,6 +10,7 @@
 #include "models/LibraryModel.h"
 #include "models/SystemStateModel.h"
 #include "models/HistoryModel.h"
+#include "models/MediaCatalog.h"
 
 // All services
 #include "services/FileScanner.h"
@@ -26,6 +28,8 @@
 #include <atomic>
 #include <fstream>
 #include <filesystem>
+#include <unordered_set>
+#include <iterator>
 
 namespace media_player 
 {
@@ -40,11 +44,18 @@ static std::atomic<int> g_scanProgress{0};
 static std::atomic<int> g_scanTotal{0};
 static std::atomic<bool> g_scanCancelled{false};
 static std::string g_currentScanPath;
-static std::vector<models::MediaFileModel> g_scannedMedia;
+static std::vector<std::string> g_scannedPaths;     // Everything the last scan found
 static std::mutex g_mediaMutex;
 
 static const char* LAST_SCAN_PATH_FILE = "./data/last_scan_path.txt";
 
+// Streamed batches arrive faster than the views need to be rebuilt
+static constexpr auto SCAN_VIEW_REFRESH_INTERVAL = std::chrono::milliseconds(250);
+
+// LibraryModel holds streamed tracks back until they are worth copying the
+// library for; they still show up at least this often
+static constexpr auto SCAN_PUBLISH_MAX_DELAY = std::chrono::seconds(2);
+
 static std::string loadLastScanPath() {
     std::ifstream f(LAST_SCAN_PATH_FILE);
     std::string path;
@@ -165,15 +176,15 @@ void Application::setupUICallbacks()
         if (m_libraryModel && index >= 0 && 
             index < static_cast<int>(m_libraryModel->getMediaCount())) 
         {
-            auto mediaList = m_libraryModel->getAllMedia();
-            const auto& media = mediaList[index];
+            auto mediaList = m_libraryModel->getSnapshot();
+            const auto& media = (*mediaList)[index];
             
             if (m_playbackController && m_playbackController->playMediaWithoutQueue(media))
             {
                 auto& state = g_uiManager->getState();
                 state.isPlaying = true;
                 std::string title = media.getTitle();
-                state.currentTrackTitle = title.empty() ? media.getFileName() : title;
+                state.currentTrackTitle = title.empty() ? std::string(media.getFileName()) : title;
                 std::string artist = media.getArtist();
                 state.currentTrackArtist = artist.empty() ? "Unknown Artist" : artist;
                 state.playbackDuration = static_cast<float>(media.getDuration());
@@ -329,12 +340,38 @@ bool Application::createAllComponents()
     m_historyRepo = std::make_shared<repositories::HistoryRepository>(
         config::AppConfig::HISTORY_STORAGE_PATH
     );
+    m_scanManifest = std::make_shared<repositories::ScanManifestRepository>(
+        config::AppConfig::LIBRARY_STORAGE_PATH
+    );
     
     // Create HistoryModel with repository for persistence
     m_historyModel = std::make_shared<models::HistoryModel>(m_historyRepo);
     
     // Create services
     auto fileScanner = std::make_shared<services::FileScanner>();
+    fileScanner->setScanManifest(m_scanManifest);
+    
+    m_mediaValidator = std::make_unique<services::MediaValidator>();
+    m_mediaValidator->setResultCallback([this](std::vector<std::string> missingPaths) {
+        m_missingPaths.push(std::move(missingPaths));
+    });
+    
+    m_libraryWatcher = std::make_unique<services::LibraryWatcher>(fileScanner);
+    m_libraryWatcher->setChangeCallback([this](std::vector<services::LibraryChange> changes) {
+        m_libraryChanges.push(std::move(changes));
+    });
+    fileScanner->setBatchSize(config::AppConfig::SCAN_BATCH_SIZE);
+    fileScanner->setBatchCallback([this](std::vector<models::MediaFileModel> batch) {
+        m_scanBatches.push(std::move(batch));
+    });
+    // Scans back off while a track streams from the device being scanned
+    fileScanner->setPlaybackProbe([this]() {
+        if (m_playbackController && m_playbackController->isPlaying())
+        {
+            return m_playbackController->getCurrentFilePath();
+        }
+        return std::string();
+    });
     auto serialComm = std::make_shared<services::SerialCommunication>();
     auto metadataReader = std::make_shared<services::MetadataReader>();
     
@@ -356,7 +393,8 @@ bool Application::createAllComponents()
     m_libraryController = std::make_shared<controllers::LibraryController>(
         libraryModel,
         libraryRepo,
-        metadataReader
+        metadataReader,
+        m_historyModel
     );
     
     m_playlistController = std::make_shared<controllers::PlaylistController>(
@@ -441,10 +479,11 @@ bool Application::createAllComponents()
     if (m_libraryModel && libraryRepo)
     {
         libraryRepo->loadFromDisk();
-        auto cachedMedia = libraryRepo->findAll();
-        if (!cachedMedia.empty())
+        auto cachedMedia = libraryRepo->getSnapshot();
+        if (!cachedMedia->empty())
         {
-            m_libraryModel->addMediaBatch(cachedMedia);
+            // Shared with the repository, not copied
+            m_libraryModel->setSnapshot(cachedMedia);
         }
     }
     
@@ -476,6 +515,21 @@ bool Application::wireUpDependencies()
 
 void Application::startScan(const std::string& path)
 {
+    // The rescan rebuilds the library; watching resumes once it completes
+    if (m_libraryWatcher)
+    {
+        m_libraryWatcher->stop();
+    }
+    m_libraryChanges.clear();
+    m_scanRootPath = path;
+    
+    m_scanBatches.clear();
+    m_scanStartTime = std::chrono::steady_clock::now();
+    m_lastScanPublish = m_scanStartTime;
+    m_scanTracksShown = 0;
+    m_timeToFirstTrackMs = -1;
+    m_libraryViewStale = false;
+    
     g_scanComplete = false;
     g_scanStarted = true;
     g_scanProgress = 0;
@@ -491,28 +545,26 @@ void Application::startScan(const std::string& path)
                 g_scanTotal = total;
                 g_currentScanPath = p;
             });
+            // Streamed records went to m_scanBatches; an inline scan returns them here
             auto scannedMedia = m_fileScanner->scanDirectorySync(path);
+            std::vector<std::string> scannedPaths = m_fileScanner->takeStreamedPaths();
+            for (const auto& media : scannedMedia)
+            {
+                scannedPaths.push_back(media.getFilePath());
+            }
+            if (!scannedMedia.empty())
+            {
+                m_scanBatches.push(std::move(scannedMedia));
+            }
             {
                 std::lock_guard<std::mutex> lock(g_mediaMutex);
-                g_scannedMedia = scannedMedia;
+                g_scannedPaths = std::move(scannedPaths);
             }
 
-            if (!g_scanCancelled)
+            // The library itself is reconciled on the main thread (see update())
+            if (!g_scanCancelled && m_scanManifest)
             {
-                // Update LibraryModel and Repository with new scan results
-                if (m_libraryModel)
-                {
-                    m_libraryModel->clear();
-                    m_libraryModel->addMediaBatch(g_scannedMedia);
-                }
-                
-                // Update repository for next startup
-                if (m_libraryRepo)
-                {
-                    m_libraryRepo->clear();
-                    m_libraryRepo->saveAll(g_scannedMedia);
-                    m_libraryRepo->saveToDisk();
-                }
+                m_scanManifest->saveToDisk();
             }
         }
         g_scanComplete = true;
@@ -527,6 +579,10 @@ void Application::resetAndRescan(const std::string& path)
     if (m_historyModel) m_historyModel->clear();
     saveLastScanPath(path);
     
+    // A different root: stream into an empty library instead of next to the old one
+    if (m_libraryModel) m_libraryModel->clear();
+    refreshLibraryViews();
+    
     // Reset UI state to prevent "ghost" pages or invalid selection
     if (g_uiManager) {
         auto& state = g_uiManager->getState();
@@ -575,6 +631,13 @@ int Application::run()
         update();
         render();
         
+        // Loading skipped the per-entry stats; do them now that a frame is up
+        if (!m_validationStarted)
+        {
+            startValidation();
+            m_validationStarted = true;
+        }
+        
         // Cap frame rate to ~60 FPS
         SDL_Delay(16);
     }
@@ -599,7 +662,7 @@ void Application::processEvents()
 
     if (g_uiManager)
     {
-        g_uiManager->getState().scanDialogVisible = (!g_scanComplete && g_scanStarted);
+        g_uiManager->getState().scanDialogVisible = (!g_scanComplete && g_scanStarted && isLibraryEmpty());
     }
     
     while (SDL_PollEvent(&event)) 
@@ -691,9 +754,36 @@ void Application::update()
     }
     
     
+    // Show tracks of a running scan as they arrive
+    if (g_scanStarted && !g_scanComplete) {
+        applyPendingScanBatches();
+    }
+    
     // Update media list reference in Library Screen when scan completes
     static bool scanWasComplete = false;
     if (g_scanComplete && !scanWasComplete) {
+        if (m_libraryModel && g_scanCancelled && m_libraryRepo &&
+            (m_scanTracksShown > 0 || m_libraryModel->isEmpty())) {
+             // Drop the partial result; the repository still has the previous library
+             m_scanBatches.clear();
+             m_libraryModel->setSnapshot(m_libraryRepo->getSnapshot());
+        }
+        else if (m_libraryModel && !g_scanCancelled) {
+             // The model holds every streamed record; files deleted since the last scan drop out here
+             applyPendingScanBatches();
+             m_libraryModel->publishStaged();
+             removeUnscannedMedia();
+             
+             // Update repository for next startup (journaled as it changes)
+             if (m_libraryRepo) {
+                 m_libraryRepo->replaceAll(*m_libraryModel->getSnapshot());
+             }
+        }
+        else {
+             m_scanBatches.clear();
+             if (m_libraryModel) m_libraryModel->dropStaged();
+        }
+        m_libraryViewStale = false;
         if (m_libraryScreen) {
              // Refresh the library view now that data is available
              // Note: m_libraryScreen->show() calls refresh, but if it's already shown (startup),
@@ -720,6 +810,10 @@ void Application::update()
         if (m_exploreController) {
              m_exploreController->setRootPath(loadLastScanPath());
         }
+        // Pick up files added/removed from now on without a full rescan
+        if (m_libraryWatcher && !g_scanCancelled) {
+             m_libraryWatcher->start(m_scanRootPath);
+        }
         scanWasComplete = true;
     } else if (!g_scanComplete) {
         scanWasComplete = false;
@@ -727,8 +821,11 @@ void Application::update()
     
     if (g_uiManager && m_libraryModel && g_scanComplete) {
         // Legacy setMediaList removed
+        applyPendingLibraryChanges();
     }
     
+    applyValidationResults();
+    
     // Thử kết nối lại phần cứng S32K144 theo chu kỳ để nhận bản tin từ UART
     if (m_hardwareController)
     {
@@ -742,18 +839,194 @@ void Application::update()
     }
 }
 
+void Application::applyPendingLibraryChanges()
+{
+    bool changed = false;
+    bool rescanNeeded = false;
+    
+    while (auto changes = m_libraryChanges.pop())
+    {
+        for (const auto& change : *changes)
+        {
+            if (change.type == services::LibraryChangeType::RESCAN_NEEDED)
+            {
+                rescanNeeded = true;
+            }
+        }
+        
+        if (m_sourceController && m_sourceController->applyLibraryChanges(*changes) > 0)
+        {
+            changed = true;
+        }
+    }
+    
+    if (rescanNeeded)
+    {
+        // Events were dropped; a plain rescan keeps queue and history
+        startScan(m_scanRootPath);
+        return;
+    }
+    
+    if (changed)
+    {
+        refreshLibraryViews();
+    }
+}
+
+void Application::startValidation()
+{
+    if (!m_mediaValidator || !m_libraryModel) return;
+    
+    std::vector<std::string> paths;
+    auto library = m_libraryModel->getSnapshot();
+    paths.reserve(library->size());
+    for (const auto& media : *library)
+    {
+        paths.push_back(media.getFilePath());
+    }
+    
+    // Playlists and history can name files the library no longer has
+    for (auto& path : models::MediaCatalog::getShared()->getFilePaths())
+    {
+        if (!m_libraryModel->contains(path))
+        {
+            paths.push_back(std::move(path));
+        }
+    }
+    
+    m_mediaValidator->start(std::move(paths));
+}
+
+void Application::applyValidationResults()
+{
+    std::vector<std::string> missing;
+    
+    while (auto batch = m_missingPaths.pop())
+    {
+        missing.insert(missing.end(), std::make_move_iterator(batch->begin()), std::make_move_iterator(batch->end()));
+    }
+    
+    if (missing.empty()) return;
+    
+    size_t marked = m_libraryModel ? m_libraryModel->markStale(missing) : 0;
+    models::MediaCatalog::getShared()->markStale(missing);
+    
+    if (marked > 0)
+    {
+        refreshLibraryViews();
+    }
+}
+
+void Application::applyPendingScanBatches()
+{
+    if (!m_libraryModel) return;
+    
+    // Everything that arrived since the last frame is staged together.
+    // A rescan of the same root replaces records whose tags changed.
+    std::vector<models::LibraryEdit> arrived;
+    
+    while (auto batch = m_scanBatches.pop())
+    {
+        for (auto& media : *batch)
+        {
+            std::string path = media.getFilePath();
+            arrived.push_back(models::LibraryEdit{ models::LibraryEdit::Type::PUT, std::move(path), std::move(media) });
+        }
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    
+    // Copying the library every frame would make a long scan quadratic
+    size_t applied = arrived.empty() ? 0 : m_libraryModel->stageChanges(std::move(arrived));
+    
+    if (applied == 0 && now - m_lastScanPublish >= SCAN_PUBLISH_MAX_DELAY)
+    {
+        applied = m_libraryModel->publishStaged();
+    }
+    
+    if (applied > 0)
+    {
+        m_lastScanPublish = now;
+        
+        if (m_scanTracksShown == 0)
+        {
+            m_timeToFirstTrackMs = static_cast<int>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(now - m_scanStartTime).count());
+            LOG_INFO("Time to first track: " + std::to_string(m_timeToFirstTrackMs) + " ms");
+            
+            if (m_exploreController) m_exploreController->setRootPath(m_scanRootPath);
+            
+            // Show the first tracks right away instead of waiting for the next refresh slot
+            m_lastViewRefresh = now - SCAN_VIEW_REFRESH_INTERVAL;
+        }
+        m_scanTracksShown += applied;
+        m_libraryViewStale = true;
+    }
+    
+    if (m_libraryViewStale && now - m_lastViewRefresh >= SCAN_VIEW_REFRESH_INTERVAL)
+    {
+        refreshLibraryViews();
+        m_lastViewRefresh = now;
+        m_libraryViewStale = false;
+    }
+}
+
+void Application::removeUnscannedMedia()
+{
+    std::unordered_set<std::string> scanned;
+    {
+        std::lock_guard<std::mutex> lock(g_mediaMutex);
+        scanned.insert(std::make_move_iterator(g_scannedPaths.begin()), std::make_move_iterator(g_scannedPaths.end()));
+        g_scannedPaths.clear();
+    }
+    
+    std::vector<models::LibraryEdit> removals;
+    for (const auto& media : *m_libraryModel->getSnapshot())
+    {
+        if (scanned.count(media.getFilePath()) == 0)
+        {
+            removals.push_back(models::LibraryEdit{ models::LibraryEdit::Type::REMOVE, media.getFilePath(), std::nullopt });
+        }
+    }
+    
+    m_libraryModel->applyChanges(removals);
+}
+
+void Application::refreshLibraryViews()
+{
+    if (m_libraryScreen) m_libraryScreen->reloadMediaList();
+    if (m_exploreController) m_exploreController->refreshMediaList();
+}
+
+int Application::getTimeToFirstTrackMs() const
+{
+    return m_timeToFirstTrackMs;
+}
+
+bool Application::isLibraryEmpty() const
+{
+    return !m_libraryModel || m_libraryModel->isEmpty();
+}
+
 void Application::render() 
 {
     if (!g_uiManager) return;
     
     g_uiManager->beginFrame();
     
-    if (!g_scanComplete && g_scanStarted) 
+    if (!g_scanComplete && g_scanStarted && isLibraryEmpty()) 
     {
         g_uiManager->getState().scanDialogVisible = true;
         g_uiManager->renderMainLayout();
         g_uiManager->renderScanProgress(g_currentScanPath, g_scanProgress, g_scanTotal);
     }
+    else if (!g_scanComplete && g_scanStarted) 
+    {
+        // Tracks are already listed and playable; keep the scan out of the way
+        g_uiManager->getState().scanDialogVisible = false;
+        g_uiManager->renderMainLayout();
+        g_uiManager->renderScanStatus(g_scanProgress, g_scanTotal, m_timeToFirstTrackMs);
+    }
     else if (!g_scanComplete && !g_scanStarted) 
     {
         g_uiManager->renderMainLayout();
@@ -829,13 +1102,13 @@ void Application::handleKeyboardEvent(const SDL_KeyboardEvent& event)
         {
             if (state.selectedMediaIndex >= 0 && state.selectedMediaIndex < mediaCount) 
             {
-                auto mediaList = m_libraryModel->getAllMedia();
-                const auto& media = mediaList[state.selectedMediaIndex];
+                auto mediaList = m_libraryModel->getSnapshot();
+                const auto& media = (*mediaList)[state.selectedMediaIndex];
                 
                 if (m_playbackController && m_playbackController->playMediaWithoutQueue(media))
                 {
                     state.isPlaying = true;
-                    state.currentTrackTitle = media.getTitle().empty() ? media.getFileName() : media.getTitle();
+                    state.currentTrackTitle = media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle();
                     state.currentTrackArtist = media.getArtist().empty() ? "Unknown Artist" : media.getArtist();
                 }
             }
@@ -0,0 +1,421 @@
+// Project includes
+#include "models/Collation.h"
+
+// System includes
+#include <algorithm>
+#include <cstdint>
+
+namespace media_player 
+{
+namespace models 
+{
+
+namespace 
+{
+
+// Byte values of the key. 0x01 separates the levels and 0x00 is unused, so
+// a key that runs out compares below every longer one.
+constexpr unsigned char LEVEL_SEPARATOR = 0x01;
+constexpr unsigned char DEFAULT_WEIGHT = 0x02;
+constexpr unsigned char SYMBOL_BASE = 0x02;     // + (c - ' '), up to 0x60
+constexpr unsigned char DIGITS_LEAD = 0x61;     // Then digit count and digits
+constexpr unsigned char LETTER_BASE = 0x70;     // + alphabet rank, up to 0x90
+constexpr unsigned char OTHER_LEAD = 0xF0;      // Then 3 bytes of the code point
+constexpr unsigned char UPPERCASE = 0x03;
+constexpr size_t MAX_DIGITS = 100;
+
+enum Mark : uint8_t 
+{
+    NO_MARK,
+    BREVE,          // ă
+    CIRCUMFLEX,     // â ê ô
+    HORN,           // ơ ư
+    STROKE          // đ
+};
+
+// Secondary weights, in Vietnamese dictionary order
+enum Tone : uint8_t 
+{
+    NO_TONE,
+    GRAVE,
+    HOOK,
+    TILDE,
+    ACUTE,
+    DOT_BELOW,
+    OTHER_ACCENT    // Diaeresis, ring, cedilla... and stacked marks
+};
+
+struct Letter 
+{
+    char base;      // 'a'..'z', 0 when the code point is not a letter here
+    uint8_t mark;
+    uint8_t tone;
+};
+
+// Rank of each ASCII letter in the Vietnamese alphabet; letters with a mark
+// take the next ranks after their base
+const uint8_t BASE_RANK[26] = { 0, 3, 4, 5, 7, 9, 10, 11, 12, 13, 14, 15, 16,
+                                17, 18, 21, 22, 23, 24, 25, 26, 28, 29, 30, 31, 32 };
+
+// U+00C0..U+00DF; the lowercase forms are 0x20 further
+const Letter LATIN1[32] = {
+    { 'a', NO_MARK, GRAVE }, { 'a', NO_MARK, ACUTE }, { 'a', CIRCUMFLEX, NO_TONE }, { 'a', NO_MARK, TILDE },
+    { 'a', NO_MARK, OTHER_ACCENT }, { 'a', NO_MARK, OTHER_ACCENT }, { 0, 0, 0 }, { 'c', NO_MARK, OTHER_ACCENT },
+    { 'e', NO_MARK, GRAVE }, { 'e', NO_MARK, ACUTE }, { 'e', CIRCUMFLEX, NO_TONE }, { 'e', NO_MARK, OTHER_ACCENT },
+    { 'i', NO_MARK, GRAVE }, { 'i', NO_MARK, ACUTE }, { 'i', NO_MARK, OTHER_ACCENT }, { 'i', NO_MARK, OTHER_ACCENT },
+    { 0, 0, 0 }, { 'n', NO_MARK, OTHER_ACCENT }, { 'o', NO_MARK, GRAVE }, { 'o', NO_MARK, ACUTE },
+    { 'o', CIRCUMFLEX, NO_TONE }, { 'o', NO_MARK, TILDE }, { 'o', NO_MARK, OTHER_ACCENT }, { 0, 0, 0 },
+    { 'o', NO_MARK, OTHER_ACCENT }, { 'u', NO_MARK, GRAVE }, { 'u', NO_MARK, ACUTE }, { 'u', NO_MARK, OTHER_ACCENT },
+    { 'u', NO_MARK, OTHER_ACCENT }, { 'y', NO_MARK, ACUTE }, { 0, 0, 0 }, { 0, 0, 0 },
+};
+
+// U+1EA0..U+1EF9, the Vietnamese block: one entry per uppercase/lowercase pair
+const Letter VIETNAMESE[45] = {
+    { 'a', NO_MARK, DOT_BELOW }, { 'a', NO_MARK, HOOK },
+    { 'a', CIRCUMFLEX, ACUTE }, { 'a', CIRCUMFLEX, GRAVE }, { 'a', CIRCUMFLEX, HOOK },
+    { 'a', CIRCUMFLEX, TILDE }, { 'a', CIRCUMFLEX, DOT_BELOW },
+    { 'a', BREVE, ACUTE }, { 'a', BREVE, GRAVE }, { 'a', BREVE, HOOK }, { 'a', BREVE, TILDE }, { 'a', BREVE, DOT_BELOW },
+    { 'e', NO_MARK, DOT_BELOW }, { 'e', NO_MARK, HOOK }, { 'e', NO_MARK, TILDE },
+    { 'e', CIRCUMFLEX, ACUTE }, { 'e', CIRCUMFLEX, GRAVE }, { 'e', CIRCUMFLEX, HOOK },
+    { 'e', CIRCUMFLEX, TILDE }, { 'e', CIRCUMFLEX, DOT_BELOW },
+    { 'i', NO_MARK, HOOK }, { 'i', NO_MARK, DOT_BELOW },
+    { 'o', NO_MARK, DOT_BELOW }, { 'o', NO_MARK, HOOK },
+    { 'o', CIRCUMFLEX, ACUTE }, { 'o', CIRCUMFLEX, GRAVE }, { 'o', CIRCUMFLEX, HOOK },
+    { 'o', CIRCUMFLEX, TILDE }, { 'o', CIRCUMFLEX, DOT_BELOW },
+    { 'o', HORN, ACUTE }, { 'o', HORN, GRAVE }, { 'o', HORN, HOOK }, { 'o', HORN, TILDE }, { 'o', HORN, DOT_BELOW },
+    { 'u', NO_MARK, DOT_BELOW }, { 'u', NO_MARK, HOOK },
+    { 'u', HORN, ACUTE }, { 'u', HORN, GRAVE }, { 'u', HORN, HOOK }, { 'u', HORN, TILDE }, { 'u', HORN, DOT_BELOW },
+    { 'y', NO_MARK, GRAVE }, { 'y', NO_MARK, DOT_BELOW }, { 'y', NO_MARK, HOOK }, { 'y', NO_MARK, TILDE },
+};
+
+// Rank offset of a marked letter from its base, -1 if the pair is not a letter
+int markOffset(char base, uint8_t mark) 
+{
+    switch (mark) 
+    {
+        case NO_MARK:
+            return 0;
+        case BREVE:
+            return base == 'a' ? 1 : -1;
+        case CIRCUMFLEX:
+            return base == 'a' ? 2 : (base == 'e' || base == 'o') ? 1 : -1;
+        case HORN:
+            return base == 'o' ? 2 : base == 'u' ? 1 : -1;
+        case STROKE:
+            return base == 'd' ? 1 : -1;
+        default:
+            return -1;
+    }
+}
+
+char letterWeight(const Letter& letter) 
+{
+    return static_cast<char>(LETTER_BASE + BASE_RANK[letter.base - 'a'] + markOffset(letter.base, letter.mark));
+}
+
+// Code point at text[i], moving i past it. A byte that does not start a
+// valid sequence is taken as the Latin-1 character of that value.
+uint32_t decode(std::string_view text, size_t& i) 
+{
+    static const uint32_t MIN_VALUE[] = { 0, 0, 0x80, 0x800, 0x10000 };
+    
+    unsigned char lead = static_cast<unsigned char>(text[i]);
+    size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x06 ? 2 : (lead >> 4) == 0x0E ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+    
+    if (length <= 1 || i + length > text.size()) 
+    {
+        i++;
+        return lead;
+    }
+    
+    uint32_t codePoint = lead & (0x7F >> length);
+    
+    for (size_t k = 1; k < length; ++k) 
+    {
+        unsigned char next = static_cast<unsigned char>(text[i + k]);
+        if ((next & 0xC0) != 0x80) 
+        {
+            i++;
+            return lead;
+        }
+        codePoint = (codePoint << 6) | (next & 0x3F);
+    }
+    
+    if (codePoint < MIN_VALUE[length] || codePoint > 0x10FFFF) 
+    {
+        i++;
+        return lead;
+    }
+    
+    i += length;
+    return codePoint;
+}
+
+bool toLetter(uint32_t codePoint, Letter& letter, bool& upper) 
+{
+    if ((codePoint >= 'a' && codePoint <= 'z') || (codePoint >= 'A' && codePoint <= 'Z')) 
+    {
+        upper = codePoint <= 'Z';
+        letter = { static_cast<char>(codePoint | 0x20), NO_MARK, NO_TONE };
+        return true;
+    }
+    
+    if (codePoint >= 0xC0 && codePoint <= 0xFF) 
+    {
+        upper = codePoint < 0xE0;
+        letter = LATIN1[codePoint & 0x1F];
+        return letter.base != 0;
+    }
+    
+    if (codePoint >= 0x1EA0 && codePoint <= 0x1EF9) 
+    {
+        upper = (codePoint & 1) == 0;
+        letter = VIETNAMESE[(codePoint - 0x1EA0) / 2];
+        return true;
+    }
+    
+    upper = (codePoint & 1) == 0;
+    
+    switch (codePoint) 
+    {
+        case 0x102:
+        case 0x103:
+            letter = { 'a', BREVE, NO_TONE };
+            return true;
+        case 0x110:
+        case 0x111:
+            letter = { 'd', STROKE, NO_TONE };
+            return true;
+        case 0x128:
+        case 0x129:
+            letter = { 'i', NO_MARK, TILDE };
+            return true;
+        case 0x168:
+        case 0x169:
+            letter = { 'u', NO_MARK, TILDE };
+            return true;
+        case 0x1A0:
+        case 0x1A1:
+            letter = { 'o', HORN, NO_TONE };
+            return true;
+        case 0x1AF:
+        case 0x1B0:
+            // Ư is the odd one of its pair
+            upper = codePoint == 0x1AF;
+            letter = { 'u', HORN, NO_TONE };
+            return true;
+        default:
+            return false;
+    }
+}
+
+void setTone(Letter& letter, uint8_t tone) 
+{
+    letter.tone = letter.tone == NO_TONE ? tone : static_cast<uint8_t>(OTHER_ACCENT);
+}
+
+void setMark(Letter& letter, uint8_t mark) 
+{
+    if (letter.mark == NO_MARK && markOffset(letter.base, mark) > 0) 
+    {
+        letter.mark = mark;
+    }
+    else 
+    {
+        setTone(letter, OTHER_ACCENT);
+    }
+}
+
+// Combining mark (U+0300..U+036F) following a letter, as in decomposed text
+void applyCombining(uint32_t codePoint, Letter& letter) 
+{
+    switch (codePoint) 
+    {
+        case 0x300:
+            setTone(letter, GRAVE);
+            break;
+        case 0x301:
+            setTone(letter, ACUTE);
+            break;
+        case 0x303:
+            setTone(letter, TILDE);
+            break;
+        case 0x309:
+            setTone(letter, HOOK);
+            break;
+        case 0x323:
+            setTone(letter, DOT_BELOW);
+            break;
+        case 0x302:
+            setMark(letter, CIRCUMFLEX);
+            break;
+        case 0x306:
+            setMark(letter, BREVE);
+            break;
+        case 0x31B:
+            setMark(letter, HORN);
+            break;
+        default:
+            setTone(letter, OTHER_ACCENT);
+            break;
+    }
+}
+
+void trimDefaults(std::string& level) 
+{
+    while (!level.empty() && static_cast<unsigned char>(level.back()) == DEFAULT_WEIGHT) 
+    {
+        level.pop_back();
+    }
+}
+
+} // namespace
+
+std::string Collation::key(std::string_view text) 
+{
+    // One byte per element on the secondary (tone) and tertiary (case) levels
+    std::string primary;
+    std::string secondary;
+    std::string tertiary;
+    primary.reserve(text.size() + 8);
+    secondary.reserve(text.size());
+    tertiary.reserve(text.size());
+    
+    Letter last = { 0, 0, 0 };
+    bool afterLetter = false;
+    size_t i = 0;
+    
+    while (i < text.size()) 
+    {
+        if (text[i] >= '0' && text[i] <= '9') 
+        {
+            size_t start = i;
+            while (i < text.size() && text[i] >= '0' && text[i] <= '9') 
+            {
+                i++;
+            }
+            
+            // Leading zeros do not count
+            while (start + 1 < i && text[start] == '0') 
+            {
+                start++;
+            }
+            size_t count = std::min(i - start, MAX_DIGITS);
+            
+            primary.push_back(static_cast<char>(DIGITS_LEAD));
+            primary.push_back(static_cast<char>(DEFAULT_WEIGHT + count));
+            primary.append(text.data() + start, count);
+            secondary.push_back(static_cast<char>(DEFAULT_WEIGHT));
+            tertiary.push_back(static_cast<char>(DEFAULT_WEIGHT));
+            afterLetter = false;
+            continue;
+        }
+        
+        uint32_t codePoint = decode(text, i);
+        Letter letter;
+        bool upper;
+        
+        if (toLetter(codePoint, letter, upper)) 
+        {
+            primary.push_back(letterWeight(letter));
+            secondary.push_back(static_cast<char>(DEFAULT_WEIGHT + letter.tone));
+            tertiary.push_back(static_cast<char>(upper ? UPPERCASE : DEFAULT_WEIGHT));
+            last = letter;
+            afterLetter = true;
+        }
+        else if (codePoint >= 0x300 && codePoint <= 0x36F) 
+        {
+            // Rewrites the element of the letter it belongs to
+            if (afterLetter) 
+            {
+                applyCombining(codePoint, last);
+                primary.back() = letterWeight(last);
+                secondary.back() = static_cast<char>(DEFAULT_WEIGHT + last.tone);
+            }
+        }
+        else if (codePoint < 0x80) 
+        {
+            // Control characters are ignored
+            if (codePoint >= 0x20 && codePoint != 0x7F) 
+            {
+                primary.push_back(static_cast<char>(SYMBOL_BASE + (codePoint - 0x20)));
+                secondary.push_back(static_cast<char>(DEFAULT_WEIGHT));
+                tertiary.push_back(static_cast<char>(DEFAULT_WEIGHT));
+            }
+            afterLetter = false;
+        }
+        else 
+        {
+            // 7 bits per byte, kept clear of the separator
+            primary.push_back(static_cast<char>(OTHER_LEAD));
+            primary.push_back(static_cast<char>(DEFAULT_WEIGHT + ((codePoint >> 14) & 0x7F)));
+            primary.push_back(static_cast<char>(DEFAULT_WEIGHT + ((codePoint >> 7) & 0x7F)));
+            primary.push_back(static_cast<char>(DEFAULT_WEIGHT + (codePoint & 0x7F)));
+            secondary.push_back(static_cast<char>(DEFAULT_WEIGHT));
+            tertiary.push_back(static_cast<char>(DEFAULT_WEIGHT));
+            afterLetter = false;
+        }
+    }
+    
+    // Equal primaries mean equally many elements, so trailing defaults can go:
+    // a missing byte already compares lowest
+    trimDefaults(secondary);
+    trimDefaults(tertiary);
+    
+    std::string key = std::move(primary);
+    
+    if (!secondary.empty() || !tertiary.empty()) 
+    {
+        key.push_back(static_cast<char>(LEVEL_SEPARATOR));
+        key += secondary;
+    }
+    if (!tertiary.empty()) 
+    {
+        key.push_back(static_cast<char>(LEVEL_SEPARATOR));
+        key += tertiary;
+    }
+    
+    return key;
+}
+
+std::string Collation::fold(std::string_view text) 
+{
+    std::string folded;
+    fold(text, folded);
+    return folded;
+}
+
+void Collation::fold(std::string_view text, std::string& out) 
+{
+    out.reserve(out.size() + text.size());
+    size_t i = 0;
+    
+    while (i < text.size()) 
+    {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        
+        if (c < 0x80) 
+        {
+            out.push_back(static_cast<char>(c >= 'A' && c <= 'Z' ? c | 0x20 : c));
+            i++;
+            continue;
+        }
+        
+        size_t start = i;
+        uint32_t codePoint = decode(text, i);
+        Letter letter;
+        bool upper;
+        
+        if (toLetter(codePoint, letter, upper)) 
+        {
+            out.push_back(letter.base);
+        }
+        else if (codePoint < 0x300 || codePoint > 0x36F) 
+        {
+            out.append(text.data() + start, i - start);
+        }
+    }
+}
+
+} // namespace models
+} // namespace media_player
@@ -77,6 +77,13 @@ void ExploreModel::clearPathStack()
 void ExploreModel::setCurrentFolders(const std::vector<FolderEntry>& folders) 
 {
     m_currentFolders = folders;
+    
+    m_folderNames.clear();
+    m_folderNames.reserve(m_currentFolders.size());
+    for (const auto& folder : m_currentFolders) 
+    {
+        m_folderNames.add(SearchIndex::normalize(folder.name));
+    }
 }
 
 const std::vector<FolderEntry>& ExploreModel::getCurrentFolders() const 
@@ -84,9 +91,15 @@ const std::vector<FolderEntry>& ExploreModel::getCurrentFolders() const
     return m_currentFolders;
 }
 
+const utils::TextArena& ExploreModel::getFolderNames() const 
+{
+    return m_folderNames;
+}
+
 void ExploreModel::setCurrentFiles(const std::vector<MediaFileModel>& files) 
 {
     m_currentFiles = files;
+    m_fileIndex.build(m_currentFiles);
 }
 
 const std::vector<MediaFileModel>& ExploreModel::getCurrentFiles() const 
@@ -94,6 +107,11 @@ const std::vector<MediaFileModel>& ExploreModel::getCurrentFiles() const
     return m_currentFiles;
 }
 
+const SearchIndex& ExploreModel::getFileIndex() const 
+{
+    return m_fileIndex;
+}
+
 const MediaFileModel* ExploreModel::getFileAt(size_t index) const 
 {
     if (index < m_currentFiles.size()) 
@@ -107,14 +125,17 @@ const MediaFileModel* ExploreModel::getFileAt(size_t index) const
 // All Media Cache
 // ============================================================================
 
-void ExploreModel::setAllMedia(const std::vector<MediaFileModel>& allMedia) 
+void ExploreModel::setAllMedia(MediaSnapshot allMedia) 
 {
-    m_allMedia = allMedia;
+    if (allMedia) 
+    {
+        m_allMedia = std::move(allMedia);
+    }
 }
 
 const std::vector<MediaFileModel>& ExploreModel::getAllMedia() const 
 {
-    return m_allMedia;
+    return *m_allMedia;
 }
 
 // ============================================================================
@@ -0,0 +1,526 @@
+// Project includes
+#include "models/FuzzySearch.h"
+
+// System includes
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+namespace media_player 
+{
+namespace models 
+{
+
+namespace 
+{
+
+// Bit set for each byte of text: letters and digits have one each, other
+// bytes share the rest
+uint64_t bytesOf(std::string_view text) 
+{
+    uint64_t bytes = 0;
+    for (char c : text) 
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        unsigned bit = byte >= 'a' && byte <= 'z' ? byte - 'a' :
+                       byte >= '0' && byte <= '9' ? 26 + (byte - '0') : 36 + byte % 28;
+        bytes |= uint64_t(1) << bit;
+    }
+    return bytes;
+}
+
+int popCount(uint64_t bits) 
+{
+    int count = 0;
+    for (; bits != 0; bits &= bits - 1) 
+    {
+        count++;
+    }
+    return count;
+}
+
+// Whether a ranks before b
+bool better(const FuzzyMatch& a, const FuzzyMatch& b) 
+{
+    return a.score > b.score || (a.score == b.score && a.position < b.position);
+}
+
+std::vector<std::string> splitTerms(const std::string& query) 
+{
+    std::vector<std::string> terms;
+    size_t start = 0;
+    
+    while (start < query.size()) 
+    {
+        size_t end = std::min(query.find(' ', start), query.size());
+        if (end > start) 
+        {
+            terms.push_back(query.substr(start, std::min(end - start, FuzzyPattern::MAX_LENGTH)));
+        }
+        start = end + 1;
+    }
+    
+    return terms;
+}
+
+// Play bonus by position, read along ascending positions
+class Bonuses 
+{
+public:
+    explicit Bonuses(const FuzzySearch::PlayCounts& plays) 
+    {
+        for (const auto& entry : plays) 
+        {
+            int32_t bonus = FuzzySearch::playBonus(entry.second);
+            if (bonus > 0) 
+            {
+                m_bonuses.push_back(FuzzyMatch{ entry.first, bonus });
+            }
+        }
+        std::sort(m_bonuses.begin(), m_bonuses.end(),
+                  [](const FuzzyMatch& a, const FuzzyMatch& b) { return a.position < b.position; });
+    }
+    
+    // cursor starts at 0; positions must not go down between calls
+    int32_t at(uint32_t position, size_t& cursor) const 
+    {
+        while (cursor < m_bonuses.size() && m_bonuses[cursor].position < position) 
+        {
+            cursor++;
+        }
+        return cursor < m_bonuses.size() && m_bonuses[cursor].position == position ? m_bonuses[cursor].score : 0;
+    }
+    
+private:
+    std::vector<FuzzyMatch> m_bonuses;
+};
+
+// Numbers the distinct words as they come, appending new ones to a buffer
+// of words back to back. Open addressing keeps the lookups, one or two per
+// word of the library, to a cache miss or so; a node based map is several
+// times slower here.
+class WordTable 
+{
+public:
+    WordTable(std::string& words, std::vector<uint32_t>& ends, size_t expected)
+        : m_words(words)
+        , m_ends(ends) 
+    {
+        size_t capacity = 1024;
+        while (capacity < expected * 2) 
+        {
+            capacity *= 2;
+        }
+        m_slots.assign(capacity, Slot{ EMPTY, 0 });
+    }
+    
+    // Number of word, which is added if new: the number of words so far
+    uint32_t find(std::string_view word) 
+    {
+        uint32_t hash = hashOf(word);
+        size_t mask = m_slots.size() - 1;
+        size_t i = hash & mask;
+        
+        for (; m_slots[i].word != EMPTY; i = (i + 1) & mask) 
+        {
+            if (m_slots[i].hash == hash && get(m_slots[i].word) == word) 
+            {
+                return m_slots[i].word;
+            }
+        }
+        
+        uint32_t number = static_cast<uint32_t>(m_ends.size() - 1);
+        m_words.append(word);
+        m_ends.push_back(static_cast<uint32_t>(m_words.size()));
+        m_slots[i] = Slot{ number, hash };
+        
+        if (m_ends.size() * 2 > m_slots.size()) 
+        {
+            grow();
+        }
+        return number;
+    }
+    
+private:
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+    
+    struct Slot 
+    {
+        uint32_t word;
+        uint32_t hash;
+    };
+    
+    // FNV-1a
+    static uint32_t hashOf(std::string_view word) 
+    {
+        uint32_t hash = 2166136261u;
+        for (char c : word) 
+        {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return hash;
+    }
+    
+    std::string_view get(uint32_t word) const 
+    {
+        return std::string_view(m_words.data() + m_ends[word], m_ends[word + 1] - m_ends[word]);
+    }
+    
+    void grow() 
+    {
+        std::vector<Slot> slots(m_slots.size() * 2, Slot{ EMPTY, 0 });
+        size_t mask = slots.size() - 1;
+        
+        for (const Slot& slot : m_slots) 
+        {
+            if (slot.word != EMPTY) 
+            {
+                size_t i = slot.hash & mask;
+                while (slots[i].word != EMPTY) 
+                {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = slot;
+            }
+        }
+        m_slots.swap(slots);
+    }
+    
+    std::string& m_words;
+    std::vector<uint32_t>& m_ends;
+    std::vector<Slot> m_slots;
+};
+
+} // namespace
+
+FuzzyPattern::FuzzyPattern(std::string_view text)
+    : m_last(0)
+    , m_length(std::min(text.size(), MAX_LENGTH)) 
+{
+    std::fill(std::begin(m_masks), std::end(m_masks), 0);
+    for (size_t i = 0; i < m_length; ++i) 
+    {
+        m_masks[static_cast<unsigned char>(text[i])] |= uint64_t(1) << i;
+    }
+    if (m_length > 0) 
+    {
+        m_last = uint64_t(1) << (m_length - 1);
+    }
+}
+
+int FuzzyPattern::search(std::string_view text, size_t& end) const 
+{
+    // Column of the edit distance table as vertical deltas: positive in vp,
+    // negative in vn. The top row stays 0 so a match may start anywhere.
+    uint64_t vp = ~uint64_t(0);
+    uint64_t vn = 0;
+    int score = static_cast<int>(m_length);
+    int best = score;
+    end = 0;
+    
+    for (size_t j = 0; j < text.size() && best > 0; ++j) 
+    {
+        uint64_t eq = m_masks[static_cast<unsigned char>(text[j])];
+        uint64_t xv = eq | vn;
+        uint64_t xh = (((eq & vp) + vp) ^ vp) | eq;
+        uint64_t hp = vn | ~(xh | vp);
+        uint64_t hn = vp & xh;
+        
+        if (hp & m_last) 
+        {
+            score++;
+        }
+        else if (hn & m_last) 
+        {
+            score--;
+        }
+        
+        hp <<= 1;
+        hn <<= 1;
+        vp = hn | ~(xv | hp);
+        vn = hp & xv;
+        
+        if (score < best) 
+        {
+            best = score;
+            end = j + 1;
+        }
+    }
+    
+    return best;
+}
+
+int FuzzySearch::maxDistance(size_t termLength) 
+{
+    return termLength < 4 ? 0 : termLength < 7 ? 1 : 2;
+}
+
+int32_t FuzzySearch::playBonus(uint32_t plays) 
+{
+    int32_t doublings = 0;
+    for (; plays > 0; plays >>= 1) 
+    {
+        doublings++;
+    }
+    return PLAY_BONUS * doublings;
+}
+
+std::string_view FuzzyFields::getField(size_t position, size_t field) const 
+{
+    size_t slot = position * SearchIndex::FIELD_COUNT + field;
+    size_t start = slot == 0 ? 0 : ends[slot - 1] + 1;
+    return std::string_view(text).substr(start, ends[slot] - start);
+}
+
+FuzzyResult FuzzySearch::search(const SearchIndex& index, const std::string& query, SearchFieldMask fields,
+                                const PlayCounts& plays, size_t limit, const FuzzyResult* previous) 
+{
+    if (!hasWords(index.getVersion())) 
+    {
+        gather(index);
+    }
+    return search(query, fields, plays, limit, previous);
+}
+
+FuzzyResult FuzzySearch::search(const std::string& query, SearchFieldMask fields, const PlayCounts& plays,
+                                size_t limit, const FuzzyResult* previous) 
+{
+    FuzzyResult result;
+    result.query = SearchIndex::normalize(query);
+    result.fields = fields;
+    result.version = m_version;
+    
+    std::vector<std::string> terms = splitTerms(result.query);
+    if (terms.empty() || fields == 0 || limit == 0) 
+    {
+        return result;
+    }
+    
+    // Word numbers hold while the index does; hits also need the same fields
+    bool sameWords = previous && previous->version == result.version;
+    bool sameHits = sameWords && previous->fields == fields;
+    size_t reused = 0;
+    
+    while (sameHits && reused < terms.size() && reused < previous->terms.size() &&
+           previous->terms[reused].text == terms[reused]) 
+    {
+        result.terms.push_back(previous->terms[reused]);
+        reused++;
+    }
+    
+    for (size_t t = reused; t < terms.size(); ++t) 
+    {
+        // A term can only match words it matched with fewer bytes, as long
+        // as it is allowed no more edits
+        const std::vector<uint32_t>* words = nullptr;
+        if (sameWords && t < previous->terms.size()) 
+        {
+            const std::string& before = previous->terms[t].text;
+            if (terms[t].compare(0, before.size(), before) == 0 &&
+                maxDistance(terms[t].size()) == maxDistance(before.size())) 
+            {
+                words = previous->terms[t].words.get();
+            }
+        }
+        
+        auto matched = std::make_shared<std::vector<uint32_t>>(scoreTerm(terms[t], fields, words));
+        auto hits = std::make_shared<std::vector<FuzzyMatch>>();
+        
+        if (t == 0) 
+        {
+            for (uint32_t position = 0; position < m_scores.size(); ++position) 
+            {
+                if (m_scores[position] != NO_SCORE) 
+                {
+                    hits->push_back(FuzzyMatch{ position, m_scores[position] });
+                }
+            }
+        }
+        else 
+        {
+            for (const auto& hit : *result.terms[t - 1].hits) 
+            {
+                if (m_scores[hit.position] != NO_SCORE) 
+                {
+                    hits->push_back(FuzzyMatch{ hit.position, hit.score + m_scores[hit.position] });
+                }
+            }
+        }
+        
+        result.terms.push_back(FuzzyTerm{ terms[t], std::move(matched), std::move(hits) });
+    }
+    
+    // The worst of the best `limit` so far sits on top of the heap, so most
+    // records are turned away by a single comparison
+    const std::vector<FuzzyMatch>& hits = *result.terms.back().hits;
+    Bonuses bonuses(plays);
+    size_t bonusCursor = 0;
+    
+    result.matches.reserve(std::min(limit, hits.size()));
+    for (const auto& hit : hits) 
+    {
+        FuzzyMatch match{ hit.position, hit.score + bonuses.at(hit.position, bonusCursor) };
+        if (result.matches.size() < limit) 
+        {
+            result.matches.push_back(match);
+            std::push_heap(result.matches.begin(), result.matches.end(), better);
+        }
+        else if (better(match, result.matches.front())) 
+        {
+            std::pop_heap(result.matches.begin(), result.matches.end(), better);
+            result.matches.back() = match;
+            std::push_heap(result.matches.begin(), result.matches.end(), better);
+        }
+    }
+    std::sort_heap(result.matches.begin(), result.matches.end(), better);
+    
+    return result;
+}
+
+FuzzyFields FuzzySearch::copyFields(const SearchIndex& index) 
+{
+    FuzzyFields copy;
+    copy.version = index.getVersion();
+    index.copyText(copy.text, copy.ends);
+    
+    return copy;
+}
+
+void FuzzySearch::gatherWords(const FuzzyFields& fields) 
+{
+    gather(fields);
+}
+
+template<typename Fields>
+void FuzzySearch::gather(const Fields& index) 
+{
+    m_version = index.getVersion();
+    m_words.clear();
+    m_wordEnds.assign(1, 0);
+    m_wordBytes.clear();
+    m_scores.assign(index.size(), NO_SCORE);
+    
+    WordTable numbers(m_words, m_wordEnds, index.size());
+    std::vector<std::pair<uint32_t, Occurrence>> found;
+    found.reserve(index.size() * SearchIndex::FIELD_COUNT * 2);
+    
+    // Neighbouring records often share an artist or album, whose words are
+    // then taken again from the record before instead of looked up
+    std::string_view lastText[SearchIndex::FIELD_COUNT];
+    size_t lastFirst[SearchIndex::FIELD_COUNT] = {};
+    size_t lastEnd[SearchIndex::FIELD_COUNT] = {};
+    
+    for (uint32_t position = 0; position < index.size(); ++position) 
+    {
+        for (size_t f = 0; f < SearchIndex::FIELD_COUNT; ++f) 
+        {
+            std::string_view text = index.getField(position, f);
+            size_t first = found.size();
+            
+            if (position > 0 && text == lastText[f]) 
+            {
+                for (size_t i = lastFirst[f]; i < lastEnd[f]; ++i) 
+                {
+                    std::pair<uint32_t, Occurrence> entry = found[i];
+                    entry.second.position = position;
+                    found.push_back(entry);
+                }
+                lastFirst[f] = first;
+                lastEnd[f] = found.size();
+                continue;
+            }
+            lastText[f] = text;
+            lastFirst[f] = first;
+            
+            size_t start = 0;
+            while (start < text.size()) 
+            {
+                size_t end = std::min(text.find(' ', start), text.size());
+                if (end > start) 
+                {
+                    std::string_view word = text.substr(start, end - start);
+                    size_t count = m_wordBytes.size();
+                    uint32_t number = numbers.find(word);
+                    if (number == count) 
+                    {
+                        m_wordBytes.push_back(bytesOf(word));
+                    }
+                    
+                    Occurrence occurrence{ position, static_cast<uint8_t>(f),
+                                           static_cast<uint8_t>(std::min<size_t>(start, MAX_OFFSET_PENALTY)) };
+                    found.emplace_back(number, occurrence);
+                }
+                start = end + 1;
+            }
+            lastEnd[f] = found.size();
+        }
+    }
+    
+    // Counting sort by word, which leaves each word's positions ascending
+    m_occurrenceEnds.assign(m_wordBytes.size() + 1, 0);
+    for (const auto& entry : found) 
+    {
+        m_occurrenceEnds[entry.first + 1]++;
+    }
+    std::partial_sum(m_occurrenceEnds.begin(), m_occurrenceEnds.end(), m_occurrenceEnds.begin());
+    
+    std::vector<uint32_t> next(m_occurrenceEnds.begin(), m_occurrenceEnds.end() - 1);
+    m_occurrences.resize(found.size());
+    for (const auto& entry : found) 
+    {
+        m_occurrences[next[entry.first]++] = entry.second;
+    }
+}
+
+std::vector<uint32_t> FuzzySearch::scoreTerm(const std::string& term, SearchFieldMask fields,
+                                             const std::vector<uint32_t>* words) 
+{
+    FuzzyPattern pattern(term);
+    int limit = maxDistance(term.size());
+    uint64_t termBytes = bytesOf(term);
+    std::vector<uint32_t> matched;
+    
+    std::fill(m_scores.begin(), m_scores.end(), NO_SCORE);
+    
+    uint32_t count = words ? static_cast<uint32_t>(words->size()) : static_cast<uint32_t>(m_wordEnds.size() - 1);
+    for (uint32_t i = 0; i < count; ++i) 
+    {
+        uint32_t word = words ? (*words)[i] : i;
+        std::string_view text = getWord(word);
+        
+        // Each byte the word is short of the term costs an edit, and so does
+        // each byte of the term the word lacks
+        if (text.size() + static_cast<size_t>(limit) < pattern.size() ||
+            popCount(termBytes & ~m_wordBytes[word]) > limit) 
+        {
+            continue;
+        }
+        
+        size_t end;
+        int distance = pattern.search(text, end);
+        if (distance > limit) 
+        {
+            continue;
+        }
+        matched.push_back(word);
+        
+        size_t start = end > pattern.size() ? end - pattern.size() : 0;
+        for (uint32_t o = m_occurrenceEnds[word]; o < m_occurrenceEnds[word + 1]; ++o) 
+        {
+            const Occurrence& occurrence = m_occurrences[o];
+            if (!(fields & (1u << occurrence.field))) 
+            {
+                continue;
+            }
+            
+            int32_t score = FIELD_WEIGHT[occurrence.field] - EDIT_PENALTY * distance -
+                            static_cast<int32_t>(std::min<size_t>(occurrence.offset + start, MAX_OFFSET_PENALTY));
+            m_scores[occurrence.position] = std::max(m_scores[occurrence.position], score);
+        }
+    }
+    
+    return matched;
+}
+
+} // namespace models
+} // namespace media_player
@@ -46,7 +46,7 @@ void HistoryModel::addEntry(const MediaFileModel& media)
     std::lock_guard<std::mutex> lock(m_mutex);
     
     // Thêm vào đầu deque (most recent first)
-    m_history.push_front(HistoryEntry(media));
+    m_history.push_front(PlayedEntry{ MediaCatalog::getShared()->intern(media), std::chrono::system_clock::now() });
     
     // Giữ số lượng trong giới hạn maxEntries
     while (m_history.size() > m_maxEntries) 
@@ -60,10 +60,11 @@ bool HistoryModel::removeMostRecentEntry(const std::string& filePath)
     std::lock_guard<std::mutex> lock(m_mutex);
     
     // Tìm entry đầu tiên (most recent) khớp với filePath
+    MediaId id = MediaId::fromPath(filePath);
     auto it = std::find_if(m_history.begin(), m_history.end(),
-        [&filePath](const HistoryEntry& entry) 
+        [id, &filePath](const PlayedEntry& entry) 
         {
-            return entry.media.getFilePath() == filePath;
+            return entry.media.refersTo(id, filePath);
         }
     );
     
@@ -83,10 +84,11 @@ size_t HistoryModel::removeAllEntries(const std::string& filePath)
     size_t originalSize = m_history.size();
     
     // Remove tất cả entries có filePath khớp
+    MediaId id = MediaId::fromPath(filePath);
     auto newEnd = std::remove_if(m_history.begin(), m_history.end(),
-        [&filePath](const HistoryEntry& entry) 
+        [id, &filePath](const PlayedEntry& entry) 
         {
-            return entry.media.getFilePath() == filePath;
+            return entry.media.refersTo(id, filePath);
         }
     );
     
@@ -116,7 +118,7 @@ std::vector<HistoryEntry> HistoryModel::getRecentHistory(size_t count) const
     
     for (size_t i = 0; i < actualCount; ++i) 
     {
-        result.push_back(m_history[i]);
+        result.push_back(m_history[i].toEntry());
     }
     
     return result;
@@ -125,7 +127,16 @@ std::vector<HistoryEntry> HistoryModel::getRecentHistory(size_t count) const
 std::vector<HistoryEntry> HistoryModel::getAllHistory() const 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    return std::vector<HistoryEntry>(m_history.begin(), m_history.end());
+    
+    std::vector<HistoryEntry> result;
+    result.reserve(m_history.size());
+    
+    for (const auto& entry : m_history) 
+    {
+        result.push_back(entry.toEntry());
+    }
+    
+    return result;
 }
 
 std::optional<HistoryEntry> HistoryModel::getEntryAt(size_t index) const 
@@ -137,7 +148,7 @@ std::optional<HistoryEntry> HistoryModel::getEntryAt(size_t index) const
         return std::nullopt;
     }
     
-    return m_history[index];
+    return m_history[index].toEntry();
 }
 
 std::optional<HistoryEntry> HistoryModel::getLastPlayed() const 
@@ -149,7 +160,7 @@ std::optional<HistoryEntry> HistoryModel::getLastPlayed() const
         return std::nullopt;
     }
     
-    return m_history.front();
+    return m_history.front().toEntry();
 }
 
 std::optional<HistoryEntry> HistoryModel::getPreviousPlayed() const 
@@ -161,7 +172,7 @@ std::optional<HistoryEntry> HistoryModel::getPreviousPlayed() const
         return std::nullopt;
     }
     
-    return m_history[1];
+    return m_history[1].toEntry();
 }
 
 bool HistoryModel::wasRecentlyPlayed(const std::string& filePath, int withinMinutes) const 
@@ -170,10 +181,11 @@ bool HistoryModel::wasRecentlyPlayed(const std::string& filePath, int withinMinu
     
     auto now = std::chrono::system_clock::now();
     auto threshold = now - std::chrono::minutes(withinMinutes);
+    MediaId id = MediaId::fromPath(filePath);
     
     for (const auto& entry : m_history) 
     {
-        if (entry.media.getFilePath() == filePath && entry.playedAt >= threshold) 
+        if (entry.media.refersTo(id, filePath) && entry.playedAt >= threshold) 
         {
             return true;
         }
@@ -182,6 +194,19 @@ bool HistoryModel::wasRecentlyPlayed(const std::string& filePath, int withinMinu
     return false;
 }
 
+std::unordered_map<MediaId, uint32_t> HistoryModel::getPlayCounts() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::unordered_map<MediaId, uint32_t> counts;
+    for (const auto& entry : m_history) 
+    {
+        counts[entry.media.getId()]++;
+    }
+    
+    return counts;
+}
+
 // ============================================================================
 // State Queries
 // ============================================================================
@@ -220,9 +245,10 @@ bool HistoryModel::loadFromRepository()
     auto repoHistory = m_repository->getAllHistory();
     m_history.clear();
     
+    auto catalog = MediaCatalog::getShared();
     for (const auto& repoEntry : repoHistory) 
     {
-        m_history.push_back(HistoryEntry(repoEntry.media, repoEntry.playedAt));
+        m_history.push_back(PlayedEntry{ catalog->intern(repoEntry.media), repoEntry.playedAt });
     }
     
     return true;
@@ -247,7 +273,7 @@ bool HistoryModel::saveToRepository()
         std::lock_guard<std::mutex> lock(m_mutex);
         for (const auto& entry : m_history)
         {
-            repositories::PlaybackHistoryEntry repoEntry(entry.media);
+            repositories::PlaybackHistoryEntry repoEntry(entry.media.materialize());
             repoEntry.playedAt = entry.playedAt;
             entries.push_back(repoEntry);
         }
@@ -9,118 +9,667 @@ namespace media_player
 namespace models 
 {
 
-void LibraryModel::addMedia(const MediaFileModel& media) 
+LibraryModel::LibraryModel()
+    : m_state(std::make_shared<const State>(State{ std::make_shared<const std::vector<MediaFileModel>>(), {} })) 
+{
+}
+
+std::shared_ptr<const LibraryModel::State> LibraryModel::getState() const 
+{
+    return std::atomic_load(&m_state);
+}
+
+MediaSnapshot LibraryModel::getSnapshot() const 
+{
+    return getState()->media;
+}
+
+void LibraryModel::publish(std::vector<MediaFileModel> mediaList, PathIndex positions, const IndexEdit& edit) 
+{
+    auto media = std::make_shared<const std::vector<MediaFileModel>>(std::move(mediaList));
+    auto state = std::make_shared<const State>(State{ media, std::move(positions) });
+    
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    if (edit) 
+    {
+        edit(m_searchIndex, m_sortIndex, *media);
+    }
+    std::atomic_store(&m_state, std::shared_ptr<const State>(std::move(state)));
+}
+
+LibraryModel::PathIndex LibraryModel::buildIndex(const std::vector<MediaFileModel>& mediaList) 
 {
-    // Check if already exists
-    for (const auto& item : m_mediaList) 
+    PathIndex positions;
+    positions.reserve(mediaList.size());
+    
+    for (size_t i = 0; i < mediaList.size(); ++i) 
     {
-        if (item.getFilePath() == media.getFilePath()) 
+        positions.emplace(MediaId::fromPath(mediaList[i].getFilePath()), static_cast<uint32_t>(i));
+    }
+    
+    return positions;
+}
+
+size_t LibraryModel::findPosition(const State& state, const std::string& filePath) 
+{
+    return findPosition(state.positions, *state.media, filePath);
+}
+
+size_t LibraryModel::findPosition(const PathIndex& positions, const std::vector<MediaFileModel>& mediaList,
+                                  const std::string& filePath) 
+{
+    // Paths sharing an id each have an entry; the path tells them apart
+    auto range = positions.equal_range(MediaId::fromPath(filePath));
+    
+    for (auto it = range.first; it != range.second; ++it) 
+    {
+        if (mediaList[it->second].getFilePath() == filePath) 
         {
-            return;
+            return it->second;
         }
     }
     
-    m_mediaList.push_back(media);
+    return npos;
+}
+
+void LibraryModel::addMedia(const MediaFileModel& media) 
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getState();
+    
+    if (findPosition(*current, media.getFilePath()) != npos) 
+    {
+        return;
+    }
+    
+    std::vector<MediaFileModel> next;
+    next.reserve(current->media->size() + 1);
+    next.insert(next.end(), current->media->begin(), current->media->end());
+    
+    PathIndex positions = current->positions;
+    positions.emplace(MediaId::fromPath(media.getFilePath()), static_cast<uint32_t>(next.size()));
+    next.push_back(media);
+    
+    publish(std::move(next), std::move(positions),
+        [](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+        {
+            search.append(list.back());
+            sort.append(list, list.size() - 1);
+        });
 }
 
 void LibraryModel::addMediaBatch(const std::vector<MediaFileModel>& mediaList) 
 {
+    addMediaBatch(std::vector<MediaFileModel>(mediaList));
+}
+
+void LibraryModel::addMediaBatch(std::vector<MediaFileModel>&& mediaList) 
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getState();
+    
+    // The published list is shared with readers and is copied; the batch is moved in
+    std::vector<MediaFileModel> next;
+    next.reserve(current->media->size() + mediaList.size());
+    next.insert(next.end(), current->media->begin(), current->media->end());
+    
+    PathIndex positions = current->positions;
+    positions.reserve(next.size() + mediaList.size());
+    
+    for (auto& media : mediaList) 
+    {
+        if (findPosition(positions, next, media.getFilePath()) == npos) 
+        {
+            positions.emplace(MediaId::fromPath(media.getFilePath()), static_cast<uint32_t>(next.size()));
+            next.push_back(std::move(media));
+        }
+    }
+    
+    size_t firstAdded = current->media->size();
+    
+    if (next.size() != firstAdded) 
+    {
+        publish(std::move(next), std::move(positions),
+            [firstAdded](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+            {
+                for (size_t i = firstAdded; i < list.size(); ++i) 
+                {
+                    search.append(list[i]);
+                }
+                sort.append(list, firstAdded);
+            });
+    }
+}
+
+void LibraryModel::replaceAll(const std::vector<MediaFileModel>& mediaList) 
+{
+    dropStaged();
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    
+    std::vector<MediaFileModel> next;
+    next.reserve(mediaList.size());
+    
+    PathIndex positions;
+    positions.reserve(mediaList.size());
+    
     for (const auto& media : mediaList) 
     {
-        addMedia(media);
+        if (findPosition(positions, next, media.getFilePath()) == npos) 
+        {
+            positions.emplace(MediaId::fromPath(media.getFilePath()), static_cast<uint32_t>(next.size()));
+            next.push_back(media);
+        }
     }
+    
+    publish(std::move(next), std::move(positions),
+        [](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+        {
+            search.build(list);
+            sort.build(list);
+        });
+}
+
+void LibraryModel::setSnapshot(MediaSnapshot snapshot) 
+{
+    if (!snapshot) 
+    {
+        snapshot = std::make_shared<const std::vector<MediaFileModel>>();
+    }
+    
+    // The list is shared as is; only the index is built here
+    PathIndex positions = buildIndex(*snapshot);
+    
+    dropStaged();
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    std::lock_guard<std::mutex> indexLock(m_indexMutex);
+    m_searchIndex.build(*snapshot);
+    m_sortIndex.build(*snapshot);
+    std::atomic_store(&m_state, std::shared_ptr<const State>(std::make_shared<const State>(State{ std::move(snapshot), std::move(positions) })));
 }
 
 bool LibraryModel::removeMedia(const std::string& filePath) 
 {
-    auto it = std::find_if(m_mediaList.begin(), m_mediaList.end(),
-        [&filePath](const MediaFileModel& item) {
-            return item.getFilePath() == filePath;
-        });
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getState();
+    
+    size_t position = findPosition(*current, filePath);
     
-    if (it != m_mediaList.end()) 
+    if (position == npos) 
     {
-        m_mediaList.erase(it);
-        return true;
+        return false;
     }
     
-    return false;
+    const auto& media = *current->media;
+    auto it = media.begin() + static_cast<std::ptrdiff_t>(position);
+    
+    std::vector<MediaFileModel> next;
+    next.reserve(media.size() - 1);
+    next.insert(next.end(), media.begin(), it);
+    next.insert(next.end(), it + 1, media.end());
+    
+    // Entries after the hole move up by one
+    PathIndex positions = current->positions;
+    auto range = positions.equal_range(MediaId::fromPath(filePath));
+    positions.erase(std::find_if(range.first, range.second,
+        [position](const PathIndex::value_type& entry) { return entry.second == position; }));
+    for (auto& entry : positions) 
+    {
+        if (entry.second > position) 
+        {
+            entry.second--;
+        }
+    }
+    
+    publish(std::move(next), std::move(positions),
+        [position](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+        {
+            search.erase(position);
+            sort.erase(list, { static_cast<uint32_t>(position) });
+        });
+    
+    return true;
 }
 
+size_t LibraryModel::removeMediaUnder(const std::string& dirPath) 
+{
+    std::string prefix = dirPath;
+    if (!prefix.empty() && prefix.back() != '/') 
+    {
+        prefix += '/';
+    }
+    
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getState();
+    
+    std::vector<MediaFileModel> next;
+    next.reserve(current->media->size());
+    std::vector<uint32_t> removedPositions;
+    
+    for (size_t i = 0; i < current->media->size(); ++i) 
+    {
+        const auto& item = (*current->media)[i];
+        
+        if (item.getFilePath().compare(0, prefix.size(), prefix) != 0) 
+        {
+            next.push_back(item);
+        }
+        else 
+        {
+            removedPositions.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    
+    size_t removed = removedPositions.size();
+    
+    if (removed > 0) 
+    {
+        PathIndex positions = buildIndex(next);
+        publish(std::move(next), std::move(positions),
+            [&removedPositions](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+            {
+                search.erase(removedPositions);
+                sort.erase(list, removedPositions);
+            });
+    }
+    
+    return removed;
+}
 
 void LibraryModel::clear() 
 {
-    m_mediaList.clear();
+    dropStaged();
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    publish({}, {}, [](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+    {
+        search.clear();
+        sort.build(list);
+    });
 }
 
 bool LibraryModel::updateMedia(const std::string& filePath, const MediaFileModel& updatedMedia) 
 {
-    auto it = std::find_if(m_mediaList.begin(), m_mediaList.end(),
-        [&filePath](const MediaFileModel& item) {
-            return item.getFilePath() == filePath;
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getState();
+    
+    size_t position = findPosition(*current, filePath);
+    
+    if (position == npos) 
+    {
+        return false;
+    }
+    
+    std::vector<MediaFileModel> next = *current->media;
+    next[position] = updatedMedia;
+    
+    // A changed path reindexes; otherwise positions stay as they are
+    PathIndex positions = updatedMedia.getFilePath() == filePath ? current->positions : buildIndex(next);
+    
+    publish(std::move(next), std::move(positions),
+        [position](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+        {
+            search.assign(position, list[position]);
+            sort.assign(list, position);
+        });
+    
+    return true;
+}
+
+size_t LibraryModel::applyChanges(const std::vector<LibraryEdit>& edits) 
+{
+    return applyChanges(std::vector<LibraryEdit>(edits));
+}
+
+size_t LibraryModel::applyChanges(std::vector<LibraryEdit>&& edits) 
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getState();
+    size_t firstAdded = current->media->size();
+    
+    std::vector<MediaFileModel> next;
+    PathIndex positions;
+    std::vector<bool> removed;
+    std::vector<bool> changed;
+    bool copied = false;
+    size_t applied = 0;
+    
+    // Copied once, on the first edit
+    auto prepare = [&]() 
+    {
+        if (!copied) 
+        {
+            copied = true;
+            next = *current->media;
+            positions = current->positions;
+            removed.assign(next.size(), false);
+            changed.assign(next.size(), false);
+        }
+    };
+    
+    for (auto& edit : edits) 
+    {
+        switch (edit.type) 
+        {
+            case LibraryEdit::Type::PUT: 
+            {
+                if (!edit.media) 
+                {
+                    break;
+                }
+                prepare();
+                
+                size_t position = findPosition(positions, next, edit.media->getFilePath());
+                if (position == npos) 
+                {
+                    positions.emplace(MediaId::fromPath(edit.media->getFilePath()), static_cast<uint32_t>(next.size()));
+                    next.push_back(std::move(*edit.media));
+                    removed.push_back(false);
+                    changed.push_back(true);
+                }
+                else 
+                {
+                    // Removed earlier in the batch: it comes back in place
+                    next[position] = std::move(*edit.media);
+                    removed[position] = false;
+                    changed[position] = true;
+                }
+                applied++;
+                break;
+            }
+            
+            case LibraryEdit::Type::REMOVE: 
+            {
+                prepare();
+                size_t position = findPosition(positions, next, edit.path);
+                if (position != npos && !removed[position]) 
+                {
+                    removed[position] = true;
+                    applied++;
+                }
+                break;
+            }
+            
+            case LibraryEdit::Type::REMOVE_UNDER: 
+            {
+                std::string prefix = edit.path;
+                if (!prefix.empty() && prefix.back() != '/') 
+                {
+                    prefix += '/';
+                }
+                
+                prepare();
+                for (size_t i = 0; i < next.size(); ++i) 
+                {
+                    if (!removed[i] && next[i].getFilePath().compare(0, prefix.size(), prefix) == 0) 
+                    {
+                        removed[i] = true;
+                        applied++;
+                    }
+                }
+                break;
+            }
+        }
+    }
+    
+    if (applied == 0) 
+    {
+        return 0;
+    }
+    
+    // Records removed from the published list, and the ones put that stay
+    std::vector<uint32_t> erased;
+    std::vector<uint32_t> assigned;
+    std::vector<MediaFileModel> kept;
+    kept.reserve(next.size());
+    
+    for (size_t i = 0; i < next.size(); ++i) 
+    {
+        if (removed[i]) 
+        {
+            if (i < firstAdded) 
+            {
+                erased.push_back(static_cast<uint32_t>(i));
+            }
+            continue;
+        }
+        if (i < firstAdded && changed[i]) 
+        {
+            assigned.push_back(static_cast<uint32_t>(kept.size()));
+        }
+        kept.push_back(std::move(next[i]));
+    }
+    
+    // Positions shift only after a removal
+    if (kept.size() != next.size()) 
+    {
+        positions = buildIndex(kept);
+    }
+    size_t firstKeptAdded = firstAdded - erased.size();
+    
+    publish(std::move(kept), std::move(positions),
+        [&erased, &assigned, firstKeptAdded](SearchIndex& search, SortIndex& sort, const std::vector<MediaFileModel>& list) 
+        {
+            if (!erased.empty()) 
+            {
+                search.erase(erased);
+                sort.erase(list, erased);
+            }
+            for (uint32_t position : assigned) 
+            {
+                search.assign(position, list[position]);
+                sort.assign(list, position);
+            }
+            for (size_t i = firstKeptAdded; i < list.size(); ++i) 
+            {
+                search.append(list[i]);
+            }
+            if (firstKeptAdded < list.size()) 
+            {
+                sort.append(list, firstKeptAdded);
+            }
         });
     
-    if (it != m_mediaList.end()) 
+    return applied;
+}
+
+size_t LibraryModel::stageChanges(std::vector<LibraryEdit>&& edits) 
+{
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+    
+    m_staged.insert(m_staged.end(), std::make_move_iterator(edits.begin()), std::make_move_iterator(edits.end()));
+    
+    // The published list grows by half or more with every publish, so the
+    // copies it costs add up to a small multiple of the final size
+    if (m_staged.size() < getSnapshot()->size() / 2) 
     {
-        *it = updatedMedia;
-        return true;
+        return 0;
     }
     
-    return false;
+    std::vector<LibraryEdit> staged;
+    staged.swap(m_staged);
+    return applyChanges(std::move(staged));
 }
 
-std::optional<MediaFileModel> LibraryModel::getMediaByPath(const std::string& filePath) const 
+size_t LibraryModel::publishStaged() 
+{
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+    
+    std::vector<LibraryEdit> staged;
+    staged.swap(m_staged);
+    return applyChanges(std::move(staged));
+}
+
+size_t LibraryModel::getStagedCount() const 
+{
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+    return m_staged.size();
+}
+
+void LibraryModel::dropStaged() 
 {
-    for (const auto& media : m_mediaList) 
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+    m_staged.clear();
+}
+
+size_t LibraryModel::markStale(const std::vector<std::string>& missingPaths) 
+{
+    std::lock_guard<std::mutex> lock(m_writeMutex);
+    auto current = getState();
+    
+    std::vector<MediaFileModel> next;
+    size_t marked = 0;
+    
+    for (const auto& filePath : missingPaths) 
     {
-        if (media.getFilePath() == filePath) 
+        size_t position = findPosition(*current, filePath);
+        
+        if (position == npos || (*current->media)[position].isStale()) 
+        {
+            continue;
+        }
+        
+        // Copied on the first hit only; nothing is published if nothing changed
+        if (next.empty()) 
         {
-            return media;
+            next = *current->media;
         }
+        next[position].setStale(true);
+        marked++;
+    }
+    
+    if (marked > 0) 
+    {
+        // Paths are unchanged, so the index carries over
+        publish(std::move(next), current->positions);
+    }
+    
+    return marked;
+}
+
+std::optional<MediaFileModel> LibraryModel::getMediaByPath(const std::string& filePath) const 
+{
+    auto current = getState();
+    size_t position = findPosition(*current, filePath);
+    
+    if (position != npos) 
+    {
+        return (*current->media)[position];
     }
     return std::nullopt;
 }
 
+bool LibraryModel::contains(const std::string& filePath) const 
+{
+    return findPosition(*getState(), filePath) != npos;
+}
+
+size_t LibraryModel::getStaleCount() const 
+{
+    auto media = getSnapshot();
+    return static_cast<size_t>(std::count_if(media->begin(), media->end(),
+        [](const MediaFileModel& item) { return item.isStale(); }));
+}
+
 std::vector<MediaFileModel> LibraryModel::search(const std::string& query) const 
 {
+    LibrarySearch found = search(query, SearchField::FILE_NAME);
+    
     std::vector<MediaFileModel> results;
+    results.reserve(found.result.positions.size());
+    
+    for (uint32_t position : found.result.positions) 
+    {
+        results.push_back((*found.media)[position]);
+    }
+    
+    return results;
+}
+
+LibrarySearch LibraryModel::search(const std::string& query, SearchFieldMask fields,
+                                   const LibrarySearch* previous, std::optional<SortCriteria> sortBy) const 
+{
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    
+    LibrarySearch found;
+    found.media = getSnapshot();
+    found.result = m_searchIndex.search(query, fields, previous ? &previous->result : nullptr);
+    if (sortBy) 
+    {
+        found.order = m_sortIndex.getOrder(*sortBy, *found.media);
+    }
+    return found;
+}
+
+LibraryFuzzySearch LibraryModel::fuzzySearch(const std::string& query, SearchFieldMask fields,
+                                             const std::unordered_map<MediaId, uint32_t>& playCounts,
+                                             size_t limit, const LibraryFuzzySearch* previous) const 
+{
+    std::lock_guard<std::mutex> fuzzyLock(m_fuzzyMutex);
+    
+    // The index is held only to copy its fields after a change; gathering
+    // the words and scoring leave it to search() and publish()
+    std::shared_ptr<const State> state;
+    std::optional<FuzzyFields> copied;
+    {
+        std::lock_guard<std::mutex> lock(m_indexMutex);
+        state = getState();
+        if (!m_fuzzySearch.hasWords(m_searchIndex.getVersion())) 
+        {
+            copied = FuzzySearch::copyFields(m_searchIndex);
+        }
+    }
+    if (copied) 
+    {
+        m_fuzzySearch.gatherWords(*copied);
+    }
+    
+    FuzzySearch::PlayCounts plays;
     
-    for (const auto& media : m_mediaList) 
+    for (const auto& entry : playCounts) 
     {
-        if (matchesQuery(media, query)) 
+        auto range = state->positions.equal_range(entry.first);
+        for (auto it = range.first; it != range.second; ++it) 
         {
-            results.push_back(media);
+            plays.emplace(it->second, entry.second);
         }
     }
     
-    return results;
+    LibraryFuzzySearch found;
+    found.media = state->media;
+    found.result = m_fuzzySearch.search(query, fields, plays, limit, previous ? &previous->result : nullptr);
+    return found;
+}
+
+LibraryOrder LibraryModel::getSortOrder(SortCriteria criteria) const 
+{
+    std::lock_guard<std::mutex> lock(m_indexMutex);
+    
+    LibraryOrder order;
+    order.media = getSnapshot();
+    order.positions = m_sortIndex.getOrder(criteria, *order.media);
+    return order;
 }
 
 std::vector<MediaFileModel> LibraryModel::getSorted(SortCriteria criteria, bool ascending) const 
 {
-    std::vector<MediaFileModel> sorted = m_mediaList;
+    LibraryOrder order = getSortOrder(criteria);
     
-    auto comparator = [criteria, ascending](const MediaFileModel& a, const MediaFileModel& b) -> bool {
-        bool result = false;
-        
-        switch (criteria) 
+    std::vector<MediaFileModel> sorted;
+    sorted.reserve(order.positions->size());
+    
+    if (ascending) 
+    {
+        for (uint32_t position : *order.positions) 
         {
-            case SortCriteria::TITLE:
-            case SortCriteria::FILE_NAME:
-                result = a.getFileName() < b.getFileName();
-                break;
-            case SortCriteria::ARTIST:
-            case SortCriteria::ALBUM:
-            case SortCriteria::DATE_ADDED:
-            default:
-                result = a.getFileName() < b.getFileName();
-                break;
+            sorted.push_back((*order.media)[position]);
         }
-        
-        return ascending ? result : !result;
-    };
-    
-    std::sort(sorted.begin(), sorted.end(), comparator);
+    }
+    else 
+    {
+        for (auto it = order.positions->rbegin(); it != order.positions->rend(); ++it) 
+        {
+            sorted.push_back((*order.media)[*it]);
+        }
+    }
     
     return sorted;
 }
@@ -128,19 +677,20 @@ std::vector<MediaFileModel> LibraryModel::getSorted(SortCriteria criteria, bool
 std::vector<MediaFileModel> LibraryModel::getPage(size_t pageNumber, size_t itemsPerPage) const 
 {
     std::vector<MediaFileModel> page;
+    MediaSnapshot snapshot = getSnapshot();
     
     size_t startIndex = pageNumber * itemsPerPage;
     
-    if (startIndex >= m_mediaList.size()) 
+    if (startIndex >= snapshot->size()) 
     {
         return page;
     }
     
-    size_t endIndex = std::min(startIndex + itemsPerPage, m_mediaList.size());
+    size_t endIndex = std::min(startIndex + itemsPerPage, snapshot->size());
     
     for (size_t i = startIndex; i < endIndex; i++) 
     {
-        page.push_back(m_mediaList[i]);
+        page.push_back((*snapshot)[i]);
     }
     
     return page;
@@ -149,7 +699,7 @@ std::vector<MediaFileModel> LibraryModel::getPage(size_t pageNumber, size_t item
 int LibraryModel::getTotalAudioFiles() const 
 {
     int count = 0;
-    for (const auto& media : m_mediaList) 
+    for (const auto& media : *getSnapshot()) 
     {
         if (media.isAudio()) 
         {
@@ -162,7 +712,7 @@ int LibraryModel::getTotalAudioFiles() const
 int LibraryModel::getTotalVideoFiles() const 
 {
     int count = 0;
-    for (const auto& media : m_mediaList) 
+    for (const auto& media : *getSnapshot()) 
     {
         if (media.isVideo()) 
         {
@@ -175,23 +725,12 @@ int LibraryModel::getTotalVideoFiles() const
 long long LibraryModel::getTotalSize() const 
 {
     long long totalSize = 0;
-    for (const auto& media : m_mediaList) 
+    for (const auto& media : *getSnapshot()) 
     {
         totalSize += media.getFileSize();
     }
     return totalSize;
 }
 
-bool LibraryModel::matchesQuery(const MediaFileModel& media, const std::string& query) const 
-{
-    std::string lowerQuery = query;
-    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
-    
-    std::string lowerFileName = media.getFileName();
-    std::transform(lowerFileName.begin(), lowerFileName.end(), lowerFileName.begin(), ::tolower);
-    
-    return lowerFileName.find(lowerQuery) != std::string::npos;
-}
-
 } // namespace models
 } // namespace media_player
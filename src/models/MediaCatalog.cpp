@@ -0,0 +1,179 @@
+// Project includes
+#include "models/MediaCatalog.h"
+
+// System includes
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+namespace media_player 
+{
+namespace models 
+{
+
+namespace 
+{
+
+const std::string EMPTY_PATH;
+
+} // namespace
+
+std::shared_ptr<const MediaFileModel> MediaHandle::get() const 
+{
+    if (!m_slot) 
+    {
+        return nullptr;
+    }
+    return std::atomic_load(&m_slot->record);
+}
+
+MediaFileModel MediaHandle::materialize() const 
+{
+    auto record = get();
+    return record ? *record : MediaFileModel();
+}
+
+const std::string& MediaHandle::getFilePath() const 
+{
+    return m_slot ? m_slot->origin->getFilePath() : EMPTY_PATH;
+}
+
+std::shared_ptr<MediaCatalog> MediaCatalog::getShared() 
+{
+    static std::shared_ptr<MediaCatalog> instance = std::make_shared<MediaCatalog>();
+    return instance;
+}
+
+MediaHandle MediaCatalog::intern(const MediaFileModel& media) 
+{
+    MediaId id = MediaId::fromPath(media.getFilePath());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::shared_ptr<Slot> slot = findSlot(id, media.getFilePath());
+    
+    if (slot) 
+    {
+        const MediaFileModel& held = *slot->record;
+        
+        if (media.getLastModified() > held.getLastModified() || (held.isStale() && !media.isStale())) 
+        {
+            std::atomic_store(&slot->record, std::make_shared<const MediaFileModel>(media));
+        }
+        return MediaHandle(std::move(slot));
+    }
+    
+    slot = std::make_shared<Slot>();
+    slot->origin = std::make_shared<const MediaFileModel>(media);
+    slot->record = slot->origin;
+    slot->id = id;
+    
+    pruneIfDue();
+    m_slots.emplace(id, slot);
+    return MediaHandle(std::move(slot));
+}
+
+bool MediaCatalog::update(const MediaFileModel& media) 
+{
+    MediaId id = MediaId::fromPath(media.getFilePath());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::shared_ptr<Slot> slot = findSlot(id, media.getFilePath());
+    
+    if (!slot) 
+    {
+        return false;
+    }
+    
+    std::atomic_store(&slot->record, std::make_shared<const MediaFileModel>(media));
+    return true;
+}
+
+size_t MediaCatalog::markStale(const std::vector<std::string>& missingPaths) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t marked = 0;
+    
+    for (const auto& filePath : missingPaths) 
+    {
+        std::shared_ptr<Slot> slot = findSlot(MediaId::fromPath(filePath), filePath);
+        
+        if (!slot || slot->record->isStale()) 
+        {
+            continue;
+        }
+        
+        auto record = std::make_shared<MediaFileModel>(*slot->record);
+        record->setStale(true);
+        std::atomic_store(&slot->record, std::shared_ptr<const MediaFileModel>(std::move(record)));
+        marked++;
+    }
+    
+    return marked;
+}
+
+MediaHandle MediaCatalog::find(const std::string& filePath) const 
+{
+    MediaId id = MediaId::fromPath(filePath);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    return MediaHandle(findSlot(id, filePath));
+}
+
+std::vector<std::string> MediaCatalog::getFilePaths() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> paths;
+    
+    for (const auto& entry : m_slots) 
+    {
+        if (auto slot = entry.second.lock()) 
+        {
+            paths.push_back(slot->origin->getFilePath());
+        }
+    }
+    
+    return paths;
+}
+
+size_t MediaCatalog::size() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    return static_cast<size_t>(std::count_if(m_slots.begin(), m_slots.end(),
+        [](const auto& entry) { return !entry.second.expired(); }));
+}
+
+std::shared_ptr<MediaCatalog::Slot> MediaCatalog::findSlot(MediaId id, const std::string& filePath) const 
+{
+    auto range = m_slots.equal_range(id);
+    
+    for (auto it = range.first; it != range.second; ++it) 
+    {
+        std::shared_ptr<Slot> slot = it->second.lock();
+        
+        if (slot && slot->origin->getFilePath() == filePath) 
+        {
+            return slot;
+        }
+    }
+    
+    return nullptr;
+}
+
+void MediaCatalog::pruneIfDue() 
+{
+    if (m_slots.size() < m_pruneAt) 
+    {
+        return;
+    }
+    
+    for (auto it = m_slots.begin(); it != m_slots.end(); ) 
+    {
+        it = it->second.expired() ? m_slots.erase(it) : std::next(it);
+    }
+    
+    m_pruneAt = std::max<size_t>(64, m_slots.size() * 2);
+}
+
+} // namespace models
+} // namespace media_player
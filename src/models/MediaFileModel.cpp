@@ -14,16 +14,30 @@ namespace models
 {
 
 MediaFileModel::MediaFileModel()
-    : m_type(MediaType::UNKNOWN)
-    , m_fileSize(0)
+    : m_fileSize(0)
+    , m_artist(&utils::StringPool::empty())
+    , m_album(&utils::StringPool::empty())
+    , m_fileNameOffset(0)
+    , m_extensionOffset(0)
+    , m_type(MediaType::UNKNOWN)
 {
 }
 
 MediaFileModel::MediaFileModel(const std::string& filePath)
-    : m_filePath(filePath)
-    , m_type(MediaType::UNKNOWN)
-    , m_fileSize(0)
+    : MediaFileModel()
 {
+    m_filePath = filePath;
+    extractFileInfo();
+    m_type = determineMediaType();
+}
+
+MediaFileModel::MediaFileModel(const std::string& filePath, size_t fileSize, 
+                               fs::file_time_type lastModified)
+    : MediaFileModel()
+{
+    m_filePath = filePath;
+    m_fileSize = fileSize;
+    m_lastModified = lastModified;
     extractFileInfo();
     m_type = determineMediaType();
 }
@@ -37,7 +51,7 @@ bool MediaFileModel::isValid() const
 
 bool MediaFileModel::operator<(const MediaFileModel& other) const 
 {
-    return m_fileName < other.m_fileName;
+    return getFileName() < other.getFileName();
 }
 
 bool MediaFileModel::operator==(const MediaFileModel& other) const 
@@ -48,8 +62,8 @@ bool MediaFileModel::operator==(const MediaFileModel& other) const
 std::string MediaFileModel::serialize() const 
 {
     return m_filePath + "|" + 
-           m_fileName + "|" + 
-           m_extension + "|" + 
+           std::string(getFileName()) + "|" + 
+           std::string(getExtension()) + "|" + 
            std::to_string(static_cast<int>(m_type)) + "|" + 
            std::to_string(m_fileSize);
 }
@@ -72,31 +86,21 @@ MediaFileModel MediaFileModel::deserialize(const std::string& data)
 
 void MediaFileModel::extractFileInfo() 
 {
-    if (m_filePath.empty()) 
-    {
-        return;
-    }
+    // Same split as fs::path::filename()/extension(), without building a path:
+    // libraries load 100k models at startup
+    size_t slash = m_filePath.find_last_of('/');
+    size_t nameStart = slash == std::string::npos ? 0 : slash + 1;
+    std::string_view fileName = std::string_view(m_filePath).substr(nameStart);
     
-    try 
-    {
-        fs::path path(m_filePath);
-        
-        m_fileName = path.filename().string();
-        m_extension = path.extension().string();
-        
-        // Keep extension case-sensitive for specific checks (like .WAV vs .wav)
-        // std::transform(m_extension.begin(), m_extension.end(), 
-        //               m_extension.begin(), ::tolower);
-        
-        if (fs::exists(path)) 
-        {
-            m_fileSize = fs::file_size(path);
-            m_lastModified = fs::last_write_time(path);
-        }
-    }
-    catch (const fs::filesystem_error& e) 
-    {
-    }
+    size_t dot = fileName.find_last_of('.');
+    bool hasExtension = dot != std::string_view::npos && dot != 0 && fileName != "..";
+    
+    m_fileNameOffset = static_cast<uint32_t>(nameStart);
+    m_extensionOffset = static_cast<uint32_t>(hasExtension ? nameStart + dot : m_filePath.size());
+    
+    // Keep extension case-sensitive for specific checks (like .WAV vs .wav)
+    // std::transform(m_extension.begin(), m_extension.end(), 
+    //               m_extension.begin(), ::tolower);
 }
 
 MediaType MediaFileModel::determineMediaType() const 
@@ -107,7 +111,9 @@ MediaType MediaFileModel::determineMediaType() const
     bool hasLetters = false;
     bool allUpper = true;
     
-    for (char c : m_extension) {
+    std::string_view extension = getExtension();
+    
+    for (char c : extension) {
         if (std::isalpha(c)) {
             hasLetters = true;
             if (!std::isupper(c)) {
@@ -122,7 +128,7 @@ MediaType MediaFileModel::determineMediaType() const
         return MediaType::UNSUPPORTED;
     }
 
-    std::string lowerExt = m_extension;
+    std::string lowerExt(extension);
     std::transform(lowerExt.begin(), lowerExt.end(), lowerExt.begin(), ::tolower);
 
     // Check against audio extensions
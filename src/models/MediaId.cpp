@@ -0,0 +1,154 @@
+// Project includes
+#include "models/MediaId.h"
+
+namespace media_player 
+{
+namespace models 
+{
+
+namespace 
+{
+
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+const std::string ID_PREFIX = "media_";
+
+uint64_t rotl(uint64_t value, int bits) 
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Little-endian whatever the host is, so ids do not depend on it
+uint64_t read64(const unsigned char* p) 
+{
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) 
+    {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+uint64_t read32(const unsigned char* p) 
+{
+    return static_cast<uint64_t>(p[0]) | (static_cast<uint64_t>(p[1]) << 8) |
+           (static_cast<uint64_t>(p[2]) << 16) | (static_cast<uint64_t>(p[3]) << 24);
+}
+
+uint64_t mixRound(uint64_t acc, uint64_t input) 
+{
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+uint64_t mergeRound(uint64_t acc, uint64_t value) 
+{
+    acc ^= mixRound(0, value);
+    return acc * PRIME1 + PRIME4;
+}
+
+} // namespace
+
+MediaId MediaId::fromPath(const char* data, size_t length) 
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = p + length;
+    uint64_t h;
+    
+    if (length >= 32) 
+    {
+        uint64_t v1 = PRIME1 + PRIME2;
+        uint64_t v2 = PRIME2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - PRIME1;
+        
+        for (const unsigned char* limit = end - 32; p <= limit; p += 32) 
+        {
+            v1 = mixRound(v1, read64(p));
+            v2 = mixRound(v2, read64(p + 8));
+            v3 = mixRound(v3, read64(p + 16));
+            v4 = mixRound(v4, read64(p + 24));
+        }
+        
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    }
+    else 
+    {
+        h = PRIME5;
+    }
+    
+    h += static_cast<uint64_t>(length);
+    
+    for (; p + 8 <= end; p += 8) 
+    {
+        h ^= mixRound(0, read64(p));
+        h = rotl(h, 27) * PRIME1 + PRIME4;
+    }
+    
+    if (p + 4 <= end) 
+    {
+        h ^= read32(p) * PRIME1;
+        h = rotl(h, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    
+    for (; p < end; ++p) 
+    {
+        h ^= static_cast<uint64_t>(*p) * PRIME5;
+        h = rotl(h, 11) * PRIME1;
+    }
+    
+    // Avalanche
+    h ^= h >> 33;
+    h *= PRIME2;
+    h ^= h >> 29;
+    h *= PRIME3;
+    h ^= h >> 32;
+    
+    return MediaId(h);
+}
+
+std::string MediaId::toString() const 
+{
+    return ID_PREFIX + std::to_string(m_value);
+}
+
+std::optional<MediaId> MediaId::parse(const std::string& text) 
+{
+    if (text.size() <= ID_PREFIX.size() || text.compare(0, ID_PREFIX.size(), ID_PREFIX) != 0) 
+    {
+        return std::nullopt;
+    }
+    
+    uint64_t value = 0;
+    
+    for (size_t i = ID_PREFIX.size(); i < text.size(); ++i) 
+    {
+        if (text[i] < '0' || text[i] > '9') 
+        {
+            return std::nullopt;
+        }
+        
+        // No value past UINT64_MAX
+        uint64_t digit = static_cast<uint64_t>(text[i] - '0');
+        if (value > (UINT64_MAX - digit) / 10) 
+        {
+            return std::nullopt;
+        }
+        value = value * 10 + digit;
+    }
+    
+    return MediaId(value);
+}
+
+} // namespace models
+} // namespace media_player
@@ -26,6 +26,11 @@ int PlaylistModel::getTotalDuration() const
 }
 
 void PlaylistModel::addItem(const MediaFileModel& media) 
+{
+    addItem(MediaCatalog::getShared()->intern(media));
+}
+
+void PlaylistModel::addItem(const MediaHandle& media) 
 {
     m_items.push_back(media);
     m_modifiedAt = std::chrono::system_clock::now();
@@ -45,9 +50,10 @@ bool PlaylistModel::removeItem(size_t index)
 
 bool PlaylistModel::removeItem(const std::string& filePath) 
 {
+    MediaId id = MediaId::fromPath(filePath);
     auto it = std::find_if(m_items.begin(), m_items.end(),
-        [&filePath](const MediaFileModel& item) {
-            return item.getFilePath() == filePath;
+        [id, &filePath](const MediaHandle& item) {
+            return item.refersTo(id, filePath);
         });
     
     if (it != m_items.end()) 
@@ -66,13 +72,26 @@ void PlaylistModel::clear()
     m_modifiedAt = std::chrono::system_clock::now();
 }
 
+std::vector<MediaFileModel> PlaylistModel::getItems() const 
+{
+    std::vector<MediaFileModel> items;
+    items.reserve(m_items.size());
+    
+    for (const auto& item : m_items) 
+    {
+        items.push_back(item.materialize());
+    }
+    
+    return items;
+}
+
 std::optional<MediaFileModel> PlaylistModel::getItemAt(size_t index) const 
 {
     if (index >= m_items.size()) 
     {
         return std::nullopt;
     }
-    return m_items[index];
+    return m_items[index].materialize();
 }
 
 bool PlaylistModel::moveItem(size_t fromIndex, size_t toIndex) 
@@ -82,7 +101,7 @@ bool PlaylistModel::moveItem(size_t fromIndex, size_t toIndex)
         return false;
     }
     
-    MediaFileModel item = m_items[fromIndex];
+    MediaHandle item = m_items[fromIndex];
     m_items.erase(m_items.begin() + fromIndex);
     m_items.insert(m_items.begin() + toIndex, item);
     m_modifiedAt = std::chrono::system_clock::now();
@@ -97,9 +116,11 @@ bool PlaylistModel::containsFile(const std::string& filePath) const
 
 int PlaylistModel::findItemIndex(const std::string& filePath) const 
 {
+    MediaId id = MediaId::fromPath(filePath);
+    
     for (size_t i = 0; i < m_items.size(); i++) 
     {
-        if (m_items[i].getFilePath() == filePath) 
+        if (m_items[i].refersTo(id, filePath)) 
         {
             return static_cast<int>(i);
         }
@@ -144,7 +165,7 @@ PlaylistModel PlaylistModel::deserialize(const std::string& data)
         if (!token.empty()) 
         {
             MediaFileModel media(token);
-            if (media.isValid()) 
+            if (media.getType() != MediaType::UNKNOWN) 
             {
                 playlist.addItem(media);
             }
@@ -13,6 +13,21 @@ namespace models
 {
 
 void QueueModel::addToEnd(const MediaFileModel& media) 
+{
+    addToEnd(MediaCatalog::getShared()->intern(media));
+}
+
+void QueueModel::addNext(const MediaFileModel& media) 
+{
+    addNext(MediaCatalog::getShared()->intern(media));
+}
+
+void QueueModel::addAt(const MediaFileModel& media, size_t position) 
+{
+    addAt(MediaCatalog::getShared()->intern(media), position);
+}
+
+void QueueModel::addToEnd(const MediaHandle& media) 
 {
     m_items.push_back(media);
     if (m_shuffleEnabled) 
@@ -21,7 +36,7 @@ void QueueModel::addToEnd(const MediaFileModel& media)
     }
 }
 
-void QueueModel::addNext(const MediaFileModel& media) 
+void QueueModel::addNext(const MediaHandle& media) 
 {
     if (m_items.empty()) 
     {
@@ -37,7 +52,7 @@ void QueueModel::addNext(const MediaFileModel& media)
     }
 }
 
-void QueueModel::addAt(const MediaFileModel& media, size_t position) 
+void QueueModel::addAt(const MediaHandle& media, size_t position) 
 {
     if (position >= m_items.size()) 
     {
@@ -82,9 +97,10 @@ bool QueueModel::removeAt(size_t index)
 
 bool QueueModel::removeByPath(const std::string& filePath) 
 {
+    MediaId id = MediaId::fromPath(filePath);
     auto it = std::find_if(m_items.begin(), m_items.end(),
-        [&filePath](const MediaFileModel& item) {
-            return item.getFilePath() == filePath;
+        [id, &filePath](const MediaHandle& item) {
+            return item.refersTo(id, filePath);
         });
     
     if (it != m_items.end()) 
@@ -111,7 +127,7 @@ std::optional<MediaFileModel> QueueModel::getCurrentItem() const
     }
     
     size_t actualIndex = getActualIndex(m_currentIndex);
-    return m_items[actualIndex];
+    return m_items[actualIndex].materialize();
 }
 
 std::optional<MediaFileModel> QueueModel::getNextItem() const 
@@ -136,7 +152,7 @@ std::optional<MediaFileModel> QueueModel::getNextItem() const
     }
     
     size_t actualIndex = getActualIndex(nextIndex);
-    return m_items[actualIndex];
+    return m_items[actualIndex].materialize();
 }
 
 std::optional<MediaFileModel> QueueModel::getPreviousItem() const 
@@ -151,13 +167,13 @@ std::optional<MediaFileModel> QueueModel::getPreviousItem() const
         if (m_repeatMode == RepeatMode::LoopAll) 
         {
             size_t actualIndex = getActualIndex(m_items.size() - 1);
-            return m_items[actualIndex];
+            return m_items[actualIndex].materialize();
         }
         return std::nullopt;
     }
     
     size_t actualIndex = getActualIndex(m_currentIndex - 1);
-    return m_items[actualIndex];
+    return m_items[actualIndex].materialize();
 }
 
 std::optional<MediaFileModel> QueueModel::getItemAt(size_t index) const 
@@ -166,17 +182,26 @@ std::optional<MediaFileModel> QueueModel::getItemAt(size_t index) const
     {
         return std::nullopt;
     }
-    return m_items[index];
+    return m_items[index].materialize();
+}
+
+std::vector<MediaFileModel> QueueModel::getAllItems() const
+{
+    std::vector<MediaFileModel> out;
+    out.reserve(m_items.size());
+    for (const auto& item : m_items)
+        out.push_back(item.materialize());
+    return out;
 }
 
 std::vector<MediaFileModel> QueueModel::getItemsInPlaybackOrder() const
 {
     if (m_items.empty()) return {};
-    if (!m_shuffleEnabled) return m_items;
+    if (!m_shuffleEnabled) return getAllItems();
     std::vector<MediaFileModel> out;
     out.reserve(m_items.size());
     for (size_t i = 0; i < m_items.size(); ++i)
-        out.push_back(m_items[getActualIndex(i)]);
+        out.push_back(m_items[getActualIndex(i)].materialize());
     return out;
 }
 
@@ -260,6 +285,15 @@ bool QueueModel::hasPrevious() const
     return m_currentIndex > 0;
 }
 
+bool QueueModel::contains(const std::string& filePath) const 
+{
+    MediaId id = MediaId::fromPath(filePath);
+    return std::any_of(m_items.begin(), m_items.end(),
+        [id, &filePath](const MediaHandle& item) {
+            return item.refersTo(id, filePath);
+        });
+}
+
 bool QueueModel::moveItem(size_t fromIndex, size_t toIndex) 
 {
     if (fromIndex >= m_items.size() || toIndex >= m_items.size()) 
@@ -267,7 +301,7 @@ bool QueueModel::moveItem(size_t fromIndex, size_t toIndex)
         return false;
     }
     
-    MediaFileModel item = m_items[fromIndex];
+    MediaHandle item = m_items[fromIndex];
     m_items.erase(m_items.begin() + fromIndex);
     m_items.insert(m_items.begin() + toIndex, item);
     
@@ -0,0 +1,427 @@
+// Project includes
+#include "models/SearchIndex.h"
+#include "models/Collation.h"
+#include "utils/TextSearch.h"
+
+// System includes
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+
+namespace media_player 
+{
+namespace models 
+{
+
+namespace 
+{
+
+// Postings are rebuilt once stale entries outnumber live ones by this much
+constexpr size_t MIN_STALE_ENTRIES = 4096;
+
+std::atomic<uint64_t> g_nextVersion(1);
+
+uint32_t trigramAt(const char* text) 
+{
+    return (static_cast<uint32_t>(static_cast<unsigned char>(text[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(text[1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(text[2]));
+}
+
+} // namespace
+
+SearchIndex::SearchIndex()
+    : m_postedCount(0)
+    , m_liveCount(0)
+    , m_version(0) 
+{
+    touch();
+}
+
+std::string SearchIndex::normalize(const std::string& text) 
+{
+    return Collation::fold(text);
+}
+
+void SearchIndex::clear() 
+{
+    m_text.clear();
+    m_documents.clear();
+    m_order.clear();
+    m_postings.clear();
+    m_postedCount = 0;
+    m_liveCount = 0;
+    touch();
+}
+
+void SearchIndex::reserve(size_t count) 
+{
+    m_text.reserve(count);
+    m_documents.reserve(count);
+    m_order.reserve(count);
+}
+
+void SearchIndex::build(const std::vector<MediaFileModel>& mediaList) 
+{
+    clear();
+    reserve(mediaList.size());
+    
+    for (const auto& media : mediaList) 
+    {
+        m_order.push_back(allocate(media, static_cast<uint32_t>(m_order.size())));
+    }
+    
+    touch();
+}
+
+void SearchIndex::append(const MediaFileModel& media) 
+{
+    m_order.push_back(allocate(media, static_cast<uint32_t>(m_order.size())));
+    touch();
+}
+
+void SearchIndex::assign(size_t position, const MediaFileModel& media) 
+{
+    uint32_t id = m_order[position];
+    
+    m_liveCount -= m_documents[id].trigramCount;
+    m_text.assign(id, textOf(media, m_documents[id].ends));
+    post(id);
+    
+    touch();
+    rebuildPostingsIfStale();
+}
+
+void SearchIndex::erase(size_t position) 
+{
+    release(m_order[position]);
+    m_order.erase(m_order.begin() + static_cast<std::ptrdiff_t>(position));
+    
+    for (size_t i = position; i < m_order.size(); ++i) 
+    {
+        m_documents[m_order[i]].position = static_cast<uint32_t>(i);
+    }
+    
+    touch();
+    rebuildPostingsIfStale();
+}
+
+void SearchIndex::erase(const std::vector<uint32_t>& positions) 
+{
+    if (positions.empty()) 
+    {
+        return;
+    }
+    
+    size_t next = 0;
+    size_t kept = positions.front();
+    
+    for (size_t i = positions.front(); i < m_order.size(); ++i) 
+    {
+        if (next < positions.size() && positions[next] == i) 
+        {
+            release(m_order[i]);
+            next++;
+            continue;
+        }
+        
+        m_order[kept] = m_order[i];
+        m_documents[m_order[kept]].position = static_cast<uint32_t>(kept);
+        kept++;
+    }
+    
+    m_order.resize(kept);
+    
+    touch();
+    rebuildPostingsIfStale();
+}
+
+void SearchIndex::eraseSwap(size_t position) 
+{
+    release(m_order[position]);
+    
+    if (position + 1 != m_order.size()) 
+    {
+        m_order[position] = m_order.back();
+        m_documents[m_order[position]].position = static_cast<uint32_t>(position);
+    }
+    m_order.pop_back();
+    
+    touch();
+    rebuildPostingsIfStale();
+}
+
+SearchResult SearchIndex::search(const std::string& query, SearchFieldMask fields,
+                                 const SearchResult* previous) const 
+{
+    SearchResult result;
+    result.query = normalize(query);
+    result.fields = fields;
+    result.version = m_version;
+    
+    if (fields == 0) 
+    {
+        return result;
+    }
+    
+    if (result.query.empty()) 
+    {
+        result.positions.resize(m_order.size());
+        for (size_t i = 0; i < m_order.size(); ++i) 
+        {
+            result.positions[i] = static_cast<uint32_t>(i);
+        }
+        return result;
+    }
+    
+    // One more character typed: only the previous matches can still match
+    bool narrowable = previous && previous->version == m_version && previous->fields == fields &&
+                      result.query.find(previous->query) != std::string::npos;
+    
+    if (narrowable && previous->query.size() == result.query.size()) 
+    {
+        result.positions = previous->positions;
+        return result;
+    }
+    
+    // Otherwise candidates come from the rarest trigram of the query
+    const Postings* rarest = nullptr;
+    
+    for (size_t i = 0; i + 3 <= result.query.size(); ++i) 
+    {
+        auto it = m_postings.find(trigramAt(result.query.data() + i));
+        
+        if (it == m_postings.end()) 
+        {
+            return result;
+        }
+        if (!rarest || it->second.size() < rarest->size()) 
+        {
+            rarest = &it->second;
+        }
+    }
+    
+    // Whichever of the two is smaller gets checked
+    if (narrowable && (!rarest || previous->positions.size() <= rarest->size())) 
+    {
+        for (uint32_t position : previous->positions) 
+        {
+            if (matches(m_order[position], result.query, fields)) 
+            {
+                result.positions.push_back(position);
+            }
+        }
+        return result;
+    }
+    
+    // Too short for a trigram: one pass over all the text
+    if (!rarest) 
+    {
+        m_text.scan(result.query, [&](uint32_t id, size_t offset) 
+        {
+            const Document& document = m_documents[id];
+            size_t f = 0;
+            while (offset >= document.ends[f]) 
+            {
+                f++;
+            }
+            
+            if (fields & (1u << f)) 
+            {
+                result.positions.push_back(document.position);
+                return true;
+            }
+            return false;
+        });
+        
+        // The arena is in write order, not position order
+        std::sort(result.positions.begin(), result.positions.end());
+        return result;
+    }
+    
+    for (uint32_t entry : *rarest) 
+    {
+        if ((entry & fields) == 0) 
+        {
+            continue;
+        }
+        
+        uint32_t id = entry >> FIELD_BITS;
+        const Document& document = m_documents[id];
+        
+        if (document.position != FREE && matches(id, result.query, fields)) 
+        {
+            result.positions.push_back(document.position);
+        }
+    }
+    
+    // Stale entries can repeat a document
+    std::sort(result.positions.begin(), result.positions.end());
+    result.positions.erase(std::unique(result.positions.begin(), result.positions.end()), result.positions.end());
+    
+    return result;
+}
+
+std::string_view SearchIndex::getField(size_t position, size_t field) const 
+{
+    uint32_t id = m_order[position];
+    const Document& document = m_documents[id];
+    uint32_t start = field == 0 ? 0 : document.ends[field - 1] + 1;
+    
+    return m_text.get(id).substr(start, document.ends[field] - start);
+}
+
+void SearchIndex::copyText(std::string& text, std::vector<uint32_t>& ends) const 
+{
+    size_t total = 0;
+    for (uint32_t id : m_order) 
+    {
+        total += m_text.get(id).size();
+    }
+    
+    text.clear();
+    text.reserve(total);
+    ends.clear();
+    ends.reserve(m_order.size() * FIELD_COUNT);
+    
+    for (uint32_t id : m_order) 
+    {
+        uint32_t start = static_cast<uint32_t>(text.size());
+        text.append(m_text.get(id));
+        for (uint32_t end : m_documents[id].ends) 
+        {
+            ends.push_back(start + end);
+        }
+    }
+}
+
+uint32_t SearchIndex::allocate(const MediaFileModel& media, uint32_t position) 
+{
+    uint32_t ends[FIELD_COUNT];
+    uint32_t id = m_text.add(textOf(media, ends));
+    
+    if (id == m_documents.size()) 
+    {
+        m_documents.emplace_back();
+    }
+    
+    Document& document = m_documents[id];
+    std::copy(ends, ends + FIELD_COUNT, document.ends);
+    document.position = position;
+    post(id);
+    
+    return id;
+}
+
+void SearchIndex::release(uint32_t id) 
+{
+    Document& document = m_documents[id];
+    
+    m_liveCount -= document.trigramCount;
+    document.position = FREE;
+    document.trigramCount = 0;
+    
+    m_text.remove(id);
+}
+
+std::string SearchIndex::textOf(const MediaFileModel& media, uint32_t (&ends)[FIELD_COUNT]) 
+{
+    std::string_view title = media.getTitle().empty() ? media.getFileName() : std::string_view(media.getTitle());
+    const std::string_view fields[FIELD_COUNT] = { title, media.getArtist(), media.getAlbum(), media.getFileName() };
+    
+    // Folding changes lengths, so each field is folded on its own
+    std::string text;
+    for (size_t f = 0; f < FIELD_COUNT; ++f) 
+    {
+        Collation::fold(fields[f], text);
+        ends[f] = static_cast<uint32_t>(text.size());
+        text.push_back('\0');
+    }
+    
+    return text;
+}
+
+void SearchIndex::post(uint32_t id) 
+{
+    Document& document = m_documents[id];
+    std::string_view text = m_text.get(id);
+    
+    // Trigram in the upper bits, field bit in the lower ones
+    std::vector<uint32_t> keys;
+    uint32_t start = 0;
+    
+    for (size_t f = 0; f < FIELD_COUNT; ++f) 
+    {
+        for (uint32_t i = start; i + 3 <= document.ends[f]; ++i) 
+        {
+            keys.push_back((trigramAt(text.data() + i) << FIELD_BITS) | (1u << f));
+        }
+        start = document.ends[f] + 1;
+    }
+    
+    std::sort(keys.begin(), keys.end());
+    
+    uint32_t count = 0;
+    
+    for (size_t i = 0; i < keys.size(); ) 
+    {
+        uint32_t trigram = keys[i] >> FIELD_BITS;
+        uint32_t mask = 0;
+        
+        for (; i < keys.size() && (keys[i] >> FIELD_BITS) == trigram; ++i) 
+        {
+            mask |= keys[i] & ((1u << FIELD_BITS) - 1);
+        }
+        
+        m_postings[trigram].push_back((id << FIELD_BITS) | mask);
+        count++;
+    }
+    
+    document.trigramCount = count;
+    m_postedCount += count;
+    m_liveCount += count;
+}
+
+void SearchIndex::rebuildPostingsIfStale() 
+{
+    if (m_postedCount <= 2 * m_liveCount + MIN_STALE_ENTRIES) 
+    {
+        return;
+    }
+    
+    m_postings.clear();
+    m_postedCount = 0;
+    m_liveCount = 0;
+    
+    for (uint32_t id : m_order) 
+    {
+        post(id);
+    }
+}
+
+void SearchIndex::touch() 
+{
+    m_version = g_nextVersion++;
+}
+
+bool SearchIndex::matches(uint32_t id, const std::string& query, SearchFieldMask fields) const 
+{
+    const Document& document = m_documents[id];
+    std::string_view text = m_text.get(id);
+    uint32_t start = 0;
+    
+    for (size_t f = 0; f < FIELD_COUNT; ++f) 
+    {
+        if ((fields & (1u << f)) &&
+            utils::TextSearch::find(text.substr(start, document.ends[f] - start), query) != utils::TextSearch::npos) 
+        {
+            return true;
+        }
+        start = document.ends[f] + 1;
+    }
+    
+    return false;
+}
+
+} // namespace models
+} // namespace media_player
@@ -0,0 +1,267 @@
+// Project includes
+#include "models/SortIndex.h"
+#include "models/Collation.h"
+
+// System includes
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <string_view>
+
+namespace media_player 
+{
+namespace models 
+{
+
+namespace 
+{
+
+constexpr uint32_t ERASED = UINT32_MAX;
+
+// Orders positions by key, equal keys by position
+struct KeyLess 
+{
+    const std::vector<std::string>& keys;
+    
+    bool operator()(uint32_t a, uint32_t b) const 
+    {
+        int result = keys[a].compare(keys[b]);
+        return result < 0 || (result == 0 && a < b);
+    }
+};
+
+} // namespace
+
+SortIndex::SortIndex() 
+{
+}
+
+void SortIndex::clear() 
+{
+    for (auto& order : m_orders) 
+    {
+        order = Order();
+    }
+}
+
+void SortIndex::build(const std::vector<MediaFileModel>& list) 
+{
+    for (size_t c = 0; c < CRITERIA_COUNT; ++c) 
+    {
+        if (m_orders[c].active) 
+        {
+            sortAll(static_cast<SortCriteria>(c), list);
+        }
+    }
+}
+
+void SortIndex::append(const std::vector<MediaFileModel>& list, size_t first) 
+{
+    for (size_t c = 0; c < CRITERIA_COUNT; ++c) 
+    {
+        Order& order = m_orders[c];
+        SortCriteria criteria = static_cast<SortCriteria>(c);
+        
+        if (!order.active) 
+        {
+            continue;
+        }
+        if (criteria == SortCriteria::DATE_ADDED) 
+        {
+            order.positions = identity(list.size());
+            continue;
+        }
+        
+        // Sort the new records alone, then merge them in
+        std::vector<uint32_t> added(list.size() - first);
+        std::iota(added.begin(), added.end(), static_cast<uint32_t>(first));
+        for (size_t i = first; i < list.size(); ++i) 
+        {
+            order.keys.push_back(keyOf(criteria, list[i]));
+        }
+        
+        KeyLess less{ order.keys };
+        std::sort(added.begin(), added.end(), less);
+        
+        std::vector<uint32_t> merged;
+        merged.reserve(list.size());
+        std::merge(order.positions->begin(), order.positions->end(), added.begin(), added.end(),
+                   std::back_inserter(merged), less);
+        order.positions = std::make_shared<const std::vector<uint32_t>>(std::move(merged));
+    }
+}
+
+void SortIndex::assign(const std::vector<MediaFileModel>& list, size_t position) 
+{
+    uint32_t moved = static_cast<uint32_t>(position);
+    
+    for (size_t c = 0; c < CRITERIA_COUNT; ++c) 
+    {
+        Order& order = m_orders[c];
+        SortCriteria criteria = static_cast<SortCriteria>(c);
+        
+        if (!order.active || criteria == SortCriteria::DATE_ADDED) 
+        {
+            continue;
+        }
+        
+        // Tag edits mostly leave other fields alone; their orders stay shared
+        std::string key = keyOf(criteria, list[position]);
+        if (key == order.keys[position]) 
+        {
+            continue;
+        }
+        order.keys[position] = std::move(key);
+        
+        std::vector<uint32_t> next;
+        next.reserve(order.positions->size());
+        std::copy_if(order.positions->begin(), order.positions->end(), std::back_inserter(next),
+                     [moved](uint32_t p) { return p != moved; });
+        
+        KeyLess less{ order.keys };
+        next.insert(std::lower_bound(next.begin(), next.end(), moved, less), moved);
+        order.positions = std::make_shared<const std::vector<uint32_t>>(std::move(next));
+    }
+}
+
+void SortIndex::erase(const std::vector<MediaFileModel>& list, const std::vector<uint32_t>& positions) 
+{
+    if (positions.empty()) 
+    {
+        return;
+    }
+    
+    // New position of each old one, shared by every criterion
+    std::vector<uint32_t> remap;
+    
+    for (size_t c = 0; c < CRITERIA_COUNT; ++c) 
+    {
+        Order& order = m_orders[c];
+        SortCriteria criteria = static_cast<SortCriteria>(c);
+        
+        if (!order.active) 
+        {
+            continue;
+        }
+        if (criteria == SortCriteria::DATE_ADDED) 
+        {
+            order.positions = identity(list.size());
+            continue;
+        }
+        
+        // Sized from the keys: list may hold records appended since
+        if (remap.empty()) 
+        {
+            remap.resize(order.keys.size());
+            size_t next = 0;
+            uint32_t kept = 0;
+            
+            for (uint32_t p = 0; p < remap.size(); ++p) 
+            {
+                if (next < positions.size() && positions[next] == p) 
+                {
+                    remap[p] = ERASED;
+                    next++;
+                }
+                else 
+                {
+                    remap[p] = kept++;
+                }
+            }
+        }
+        
+        for (uint32_t p = 0; p < remap.size(); ++p) 
+        {
+            if (remap[p] != ERASED && remap[p] != p) 
+            {
+                order.keys[remap[p]] = std::move(order.keys[p]);
+            }
+        }
+        order.keys.resize(order.keys.size() - positions.size());
+        
+        std::vector<uint32_t> next;
+        next.reserve(order.keys.size());
+        for (uint32_t p : *order.positions) 
+        {
+            if (remap[p] != ERASED) 
+            {
+                next.push_back(remap[p]);
+            }
+        }
+        order.positions = std::make_shared<const std::vector<uint32_t>>(std::move(next));
+    }
+}
+
+SortOrder SortIndex::getOrder(SortCriteria criteria, const std::vector<MediaFileModel>& list) 
+{
+    Order& order = m_orders[static_cast<size_t>(criteria)];
+    
+    if (!order.active) 
+    {
+        order.active = true;
+        sortAll(criteria, list);
+    }
+    
+    return order.positions;
+}
+
+std::string SortIndex::keyOf(SortCriteria criteria, const MediaFileModel& media) 
+{
+    switch (criteria) 
+    {
+        case SortCriteria::TITLE:
+            return Collation::key(media.getTitle().empty() ? media.getFileName() : std::string_view(media.getTitle()));
+        case SortCriteria::ARTIST:
+            return Collation::key(media.getArtist());
+        case SortCriteria::ALBUM:
+            return Collation::key(media.getAlbum());
+        case SortCriteria::FILE_NAME:
+            return Collation::key(media.getFileName());
+        case SortCriteria::DURATION: 
+        {
+            // Big-endian, so the bytes compare like the numbers
+            uint32_t seconds = static_cast<uint32_t>(std::max(0, media.getDuration()));
+            std::string key(4, '\0');
+            for (size_t i = 0; i < 4; ++i) 
+            {
+                key[i] = static_cast<char>(seconds >> (24 - 8 * i));
+            }
+            return key;
+        }
+        default:
+            return std::string();
+    }
+}
+
+SortOrder SortIndex::identity(size_t size) 
+{
+    std::vector<uint32_t> positions(size);
+    std::iota(positions.begin(), positions.end(), 0u);
+    return std::make_shared<const std::vector<uint32_t>>(std::move(positions));
+}
+
+void SortIndex::sortAll(SortCriteria criteria, const std::vector<MediaFileModel>& list) 
+{
+    Order& order = m_orders[static_cast<size_t>(criteria)];
+    
+    if (criteria == SortCriteria::DATE_ADDED) 
+    {
+        order.positions = identity(list.size());
+        return;
+    }
+    
+    order.keys.clear();
+    order.keys.reserve(list.size());
+    for (const auto& media : list) 
+    {
+        order.keys.push_back(keyOf(criteria, media));
+    }
+    
+    std::vector<uint32_t> positions(list.size());
+    std::iota(positions.begin(), positions.end(), 0u);
+    std::sort(positions.begin(), positions.end(), KeyLess{ order.keys });
+    order.positions = std::make_shared<const std::vector<uint32_t>>(std::move(positions));
+}
+
+} // namespace models
+} // namespace media_player
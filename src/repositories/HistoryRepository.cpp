@@ -3,6 +3,7 @@
 
 // System includes
 #include <fstream>
+#include <sstream>
 #include <filesystem>
 #include <algorithm>
 #include <chrono>
@@ -14,9 +15,11 @@ namespace media_player
 namespace repositories 
 {
 
-HistoryRepository::HistoryRepository(const std::string& storagePath, size_t maxEntries)
+HistoryRepository::HistoryRepository(const std::string& storagePath, size_t maxEntries,
+                                     std::shared_ptr<PersistenceService> persistence)
     : m_storagePath(storagePath)
     , m_maxEntries(maxEntries)
+    , m_persistence(persistence ? persistence : PersistenceService::getShared())
 {
     // Load history from disk on startup
     ensureStorageDirectoryExists();
@@ -25,8 +28,8 @@ HistoryRepository::HistoryRepository(const std::string& storagePath, size_t maxE
 
 HistoryRepository::~HistoryRepository() 
 {
-    // Save history to disk on shutdown
-    saveToDisk();
+    // Write what is still pending before the writer loses its repository
+    m_persistence->flush(getHistoryFilePath());
 }
 
 void HistoryRepository::addEntry(const models::MediaFileModel& media) 
@@ -34,7 +37,7 @@ void HistoryRepository::addEntry(const models::MediaFileModel& media)
     std::lock_guard<std::mutex> lock(m_mutex);
     
     // Add to front of deque
-    m_history.push_front(PlaybackHistoryEntry(media));
+    m_history.push_front(StoredEntry{ models::MediaCatalog::getShared()->intern(media), std::chrono::system_clock::now() });
     
     // Maintain max size
     if (m_history.size() > m_maxEntries) 
@@ -42,28 +45,32 @@ void HistoryRepository::addEntry(const models::MediaFileModel& media)
         m_history.pop_back();
     }
     
-    
+    markDirty();
 }
 
 void HistoryRepository::removeMostRecentEntryByFilePath(const std::string& filePath)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    models::MediaId id = models::MediaId::fromPath(filePath);
     auto it = std::find_if(m_history.begin(), m_history.end(),
-        [&filePath](const PlaybackHistoryEntry& e) { return e.media.getFilePath() == filePath; });
+        [id, &filePath](const StoredEntry& e) { return e.media.refersTo(id, filePath); });
     if (it != m_history.end())
     {
         m_history.erase(it);
+        markDirty();
     }
 }
 
 void HistoryRepository::removeAllEntriesByFilePath(const std::string& filePath)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    models::MediaId id = models::MediaId::fromPath(filePath);
     auto it = std::remove_if(m_history.begin(), m_history.end(),
-        [&filePath](const PlaybackHistoryEntry& e) { return e.media.getFilePath() == filePath; });
+        [id, &filePath](const StoredEntry& e) { return e.media.refersTo(id, filePath); });
     if (it != m_history.end())
     {
         m_history.erase(it, m_history.end());
+        markDirty();
     }
 }
 
@@ -78,7 +85,7 @@ std::vector<PlaybackHistoryEntry> HistoryRepository::getRecentHistory(size_t cou
     
     for (size_t i = 0; i < actualCount; ++i) 
     {
-        result.push_back(m_history[i]);
+        result.push_back(m_history[i].toEntry());
     }
     
     return result;
@@ -88,18 +95,27 @@ std::vector<PlaybackHistoryEntry> HistoryRepository::getAllHistory() const
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    return std::vector<PlaybackHistoryEntry>(m_history.begin(), m_history.end());
-    return std::vector<PlaybackHistoryEntry>(m_history.begin(), m_history.end());
+    std::vector<PlaybackHistoryEntry> result;
+    result.reserve(m_history.size());
+    
+    for (const auto& entry : m_history) 
+    {
+        result.push_back(entry.toEntry());
+    }
+    
+    return result;
 }
 
 void HistoryRepository::setHistory(const std::vector<PlaybackHistoryEntry>& history)
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_history.clear();
+    auto catalog = models::MediaCatalog::getShared();
     for (const auto& entry : history)
     {
-        m_history.push_back(entry);
+        m_history.push_back(StoredEntry{ catalog->intern(entry.media), entry.playedAt });
     }
+    markDirty();
 }
 
 void HistoryRepository::clear() 
@@ -107,6 +123,7 @@ void HistoryRepository::clear()
     std::lock_guard<std::mutex> lock(m_mutex);
     
     m_history.clear();
+    markDirty();
 }
 
 size_t HistoryRepository::count() const 
@@ -121,10 +138,11 @@ bool HistoryRepository::wasRecentlyPlayed(const std::string& filePath, int withi
     
     auto now = std::chrono::system_clock::now();
     auto threshold = now - std::chrono::minutes(withinMinutes);
+    models::MediaId id = models::MediaId::fromPath(filePath);
     
     for (const auto& entry : m_history) 
     {
-        if (entry.media.getFilePath() == filePath && entry.playedAt >= threshold) 
+        if (entry.media.refersTo(id, filePath) && entry.playedAt >= threshold) 
         {
             return true;
         }
@@ -142,7 +160,7 @@ std::optional<PlaybackHistoryEntry> HistoryRepository::getLastPlayed() const
         return std::nullopt;
     }
     
-    return m_history.front();
+    return m_history.front().toEntry();
 }
 
 std::optional<PlaybackHistoryEntry> HistoryRepository::getPreviousPlayed() const
@@ -150,15 +168,16 @@ std::optional<PlaybackHistoryEntry> HistoryRepository::getPreviousPlayed() const
     std::lock_guard<std::mutex> lock(m_mutex);
     if (m_history.size() < 2)
         return std::nullopt;
-    return m_history[1];
+    return m_history[1].toEntry();
 }
 
 std::optional<PlaybackHistoryEntry> HistoryRepository::getPlayedBefore(const std::string& currentFilePath) const
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    models::MediaId id = models::MediaId::fromPath(currentFilePath);
     for (size_t i = 0; i < m_history.size(); ++i)
-        if (m_history[i].media.getFilePath() == currentFilePath && i + 1 < m_history.size())
-            return m_history[i + 1];
+        if (m_history[i].media.refersTo(id, currentFilePath) && i + 1 < m_history.size())
+            return m_history[i + 1].toEntry();
     return std::nullopt;
 }
 
@@ -170,21 +189,22 @@ bool HistoryRepository::loadFromDisk()
 
 bool HistoryRepository::saveToDisk() 
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    return serializeHistory();
+    markDirty();
+    return m_persistence->flush(getHistoryFilePath());
+}
+
+void HistoryRepository::markDirty() 
+{
+    m_persistence->markDirty(getHistoryFilePath(), [this]() { return serializeHistory(); });
 }
 
 bool HistoryRepository::serializeHistory() 
 {
     try 
     {
-        std::string filePath = getHistoryFilePath();
-        std::ofstream file(filePath);
-        
-        if (!file.is_open()) 
-        {
-            return false;
-        }
+        // Formatted under the lock, written without it
+        std::ostringstream file;
+        std::unique_lock<std::mutex> lock(m_mutex);
         
         file << "HISTORY_VERSION:1.1\n";
         file << "COUNT:" << m_history.size() << "\n";
@@ -194,16 +214,17 @@ bool HistoryRepository::serializeHistory()
         for (const auto& entry : m_history) 
         {
             auto timestamp = std::chrono::system_clock::to_time_t(entry.playedAt);
-            std::string title = entry.media.getTitle();
-            std::string artist = entry.media.getArtist();
+            auto media = entry.media.get();
+            std::string title = media->getTitle();
+            std::string artist = media->getArtist();
             for (char& c : title) if (c == tab || c == '\n' || c == '\r') c = ' ';
             for (char& c : artist) if (c == tab || c == '\n' || c == '\r') c = ' ';
             file << entry.media.getFilePath() << tab << timestamp << tab << title << tab << artist << "\n";
         }
         
-        file.close();
+        lock.unlock();
         
-        return true;
+        return PersistenceService::writeFileAtomically(getHistoryFilePath(), file.str());
     }
     catch (const std::exception& e) 
     {
@@ -266,11 +287,11 @@ bool HistoryRepository::deserializeHistory()
                 if (!mediaPath.empty()) 
                 {
                     models::MediaFileModel media(mediaPath);
-                    if (media.isValid()) 
+                    if (media.getType() != models::MediaType::UNKNOWN) 
                     {
                         if (!title.empty()) media.setTitle(title);
                         if (!artist.empty()) media.setArtist(artist);
-                        PlaybackHistoryEntry entry(media);
+                        StoredEntry entry{ models::MediaCatalog::getShared()->intern(media), std::chrono::system_clock::now() };
                         try 
                         {
                             if (!timestampStr.empty()) {
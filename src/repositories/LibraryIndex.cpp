@@ -0,0 +1,363 @@
+// Project includes
+#include "repositories/LibraryIndex.h"
+
+// System includes
+#include <algorithm>
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+namespace 
+{
+
+constexpr size_t MIN_CAPACITY = 16;
+
+// Keeps the load factor at or below 3/4
+bool overloaded(size_t count, size_t capacity) 
+{
+    return count * 4 > capacity * 3;
+}
+
+const std::vector<uint32_t> NO_POSITIONS;
+
+} // namespace
+
+LibraryIndex::LibraryIndex()
+    : m_mask(0)
+    , m_totalSize(0) 
+{
+}
+
+void LibraryIndex::reserve(size_t count) 
+{
+    m_media.reserve(count);
+    m_hashes.reserve(count);
+    m_links.reserve(count);
+    
+    size_t capacity = std::max(MIN_CAPACITY, m_slots.size());
+    while (overloaded(count, capacity)) 
+    {
+        capacity *= 2;
+    }
+    
+    if (capacity > m_slots.size()) 
+    {
+        rehash(capacity);
+    }
+}
+
+void LibraryIndex::clear() 
+{
+    m_slots.clear();
+    m_mask = 0;
+    m_media.clear();
+    m_hashes.clear();
+    m_links.clear();
+    
+    for (auto& postings : m_byType) 
+    {
+        postings.clear();
+    }
+    m_byArtist.clear();
+    m_byAlbum.clear();
+    m_totalSize = 0;
+    m_text.reset();
+}
+
+size_t LibraryIndex::find(models::MediaId id) const 
+{
+    size_t slot = findSlot(id.value(), nullptr);
+    return slot == npos ? npos : m_slots[slot].position;
+}
+
+size_t LibraryIndex::find(const std::string& filePath) const 
+{
+    return find(models::MediaId::fromPath(filePath), filePath);
+}
+
+size_t LibraryIndex::find(models::MediaId id, const std::string& filePath) const 
+{
+    size_t slot = findSlot(id.value(), &filePath);
+    return slot == npos ? npos : m_slots[slot].position;
+}
+
+std::pair<size_t, bool> LibraryIndex::put(models::MediaFileModel media) 
+{
+    models::MediaId id = models::MediaId::fromPath(media.getFilePath());
+    return put(id, std::move(media));
+}
+
+std::pair<size_t, bool> LibraryIndex::put(models::MediaId id, models::MediaFileModel media) 
+{
+    uint64_t hash = id.value();
+    size_t slot = findSlot(hash, &media.getFilePath());
+    
+    if (slot != npos) 
+    {
+        size_t position = m_slots[slot].position;
+        assign(position, std::move(media));
+        return { position, false };
+    }
+    
+    if (overloaded(m_media.size() + 1, m_slots.size())) 
+    {
+        rehash(std::max(MIN_CAPACITY, m_slots.size() * 2));
+    }
+    
+    uint32_t position = static_cast<uint32_t>(m_media.size());
+    m_media.push_back(std::move(media));
+    m_hashes.push_back(hash);
+    m_links.push_back(Links{});
+    
+    insertSlot(hash, position);
+    link(position);
+    
+    if (m_text) 
+    {
+        m_text->append(m_media[position]);
+    }
+    
+    return { position, true };
+}
+
+void LibraryIndex::assign(size_t position, models::MediaFileModel media) 
+{
+    uint32_t at = static_cast<uint32_t>(position);
+    unlink(at);
+    m_media[at] = std::move(media);
+    link(at);
+    
+    if (m_text) 
+    {
+        m_text->assign(at, m_media[at]);
+    }
+}
+
+bool LibraryIndex::erase(const std::string& filePath) 
+{
+    size_t position = find(filePath);
+    
+    if (position == npos) 
+    {
+        return false;
+    }
+    
+    eraseAt(position);
+    return true;
+}
+
+void LibraryIndex::eraseAt(size_t position) 
+{
+    uint32_t hole = static_cast<uint32_t>(position);
+    uint32_t last = static_cast<uint32_t>(m_media.size() - 1);
+    
+    eraseSlot(slotOf(hole));
+    unlink(hole);
+    
+    if (m_text) 
+    {
+        m_text->eraseSwap(hole);
+    }
+    
+    // Move the last entry into the hole and repoint everything that refers to it
+    if (hole != last) 
+    {
+        m_slots[slotOf(last)].position = hole;
+        
+        m_media[hole] = std::move(m_media[last]);
+        m_hashes[hole] = m_hashes[last];
+        m_links[hole] = m_links[last];
+        
+        const Links& links = m_links[hole];
+        m_byType[static_cast<size_t>(m_media[hole].getType())][links.typeIndex] = hole;
+        (*links.artist)[links.artistIndex] = hole;
+        (*links.album)[links.albumIndex] = hole;
+    }
+    
+    m_media.pop_back();
+    m_hashes.pop_back();
+    m_links.pop_back();
+}
+
+size_t LibraryIndex::eraseUnder(const std::string& prefix) 
+{
+    size_t erased = 0;
+    
+    // Backwards, so the entry moved into a hole has been looked at already
+    for (size_t position = m_media.size(); position-- > 0; ) 
+    {
+        if (m_media[position].getFilePath().compare(0, prefix.size(), prefix) == 0) 
+        {
+            eraseAt(position);
+            erased++;
+        }
+    }
+    
+    return erased;
+}
+
+models::SearchResult LibraryIndex::search(const std::string& query, models::SearchFieldMask fields) 
+{
+    if (!m_text) 
+    {
+        m_text = std::make_unique<models::SearchIndex>();
+        m_text->build(m_media);
+    }
+    
+    return m_text->search(query, fields);
+}
+
+const std::vector<uint32_t>& LibraryIndex::findByType(models::MediaType type) const 
+{
+    size_t index = static_cast<size_t>(type);
+    return index < TYPE_COUNT ? m_byType[index] : NO_POSITIONS;
+}
+
+const std::vector<uint32_t>& LibraryIndex::findByArtist(const std::string& artist) const 
+{
+    auto it = m_byArtist.find(artist);
+    return it != m_byArtist.end() ? it->second : NO_POSITIONS;
+}
+
+const std::vector<uint32_t>& LibraryIndex::findByAlbum(const std::string& album) const 
+{
+    auto it = m_byAlbum.find(album);
+    return it != m_byAlbum.end() ? it->second : NO_POSITIONS;
+}
+
+size_t LibraryIndex::findSlot(uint64_t hash, const std::string* filePath) const 
+{
+    if (m_slots.empty()) 
+    {
+        return npos;
+    }
+    
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    
+    for (size_t slot = hash & m_mask; ; slot = (slot + 1) & m_mask) 
+    {
+        const Slot& candidate = m_slots[slot];
+        
+        if (candidate.position == EMPTY) 
+        {
+            return npos;
+        }
+        
+        // A path that shares the hash is another entry; probing goes on
+        if (candidate.tag == tag && m_hashes[candidate.position] == hash &&
+            (!filePath || m_media[candidate.position].getFilePath() == *filePath)) 
+        {
+            return slot;
+        }
+    }
+}
+
+size_t LibraryIndex::slotOf(uint32_t position) const 
+{
+    size_t slot = m_hashes[position] & m_mask;
+    
+    while (m_slots[slot].position != position) 
+    {
+        slot = (slot + 1) & m_mask;
+    }
+    
+    return slot;
+}
+
+void LibraryIndex::insertSlot(uint64_t hash, uint32_t position) 
+{
+    size_t slot = hash & m_mask;
+    
+    while (m_slots[slot].position != EMPTY) 
+    {
+        slot = (slot + 1) & m_mask;
+    }
+    
+    m_slots[slot] = Slot{ static_cast<uint32_t>(hash >> 32), position };
+}
+
+void LibraryIndex::eraseSlot(size_t slot) 
+{
+    m_slots[slot].position = EMPTY;
+    
+    // Backward shift: pull later slots of the probe run into the gap when the
+    // gap is no further from their home slot than they are now, so lookups
+    // never need tombstones
+    for (size_t next = (slot + 1) & m_mask; m_slots[next].position != EMPTY; next = (next + 1) & m_mask) 
+    {
+        size_t home = m_hashes[m_slots[next].position] & m_mask;
+        
+        if (((next - home) & m_mask) >= ((next - slot) & m_mask)) 
+        {
+            m_slots[slot] = m_slots[next];
+            m_slots[next].position = EMPTY;
+            slot = next;
+        }
+    }
+}
+
+void LibraryIndex::rehash(size_t capacity) 
+{
+    m_slots.assign(capacity, Slot{ 0, EMPTY });
+    m_mask = capacity - 1;
+    
+    for (size_t position = 0; position < m_hashes.size(); ++position) 
+    {
+        insertSlot(m_hashes[position], static_cast<uint32_t>(position));
+    }
+}
+
+void LibraryIndex::link(uint32_t position) 
+{
+    const models::MediaFileModel& media = m_media[position];
+    Links& links = m_links[position];
+    
+    Postings& byType = m_byType[static_cast<size_t>(media.getType())];
+    links.typeIndex = static_cast<uint32_t>(byType.size());
+    byType.push_back(position);
+    
+    links.artist = &m_byArtist[media.getArtist()];
+    links.artistIndex = static_cast<uint32_t>(links.artist->size());
+    links.artist->push_back(position);
+    
+    links.album = &m_byAlbum[media.getAlbum()];
+    links.albumIndex = static_cast<uint32_t>(links.album->size());
+    links.album->push_back(position);
+    
+    m_totalSize += media.getFileSize();
+}
+
+void LibraryIndex::unlink(uint32_t position) 
+{
+    const models::MediaFileModel& media = m_media[position];
+    Links links = m_links[position];
+    
+    removePosting(m_byType[static_cast<size_t>(media.getType())], links.typeIndex, &Links::typeIndex);
+    removePosting(*links.artist, links.artistIndex, &Links::artistIndex);
+    removePosting(*links.album, links.albumIndex, &Links::albumIndex);
+    
+    if (links.artist->empty()) 
+    {
+        m_byArtist.erase(media.getArtist());
+    }
+    if (links.album->empty()) 
+    {
+        m_byAlbum.erase(media.getAlbum());
+    }
+    
+    m_totalSize -= media.getFileSize();
+}
+
+void LibraryIndex::removePosting(Postings& postings, uint32_t index, uint32_t Links::*field) 
+{
+    // Swap with the last posting; its entry learns its new index
+    uint32_t moved = postings.back();
+    postings[index] = moved;
+    m_links[moved].*field = index;
+    postings.pop_back();
+}
+
+} // namespace repositories
+} // namespace media_player
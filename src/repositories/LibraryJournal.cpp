@@ -0,0 +1,388 @@
+// Project includes
+#include "repositories/LibraryJournal.h"
+
+// System includes
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+namespace 
+{
+
+constexpr char MAGIC[8] = { 'M', 'P', 'L', 'I', 'B', 'J', 'N', 'L' };
+constexpr uint32_t VERSION = 1;
+constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+constexpr size_t RECORD_PREFIX = 2 * sizeof(uint32_t);         // length, checksum
+constexpr uint32_t MAX_PAYLOAD = 64 * 1024 * 1024;
+
+// FNV-1a; catches torn and zero-filled tails, not tampering
+uint32_t checksum(const char* data, size_t size) 
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) 
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+template<typename T>
+void put(std::string& out, T value) 
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void putText(std::string& out, const std::string& text) 
+{
+    put(out, static_cast<uint32_t>(text.size()));
+    out += text;
+}
+
+// Wraps the payload that starts at payloadStart into a record
+void seal(std::string& buffer, size_t recordStart) 
+{
+    size_t payloadStart = recordStart + RECORD_PREFIX;
+    uint32_t length = static_cast<uint32_t>(buffer.size() - payloadStart);
+    uint32_t sum = checksum(buffer.data() + payloadStart, length);
+    std::memcpy(&buffer[recordStart], &length, sizeof(length));
+    std::memcpy(&buffer[recordStart + sizeof(length)], &sum, sizeof(sum));
+}
+
+size_t beginRecord(std::string& buffer, LibraryJournalOp op) 
+{
+    size_t recordStart = buffer.size();
+    buffer.append(RECORD_PREFIX, '\0');
+    put(buffer, static_cast<uint8_t>(op));
+    return recordStart;
+}
+
+// Bounds-checked reader over one payload
+class PayloadReader 
+{
+public:
+    PayloadReader(const char* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+        , m_pos(0)
+        , m_ok(true) 
+    {
+    }
+    
+    template<typename T>
+    T get() 
+    {
+        T value{};
+        if (m_pos + sizeof(T) > m_size) 
+        {
+            m_ok = false;
+            return value;
+        }
+        std::memcpy(&value, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return value;
+    }
+    
+    std::string getText() 
+    {
+        uint32_t length = get<uint32_t>();
+        if (!m_ok || length > m_size - m_pos) 
+        {
+            m_ok = false;
+            return std::string();
+        }
+        std::string text(m_data + m_pos, length);
+        m_pos += length;
+        return text;
+    }
+    
+    bool isComplete() const 
+    {
+        return m_ok && m_pos == m_size;
+    }
+    
+private:
+    const char* m_data;
+    size_t m_size;
+    size_t m_pos;
+    bool m_ok;
+};
+
+bool decode(const char* data, size_t size, LibraryJournalEntry& entry) 
+{
+    PayloadReader reader(data, size);
+    entry.op = static_cast<LibraryJournalOp>(reader.get<uint8_t>());
+    
+    switch (entry.op) 
+    {
+        case LibraryJournalOp::PUT: 
+        {
+            uint64_t fileSize = reader.get<uint64_t>();
+            int64_t lastModified = reader.get<int64_t>();
+            int32_t duration = reader.get<int32_t>();
+            std::string path = reader.getText();
+            std::string title = reader.getText();
+            std::string artist = reader.getText();
+            std::string album = reader.getText();
+            
+            entry.media = models::MediaFileModel(path, static_cast<size_t>(fileSize),
+                std::filesystem::file_time_type(std::filesystem::file_time_type::duration(lastModified)));
+            entry.media.setTitle(title);
+            entry.media.setArtist(artist);
+            entry.media.setAlbum(album);
+            entry.media.setDuration(duration);
+            entry.path = path;
+            break;
+        }
+        
+        case LibraryJournalOp::REMOVE:
+        case LibraryJournalOp::REMOVE_UNDER:
+            entry.path = reader.getText();
+            break;
+        
+        case LibraryJournalOp::CLEAR:
+            break;
+        
+        default:
+            return false;
+    }
+    
+    return reader.isComplete();
+}
+
+bool writeAll(int fd, const char* data, size_t size) 
+{
+    while (size > 0) 
+    {
+        ssize_t written = ::write(fd, data, size);
+        if (written <= 0) 
+        {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+LibraryJournal::LibraryJournal(const std::string& filePath)
+    : m_filePath(filePath)
+    , m_fd(-1)
+    , m_size(0) 
+{
+    struct stat st;
+    if (::stat(m_filePath.c_str(), &st) == 0) 
+    {
+        m_size = static_cast<uint64_t>(st.st_size);
+    }
+}
+
+LibraryJournal::~LibraryJournal() 
+{
+    close();
+}
+
+void LibraryJournal::encodePut(std::string& buffer, const models::MediaFileModel& media) 
+{
+    size_t recordStart = beginRecord(buffer, LibraryJournalOp::PUT);
+    put(buffer, static_cast<uint64_t>(media.getFileSize()));
+    put(buffer, static_cast<int64_t>(media.getLastModified().time_since_epoch().count()));
+    put(buffer, static_cast<int32_t>(media.getDuration()));
+    putText(buffer, media.getFilePath());
+    putText(buffer, media.getTitle());
+    putText(buffer, media.getArtist());
+    putText(buffer, media.getAlbum());
+    seal(buffer, recordStart);
+}
+
+void LibraryJournal::encodeRemove(std::string& buffer, const std::string& filePath) 
+{
+    size_t recordStart = beginRecord(buffer, LibraryJournalOp::REMOVE);
+    putText(buffer, filePath);
+    seal(buffer, recordStart);
+}
+
+void LibraryJournal::encodeRemoveUnder(std::string& buffer, const std::string& dirPath) 
+{
+    size_t recordStart = beginRecord(buffer, LibraryJournalOp::REMOVE_UNDER);
+    putText(buffer, dirPath);
+    seal(buffer, recordStart);
+}
+
+void LibraryJournal::encodeClear(std::string& buffer) 
+{
+    seal(buffer, beginRecord(buffer, LibraryJournalOp::CLEAR));
+}
+
+bool LibraryJournal::append(const std::string& buffer) 
+{
+    if (buffer.empty()) 
+    {
+        return true;
+    }
+    
+    if (m_fd < 0 && !openForAppend()) 
+    {
+        return false;
+    }
+    
+    if (!writeAll(m_fd, buffer.data(), buffer.size())) 
+    {
+        // A partial record is cut off by replay and truncated on the next load
+        close();
+        return false;
+    }
+    
+    m_size += buffer.size();
+    return true;
+}
+
+void LibraryJournal::close() 
+{
+    if (m_fd >= 0) 
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool LibraryJournal::rotateTo(const std::string& toPath) 
+{
+    close();
+    
+    if (std::rename(m_filePath.c_str(), toPath.c_str()) != 0) 
+    {
+        return false;
+    }
+    
+    m_size = 0;
+    return true;
+}
+
+void LibraryJournal::discard() 
+{
+    close();
+    ::unlink(m_filePath.c_str());
+    m_size = 0;
+}
+
+bool LibraryJournal::truncate(uint64_t validBytes) 
+{
+    close();
+    
+    struct stat st;
+    if (::stat(m_filePath.c_str(), &st) != 0) 
+    {
+        m_size = 0;
+        return true;
+    }
+    
+    if (static_cast<uint64_t>(st.st_size) > validBytes &&
+        ::truncate(m_filePath.c_str(), static_cast<off_t>(validBytes)) != 0) 
+    {
+        return false;
+    }
+    
+    m_size = std::min<uint64_t>(validBytes, static_cast<uint64_t>(st.st_size));
+    return true;
+}
+
+uint64_t LibraryJournal::replay(const std::string& filePath, const std::function<void(const LibraryJournalEntry&)>& apply) 
+{
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) 
+    {
+        return 0;
+    }
+    
+    std::vector<char> data;
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) 
+    {
+        data.resize(static_cast<size_t>(st.st_size));
+        ssize_t got = ::pread(fd, data.data(), data.size(), 0);
+        data.resize(got > 0 ? static_cast<size_t>(got) : 0);
+    }
+    ::close(fd);
+    
+    uint32_t version = 0;
+    if (data.size() < HEADER_SIZE || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) 
+    {
+        return 0;
+    }
+    std::memcpy(&version, data.data() + sizeof(MAGIC), sizeof(version));
+    if (version != VERSION) 
+    {
+        return 0;
+    }
+    
+    size_t pos = HEADER_SIZE;
+    LibraryJournalEntry entry;
+    
+    while (data.size() - pos >= RECORD_PREFIX) 
+    {
+        uint32_t length = 0;
+        uint32_t sum = 0;
+        std::memcpy(&length, data.data() + pos, sizeof(length));
+        std::memcpy(&sum, data.data() + pos + sizeof(length), sizeof(sum));
+        
+        const char* payload = data.data() + pos + RECORD_PREFIX;
+        if (length == 0 || length > MAX_PAYLOAD || length > data.size() - pos - RECORD_PREFIX ||
+            checksum(payload, length) != sum || !decode(payload, length, entry)) 
+        {
+            break;
+        }
+        
+        apply(entry);
+        pos += RECORD_PREFIX + length;
+    }
+    
+    return pos;
+}
+
+bool LibraryJournal::openForAppend() 
+{
+    m_fd = ::open(m_filePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_fd < 0) 
+    {
+        return false;
+    }
+    
+    struct stat st;
+    if (::fstat(m_fd, &st) != 0) 
+    {
+        close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(st.st_size);
+    
+    if (m_size == 0) 
+    {
+        std::string header(MAGIC, sizeof(MAGIC));
+        put(header, VERSION);
+        put(header, static_cast<uint32_t>(0));
+        
+        if (!writeAll(m_fd, header.data(), header.size())) 
+        {
+            close();
+            return false;
+        }
+        m_size = header.size();
+    }
+    
+    return true;
+}
+
+} // namespace repositories
+} // namespace media_player
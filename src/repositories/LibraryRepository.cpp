@@ -1,11 +1,13 @@
 // Project includes
 #include "repositories/LibraryRepository.h"
+#include "repositories/LibrarySnapshot.h"
+#include "config/AppConfig.h"
 
 // System includes
 #include <fstream>
 #include <filesystem>
 #include <sstream>
-#include <algorithm>
+#include <unistd.h>
 
 namespace fs = std::filesystem;
 
@@ -14,37 +16,80 @@ namespace media_player
 namespace repositories 
 {
 
-LibraryRepository::LibraryRepository(const std::string& storagePath)
+LibraryRepository::LibraryRepository(const std::string& storagePath,
+                                     std::shared_ptr<PersistenceService> persistence)
     : m_storagePath(storagePath)
+    , m_journal(storagePath + "/library.journal")
+    , m_compactThreshold(config::AppConfig::LIBRARY_JOURNAL_COMPACT_BYTES)
+    , m_persistence(persistence ? persistence : PersistenceService::getShared())
+    , m_compactRequested(false)
+    , m_snapshotUnreadable(false)
+    , m_stopCompactor(false)
+    , m_compactions(0) 
 {
     ensureStorageDirectoryExists();
     loadFromDisk();
+    
+    // Finish a compaction cut short by the last shutdown
+    m_compactRequested = fs::exists(getCompactingJournalFilePath()) || m_journal.size() >= m_compactThreshold;
+    m_compactor = std::thread(&LibraryRepository::compactorLoop, this);
 }
 
 LibraryRepository::~LibraryRepository() 
 {
-    saveToDisk();
+    // Only the queued records are left to write on the way out. A
+    // compaction in progress stops early and resumes on the next start.
+    flush();
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopCompactor = true;
+    }
+    m_compactCondition.notify_all();
+    
+    if (m_compactor.joinable()) 
+    {
+        m_compactor.join();
+    }
 }
 
 bool LibraryRepository::save(const models::MediaFileModel& media) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    std::string id = generateId(media.getFilePath());
-    m_cache[id] = media;
+    models::MediaId id = models::MediaId::fromPath(media.getFilePath());
+    size_t position = m_cache.find(id, media.getFilePath());
+    
+    if (position != LibraryIndex::npos && sameEntry(m_cache.at(position), media)) 
+    {
+        return true;
+    }
+    
+    std::string records;
+    LibraryJournal::encodePut(records, media);
+    appendToJournal(records);
+    
+    m_cache.put(id, media);
+    invalidateSnapshot();
     
     return true;
 }
 
 std::optional<models::MediaFileModel> LibraryRepository::findById(const std::string& id) 
+{
+    std::optional<models::MediaId> parsed = models::MediaId::parse(id);
+    return parsed ? findById(*parsed) : std::nullopt;
+}
+
+std::optional<models::MediaFileModel> LibraryRepository::findById(models::MediaId id) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    auto it = m_cache.find(id);
+    size_t position = m_cache.find(id);
     
-    if (it != m_cache.end()) 
+    if (position != LibraryIndex::npos) 
     {
-        return it->second;
+        return m_cache.at(position);
     }
     
     return std::nullopt;
@@ -52,65 +97,214 @@ std::optional<models::MediaFileModel> LibraryRepository::findById(const std::str
 
 std::vector<models::MediaFileModel> LibraryRepository::findAll() 
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    return *getSnapshot();
+}
+
+models::MediaSnapshot LibraryRepository::getSnapshot() const 
+{
+    models::MediaSnapshot snapshot = std::atomic_load(&m_snapshot);
     
-    std::vector<models::MediaFileModel> result;
-    result.reserve(m_cache.size());
+    if (snapshot) 
+    {
+        return snapshot;
+    }
     
-    for (const auto& pair : m_cache) 
+    std::lock_guard<std::mutex> lock(m_mutex);
+    snapshot = std::atomic_load(&m_snapshot);
+    
+    if (!snapshot) 
     {
-        result.push_back(pair.second);
+        snapshot = std::make_shared<const std::vector<models::MediaFileModel>>(m_cache.entries());
+        std::atomic_store(&m_snapshot, snapshot);
     }
     
-    return result;
+    return snapshot;
 }
 
 bool LibraryRepository::update(const models::MediaFileModel& media) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    std::string id = generateId(media.getFilePath());
+    size_t position = m_cache.find(media.getFilePath());
     
-    if (m_cache.find(id) == m_cache.end()) 
+    if (position == LibraryIndex::npos) 
     {
         return false;
     }
     
-    m_cache[id] = media;
+    if (!sameEntry(m_cache.at(position), media)) 
+    {
+        std::string records;
+        LibraryJournal::encodePut(records, media);
+        appendToJournal(records);
+        
+        m_cache.assign(position, media);
+        invalidateSnapshot();
+    }
     
     return true;
 }
 
 bool LibraryRepository::remove(const std::string& id) 
+{
+    std::optional<models::MediaId> parsed = models::MediaId::parse(id);
+    return parsed && remove(*parsed);
+}
+
+bool LibraryRepository::remove(models::MediaId id) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    auto it = m_cache.find(id);
+    size_t position = m_cache.find(id);
+    
+    if (position == LibraryIndex::npos) 
+    {
+        return false;
+    }
+    
+    std::string records;
+    LibraryJournal::encodeRemove(records, m_cache.at(position).getFilePath());
+    appendToJournal(records);
+    
+    m_cache.eraseAt(position);
+    invalidateSnapshot();
+    
+    return true;
+}
+
+bool LibraryRepository::removeByPath(const std::string& filePath) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
     
-    if (it == m_cache.end()) 
+    if (!m_cache.erase(filePath)) 
     {
         return false;
     }
     
-    m_cache.erase(it);
+    invalidateSnapshot();
+    
+    std::string records;
+    LibraryJournal::encodeRemove(records, filePath);
+    appendToJournal(records);
     
     return true;
 }
 
+size_t LibraryRepository::removeUnderPath(const std::string& dirPath) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::string prefix = dirPath;
+    if (!prefix.empty() && prefix.back() != '/') 
+    {
+        prefix += '/';
+    }
+    
+    size_t removed = m_cache.eraseUnder(prefix);
+    
+    if (removed > 0) 
+    {
+        std::string records;
+        LibraryJournal::encodeRemoveUnder(records, prefix);
+        appendToJournal(records);
+        invalidateSnapshot();
+    }
+    
+    return removed;
+}
+
 bool LibraryRepository::exists(const std::string& id) 
+{
+    std::optional<models::MediaId> parsed = models::MediaId::parse(id);
+    return parsed && exists(*parsed);
+}
+
+bool LibraryRepository::exists(models::MediaId id) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
-    return m_cache.find(id) != m_cache.end();
+    return m_cache.find(id) != LibraryIndex::npos;
 }
 
 bool LibraryRepository::saveAll(const std::vector<models::MediaFileModel>& mediaList) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
+    // One journal write for the whole batch, unchanged entries left out
+    std::string records;
+    
+    m_cache.reserve(m_cache.size() + mediaList.size());
+    
     for (const auto& media : mediaList) 
     {
-        std::string id = generateId(media.getFilePath());
-        m_cache[id] = media;
+        models::MediaId id = models::MediaId::fromPath(media.getFilePath());
+        size_t position = m_cache.find(id, media.getFilePath());
+        
+        if (position == LibraryIndex::npos) 
+        {
+            LibraryJournal::encodePut(records, media);
+            m_cache.put(id, media);
+        }
+        else if (!sameEntry(m_cache.at(position), media)) 
+        {
+            LibraryJournal::encodePut(records, media);
+            m_cache.assign(position, media);
+        }
+    }
+    
+    // No records: nothing changed
+    if (!records.empty()) 
+    {
+        appendToJournal(records);
+        invalidateSnapshot();
+    }
+    
+    return true;
+}
+
+bool LibraryRepository::replaceAll(const std::vector<models::MediaFileModel>& mediaList) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::string records;
+    
+    // Positions seen in mediaList; they stay put until the first erase below
+    m_cache.reserve(m_cache.size() + mediaList.size());
+    std::vector<bool> kept(m_cache.size() + mediaList.size(), false);
+    
+    for (const auto& media : mediaList) 
+    {
+        models::MediaId id = models::MediaId::fromPath(media.getFilePath());
+        size_t position = m_cache.find(id, media.getFilePath());
+        
+        if (position == LibraryIndex::npos) 
+        {
+            LibraryJournal::encodePut(records, media);
+            position = m_cache.put(id, media).first;
+        }
+        else if (!sameEntry(m_cache.at(position), media)) 
+        {
+            LibraryJournal::encodePut(records, media);
+            m_cache.assign(position, media);
+        }
+        
+        kept[position] = true;
+    }
+    
+    // Backwards, so the entry moved into a hole is one already kept
+    for (size_t position = m_cache.size(); position-- > 0; ) 
+    {
+        if (!kept[position]) 
+        {
+            LibraryJournal::encodeRemove(records, m_cache.at(position).getFilePath());
+            m_cache.eraseAt(position);
+        }
+    }
+    
+    // No records: nothing changed
+    if (!records.empty()) 
+    {
+        appendToJournal(records);
+        invalidateSnapshot();
     }
     
     return true;
@@ -120,7 +314,12 @@ void LibraryRepository::clear()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
+    std::string records;
+    LibraryJournal::encodeClear(records);
+    appendToJournal(records);
+    
     m_cache.clear();
+    invalidateSnapshot();
 }
 
 size_t LibraryRepository::count() const 
@@ -133,92 +332,306 @@ std::optional<models::MediaFileModel> LibraryRepository::findByPath(const std::s
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    std::string id = generateId(filePath);
-    return findById(id);
+    size_t position = m_cache.find(filePath);
+    
+    if (position != LibraryIndex::npos) 
+    {
+        return m_cache.at(position);
+    }
+    
+    return std::nullopt;
 }
 
 std::vector<models::MediaFileModel> LibraryRepository::findByType(models::MediaType type) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return collect(m_cache.findByType(type));
+}
+
+std::vector<models::MediaFileModel> LibraryRepository::findByArtist(const std::string& artist) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return collect(m_cache.findByArtist(artist));
+}
+
+std::vector<models::MediaFileModel> LibraryRepository::findByAlbum(const std::string& album) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return collect(m_cache.findByAlbum(album));
+}
+
+std::vector<models::MediaFileModel> LibraryRepository::searchByFileName(const std::string& query) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    std::vector<models::MediaFileModel> result;
+    return collect(m_cache.search(query, models::SearchField::FILE_NAME).positions);
+}
+
+size_t LibraryRepository::countByType(models::MediaType type) const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cache.countByType(type);
+}
+
+long long LibraryRepository::getTotalSize() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<long long>(m_cache.getTotalSize());
+}
+
+bool LibraryRepository::loadFromDisk() 
+{
+    std::lock_guard<std::mutex> fileLock(m_fileMutex);
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
     
-    for (const auto& pair : m_cache) 
-    {
-        if (pair.second.getType() == type) 
-        {
-            result.push_back(pair.second);
-        }
-    }
+    bool loaded = deserializeLibrary();
+    invalidateSnapshot();
     
-    return result;
+    return loaded;
 }
 
-std::vector<models::MediaFileModel> LibraryRepository::searchByFileName(const std::string& query) 
+bool LibraryRepository::flush() 
 {
+    return m_persistence->flush(getJournalFilePath());
+}
+
+bool LibraryRepository::saveToDisk() 
+{
+    std::lock_guard<std::mutex> fileLock(m_fileMutex);
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
     std::lock_guard<std::mutex> lock(m_mutex);
     
-    std::vector<models::MediaFileModel> results;
-    std::string lowerQuery = query;
-    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+    if (!serializeLibrary()) 
+    {
+        return false;
+    }
+    
+    // Everything journaled or queued so far is in the snapshot now
+    m_journal.discard();
+    m_pendingRecords.clear();
+    ::unlink(getCompactingJournalFilePath().c_str());
+    
+    return true;
+}
+
+bool LibraryRepository::compact() 
+{
+    std::lock_guard<std::mutex> fileLock(m_fileMutex);
+    std::string compactingPath = getCompactingJournalFilePath();
     
-    for (const auto& pair : m_cache) 
     {
-        std::string lowerName = pair.second.getFileName();
-        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
+        std::lock_guard<std::mutex> journalLock(m_journalMutex);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_compactRequested = false;
         
-        if (lowerName.find(lowerQuery) != std::string::npos) 
+        // The cache holds only the journal then; folding it would write
+        // that over the library
+        if (m_snapshotUnreadable) 
         {
-            results.push_back(pair.second);
+            return false;
+        }
+        
+        // A journal left by an interrupted compaction is folded first; new
+        // mutations keep going to the active journal meanwhile
+        if (!fs::exists(compactingPath)) 
+        {
+            if (!fs::exists(m_journal.getFilePath())) 
+            {
+                return true;
+            }
+            
+            if (!m_journal.rotateTo(compactingPath)) 
+            {
+                return false;
+            }
         }
     }
     
-    return results;
+    // Fold without m_mutex: the base snapshot plus the rotated journal is all
+    // that is needed, so readers and writers of the cache never wait on this
+    LibraryIndex folded;
+    
+    if (!loadSnapshot(folded)) 
+    {
+        // Damaged since it was loaded: the rotated journal stays, and is
+        // replayed by the next load
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_snapshotUnreadable = true;
+        
+        return false;
+    }
+    
+    LibraryJournal::replay(compactingPath, [this, &folded](const LibraryJournalEntry& entry) 
+    {
+        applyEntry(folded, entry);
+    });
+    
+    if (m_stopCompactor) 
+    {
+        return false;
+    }
+    
+    std::vector<const models::MediaFileModel*> media;
+    media.reserve(folded.size());
+    
+    for (const auto& item : folded.entries()) 
+    {
+        media.push_back(&item);
+    }
+    
+    if (!LibrarySnapshot::write(getLibraryFilePath(), media)) 
+    {
+        return false;
+    }
+    
+    // Replaying it again over the new snapshot would be harmless, so a crash
+    // before this unlink costs only time
+    ::unlink(compactingPath.c_str());
+    m_compactions++;
+    
+    return true;
 }
 
-size_t LibraryRepository::countByType(models::MediaType type) const 
+void LibraryRepository::setCompactThreshold(uint64_t bytes) 
 {
     std::lock_guard<std::mutex> lock(m_mutex);
+    m_compactThreshold = bytes;
+}
+
+uint64_t LibraryRepository::getJournalSize() const 
+{
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
+    return m_journal.size();
+}
+
+size_t LibraryRepository::getCompactionCount() const 
+{
+    return m_compactions;
+}
+
+void LibraryRepository::appendToJournal(const std::string& records) 
+{
+    if (records.empty()) 
+    {
+        return;
+    }
     
-    size_t count = 0;
+    // Records of a burst of mutations go out in one append
+    m_pendingRecords += records;
+    m_persistence->markDirty(getJournalFilePath(), [this]() { return writePendingRecords(); });
+}
+
+bool LibraryRepository::writePendingRecords() 
+{
+    std::lock_guard<std::mutex> journalLock(m_journalMutex);
+    std::string records;
     
-    for (const auto& pair : m_cache) 
     {
-        if (pair.second.getType() == type) 
-        {
-            count++;
-        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        records.swap(m_pendingRecords);
     }
     
-    return count;
+    // A failed append leaves the change in memory only; the next
+    // saveToDisk() or compaction of a readable journal still captures it
+    bool appended = m_journal.append(records);
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    if (m_journal.size() >= m_compactThreshold && !m_compactRequested && !m_snapshotUnreadable) 
+    {
+        m_compactRequested = true;
+        m_compactCondition.notify_one();
+    }
+    
+    return appended;
 }
 
-long long LibraryRepository::getTotalSize() const 
+void LibraryRepository::applyEntry(LibraryIndex& cache, const LibraryJournalEntry& entry) const 
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    switch (entry.op) 
+    {
+        case LibraryJournalOp::PUT:
+            if (entry.media.getType() != models::MediaType::UNKNOWN) 
+            {
+                cache.put(entry.media);
+            }
+            break;
+        
+        case LibraryJournalOp::REMOVE:
+            cache.erase(entry.path);
+            break;
+        
+        case LibraryJournalOp::REMOVE_UNDER:
+            cache.eraseUnder(entry.path);
+            break;
+        
+        case LibraryJournalOp::CLEAR:
+            cache.clear();
+            break;
+    }
+}
+
+bool LibraryRepository::loadSnapshot(LibraryIndex& cache) const 
+{
+    std::string filePath = getLibraryFilePath();
+    
+    if (!fs::exists(filePath)) 
+    {
+        return true;
+    }
     
-    long long totalSize = 0;
+    LibrarySnapshot snapshot;
     
-    for (const auto& pair : m_cache) 
+    if (!snapshot.open(filePath)) 
     {
-        totalSize += pair.second.getFileSize();
+        return false;
     }
     
-    return totalSize;
+    // Size, mtime and tags come from the snapshot: no file is touched
+    cache.reserve(cache.size() + snapshot.size());
+    
+    for (size_t i = 0; i < snapshot.size(); ++i) 
+    {
+        models::MediaFileModel media = snapshot.toMedia(i);
+        
+        if (media.getType() != models::MediaType::UNKNOWN) 
+        {
+            cache.put(std::move(media));
+        }
+    }
+    
+    return true;
 }
 
-bool LibraryRepository::loadFromDisk() 
+bool LibraryRepository::sameEntry(const models::MediaFileModel& a, const models::MediaFileModel& b) 
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    return deserializeLibrary();
+    // Callers match entries by id, so the paths are already equal
+    return a.getFileSize() == b.getFileSize() &&
+           a.getLastModified() == b.getLastModified() &&
+           a.getDuration() == b.getDuration() &&
+           a.getTitle() == b.getTitle() &&
+           a.getArtist() == b.getArtist() &&
+           a.getAlbum() == b.getAlbum();
 }
 
-bool LibraryRepository::saveToDisk() 
+void LibraryRepository::compactorLoop() 
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
     
-    return serializeLibrary();
+    while (true) 
+    {
+        m_compactCondition.wait(lock, [this]() { return m_compactRequested || m_stopCompactor; });
+        
+        if (m_stopCompactor) 
+        {
+            return;
+        }
+        
+        lock.unlock();
+        compact();
+        lock.lock();
+    }
 }
 
 std::string LibraryRepository::getLibraryFilePath() const 
@@ -226,34 +639,34 @@ std::string LibraryRepository::getLibraryFilePath() const
     return m_storagePath + "/library.dat";
 }
 
+std::string LibraryRepository::getJournalFilePath() const 
+{
+    return m_storagePath + "/library.journal";
+}
+
+std::string LibraryRepository::getCompactingJournalFilePath() const 
+{
+    return m_storagePath + "/library.journal.compacting";
+}
+
 bool LibraryRepository::serializeLibrary() 
 {
     try 
     {
-        std::string filePath = getLibraryFilePath();
-        std::ofstream file(filePath);
+        std::vector<const models::MediaFileModel*> media;
+        media.reserve(m_cache.size());
         
-        if (!file.is_open()) 
+        for (const auto& item : m_cache.entries()) 
         {
-            return false;
+            media.push_back(&item);
         }
         
-        file << "LIBRARY_VERSION:1.0\n";
-        file << "COUNT:" << m_cache.size() << "\n";
-        file << "ENTRIES:\n";
-        
-        for (const auto& pair : m_cache) 
+        if (!LibrarySnapshot::write(getLibraryFilePath(), media)) 
         {
-            const auto& media = pair.second;
-            file << media.getFilePath() << "|"
-                 << media.getFileName() << "|"
-                 << media.getExtension() << "|"
-                 << static_cast<int>(media.getType()) << "|"
-                 << media.getFileSize() << "\n";
+            return false;
         }
         
-        file.close();
-        
+        m_snapshotUnreadable = false;
         return true;
     }
     catch (const std::exception& e) 
@@ -268,13 +681,44 @@ bool LibraryRepository::deserializeLibrary()
     try 
     {
         std::string filePath = getLibraryFilePath();
+        bool loaded = true;
         
-        if (!fs::exists(filePath)) 
+        if (fs::exists(filePath) && !LibrarySnapshot::isSnapshotFile(filePath)) 
+        {
+            // Libraries saved before the snapshot format are read once more as
+            // text and converted, so the journal always sits on a snapshot
+            loaded = deserializeLegacyLibrary() && serializeLibrary();
+        }
+        else 
         {
-            return true;
+            loaded = loadSnapshot(m_cache);
         }
+        m_snapshotUnreadable = !loaded;
+        
+        // Mutations since the snapshot, oldest first: a journal left by an
+        // interrupted compaction, then the active one
+        auto apply = [this](const LibraryJournalEntry& entry) 
+        {
+            applyEntry(m_cache, entry);
+        };
+        LibraryJournal::replay(getCompactingJournalFilePath(), apply);
+        m_journal.truncate(LibraryJournal::replay(getJournalFilePath(), apply));
         
-        std::ifstream file(filePath);
+        return loaded;
+    }
+    catch (const std::exception& e) 
+    {
+        (void)e;
+        m_snapshotUnreadable = true;
+        return false;
+    }
+}
+
+bool LibraryRepository::deserializeLegacyLibrary() 
+{
+    try 
+    {
+        std::ifstream file(getLibraryFilePath());
         
         if (!file.is_open()) 
         {
@@ -303,15 +747,26 @@ bool LibraryRepository::deserializeLibrary()
                 // Parse entry: filepath|filename|extension|type|size
                 std::istringstream iss(line);
                 std::string filePath;
+                std::string fileName;
+                std::string extension;
+                std::string type;
+                uintmax_t size = 0;
                 
                 if (std::getline(iss, filePath, '|')) 
                 {
-                    models::MediaFileModel media(filePath);
+                    // Name, extension and type follow from the path again; the
+                    // size is kept, the mtime was never saved and stays unknown
+                    std::getline(iss, fileName, '|');
+                    std::getline(iss, extension, '|');
+                    std::getline(iss, type, '|');
+                    iss >> size;
+                    
+                    models::MediaFileModel media(filePath, static_cast<size_t>(size), fs::file_time_type());
                     
-                    if (media.isValid()) 
+                    // No stat per entry; MediaValidator checks existence once the UI is up
+                    if (media.getType() != models::MediaType::UNKNOWN) 
                     {
-                        std::string id = generateId(filePath);
-                        m_cache[id] = media;
+                        m_cache.put(std::move(media));
                         loadedCount++;
                     }
                 }
@@ -344,13 +799,23 @@ void LibraryRepository::ensureStorageDirectoryExists()
     }
 }
 
-std::string LibraryRepository::generateId(const std::string& filePath) const 
+void LibraryRepository::invalidateSnapshot() 
 {
-    // Simple hash-based ID generation
-    std::hash<std::string> hasher;
-    size_t hash = hasher(filePath);
+    // Holders keep the old list; the next reader builds a new one
+    std::atomic_store(&m_snapshot, models::MediaSnapshot());
+}
+
+std::vector<models::MediaFileModel> LibraryRepository::collect(const std::vector<uint32_t>& positions) const 
+{
+    std::vector<models::MediaFileModel> result;
+    result.reserve(positions.size());
     
-    return "media_" + std::to_string(hash);
+    for (uint32_t position : positions) 
+    {
+        result.push_back(m_cache.at(position));
+    }
+    
+    return result;
 }
 
 } // namespace repositories
@@ -0,0 +1,248 @@
+// Project includes
+#include "repositories/LibrarySnapshot.h"
+
+// System includes
+#include <cstring>
+#include <cstdio>
+#include <limits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+namespace 
+{
+
+constexpr char MAGIC[8] = { 'M', 'P', 'L', 'I', 'B', 'S', 'N', 'P' };
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Appends text to the heap and returns where it landed
+bool appendText(std::string& heap, const std::string& text, uint32_t& offset, uint32_t& length) 
+{
+    if (heap.size() + text.size() > std::numeric_limits<uint32_t>::max()) 
+    {
+        return false;
+    }
+    
+    offset = static_cast<uint32_t>(heap.size());
+    length = static_cast<uint32_t>(text.size());
+    heap += text;
+    return true;
+}
+
+bool writeAll(int fd, const void* data, size_t size) 
+{
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) 
+    {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written <= 0) 
+        {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+} // namespace
+
+LibrarySnapshot::LibrarySnapshot()
+    : m_data(nullptr)
+    , m_mappedSize(0)
+    , m_records(nullptr)
+    , m_recordCount(0)
+    , m_heap(nullptr)
+    , m_heapSize(0) 
+{
+}
+
+LibrarySnapshot::~LibrarySnapshot() 
+{
+    close();
+}
+
+bool LibrarySnapshot::open(const std::string& filePath) 
+{
+    close();
+    
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) 
+    {
+        return false;
+    }
+    
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(LibrarySnapshotHeader)) 
+    {
+        ::close(fd);
+        return false;
+    }
+    
+    size_t fileSize = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    
+    if (data == MAP_FAILED) 
+    {
+        return false;
+    }
+    
+    const auto* header = static_cast<const LibrarySnapshotHeader*>(data);
+    uint64_t tableBytes = header->recordCount * sizeof(LibrarySnapshotRecord);
+    
+    bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 header->version == VERSION &&
+                 header->byteOrder == BYTE_ORDER_MARK &&
+                 header->headerSize == sizeof(LibrarySnapshotHeader) &&
+                 header->recordSize == sizeof(LibrarySnapshotRecord) &&
+                 header->recordOffset % alignof(LibrarySnapshotRecord) == 0 &&
+                 header->recordCount <= fileSize / sizeof(LibrarySnapshotRecord) &&
+                 header->recordOffset <= fileSize && tableBytes <= fileSize - header->recordOffset &&
+                 header->heapOffset <= fileSize && header->heapSize <= fileSize - header->heapOffset;
+    
+    if (!valid) 
+    {
+        ::munmap(data, fileSize);
+        return false;
+    }
+    
+    // Records are read once, front to back
+    ::madvise(data, fileSize, MADV_SEQUENTIAL);
+    
+    m_data = data;
+    m_mappedSize = fileSize;
+    m_records = reinterpret_cast<const LibrarySnapshotRecord*>(static_cast<const char*>(data) + header->recordOffset);
+    m_recordCount = static_cast<size_t>(header->recordCount);
+    m_heap = static_cast<const char*>(data) + header->heapOffset;
+    m_heapSize = header->heapSize;
+    
+    return true;
+}
+
+void LibrarySnapshot::close() 
+{
+    if (m_data) 
+    {
+        ::munmap(m_data, m_mappedSize);
+    }
+    
+    m_data = nullptr;
+    m_mappedSize = 0;
+    m_records = nullptr;
+    m_recordCount = 0;
+    m_heap = nullptr;
+    m_heapSize = 0;
+}
+
+std::string_view LibrarySnapshot::text(uint32_t offset, uint32_t length) const 
+{
+    if (static_cast<uint64_t>(offset) + length > m_heapSize) 
+    {
+        return std::string_view();
+    }
+    return std::string_view(m_heap + offset, length);
+}
+
+models::MediaFileModel LibrarySnapshot::toMedia(size_t index) const 
+{
+    const LibrarySnapshotRecord& entry = m_records[index];
+    
+    std::filesystem::file_time_type lastModified{
+        std::filesystem::file_time_type::duration(entry.lastModified) };
+    models::MediaFileModel media(std::string(path(index)), static_cast<size_t>(entry.fileSize), lastModified);
+    
+    // Straight from the mapping: artist and album are interned, not copied
+    media.setTitle(text(entry.titleOffset, entry.titleLength));
+    media.setArtist(text(entry.artistOffset, entry.artistLength));
+    media.setAlbum(text(entry.albumOffset, entry.albumLength));
+    media.setDuration(entry.duration);
+    
+    return media;
+}
+
+bool LibrarySnapshot::write(const std::string& filePath, const std::vector<const models::MediaFileModel*>& media) 
+{
+    std::vector<LibrarySnapshotRecord> records;
+    records.reserve(media.size());
+    std::string heap;
+    
+    for (const models::MediaFileModel* item : media) 
+    {
+        LibrarySnapshotRecord entry;
+        std::memset(&entry, 0, sizeof(entry));
+        
+        entry.fileSize = item->getFileSize();
+        entry.lastModified = static_cast<int64_t>(item->getLastModified().time_since_epoch().count());
+        entry.duration = item->getDuration();
+        entry.type = static_cast<uint8_t>(item->getType());
+        
+        if (!appendText(heap, item->getFilePath(), entry.pathOffset, entry.pathLength) ||
+            !appendText(heap, item->getTitle(), entry.titleOffset, entry.titleLength) ||
+            !appendText(heap, item->getArtist(), entry.artistOffset, entry.artistLength) ||
+            !appendText(heap, item->getAlbum(), entry.albumOffset, entry.albumLength)) 
+        {
+            return false;
+        }
+        
+        records.push_back(entry);
+    }
+    
+    LibrarySnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.headerSize = sizeof(LibrarySnapshotHeader);
+    header.recordSize = sizeof(LibrarySnapshotRecord);
+    header.recordCount = records.size();
+    header.recordOffset = sizeof(LibrarySnapshotHeader);
+    header.heapOffset = header.recordOffset + records.size() * sizeof(LibrarySnapshotRecord);
+    header.heapSize = heap.size();
+    
+    std::string tempPath = filePath + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) 
+    {
+        return false;
+    }
+    
+    bool written = writeAll(fd, &header, sizeof(header)) &&
+                   writeAll(fd, records.data(), records.size() * sizeof(LibrarySnapshotRecord)) &&
+                   writeAll(fd, heap.data(), heap.size()) &&
+                   ::fsync(fd) == 0;
+    written = ::close(fd) == 0 && written;
+    
+    if (!written || std::rename(tempPath.c_str(), filePath.c_str()) != 0) 
+    {
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+    
+    return true;
+}
+
+bool LibrarySnapshot::isSnapshotFile(const std::string& filePath) 
+{
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) 
+    {
+        return false;
+    }
+    
+    char magic[sizeof(MAGIC)];
+    bool isSnapshot = ::read(fd, magic, sizeof(magic)) == static_cast<ssize_t>(sizeof(magic)) &&
+                      std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+    ::close(fd);
+    
+    return isSnapshot;
+}
+
+} // namespace repositories
+} // namespace media_player
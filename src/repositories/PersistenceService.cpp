@@ -0,0 +1,248 @@
+// Project includes
+#include "repositories/PersistenceService.h"
+#include "config/AppConfig.h"
+
+// System includes
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+PersistenceService::PersistenceService()
+    : PersistenceService(std::chrono::milliseconds(config::AppConfig::PERSIST_COALESCE_MS),
+                         std::chrono::milliseconds(config::AppConfig::PERSIST_MAX_DELAY_MS)) 
+{
+}
+
+PersistenceService::PersistenceService(std::chrono::milliseconds delay, std::chrono::milliseconds maxDelay)
+    : m_delay(delay)
+    , m_maxDelay(std::max(delay, maxDelay))
+    , m_stop(false)
+    , m_writes(0) 
+{
+    m_worker = std::thread(&PersistenceService::workerLoop, this);
+}
+
+PersistenceService::~PersistenceService() 
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    
+    if (m_worker.joinable()) 
+    {
+        m_worker.join();
+    }
+    
+    flush();
+}
+
+std::shared_ptr<PersistenceService> PersistenceService::getShared() 
+{
+    static std::shared_ptr<PersistenceService> instance = std::make_shared<PersistenceService>();
+    return instance;
+}
+
+void PersistenceService::markDirty(const std::string& key, WriteTask writer) 
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+        auto it = m_pending.find(key);
+        
+        if (it == m_pending.end()) 
+        {
+            m_pending.emplace(key, Pending{ std::move(writer), now, now + m_delay });
+        }
+        else 
+        {
+            // Debounce, but never past the deadline set by the first mark
+            it->second.writer = std::move(writer);
+            it->second.due = std::min(now + m_delay, it->second.firstDirty + m_maxDelay);
+        }
+    }
+    m_condition.notify_all();
+}
+
+bool PersistenceService::flush(const std::string& key) 
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this, &key]() { return m_running.count(key) == 0; });
+    
+    auto it = m_pending.find(key);
+    
+    if (it == m_pending.end()) 
+    {
+        return true;
+    }
+    
+    WriteTask writer = std::move(it->second.writer);
+    m_pending.erase(it);
+    
+    return run(lock, key, std::move(writer));
+}
+
+bool PersistenceService::flush() 
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool allSuccess = true;
+    
+    while (!m_pending.empty() || !m_running.empty()) 
+    {
+        auto it = m_pending.begin();
+        
+        while (it != m_pending.end() && m_running.count(it->first) != 0) 
+        {
+            ++it;
+        }
+        
+        if (it == m_pending.end()) 
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+        
+        std::string key = it->first;
+        WriteTask writer = std::move(it->second.writer);
+        m_pending.erase(it);
+        
+        if (!run(lock, key, std::move(writer))) 
+        {
+            allSuccess = false;
+        }
+    }
+    
+    return allSuccess;
+}
+
+size_t PersistenceService::getPendingCount() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+size_t PersistenceService::getWriteCount() const 
+{
+    return m_writes;
+}
+
+bool PersistenceService::writeFileAtomically(const std::string& path, const std::string& contents) 
+{
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    
+    if (fd < 0) 
+    {
+        return false;
+    }
+    
+    const char* data = contents.data();
+    size_t remaining = contents.size();
+    bool written = true;
+    
+    while (remaining > 0) 
+    {
+        ssize_t count = ::write(fd, data, remaining);
+        if (count <= 0) 
+        {
+            written = false;
+            break;
+        }
+        data += count;
+        remaining -= static_cast<size_t>(count);
+    }
+    
+    written = written && ::fsync(fd) == 0;
+    written = ::close(fd) == 0 && written;
+    
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) 
+    {
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+    
+    // Make the rename itself durable
+    size_t slash = path.find_last_of('/');
+    std::string dirPath = slash == std::string::npos ? "." : path.substr(0, slash == 0 ? 1 : slash);
+    int dirFd = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    
+    if (dirFd >= 0) 
+    {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    
+    return true;
+}
+
+bool PersistenceService::run(std::unique_lock<std::mutex>& lock, const std::string& key, WriteTask writer) 
+{
+    m_running.insert(key);
+    lock.unlock();
+    
+    bool success = false;
+    
+    try 
+    {
+        success = writer();
+    }
+    catch (const std::exception& e) 
+    {
+        (void)e;
+        success = false;
+    }
+    
+    lock.lock();
+    m_running.erase(key);
+    m_writes++;
+    m_condition.notify_all();
+    
+    return success;
+}
+
+void PersistenceService::workerLoop() 
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    
+    while (!m_stop) 
+    {
+        // Earliest deadline among keys that are not being written right now
+        auto next = m_pending.end();
+        
+        for (auto it = m_pending.begin(); it != m_pending.end(); ++it) 
+        {
+            if (m_running.count(it->first) == 0 && (next == m_pending.end() || it->second.due < next->second.due)) 
+            {
+                next = it;
+            }
+        }
+        
+        if (next == m_pending.end()) 
+        {
+            m_condition.wait(lock);
+            continue;
+        }
+        
+        if (next->second.due > Clock::now()) 
+        {
+            m_condition.wait_until(lock, next->second.due);
+            continue;
+        }
+        
+        std::string key = next->first;
+        WriteTask writer = std::move(next->second.writer);
+        m_pending.erase(next);
+        
+        run(lock, key, std::move(writer));
+    }
+}
+
+} // namespace repositories
+} // namespace media_player
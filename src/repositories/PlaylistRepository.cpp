@@ -1,5 +1,6 @@
 // Project includes
 #include "repositories/PlaylistRepository.h"
+#include "utils/TextSearch.h"
 
 // System includes
 #include <fstream>
@@ -14,8 +15,10 @@ namespace media_player
 namespace repositories 
 {
 
-PlaylistRepository::PlaylistRepository(const std::string& storagePath)
+PlaylistRepository::PlaylistRepository(const std::string& storagePath,
+                                       std::shared_ptr<PersistenceService> persistence)
     : m_storagePath(storagePath)
+    , m_persistence(persistence ? persistence : PersistenceService::getShared())
 {
     ensureStorageDirectoryExists();
     loadFromDisk();
@@ -23,7 +26,8 @@ PlaylistRepository::PlaylistRepository(const std::string& storagePath)
 
 PlaylistRepository::~PlaylistRepository() 
 {
-    saveToDisk();
+    // Write what is still pending before the writer loses its repository
+    m_persistence->flush(m_storagePath);
 }
 
 bool PlaylistRepository::save(const models::PlaylistModel& playlist) 
@@ -39,16 +43,9 @@ bool PlaylistRepository::save(const models::PlaylistModel& playlist)
             return false;
         }
         
-        // Save to cache
+        // Save to cache; the file is written in the background
         m_cache[id] = playlist;
-        
-        // Persist to disk
-        std::string filePath = getPlaylistFilePath(id);
-        
-        if (!serializePlaylist(playlist, filePath)) 
-        {
-            return false;
-        }
+        markDirty(id);
         
         return true;
     }
@@ -99,16 +96,9 @@ bool PlaylistRepository::update(const models::PlaylistModel& playlist)
         return false;
     }
     
-    // Update cache
+    // Update cache; the file is written in the background
     m_cache[id] = playlist;
-    
-    // Persist to disk
-    std::string filePath = getPlaylistFilePath(id);
-    
-    if (!serializePlaylist(playlist, filePath)) 
-    {
-        return false;
-    }
+    markDirty(id);
     
     return true;
 }
@@ -124,27 +114,11 @@ bool PlaylistRepository::remove(const std::string& id)
         return false;
     }
     
-    std::string name = it->second.getName();
-    
-    // Remove from cache
+    // Remove from cache; the file is deleted in the background
     m_cache.erase(it);
+    markDirty(id);
     
-    // Remove from disk
-    std::string filePath = getPlaylistFilePath(id);
-    
-    try 
-    {
-        if (fs::exists(filePath)) 
-        {
-            fs::remove(filePath);
-        }
-        
-        return true;
-    }
-    catch (const fs::filesystem_error& e) 
-    {
-        return false;
-    }
+    return true;
 }
 
 bool PlaylistRepository::exists(const std::string& id) 
@@ -172,21 +146,10 @@ void PlaylistRepository::clear()
 {
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
     
-    // Remove all files
-    try 
-    {
-        for (const auto& pair : m_cache) 
-        {
-            std::string filePath = getPlaylistFilePath(pair.first);
-            
-            if (fs::exists(filePath)) 
-            {
-                fs::remove(filePath);
-            }
-        }
-    }
-    catch (const fs::filesystem_error& e) 
+    // Their files are deleted in the background
+    for (const auto& pair : m_cache) 
     {
+        markDirty(pair.first);
     }
     
     m_cache.clear();
@@ -218,15 +181,10 @@ std::vector<models::PlaylistModel> PlaylistRepository::searchByName(const std::s
     std::lock_guard<std::recursive_mutex> lock(m_mutex);
     
     std::vector<models::PlaylistModel> results;
-    std::string lowerQuery = query;
-    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
     
     for (const auto& pair : m_cache) 
     {
-        std::string lowerName = pair.second.getName();
-        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-        
-        if (lowerName.find(lowerQuery) != std::string::npos) 
+        if (utils::TextSearch::containsIgnoreCase(pair.second.getName(), query)) 
         {
             results.push_back(pair.second);
         }
@@ -273,66 +231,97 @@ bool PlaylistRepository::loadFromDisk()
 
 bool PlaylistRepository::saveToDisk() 
 {
-    std::lock_guard<std::recursive_mutex> lock(m_mutex);
-    
-    try 
     {
-        ensureStorageDirectoryExists();
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
         
         for (const auto& pair : m_cache) 
         {
-            std::string filePath = getPlaylistFilePath(pair.first);
-            serializePlaylist(pair.second, filePath);
+            markDirty(pair.first);
         }
-        
-        return true;
-    }
-    catch (const std::exception& e) 
-    {
-        return false;
     }
+    
+    return m_persistence->flush(m_storagePath);
 }
 
-std::string PlaylistRepository::getPlaylistFilePath(const std::string& id) const 
+void PlaylistRepository::markDirty(const std::string& id) 
 {
-    return m_storagePath + "/" + id + ".playlist";
+    m_dirtyIds.insert(id);
+    m_persistence->markDirty(m_storagePath, [this]() { return writeDirtyPlaylists(); });
 }
 
-bool PlaylistRepository::serializePlaylist(const models::PlaylistModel& playlist, 
-                                          const std::string& filePath) 
+bool PlaylistRepository::writeDirtyPlaylists() 
 {
-    try 
+    // Contents are taken under the lock (nullopt: the playlist is gone), the
+    // files are written without it
+    std::vector<std::pair<std::string, std::optional<std::string>>> writes;
+    
     {
-        std::ofstream file(filePath);
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        writes.reserve(m_dirtyIds.size());
         
-        if (!file.is_open()) 
+        for (const auto& id : m_dirtyIds) 
         {
-            return false;
+            auto it = m_cache.find(id);
+            
+            if (it != m_cache.end()) 
+            {
+                writes.emplace_back(getPlaylistFilePath(id), serializePlaylist(it->second));
+            }
+            else 
+            {
+                writes.emplace_back(getPlaylistFilePath(id), std::nullopt);
+            }
         }
         
-        // Write playlist metadata
-        file << "ID:" << playlist.getId() << "\n";
-        file << "NAME:" << playlist.getName() << "\n";
-        file << "COUNT:" << playlist.getItemCount() << "\n";
-        file << "ITEMS:\n";
-        
-        const char tab = '\t';
-        for (const auto& item : playlist.getItems()) 
+        m_dirtyIds.clear();
+    }
+    
+    ensureStorageDirectoryExists();
+    bool allSuccess = true;
+    
+    for (const auto& write : writes) 
+    {
+        if (write.second) 
         {
-            std::string title = item.getTitle();
-            std::string artist = item.getArtist();
-            for (char& c : title) if (c == tab || c == '\n' || c == '\r') c = ' ';
-            for (char& c : artist) if (c == tab || c == '\n' || c == '\r') c = ' ';
-            file << item.getFilePath() << tab << title << tab << artist << "\n";
+            allSuccess = PersistenceService::writeFileAtomically(write.first, *write.second) && allSuccess;
+        }
+        else 
+        {
+            std::error_code error;
+            fs::remove(write.first, error);
+            allSuccess = !error && allSuccess;
         }
-        
-        file.close();
-        return true;
     }
-    catch (const std::exception& e) 
+    
+    return allSuccess;
+}
+
+std::string PlaylistRepository::getPlaylistFilePath(const std::string& id) const 
+{
+    return m_storagePath + "/" + id + ".playlist";
+}
+
+std::string PlaylistRepository::serializePlaylist(const models::PlaylistModel& playlist) const 
+{
+    std::ostringstream file;
+    
+    // Write playlist metadata
+    file << "ID:" << playlist.getId() << "\n";
+    file << "NAME:" << playlist.getName() << "\n";
+    file << "COUNT:" << playlist.getItemCount() << "\n";
+    file << "ITEMS:\n";
+    
+    const char tab = '\t';
+    for (const auto& item : playlist.getItems()) 
     {
-        return false;
+        std::string title = item.getTitle();
+        std::string artist = item.getArtist();
+        for (char& c : title) if (c == tab || c == '\n' || c == '\r') c = ' ';
+        for (char& c : artist) if (c == tab || c == '\n' || c == '\r') c = ' ';
+        file << item.getFilePath() << tab << title << tab << artist << "\n";
     }
+    
+    return file.str();
 }
 
 std::optional<models::PlaylistModel> PlaylistRepository::deserializePlaylist(const std::string& filePath) 
@@ -421,7 +410,8 @@ std::optional<models::PlaylistModel> PlaylistRepository::deserializePlaylist(con
         {
             if (il.path.empty()) continue;
             models::MediaFileModel media(il.path);
-            if (media.isValid()) 
+            // Missing files are marked stale later rather than dropped here
+            if (media.getType() != models::MediaType::UNKNOWN) 
             {
                 if (!il.title.empty()) media.setTitle(il.title);
                 if (!il.artist.empty()) media.setArtist(il.artist);
@@ -0,0 +1,327 @@
+// Project includes
+#include "repositories/ScanManifestRepository.h"
+
+// System includes
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string_view>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+namespace media_player 
+{
+namespace repositories 
+{
+
+ScanManifestEntry ScanManifestEntry::fromMedia(const models::MediaFileModel& media) 
+{
+    ScanManifestEntry entry;
+    entry.filePath = media.getFilePath();
+    entry.fileSize = media.getFileSize();
+    entry.lastModified = media.getLastModified().time_since_epoch().count();
+    entry.title = media.getTitle();
+    entry.artist = media.getArtist();
+    entry.album = media.getAlbum();
+    entry.duration = media.getDuration();
+    return entry;
+}
+
+bool ScanManifestEntry::matches(const models::MediaFileModel& media) const 
+{
+    return fileSize == media.getFileSize() &&
+           lastModified == media.getLastModified().time_since_epoch().count();
+}
+
+void ScanManifestEntry::applyTo(models::MediaFileModel& media) const 
+{
+    if (!title.empty()) media.setTitle(title);
+    if (!artist.empty()) media.setArtist(artist);
+    if (!album.empty()) media.setAlbum(album);
+    media.setDuration(duration);
+}
+
+ScanManifestRepository::ScanManifestRepository(const std::string& storagePath)
+    : m_storagePath(storagePath) 
+{
+    ensureStorageDirectoryExists();
+    loadFromDisk();
+}
+
+ScanManifestRepository::~ScanManifestRepository() 
+{
+    saveToDisk();
+}
+
+std::optional<ScanManifestEntry> ScanManifestRepository::find(const std::string& filePath) const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    auto it = m_entries.find(filePath);
+    
+    if (it != m_entries.end()) 
+    {
+        return it->second;
+    }
+    
+    return std::nullopt;
+}
+
+void ScanManifestRepository::put(const ScanManifestEntry& entry) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[entry.filePath] = entry;
+}
+
+void ScanManifestRepository::replaceRoot(const std::string& rootPath,
+                                         const std::vector<ScanManifestEntry>& entries) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::string prefix = rootPrefix(rootPath);
+    
+    for (auto it = m_entries.begin(); it != m_entries.end(); ) 
+    {
+        if (it->first.compare(0, prefix.size(), prefix) == 0) 
+        {
+            it = m_entries.erase(it);
+        }
+        else 
+        {
+            ++it;
+        }
+    }
+    
+    for (const auto& entry : entries) 
+    {
+        m_entries[entry.filePath] = entry;
+    }
+}
+
+void ScanManifestRepository::retainRoot(const std::string& rootPath,
+                                        const std::vector<std::string>& paths) 
+{
+    std::unordered_set<std::string_view> kept(paths.begin(), paths.end());
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::string prefix = rootPrefix(rootPath);
+    
+    for (auto it = m_entries.begin(); it != m_entries.end(); ) 
+    {
+        if (it->first.compare(0, prefix.size(), prefix) == 0 && kept.count(it->first) == 0) 
+        {
+            it = m_entries.erase(it);
+        }
+        else 
+        {
+            ++it;
+        }
+    }
+}
+
+size_t ScanManifestRepository::countUnder(const std::string& rootPath) const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    std::string prefix = rootPrefix(rootPath);
+    size_t result = 0;
+    
+    for (const auto& pair : m_entries) 
+    {
+        if (pair.first.compare(0, prefix.size(), prefix) == 0) 
+        {
+            result++;
+        }
+    }
+    
+    return result;
+}
+
+void ScanManifestRepository::clear() 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+size_t ScanManifestRepository::count() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+bool ScanManifestRepository::loadFromDisk() 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return deserializeManifest();
+}
+
+bool ScanManifestRepository::saveToDisk() 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return serializeManifest();
+}
+
+bool ScanManifestRepository::serializeManifest() 
+{
+    try 
+    {
+        std::ofstream file(getManifestFilePath());
+        
+        if (!file.is_open()) 
+        {
+            return false;
+        }
+        
+        file << "MANIFEST_VERSION:1.0\n";
+        file << "COUNT:" << m_entries.size() << "\n";
+        file << "ENTRIES:\n";
+        
+        // path\tsize\tmtime\tduration\ttitle\tartist\talbum
+        const char tab = '\t';
+        auto clean = [tab](std::string text) 
+        {
+            for (char& c : text) if (c == tab || c == '\n' || c == '\r') c = ' ';
+            return text;
+        };
+        
+        for (const auto& pair : m_entries) 
+        {
+            const auto& entry = pair.second;
+            file << entry.filePath << tab
+                 << entry.fileSize << tab
+                 << entry.lastModified << tab
+                 << entry.duration << tab
+                 << clean(entry.title) << tab
+                 << clean(entry.artist) << tab
+                 << clean(entry.album) << "\n";
+        }
+        
+        file.close();
+        
+        return true;
+    }
+    catch (const std::exception& e) 
+    {
+        return false;
+    }
+}
+
+bool ScanManifestRepository::deserializeManifest() 
+{
+    try 
+    {
+        std::string filePath = getManifestFilePath();
+        
+        if (!fs::exists(filePath)) 
+        {
+            return true;
+        }
+        
+        std::ifstream file(filePath);
+        
+        if (!file.is_open()) 
+        {
+            return false;
+        }
+        
+        m_entries.clear();
+        
+        std::string line;
+        bool readingEntries = false;
+        
+        while (std::getline(file, line)) 
+        {
+            if (line.empty()) 
+            {
+                continue;
+            }
+            
+            if (line == "ENTRIES:") 
+            {
+                readingEntries = true;
+                continue;
+            }
+            
+            if (!readingEntries) 
+            {
+                continue;
+            }
+            
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, '\t')) 
+            {
+                fields.push_back(field);
+            }
+            
+            // Trailing empty tags are dropped by getline
+            if (fields.size() < 4) 
+            {
+                continue;
+            }
+            fields.resize(7);
+            
+            try 
+            {
+                ScanManifestEntry entry;
+                entry.filePath = fields[0];
+                entry.fileSize = std::stoull(fields[1]);
+                entry.lastModified = std::stoll(fields[2]);
+                entry.duration = std::stoi(fields[3]);
+                entry.title = fields[4];
+                entry.artist = fields[5];
+                entry.album = fields[6];
+                m_entries[entry.filePath] = entry;
+            }
+            catch (...) 
+            {
+                // Skip malformed line
+            }
+        }
+        
+        file.close();
+        
+        return true;
+    }
+    catch (const std::exception& e) 
+    {
+        return false;
+    }
+}
+
+void ScanManifestRepository::ensureStorageDirectoryExists() 
+{
+    try 
+    {
+        if (!fs::exists(m_storagePath)) 
+        {
+            fs::create_directories(m_storagePath);
+        }
+    }
+    catch (const fs::filesystem_error& e) 
+    {
+    
+    }
+}
+
+std::string ScanManifestRepository::rootPrefix(const std::string& rootPath) 
+{
+    // Only whole path components count as "under" the root
+    std::string prefix = rootPath;
+    if (!prefix.empty() && prefix.back() != '/') 
+    {
+        prefix += '/';
+    }
+    return prefix;
+}
+
+std::string ScanManifestRepository::getManifestFilePath() const 
+{
+    return m_storagePath + "/scan_manifest.dat";
+}
+
+} // namespace repositories
+} // namespace media_player
@@ -0,0 +1,243 @@
+// Project includes
+#include "services/DirectoryReader.h"
+
+// System includes
+#include <chrono>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace media_player 
+{
+namespace services 
+{
+
+namespace 
+{
+#ifdef __linux__
+    constexpr size_t GETDENTS_BUFFER_SIZE = 32 * 1024;
+    
+    FileStat toFileStat(const struct stat& st) 
+    {
+        FileStat result;
+        result.size = static_cast<uintmax_t>(st.st_size);
+        result.lastModified = DirectoryReader::toFileTime(st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+        return result;
+    }
+    
+    // Closes the directory fd on every return path
+    struct FdGuard 
+    {
+        int fd;
+        ~FdGuard() 
+        {
+            if (fd >= 0) close(fd);
+        }
+    };
+#endif
+}
+
+DirectoryReader::DirectoryReader(DirectoryBackend backend)
+    : m_backend(isAvailable(backend) ? backend : DirectoryBackend::PORTABLE) 
+{
+}
+
+DirectoryBackend DirectoryReader::defaultBackend() 
+{
+#ifdef __linux__
+    return DirectoryBackend::GETDENTS;
+#else
+    return DirectoryBackend::PORTABLE;
+#endif
+}
+
+bool DirectoryReader::isAvailable(DirectoryBackend backend) 
+{
+#ifdef __linux__
+    return backend == DirectoryBackend::PORTABLE || backend == DirectoryBackend::GETDENTS;
+#else
+    return backend == DirectoryBackend::PORTABLE;
+#endif
+}
+
+bool DirectoryReader::statFile(const std::string& filePath, FileStat& result) 
+{
+#ifdef __linux__
+    struct stat st;
+    if (::stat(filePath.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) 
+    {
+        return false;
+    }
+    result = toFileStat(st);
+    return true;
+#else
+    std::error_code error;
+    if (!fs::is_regular_file(filePath, error)) 
+    {
+        return false;
+    }
+    result.size = fs::file_size(filePath, error);
+    result.lastModified = fs::last_write_time(filePath, error);
+    return !error;
+#endif
+}
+
+fs::file_time_type DirectoryReader::toFileTime(int64_t seconds, int64_t nanoseconds) 
+{
+    using FileDuration = fs::file_time_type::duration;
+    
+    // file_time_type's epoch is implementation-defined (libstdc++ uses 2174-01-01);
+    // derive its whole-second offset from system_clock once
+    static const auto epochOffset = std::chrono::round<std::chrono::seconds>(
+        fs::file_time_type::clock::now().time_since_epoch() -
+        std::chrono::duration_cast<FileDuration>(std::chrono::system_clock::now().time_since_epoch()));
+    
+    auto sinceUnixEpoch = std::chrono::seconds(seconds) + std::chrono::nanoseconds(nanoseconds);
+    return fs::file_time_type(std::chrono::duration_cast<FileDuration>(sinceUnixEpoch + epochOffset));
+}
+
+bool DirectoryReader::read(const std::string& dirPath,
+                           const FileFilter& filter,
+                           const DirectoryCallback& onDirectory,
+                           const FileCallback& onFile) const 
+{
+    if (m_backend == DirectoryBackend::GETDENTS) 
+    {
+        return readGetdents(dirPath, filter, onDirectory, onFile);
+    }
+    
+    return readPortable(dirPath, filter, onDirectory, onFile);
+}
+
+bool DirectoryReader::readPortable(const std::string& dirPath, const FileFilter& filter,
+                                   const DirectoryCallback& onDirectory, const FileCallback& onFile) const 
+{
+    try 
+    {
+        for (const auto& entry : fs::directory_iterator(dirPath)) 
+        {
+            try 
+            {
+                if (entry.is_directory()) 
+                {
+                    // Skip hidden directories
+                    if (entry.path().filename().string()[0] == '.') 
+                    {
+                        continue;
+                    }
+                    
+                    onDirectory(entry.path().string());
+                }
+                else if (entry.is_regular_file() && filter(entry.path().filename().string())) 
+                {
+                    onFile(entry.path().string(), nullptr);
+                }
+            }
+            catch (const fs::filesystem_error& e) 
+            {
+                continue;
+            }
+        }
+    }
+    catch (const fs::filesystem_error& e) 
+    {
+        return false;
+    }
+    
+    return true;
+}
+
+bool DirectoryReader::readGetdents(const std::string& dirPath, const FileFilter& filter,
+                                   const DirectoryCallback& onDirectory, const FileCallback& onFile) const 
+{
+#ifdef __linux__
+    FdGuard dir{ openat(AT_FDCWD, dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) };
+    
+    if (dir.fd < 0) 
+    {
+        return false;
+    }
+    
+    std::string prefix = dirPath;
+    if (prefix.empty() || prefix.back() != '/') 
+    {
+        prefix += '/';
+    }
+    
+    alignas(struct dirent64) char buffer[GETDENTS_BUFFER_SIZE];
+    
+    while (true) 
+    {
+        long length = syscall(SYS_getdents64, dir.fd, buffer, sizeof(buffer));
+        
+        if (length <= 0) 
+        {
+            // 0: end of directory; an error mid-way keeps what was listed
+            break;
+        }
+        
+        for (long offset = 0; offset < length; ) 
+        {
+            const auto* entry = reinterpret_cast<const struct dirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+            
+            const char* name = entry->d_name;
+            unsigned char type = entry->d_type;
+            
+            // Also skips "." and ".."
+            if (type == DT_DIR && name[0] == '.') 
+            {
+                continue;
+            }
+            
+            struct stat st;
+            bool haveStat = false;
+            
+            // Symlinks are followed like std::filesystem does; some filesystems
+            // don't report d_type at all
+            if (type == DT_LNK || type == DT_UNKNOWN) 
+            {
+                if (fstatat(dir.fd, name, &st, 0) != 0) 
+                {
+                    continue;
+                }
+                haveStat = true;
+                type = S_ISDIR(st.st_mode) ? DT_DIR : (S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN);
+            }
+            
+            if (type == DT_DIR) 
+            {
+                if (name[0] != '.') 
+                {
+                    onDirectory(prefix + name);
+                }
+            }
+            else if (type == DT_REG && filter(name)) 
+            {
+                // The only stat a candidate gets; MediaFileModel reuses it
+                if (!haveStat && fstatat(dir.fd, name, &st, 0) != 0) 
+                {
+                    continue;
+                }
+                
+                FileStat fileStat = toFileStat(st);
+                onFile(prefix + name, &fileStat);
+            }
+        }
+    }
+    
+    return true;
+#else
+    return readPortable(dirPath, filter, onDirectory, onFile);
+#endif
+}
+
+} // namespace services
+} // namespace media_player
@@ -1,6 +1,10 @@
 // Project includes
 #include "services/FileScanner.h"
 #include "config/AppConfig.h"
+#include "utils/WorkStealingPool.h"
+#include "utils/BoundedQueue.h"
+#include "services/TagPrefetcher.h"
+#include "services/NativeTagParser.h"
 
 // TagLib includes
 #include <taglib/fileref.h>
@@ -10,6 +14,7 @@
 // System includes
 #include <filesystem>
 #include <algorithm>
+#include <chrono>
 
 namespace fs = std::filesystem;
 
@@ -20,14 +25,33 @@ namespace services
 
 FileScanner::FileScanner()
     : m_maxDepth(config::AppConfig::MAX_SCAN_DEPTH)
+    , m_threadCount(config::AppConfig::SCAN_THREAD_COUNT)
+    , m_metadataWorkerCount(config::AppConfig::SCAN_METADATA_WORKERS)
+    , m_batchSize(config::AppConfig::SCAN_BATCH_SIZE)
+    , m_directoryReader(DirectoryReader::defaultBackend())
+    , m_tagPrefetch(config::AppConfig::SCAN_TAG_PREFETCH)
+    , m_nativeTags(config::AppConfig::SCAN_NATIVE_TAGS)
+    , m_idleIoPriority(config::AppConfig::SCAN_IO_IDLE_PRIORITY)
+    , m_dropPageCache(config::AppConfig::SCAN_DROP_PAGE_CACHE)
     , m_isScanning(false)
     , m_shouldStop(false)
     , m_scannedCount(0)
-    , m_totalFiles(0)
+    , m_reusedCount(0)
+    , m_prefetchedCount(0)
+    , m_nativeCount(0)
+    , m_previousTotal(0)
+    , m_discoveredFiles(0)
+    , m_dirsFound(0)
+    , m_dirsVisited(0)
+    , m_walkDone(false)
 {
     // Initialize with audio and video extensions
     // Initialize with all scannable extensions
     m_validExtensions = config::AppConfig::SCANNABLE_EXTENSIONS;
+    
+    m_ioScheduler.setLimits({ config::AppConfig::SCAN_IO_BYTES_PER_SEC, config::AppConfig::SCAN_IO_OPS_PER_SEC });
+    m_ioScheduler.setPlaybackLimits({ config::AppConfig::SCAN_IO_PLAYBACK_BYTES_PER_SEC, 
+                                      config::AppConfig::SCAN_IO_PLAYBACK_OPS_PER_SEC });
 }
 
 FileScanner::~FileScanner() 
@@ -56,7 +80,12 @@ void FileScanner::scanDirectory(const std::string& rootPath)
     m_shouldStop = false;
     m_isScanning = true;
     m_foundFiles.clear();
+    m_streamedPaths.clear();
     m_scannedCount = 0;
+    m_reusedCount = 0;
+    m_prefetchedCount = 0;
+    m_nativeCount = 0;
+    beginProgress(rootPath);
     
     // Ensure previous thread is joined before creating new one
     if (m_scanThread && m_scanThread->joinable()) 
@@ -118,30 +147,14 @@ std::vector<models::MediaFileModel> FileScanner::scanDirectorySync(const std::st
     m_shouldStop = false;
     m_isScanning = true;
     m_foundFiles.clear();
+    m_streamedPaths.clear();
     m_scannedCount = 0;
+    m_reusedCount = 0;
+    m_prefetchedCount = 0;
+    m_nativeCount = 0;
+    beginProgress(rootPath);
     
-    // Count total files first (estimate)
-    int totalEstimate = 0;
-    try 
-    {
-        for (auto& p : fs::recursive_directory_iterator(rootPath, fs::directory_options::skip_permission_denied)) 
-        {
-            if (p.is_regular_file()) 
-            {
-                std::string ext = p.path().extension().string();
-                std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                if (hasValidExtension(ext)) 
-                {
-                    totalEstimate++;
-                }
-            }
-        }
-    }
-    catch (...) {}
-    
-    m_totalFiles = totalEstimate;
-    
-    scanRecursive(rootPath, 0);
+    scanTree(rootPath);
     
     m_isScanning = false;
     
@@ -153,16 +166,160 @@ void FileScanner::setMaxDepth(int depth)
     m_maxDepth = depth;
 }
 
+int FileScanner::getMaxDepth() const 
+{
+    return m_maxDepth;
+}
+
 void FileScanner::setFileExtensions(const std::vector<std::string>& extensions) 
 {
     m_validExtensions = extensions;
 }
 
+void FileScanner::setThreadCount(int threadCount) 
+{
+    m_threadCount = std::max(1, threadCount);
+}
+
+int FileScanner::getThreadCount() const 
+{
+    return m_threadCount;
+}
+
+void FileScanner::setDirectoryBackend(DirectoryBackend backend) 
+{
+    m_directoryReader = DirectoryReader(backend);
+}
+
+DirectoryBackend FileScanner::getDirectoryBackend() const 
+{
+    return m_directoryReader.getBackend();
+}
+
+void FileScanner::setTagPrefetch(bool enabled) 
+{
+    m_tagPrefetch = enabled;
+}
+
+bool FileScanner::isTagPrefetchEnabled() const 
+{
+    return m_tagPrefetch;
+}
+
+int FileScanner::getPrefetchedCount() const 
+{
+    return m_prefetchedCount;
+}
+
+void FileScanner::setNativeTagParser(bool enabled) 
+{
+    m_nativeTags = enabled;
+}
+
+bool FileScanner::isNativeTagParserEnabled() const 
+{
+    return m_nativeTags;
+}
+
+int FileScanner::getNativeTagCount() const 
+{
+    return m_nativeCount;
+}
+
+void FileScanner::setIoLimits(const ScanIoLimits& limits, const ScanIoLimits& duringPlayback) 
+{
+    m_ioScheduler.setLimits(limits);
+    m_ioScheduler.setPlaybackLimits(duringPlayback);
+}
+
+void FileScanner::setPlaybackProbe(PlaybackProbe probe) 
+{
+    m_ioScheduler.setPlaybackProbe(std::move(probe));
+}
+
+bool FileScanner::isIoBackingOff() const 
+{
+    return m_ioScheduler.isBackingOff();
+}
+
+double FileScanner::getIoThrottledSeconds() const 
+{
+    return m_ioScheduler.getThrottledSeconds();
+}
+
+void FileScanner::setIdleIoPriority(bool enabled) 
+{
+    m_idleIoPriority = enabled;
+}
+
+void FileScanner::setDropPageCache(bool enabled) 
+{
+    m_dropPageCache = enabled;
+}
+
+void FileScanner::setMetadataWorkerCount(int workerCount) 
+{
+    m_metadataWorkerCount = std::max(0, workerCount);
+}
+
+int FileScanner::getMetadataWorkerCount() const 
+{
+    return m_metadataWorkerCount;
+}
+
+void FileScanner::setBatchCallback(ScanBatchCallback callback) 
+{
+    m_batchCallback = callback;
+}
+
+void FileScanner::setBatchSize(size_t batchSize) 
+{
+    m_batchSize = std::max<size_t>(1, batchSize);
+}
+
+std::vector<std::string> FileScanner::takeStreamedPaths() 
+{
+    return std::move(m_streamedPaths);
+}
+
+ScanPipelineStats FileScanner::getLastPipelineStats() const 
+{
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return m_pipelineStats;
+}
+
+void FileScanner::setScanManifest(std::shared_ptr<repositories::ScanManifestRepository> manifest) 
+{
+    m_manifest = manifest;
+}
+
+int FileScanner::getReusedTagCount() const 
+{
+    return m_reusedCount;
+}
+
+std::optional<models::MediaFileModel> FileScanner::scanFile(const std::string& filePath) 
+{
+    if (!isValidMediaFile(filePath)) 
+    {
+        return std::nullopt;
+    }
+    
+    auto media = readMediaFile(filePath);
+    
+    if (media && m_manifest) 
+    {
+        m_manifest->put(repositories::ScanManifestEntry::fromMedia(*media));
+    }
+    
+    return media;
+}
+
 void FileScanner::scanWorker(const std::string& rootPath) 
 {
     try 
     {
-        scanRecursive(rootPath, 0);
+        scanTree(rootPath);
         
         if (!m_shouldStop) 
         {
@@ -179,106 +336,702 @@ void FileScanner::scanWorker(const std::string& rootPath)
     m_isScanning = false;
 }
 
-void FileScanner::scanRecursive(const std::string& dirPath, int currentDepth) 
+void FileScanner::scanTree(const std::string& rootPath) 
 {
-    if (m_shouldStop) 
+    // Walk and reader threads start below, so they inherit the idle class
+    IdleIoPriorityScope ioPriority(m_idleIoPriority);
+    m_ioScheduler.beginScan(rootPath);
+    
+    if (m_metadataWorkerCount > 0) 
     {
-        return;
+        scanPipelined(rootPath);
+    }
+    else 
+    {
+        scanInline(rootPath);
     }
     
-    if (currentDepth > m_maxDepth) 
+    if (!m_shouldStop) 
     {
-        return;
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        m_lastScanCounts[rootPath] = static_cast<int>(m_foundFiles.size() + m_streamedPaths.size());
     }
     
-    try 
+    // Final report so the total settles on the exact count
+    notifyProgress(m_scannedCount, rootPath);
+    
+    updateManifest(rootPath);
+}
+
+void FileScanner::scanInline(const std::string& rootPath) 
+{
+    // Tags are read inline by whichever walk worker found the file
+    std::vector<std::vector<models::MediaFileModel>> workerResults(static_cast<size_t>(m_threadCount));
+    
+    walkTree(rootPath, [this, &workerResults](size_t workerIndex, const std::string& filePath, const FileStat* stat) 
+    {
+        m_discoveredFiles++;
+        auto media = readMediaFile(filePath, stat);
+        if (media) 
+        {
+            workerResults[workerIndex].push_back(std::move(*media));
+            recordFound(filePath);
+        }
+    });
+    m_walkDone = true;
+    
+    for (auto& results : workerResults) 
+    {
+        m_foundFiles.insert(m_foundFiles.end(),
+                            std::make_move_iterator(results.begin()),
+                            std::make_move_iterator(results.end()));
+    }
+    
+    if (m_threadCount > 1) 
     {
-        for (const auto& entry : fs::directory_iterator(dirPath)) 
+        sortFoundFiles();
+    }
+}
+
+void FileScanner::scanPipelined(const std::string& rootPath) 
+{
+    auto startTime = std::chrono::steady_clock::now();
+    
+    utils::BoundedQueue<ScanCandidate> pathQueue(config::AppConfig::SCAN_QUEUE_CAPACITY);
+    utils::BoundedQueue<models::MediaFileModel> mediaQueue(config::AppConfig::SCAN_QUEUE_CAPACITY);
+    
+    std::thread walker;
+    std::vector<std::thread> readers;
+    std::atomic<int> activeReaders(m_metadataWorkerCount);
+    
+    // If the sink throws (a batch callback, say), stop the other stages and
+    // join them before the queues go away
+    struct PipelineGuard 
+    {
+        std::atomic<bool>& shouldStop;
+        utils::BoundedQueue<ScanCandidate>& pathQueue;
+        utils::BoundedQueue<models::MediaFileModel>& mediaQueue;
+        std::thread& walker;
+        std::vector<std::thread>& readers;
+        
+        void join() 
         {
-            if (m_shouldStop) 
+            if (walker.joinable()) 
             {
-                return;
+                walker.join();
+            }
+            for (auto& reader : readers) 
+            {
+                if (reader.joinable()) 
+                {
+                    reader.join();
+                }
+            }
+        }
+        
+        ~PipelineGuard() 
+        {
+            bool running = walker.joinable() ||
+                std::any_of(readers.begin(), readers.end(), [](const std::thread& t) { return t.joinable(); });
+            if (running) 
+            {
+                shouldStop = true;
+                pathQueue.close();
+                mediaQueue.close();
+                join();
+            }
+        }
+    } guard{ m_shouldStop, pathQueue, mediaQueue, walker, readers };
+    
+    // Stage 1: directory walk, only media paths go downstream
+    walker = std::thread([this, &rootPath, &pathQueue]() 
+    {
+        try 
+        {
+            walkTree(rootPath, [this, &pathQueue](size_t, const std::string& filePath, const FileStat* stat) 
+            {
+                m_discoveredFiles++;
+                pathQueue.push(ScanCandidate{ filePath, stat ? std::optional<FileStat>(*stat) : std::nullopt });
+            });
+        }
+        catch (...) 
+        {
+        }
+        m_walkDone = true;
+        pathQueue.close();
+    });
+    
+    // Stage 2: tag readers; the last one to finish closes the media queue
+    readers.reserve(static_cast<size_t>(m_metadataWorkerCount));
+    
+    for (int i = 0; i < m_metadataWorkerCount; ++i) 
+    {
+        readers.emplace_back([this, &pathQueue, &mediaQueue, &activeReaders]() 
+        {
+            // Each reader has its own ring; without io_uring it reads the blocking way
+            std::unique_ptr<TagPrefetcher> prefetcher;
+            if (m_tagPrefetch) 
+            {
+                prefetcher = std::make_unique<TagPrefetcher>(config::AppConfig::SCAN_PREFETCH_HEAD_BYTES,
+                                                             config::AppConfig::SCAN_PREFETCH_TAIL_BYTES);
+                if (!prefetcher->isAvailable()) 
+                {
+                    prefetcher.reset();
+                }
             }
             
-            try 
+            std::vector<ScanCandidate> batch;
+            
+            while (auto candidate = pathQueue.waitAndPop()) 
             {
-                if (entry.is_directory()) 
+                // Keep draining after a stop so the walk never blocks on a full queue
+                if (m_shouldStop) 
                 {
-                    // Skip hidden directories
-                    if (entry.path().filename().string()[0] == '.') 
-                    {
-                        continue;
-                    }
-                    
-                    scanRecursive(entry.path().string(), currentDepth + 1);
+                    continue;
                 }
-                else if (entry.is_regular_file()) 
+                
+                batch.clear();
+                batch.push_back(std::move(*candidate));
+                
+                // Prefetch whatever else is already queued along with it; one file
+                // at a time while playback shares the device, to keep its queue short
+                size_t prefetchBatch = m_ioScheduler.isBackingOff() 
+                    ? 1 
+                    : static_cast<size_t>(config::AppConfig::SCAN_PREFETCH_BATCH);
+                while (prefetcher && batch.size() < prefetchBatch) 
                 {
-                    std::string filePath = entry.path().string();
-                    
-                    if (isValidMediaFile(filePath)) 
+                    auto next = pathQueue.tryPop();
+                    if (!next) 
                     {
-                        models::MediaFileModel media(filePath);
-                        
-                        if (media.isValid()) 
-                        {
-                            // Read metadata using TagLib
-                            try 
-                            {
-                                TagLib::FileRef file(filePath.c_str());
-                                if (!file.isNull()) 
-                                {
-                                    TagLib::Tag* tag = file.tag();
-                                    if (tag) 
-                                    {
-                                        std::string title = tag->title().toCString(true);
-                                        std::string artist = tag->artist().toCString(true);
-                                        std::string album = tag->album().toCString(true);
-                                        
-                                        if (!title.empty()) media.setTitle(title);
-                                        if (!artist.empty()) media.setArtist(artist);
-                                        if (!album.empty()) media.setAlbum(album);
-                                    }
-                                    
-                                    TagLib::AudioProperties* props = file.audioProperties();
-                                    if (props) 
-                                    {
-                                        media.setDuration(props->lengthInSeconds());
-                                    }
-                                }
-                            }
-                            catch (...) 
-                            {
-                                // Ignore metadata read errors
-                            }
-                            
-                            m_foundFiles.push_back(media);
-                            m_scannedCount++;
-                            
-                            // Notify progress every 10 files
-                            if (m_scannedCount % 10 == 0) 
-                            {
-                                notifyProgress(m_scannedCount, filePath);
-                            }
-                        }
+                        break;
                     }
-                    else
+                    batch.push_back(std::move(*next));
+                }
+                
+                try 
+                {
+                    readMediaBatch(batch, prefetcher.get(), [&mediaQueue](models::MediaFileModel&& media) 
                     {
-                    }
+                        mediaQueue.push(std::move(media));
+                    });
+                }
+                catch (...) 
+                {
                 }
             }
-            catch (const fs::filesystem_error& e) 
+            
+            if (--activeReaders == 0) 
+            {
+                mediaQueue.close();
+            }
+        });
+    }
+    
+    // Stage 3: batching sink on the calling thread
+    std::vector<models::MediaFileModel> batch;
+    batch.reserve(m_batchSize);
+    uint64_t batchCount = 0;
+    double sinkBlockedSeconds = 0.0;
+    double firstBatchSeconds = 0.0;
+    
+    auto flush = [this, &batch, &batchCount, &sinkBlockedSeconds, &firstBatchSeconds, startTime]() 
+    {
+        auto flushStart = std::chrono::steady_clock::now();
+        if (batchCount == 0) 
+        {
+            firstBatchSeconds = std::chrono::duration<double>(flushStart - startTime).count();
+        }
+        emitBatch(batch);
+        sinkBlockedSeconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - flushStart).count();
+        batchCount++;
+    };
+    
+    while (auto media = mediaQueue.waitAndPop()) 
+    {
+        recordFound(media->getFilePath());
+        batch.push_back(std::move(*media));
+        
+        if (batch.size() >= m_batchSize) 
+        {
+            flush();
+        }
+    }
+    
+    if (!batch.empty()) 
+    {
+        flush();
+    }
+    
+    guard.join();
+    
+    sortFoundFiles();
+    
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    auto rate = [elapsed](uint64_t items) 
+    {
+        return elapsed > 0.0 ? items / elapsed : 0.0;
+    };
+    
+    ScanPipelineStats stats;
+    stats.discovery.itemsOut = pathQueue.getPushCount();
+    stats.discovery.blockedSeconds = pathQueue.getPushWaitSeconds();
+    stats.discovery.itemsPerSecond = rate(stats.discovery.itemsOut);
+    stats.metadata.itemsOut = mediaQueue.getPushCount();
+    stats.metadata.blockedSeconds = mediaQueue.getPushWaitSeconds();
+    stats.metadata.starvedSeconds = pathQueue.getPopWaitSeconds();
+    stats.metadata.itemsPerSecond = rate(stats.metadata.itemsOut);
+    stats.sink.itemsOut = mediaQueue.getPopCount();
+    stats.sink.blockedSeconds = sinkBlockedSeconds;
+    stats.sink.starvedSeconds = mediaQueue.getPopWaitSeconds();
+    stats.sink.itemsPerSecond = rate(stats.sink.itemsOut);
+    stats.pathQueueHighWater = pathQueue.getHighWaterMark();
+    stats.mediaQueueHighWater = mediaQueue.getHighWaterMark();
+    stats.batchCount = batchCount;
+    stats.firstBatchSeconds = firstBatchSeconds;
+    stats.elapsedSeconds = elapsed;
+    
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_pipelineStats = stats;
+}
+
+void FileScanner::walkTree(const std::string& rootPath, const FileVisitor& visitor) 
+{
+    if (m_threadCount > 1) 
+    {
+        scanParallel(rootPath, visitor);
+    }
+    else 
+    {
+        scanRecursive(rootPath, 0, visitor);
+    }
+}
+
+void FileScanner::scanRecursive(const std::string& dirPath, int currentDepth, const FileVisitor& visitor) 
+{
+    m_dirsVisited++;
+    
+    if (m_shouldStop) 
+    {
+        return;
+    }
+    
+    if (currentDepth > m_maxDepth) 
+    {
+        return;
+    }
+    
+    listDirectory(dirPath,
+        [this, currentDepth, &visitor](const std::string& subdirPath) 
+        {
+            m_dirsFound++;
+            scanRecursive(subdirPath, currentDepth + 1, visitor);
+        },
+        [&visitor](const std::string& filePath, const FileStat* stat) 
+        {
+            visitor(0, filePath, stat);
+        });
+}
+
+void FileScanner::scanParallel(const std::string& rootPath, const FileVisitor& visitor) 
+{
+    // Each directory is a task: a worker enumerates it, hands its files to the
+    // visitor and pushes subdirectories back so idle workers can steal them
+    utils::WorkStealingPool<DirectoryTask> pool(static_cast<size_t>(m_threadCount));
+    
+    pool.run({ DirectoryTask{ rootPath, 0 } },
+        [this, &visitor](size_t workerIndex, DirectoryTask& task,
+                         const utils::WorkStealingPool<DirectoryTask>::Spawn& spawn) 
+        {
+            m_dirsVisited++;
+            
+            if (task.depth > m_maxDepth) 
+            {
+                return;
+            }
+            
+            listDirectory(task.path,
+                [this, &task, &spawn](const std::string& subdirPath) 
+                {
+                    m_dirsFound++;
+                    spawn(DirectoryTask{ subdirPath, task.depth + 1 });
+                },
+                [workerIndex, &visitor](const std::string& filePath, const FileStat* stat) 
+                {
+                    visitor(workerIndex, filePath, stat);
+                });
+        },
+        &m_shouldStop);
+}
+
+bool FileScanner::listDirectory(const std::string& dirPath, 
+                                const DirectoryReader::DirectoryCallback& onDirectory,
+                                const DirectoryReader::FileCallback& onFile) 
+{
+    // Only media files reach the visitor, so only they are ever stat'ed
+    uint64_t ops = 1;
+    bool listed = m_directoryReader.read(dirPath,
+        [this](const std::string& fileName) 
+        {
+            return !m_shouldStop && isValidMediaFile(fileName);
+        },
+        [this, &onDirectory](const std::string& subdirPath) 
+        {
+            if (!m_shouldStop) 
+            {
+                onDirectory(subdirPath);
+            }
+        },
+        [&ops, &onFile](const std::string& filePath, const FileStat* stat) 
+        {
+            // A stat from the walk is one more operation on the device
+            if (stat) 
+            {
+                ops++;
+            }
+            onFile(filePath, stat);
+        });
+    
+    m_ioScheduler.charge(0, ops, m_shouldStop);
+    return listed;
+}
+
+std::optional<models::MediaFileModel> FileScanner::readMediaFile(const std::string& filePath, const FileStat* stat) 
+{
+    // With a stat from the walk the file is known to exist; don't stat it again
+    FileStat ownStat;
+    if (!stat) 
+    {
+        if (!DirectoryReader::statFile(filePath, ownStat)) 
+        {
+            return std::nullopt;
+        }
+        stat = &ownStat;
+    }
+    
+    models::MediaFileModel media(filePath, stat->size, stat->lastModified);
+    
+    if (media.getType() == models::MediaType::UNKNOWN) 
+    {
+        return std::nullopt;
+    }
+    
+    // Unchanged since the last scan: the stat above is all the I/O we need
+    if (reuseManifestTags(media)) 
+    {
+        return media;
+    }
+    
+    if (m_nativeTags) 
+    {
+        FileTagSource source(filePath, media.getFileSize());
+        source.setDropCache(shouldDropCache(filePath));
+        bool parsed = readNativeTags(media, source);
+        m_ioScheduler.charge(source.getBytesRead(), source.getReadCount(), m_shouldStop);
+        
+        if (parsed) 
+        {
+            return media;
+        }
+    }
+    
+    // Exotic tags, other formats: TagLib
+    try 
+    {
+        TagLib::FileRef file(filePath.c_str());
+        applyTags(media, file);
+    }
+    catch (...) 
+    {
+        // Ignore metadata read errors
+    }
+    chargeTagLibRead(filePath);
+    
+    return media;
+}
+
+void FileScanner::readMediaBatch(std::vector<ScanCandidate>& batch, TagPrefetcher* prefetcher,
+                                 const std::function<void(models::MediaFileModel&&)>& sink) 
+{
+    if (!prefetcher) 
+    {
+        for (auto& candidate : batch) 
+        {
+            auto media = readMediaFile(candidate.path, candidate.stat ? &*candidate.stat : nullptr);
+            if (media) 
+            {
+                sink(std::move(*media));
+            }
+        }
+        return;
+    }
+    
+    std::vector<PrefetchedFile> files;
+    files.reserve(batch.size());
+    
+    for (auto& candidate : batch) 
+    {
+        PrefetchedFile file;
+        file.path = std::move(candidate.path);
+        
+        if (candidate.stat) 
+        {
+            // Manifest hits need no reads at all
+            models::MediaFileModel media(file.path, candidate.stat->size, candidate.stat->lastModified);
+            if (media.getType() == models::MediaType::UNKNOWN) 
             {
                 continue;
             }
+            if (reuseManifestTags(media)) 
+            {
+                sink(std::move(media));
+                continue;
+            }
+            
+            file.hasStat = true;
+            file.stat = *candidate.stat;
         }
+        
+        file.dropCache = shouldDropCache(file.path);
+        files.push_back(std::move(file));
+    }
+    
+    std::vector<bool> checkedManifest(files.size());
+    for (size_t i = 0; i < files.size(); ++i) 
+    {
+        checkedManifest[i] = files[i].hasStat;
     }
-    catch (const fs::filesystem_error& e) 
+    
+    prefetcher->prefetch(files);
+    
+    // open, statx if the walk did not stat, head and tail reads
+    uint64_t prefetchedBytes = 0;
+    uint64_t prefetchOps = 0;
+    for (size_t i = 0; i < files.size(); ++i) 
     {
+        prefetchedBytes += files[i].head.size() + files[i].tail.size();
+        prefetchOps += 1 + (checkedManifest[i] ? 0 : 1) + (files[i].head.empty() ? 0 : 1) + (files[i].tail.empty() ? 0 : 1);
+    }
+    m_ioScheduler.charge(prefetchedBytes, prefetchOps, m_shouldStop);
+    
+    for (size_t i = 0; i < files.size(); ++i) 
+    {
+        const PrefetchedFile& file = files[i];
         
+        if (!file.ok) 
+        {
+            // Blocking path, same as without io_uring
+            auto media = readMediaFile(file.path, file.hasStat ? &file.stat : nullptr);
+            if (media) 
+            {
+                sink(std::move(*media));
+            }
+            continue;
+        }
+        
+        models::MediaFileModel media(file.path, file.stat.size, file.stat.lastModified);
+        if (media.getType() == models::MediaType::UNKNOWN) 
+        {
+            continue;
+        }
+        
+        if (checkedManifest[i] || !reuseManifestTags(media)) 
+        {
+            FileTagSource source(file.path, file.stat.size);
+            source.addPreloaded(0, file.head);
+            source.addPreloaded(file.tailOffset, file.tail);
+            source.setDropCache(file.dropCache);
+            
+            bool parsed = m_nativeTags && readNativeTags(media, source);
+            m_ioScheduler.charge(source.getBytesRead(), source.getReadCount(), m_shouldStop);
+            
+            if (parsed) 
+            {
+                m_prefetchedCount++;
+                sink(std::move(media));
+                continue;
+            }
+            
+            try 
+            {
+                PrefetchedFileStream stream(file);
+                TagLib::FileRef tagFile(&stream);
+                applyTags(media, tagFile);
+                m_ioScheduler.charge(0, stream.getFallbackReads(), m_shouldStop);
+            }
+            catch (...) 
+            {
+                // Ignore metadata read errors
+            }
+            if (file.dropCache) 
+            {
+                ScanIoScheduler::dropPageCache(file.path);
+            }
+            m_prefetchedCount++;
+        }
+        
+        sink(std::move(media));
+    }
+}
+
+bool FileScanner::reuseManifestTags(models::MediaFileModel& media) 
+{
+    if (!m_manifest) 
+    {
+        return false;
+    }
+    
+    auto cached = m_manifest->find(media.getFilePath());
+    if (cached && cached->matches(media)) 
+    {
+        cached->applyTo(media);
+        m_reusedCount++;
+        return true;
+    }
+    
+    return false;
+}
+
+bool FileScanner::readNativeTags(models::MediaFileModel& media, TagByteSource& source) 
+{
+    std::string extension = toLowerCase(std::string(media.getExtension()));
+    if (!NativeTagParser::isSupportedExtension(extension)) 
+    {
+        return false;
+    }
+    
+    NativeTags tags;
+    if (!NativeTagParser::parse(source, extension, tags)) 
+    {
+        return false;
+    }
+    
+    if (!tags.title.empty()) media.setTitle(tags.title);
+    if (!tags.artist.empty()) media.setArtist(tags.artist);
+    if (!tags.album.empty()) media.setAlbum(tags.album);
+    media.setDuration(tags.durationSeconds);
+    
+    m_nativeCount++;
+    return true;
+}
+
+void FileScanner::chargeTagLibRead(const std::string& filePath) 
+{
+    // TagLib's reads are not visible from here; charge a typical header + tail read
+    m_ioScheduler.charge(config::AppConfig::SCAN_PREFETCH_HEAD_BYTES + config::AppConfig::SCAN_PREFETCH_TAIL_BYTES, 
+                         2, m_shouldStop);
+    
+    if (shouldDropCache(filePath)) 
+    {
+        ScanIoScheduler::dropPageCache(filePath);
+    }
+}
+
+bool FileScanner::shouldDropCache(const std::string& filePath) const 
+{
+    // The track being played keeps its pages
+    return m_dropPageCache && !m_ioScheduler.isPlaybackFile(filePath);
+}
+
+void FileScanner::applyTags(models::MediaFileModel& media, TagLib::FileRef& file) 
+{
+    if (file.isNull()) 
+    {
+        return;
+    }
+    
+    TagLib::Tag* tag = file.tag();
+    if (tag) 
+    {
+        std::string title = tag->title().toCString(true);
+        std::string artist = tag->artist().toCString(true);
+        std::string album = tag->album().toCString(true);
+        
+        if (!title.empty()) media.setTitle(title);
+        if (!artist.empty()) media.setArtist(artist);
+        if (!album.empty()) media.setAlbum(album);
+    }
+    
+    TagLib::AudioProperties* props = file.audioProperties();
+    if (props) 
+    {
+        media.setDuration(props->lengthInSeconds());
+    }
+}
+
+void FileScanner::updateManifest(const std::string& rootPath) 
+{
+    // A cancelled scan only saw part of the tree; keep the old entries
+    if (!m_manifest || m_shouldStop) 
+    {
+        return;
+    }
+    
+    // Streamed records were put as they went by; only their paths are left
+    if (!m_streamedPaths.empty()) 
+    {
+        m_manifest->retainRoot(rootPath, m_streamedPaths);
+        return;
+    }
+    
+    std::vector<repositories::ScanManifestEntry> entries;
+    entries.reserve(m_foundFiles.size());
+    
+    for (const auto& media : m_foundFiles) 
+    {
+        entries.push_back(repositories::ScanManifestEntry::fromMedia(media));
+    }
+    
+    m_manifest->replaceRoot(rootPath, entries);
+}
+
+void FileScanner::recordFound(const std::string& filePath) 
+{
+    int count = ++m_scannedCount;
+    
+    // Notify progress every 10 files
+    if (count % 10 == 0) 
+    {
+        notifyProgress(count, filePath);
     }
 }
 
+void FileScanner::emitBatch(std::vector<models::MediaFileModel>& batch) 
+{
+    if (m_batchCallback) 
+    {
+        // The callback takes the records; a full copy here would double the library
+        for (const auto& media : batch) 
+        {
+            m_streamedPaths.push_back(media.getFilePath());
+            if (m_manifest) 
+            {
+                m_manifest->put(repositories::ScanManifestEntry::fromMedia(media));
+            }
+        }
+        m_batchCallback(std::move(batch));
+    }
+    else 
+    {
+        m_foundFiles.insert(m_foundFiles.end(),
+                            std::make_move_iterator(batch.begin()),
+                            std::make_move_iterator(batch.end()));
+    }
+    
+    batch.clear();
+    batch.reserve(m_batchSize);
+}
+
+void FileScanner::sortFoundFiles() 
+{
+    // Worker interleaving is nondeterministic; keep a stable order for callers
+    std::sort(m_foundFiles.begin(), m_foundFiles.end(),
+        [](const models::MediaFileModel& a, const models::MediaFileModel& b) 
+        {
+            return a.getFilePath() < b.getFilePath();
+        });
+}
+
 bool FileScanner::isValidMediaFile(const std::string& filePath) const 
 {
     std::string extension = getFileExtension(filePath);
@@ -313,15 +1066,63 @@ std::string FileScanner::toLowerCase(const std::string& str) const
     return result;
 }
 
+void FileScanner::beginProgress(const std::string& rootPath) 
+{
+    m_discoveredFiles = 0;
+    m_dirsFound = 1;    // The root itself
+    m_dirsVisited = 0;
+    m_walkDone = false;
+    
+    // Seed the total with what this root held last time, if we know
+    m_previousTotal = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+        auto it = m_lastScanCounts.find(rootPath);
+        if (it != m_lastScanCounts.end()) 
+        {
+            m_previousTotal = it->second;
+        }
+    }
+    
+    if (m_previousTotal == 0 && m_manifest) 
+    {
+        m_previousTotal = static_cast<int>(m_manifest->countUnder(rootPath));
+    }
+}
+
+int FileScanner::estimateTotal() const 
+{
+    int discovered = m_discoveredFiles;
+    
+    if (m_walkDone) 
+    {
+        return discovered;
+    }
+    
+    // Extrapolate the media-per-directory rate over directories not yet listed
+    int visited = m_dirsVisited;
+    int pending = std::max(0, m_dirsFound - visited);
+    int projected = discovered;
+    if (visited > 0) 
+    {
+        projected += static_cast<int>(static_cast<long long>(pending) * discovered / visited);
+    }
+    
+    return std::max(m_previousTotal.load(), projected);
+}
+
 void FileScanner::notifyProgress(int count, const std::string& currentPath) 
 {
+    // Parallel workers report concurrently; callbacks keep single-caller semantics
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+    
     if (m_progressCallback) 
     {
         m_progressCallback(count, currentPath);
     }
     if (m_progressCallback3) 
     {
-        m_progressCallback3(count, m_totalFiles, currentPath);
+        m_progressCallback3(count, estimateTotal(), currentPath);
     }
 }
 
@@ -0,0 +1,408 @@
+// Project includes
+#include "services/LibraryWatcher.h"
+
+// System includes
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace media_player 
+{
+namespace services 
+{
+
+namespace 
+{
+    // Files are reported once fully written (CLOSE_WRITE) or moved in;
+    // CREATE is only used to tell a new file from a modified one
+    constexpr uint32_t WATCH_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE |
+                                    IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+    
+    constexpr int IDLE_POLL_MS = 200;
+    constexpr int DEFAULT_SETTLE_MS = 150;
+    constexpr int MAX_SETTLE_FACTOR = 10;   // Report a long burst at least every 10 settle periods
+}
+
+LibraryWatcher::LibraryWatcher(std::shared_ptr<FileScanner> fileScanner)
+    : m_fileScanner(fileScanner)
+    , m_inotifyFd(-1)
+    , m_settleDelayMs(DEFAULT_SETTLE_MS)
+    , m_maxDepth(0)
+    , m_isWatching(false)
+    , m_shouldStop(false) 
+{
+}
+
+LibraryWatcher::~LibraryWatcher() 
+{
+    stop();
+}
+
+bool LibraryWatcher::start(const std::string& rootPath) 
+{
+    stop();
+    
+    if (!m_fileScanner) 
+    {
+        return false;
+    }
+    
+    try 
+    {
+        if (!fs::is_directory(rootPath)) 
+        {
+            return false;
+        }
+    }
+    catch (const fs::filesystem_error& e) 
+    {
+        return false;
+    }
+    
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    
+    if (m_inotifyFd < 0) 
+    {
+        return false;
+    }
+    
+    m_rootPath = rootPath;
+    m_maxDepth = m_fileScanner->getMaxDepth();
+    m_shouldStop = false;
+    
+    // Existing files are already in the library; only watch from here on
+    addWatchRecursive(rootPath, 0, nullptr);
+    
+    m_isWatching = true;
+    m_watchThread = std::thread(&LibraryWatcher::watchLoop, this);
+    
+    return true;
+}
+
+void LibraryWatcher::stop() 
+{
+    m_shouldStop = true;
+    
+    if (m_watchThread.joinable()) 
+    {
+        m_watchThread.join();
+    }
+    
+    if (m_inotifyFd >= 0) 
+    {
+        // Closing the descriptor drops every watch at once
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_watchPaths.clear();
+    }
+    
+    m_isWatching = false;
+}
+
+bool LibraryWatcher::isWatching() const 
+{
+    return m_isWatching;
+}
+
+std::string LibraryWatcher::getRootPath() const 
+{
+    return m_rootPath;
+}
+
+size_t LibraryWatcher::getWatchCount() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_watchPaths.size();
+}
+
+void LibraryWatcher::setChangeCallback(LibraryChangeCallback callback) 
+{
+    m_changeCallback = callback;
+}
+
+void LibraryWatcher::setSettleDelay(int milliseconds) 
+{
+    m_settleDelayMs = std::max(1, milliseconds);
+}
+
+void LibraryWatcher::watchLoop() 
+{
+    // Keyed by path: repeated events for one file collapse into one change
+    std::map<std::string, LibraryChange> pending;
+    auto firstPending = std::chrono::steady_clock::now();
+    
+    while (!m_shouldStop) 
+    {
+        pollfd pfd{ m_inotifyFd, POLLIN, 0 };
+        int timeout = pending.empty() ? IDLE_POLL_MS : m_settleDelayMs;
+        int ready = poll(&pfd, 1, timeout);
+        
+        if (ready < 0) 
+        {
+            if (errno == EINTR) 
+            {
+                continue;
+            }
+            break;
+        }
+        
+        if (ready > 0 && (pfd.revents & POLLIN)) 
+        {
+            bool wasEmpty = pending.empty();
+            readEvents(pending);
+            
+            if (wasEmpty) 
+            {
+                firstPending = std::chrono::steady_clock::now();
+            }
+            
+            // Still busy: wait for the burst to settle, but not forever
+            auto waited = std::chrono::steady_clock::now() - firstPending;
+            if (waited < std::chrono::milliseconds(m_settleDelayMs * MAX_SETTLE_FACTOR)) 
+            {
+                continue;
+            }
+        }
+        
+        if (!pending.empty()) 
+        {
+            flush(pending);
+        }
+    }
+}
+
+void LibraryWatcher::readEvents(std::map<std::string, LibraryChange>& pending) 
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+    
+    while (true) 
+    {
+        ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        
+        if (length <= 0) 
+        {
+            // EAGAIN: drained
+            return;
+        }
+        
+        for (char* ptr = buffer; ptr < buffer + length; ) 
+        {
+            const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+            
+            if (event->mask & IN_Q_OVERFLOW) 
+            {
+                pending[m_rootPath] = LibraryChange{ LibraryChangeType::RESCAN_NEEDED, m_rootPath, std::nullopt };
+                continue;
+            }
+            
+            if (event->mask & IN_IGNORED) 
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_watchPaths.erase(event->wd);
+                continue;
+            }
+            
+            if (event->len == 0) 
+            {
+                continue;
+            }
+            
+            std::string dirPath;
+            int depth;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_watchPaths.find(event->wd);
+                if (it == m_watchPaths.end()) 
+                {
+                    continue;
+                }
+                dirPath = it->second.path;
+                depth = it->second.depth;
+            }
+            
+            std::string name(event->name);
+            std::string path = dirPath + "/" + name;
+            
+            if (event->mask & IN_ISDIR) 
+            {
+                // Skip hidden directories, like the scanner does
+                if (name[0] == '.') 
+                {
+                    continue;
+                }
+                
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) 
+                {
+                    // Files may already be inside (moved in, or copied before the watch existed)
+                    addWatchRecursive(path, depth + 1, &pending);
+                }
+                else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) 
+                {
+                    removeWatchesUnder(path);
+                    
+                    for (auto it = pending.begin(); it != pending.end(); ) 
+                    {
+                        it = isUnder(it->first, path) ? pending.erase(it) : std::next(it);
+                    }
+                    pending[path] = LibraryChange{ LibraryChangeType::DIRECTORY_REMOVED, path, std::nullopt };
+                }
+                continue;
+            }
+            
+            if (!m_fileScanner->isValidMediaFile(path)) 
+            {
+                continue;
+            }
+            
+            if (event->mask & (IN_DELETE | IN_MOVED_FROM)) 
+            {
+                pending[path] = LibraryChange{ LibraryChangeType::FILE_REMOVED, path, std::nullopt };
+            }
+            else if (event->mask & (IN_CREATE | IN_MOVED_TO)) 
+            {
+                pending[path] = LibraryChange{ LibraryChangeType::FILE_ADDED, path, std::nullopt };
+            }
+            else if (event->mask & IN_CLOSE_WRITE) 
+            {
+                auto it = pending.find(path);
+                if (it == pending.end() || it->second.type != LibraryChangeType::FILE_ADDED) 
+                {
+                    pending[path] = LibraryChange{ LibraryChangeType::FILE_MODIFIED, path, std::nullopt };
+                }
+            }
+        }
+    }
+}
+
+void LibraryWatcher::addWatchRecursive(const std::string& dirPath, int depth,
+                                       std::map<std::string, LibraryChange>* pending) 
+{
+    // Same limit as FileScanner::scanRecursive: deeper files are not in the library
+    if (depth > m_maxDepth) 
+    {
+        return;
+    }
+    
+    int wd = inotify_add_watch(m_inotifyFd, dirPath.c_str(), WATCH_MASK);
+    
+    if (wd < 0) 
+    {
+        // ENOSPC: max_user_watches reached, this subtree stays unwatched
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_watchPaths[wd] = WatchedDirectory{ dirPath, depth };
+    }
+    
+    try 
+    {
+        for (const auto& entry : fs::directory_iterator(dirPath)) 
+        {
+            try 
+            {
+                if (entry.is_directory()) 
+                {
+                    if (entry.path().filename().string()[0] == '.') 
+                    {
+                        continue;
+                    }
+                    
+                    addWatchRecursive(entry.path().string(), depth + 1, pending);
+                }
+                else if (pending && entry.is_regular_file()) 
+                {
+                    std::string path = entry.path().string();
+                    if (m_fileScanner->isValidMediaFile(path)) 
+                    {
+                        (*pending)[path] = LibraryChange{ LibraryChangeType::FILE_ADDED, path, std::nullopt };
+                    }
+                }
+            }
+            catch (const fs::filesystem_error& e) 
+            {
+                continue;
+            }
+        }
+    }
+    catch (const fs::filesystem_error& e) 
+    {
+    }
+}
+
+void LibraryWatcher::removeWatchesUnder(const std::string& dirPath) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    
+    for (auto it = m_watchPaths.begin(); it != m_watchPaths.end(); ) 
+    {
+        if (it->second.path == dirPath || isUnder(it->second.path, dirPath)) 
+        {
+            // Already gone for deleted directories; needed for ones moved out of the root
+            inotify_rm_watch(m_inotifyFd, it->first);
+            it = m_watchPaths.erase(it);
+        }
+        else 
+        {
+            ++it;
+        }
+    }
+}
+
+void LibraryWatcher::flush(std::map<std::string, LibraryChange>& pending) 
+{
+    std::vector<LibraryChange> changes;
+    changes.reserve(pending.size());
+    
+    for (auto& pair : pending) 
+    {
+        LibraryChange& change = pair.second;
+        
+        if (change.type == LibraryChangeType::FILE_ADDED ||
+            change.type == LibraryChangeType::FILE_MODIFIED) 
+        {
+            change.media = m_fileScanner->scanFile(change.path);
+            
+            if (!change.media) 
+            {
+                // Vanished again before we got to it
+                if (fs::exists(change.path)) 
+                {
+                    continue;
+                }
+                change.type = LibraryChangeType::FILE_REMOVED;
+            }
+        }
+        
+        changes.push_back(std::move(change));
+    }
+    
+    pending.clear();
+    
+    if (!changes.empty() && m_changeCallback) 
+    {
+        m_changeCallback(std::move(changes));
+    }
+}
+
+bool LibraryWatcher::isUnder(const std::string& path, const std::string& dirPath) 
+{
+    return path.size() > dirPath.size() &&
+           path[dirPath.size()] == '/' &&
+           path.compare(0, dirPath.size(), dirPath) == 0;
+}
+
+} // namespace services
+} // namespace media_player
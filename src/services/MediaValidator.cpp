@@ -0,0 +1,166 @@
+// Project includes
+#include "services/MediaValidator.h"
+#include "services/DirectoryReader.h"
+#include "utils/WorkStealingPool.h"
+
+// System includes
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+namespace media_player 
+{
+namespace services 
+{
+
+namespace 
+{
+
+// Few enough that a slow device is not flooded, enough to keep its queue busy
+constexpr size_t PATHS_PER_TASK = 64;
+
+struct PathRange 
+{
+    size_t first;
+    size_t last;
+};
+
+} // namespace
+
+MediaValidator::MediaValidator(size_t threadCount)
+    : m_threadCount(std::max<size_t>(1, threadCount))
+    , m_batchSize(DEFAULT_BATCH_SIZE)
+    , m_isRunning(false)
+    , m_shouldStop(false)
+    , m_checkedCount(0)
+    , m_missingCount(0) 
+{
+}
+
+MediaValidator::~MediaValidator() 
+{
+    stop();
+}
+
+bool MediaValidator::start(std::vector<std::string> paths) 
+{
+    if (m_isRunning) 
+    {
+        return false;
+    }
+    
+    // The previous run has finished; reap its thread
+    if (m_thread.joinable()) 
+    {
+        m_thread.join();
+    }
+    
+    m_shouldStop = false;
+    m_checkedCount = 0;
+    m_missingCount = 0;
+    m_isRunning = true;
+    m_thread = std::thread(&MediaValidator::run, this, std::move(paths));
+    return true;
+}
+
+void MediaValidator::stop() 
+{
+    m_shouldStop = true;
+    wait();
+}
+
+void MediaValidator::wait() 
+{
+    if (m_thread.joinable()) 
+    {
+        m_thread.join();
+    }
+}
+
+bool MediaValidator::isRunning() const 
+{
+    return m_isRunning;
+}
+
+void MediaValidator::setResultCallback(ValidationCallback callback) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_resultCallback = std::move(callback);
+}
+
+void MediaValidator::setBatchSize(size_t batchSize) 
+{
+    m_batchSize = std::max<size_t>(1, batchSize);
+}
+
+size_t MediaValidator::getCheckedCount() const 
+{
+    return m_checkedCount;
+}
+
+size_t MediaValidator::getMissingCount() const 
+{
+    return m_missingCount;
+}
+
+std::vector<std::string> MediaValidator::findMissing(const std::vector<std::string>& paths) const 
+{
+    std::vector<PathRange> tasks;
+    for (size_t first = 0; first < paths.size(); first += PATHS_PER_TASK) 
+    {
+        tasks.push_back({ first, std::min(first + PATHS_PER_TASK, paths.size()) });
+    }
+    
+    // One flag per path, written by whichever worker took its range
+    std::vector<uint8_t> missing(paths.size(), 0);
+    utils::WorkStealingPool<PathRange> pool(std::min(m_threadCount, std::max<size_t>(1, tasks.size())));
+    
+    pool.run(std::move(tasks), [&paths, &missing](size_t, PathRange& range, const auto&) 
+    {
+        FileStat stat;
+        for (size_t i = range.first; i < range.last; ++i) 
+        {
+            missing[i] = !DirectoryReader::statFile(paths[i], stat);
+        }
+    });
+    
+    std::vector<std::string> result;
+    for (size_t i = 0; i < paths.size(); ++i) 
+    {
+        if (missing[i]) 
+        {
+            result.push_back(paths[i]);
+        }
+    }
+    return result;
+}
+
+void MediaValidator::run(std::vector<std::string> paths) 
+{
+    std::vector<std::string> batch;
+    
+    for (size_t first = 0; first < paths.size() && !m_shouldStop; first += m_batchSize) 
+    {
+        size_t last = std::min(first + m_batchSize, paths.size());
+        batch.assign(std::make_move_iterator(paths.begin() + first), std::make_move_iterator(paths.begin() + last));
+        
+        std::vector<std::string> missing = findMissing(batch);
+        m_checkedCount += batch.size();
+        m_missingCount += missing.size();
+        
+        if (!missing.empty()) 
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_resultCallback) 
+            {
+                m_resultCallback(std::move(missing));
+            }
+        }
+    }
+    
+    m_isRunning = false;
+}
+
+} // namespace services
+} // namespace media_player
@@ -1,5 +1,6 @@
 // Project includes
 #include "services/MetadataReader.h"
+#include "services/NativeTagParser.h"
 
 // TagLib includes
 #include <taglib/fileref.h>
@@ -36,6 +37,27 @@ std::unique_ptr<models::MetadataModel> MetadataReader::readMetadata(const std::s
     
     auto metadata = std::make_unique<models::MetadataModel>();
     
+    // MP3/WAV: one pass over the tag headers, cover art found without loading it
+    NativeTags nativeTags;
+    if (NativeTagParser::parseFile(filePath, nativeTags)) 
+    {
+        metadata->setTitle(nativeTags.title);
+        metadata->setArtist(nativeTags.artist);
+        metadata->setAlbum(nativeTags.album);
+        metadata->setGenre(nativeTags.genre);
+        metadata->setYear(std::to_string(nativeTags.year));
+        metadata->setCustomTag("duration", std::to_string(nativeTags.durationSeconds));
+        metadata->setCustomTag("bitrate", std::to_string(nativeTags.bitrateKbps));
+        
+        if (nativeTags.hasCoverArt) 
+        {
+            metadata->setCustomTag("cover_art_available", "true");
+            metadata->setCustomTag("cover_art_size", std::to_string(nativeTags.coverArtSize));
+        }
+        
+        return metadata;
+    }
+    
     try 
     {
         TagLib::FileRef file(filePath.c_str());
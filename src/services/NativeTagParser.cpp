@@ -0,0 +1,1073 @@
+// Project includes
+#include "services/NativeTagParser.h"
+#include "services/ScanIoScheduler.h"
+
+// System includes
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace media_player 
+{
+namespace services 
+{
+
+namespace 
+{
+
+constexpr size_t MIN_READ_SIZE = 8 * 1024;          // Smallest pread; covers a typical tag without art
+constexpr size_t ID3V2_HEADER_SIZE = 10;
+constexpr size_t ID3V1_SIZE = 128;
+constexpr size_t APE_FOOTER_SIZE = 32;
+constexpr size_t MAX_TEXT_FRAME = 64 * 1024;        // Larger text frames are skipped
+constexpr size_t MAX_PICTURE_HEADER = 1024;         // MIME type + description of an APIC frame
+constexpr size_t FRAME_SYNC_PROBE = 4 * 1024;       // First look for the MPEG frame this close to the tag
+constexpr size_t FRAME_SYNC_WINDOW = 16 * 1024;     // How far past the tag the first MPEG frame may start
+constexpr size_t MAX_INFO_LIST = 64 * 1024;
+
+const char* const ID3V1_GENRES[] = {
+    "Blues", "Classic Rock", "Country", "Dance", "Disco", "Funk", "Grunge", "Hip-Hop",
+    "Jazz", "Metal", "New Age", "Oldies", "Other", "Pop", "R&B", "Rap",
+    "Reggae", "Rock", "Techno", "Industrial", "Alternative", "Ska", "Death Metal", "Pranks",
+    "Soundtrack", "Euro-Techno", "Ambient", "Trip-Hop", "Vocal", "Jazz+Funk", "Fusion", "Trance",
+    "Classical", "Instrumental", "Acid", "House", "Game", "Sound Clip", "Gospel", "Noise",
+    "Alternative Rock", "Bass", "Soul", "Punk", "Space", "Meditative", "Instrumental Pop", "Instrumental Rock",
+    "Ethnic", "Gothic", "Darkwave", "Techno-Industrial", "Electronic", "Pop-Folk", "Eurodance", "Dream",
+    "Southern Rock", "Comedy", "Cult", "Gangsta", "Top 40", "Christian Rap", "Pop/Funk", "Jungle",
+    "Native American", "Cabaret", "New Wave", "Psychedelic", "Rave", "Showtunes", "Trailer", "Lo-Fi",
+    "Tribal", "Acid Punk", "Acid Jazz", "Polka", "Retro", "Musical", "Rock & Roll", "Hard Rock",
+    "Folk", "Folk Rock", "National Folk", "Swing", "Fast Fusion", "Bebop", "Latin", "Revival",
+    "Celtic", "Bluegrass", "Avantgarde", "Gothic Rock", "Progressive Rock", "Psychedelic Rock", "Symphonic Rock", "Slow Rock",
+    "Big Band", "Chorus", "Easy Listening", "Acoustic", "Humour", "Speech", "Chanson", "Opera",
+    "Chamber Music", "Sonata", "Symphony", "Booty Bass", "Primus", "Porn Groove", "Satire", "Slow Jam",
+    "Club", "Tango", "Samba", "Folklore", "Ballad", "Power Ballad", "Rhythmic Soul", "Freestyle",
+    "Duet", "Punk Rock", "Drum Solo", "A Cappella", "Euro-House", "Dancehall", "Goa", "Drum & Bass",
+    "Club-House", "Hardcore Techno", "Terror", "Indie", "Britpop", "Worldbeat", "Polsk Punk", "Beat",
+    "Christian Gangsta Rap", "Heavy Metal", "Black Metal", "Crossover", "Contemporary Christian", "Christian Rock", "Merengue", "Salsa",
+    "Thrash Metal", "Anime", "Jpop", "Synthpop"
+};
+constexpr int ID3V1_GENRE_COUNT = static_cast<int>(sizeof(ID3V1_GENRES) / sizeof(ID3V1_GENRES[0]));
+
+// Bitrates in kbps: [MPEG-1 L1, L2, L3, MPEG-2/2.5 L1, L2/L3][index]
+const int MPEG_BITRATES[5][15] = {
+    { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448 },
+    { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384 },
+    { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320 },
+    { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256 },
+    { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160 }
+};
+
+// Sample rates: [MPEG-1, MPEG-2, MPEG-2.5][index]
+const int MPEG_SAMPLE_RATES[3][3] = {
+    { 44100, 48000, 32000 },
+    { 22050, 24000, 16000 },
+    { 11025, 12000, 8000 }
+};
+
+uint32_t readBE32(const char* data) 
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+uint32_t readLE32(const char* data) 
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+uint16_t readLE16(const char* data) 
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// 28-bit integer stored in 4 bytes of 7 bits; false if a byte has its high bit set
+bool readSyncSafe(const char* data, uint32_t& value) 
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    if ((p[0] | p[1] | p[2] | p[3]) & 0x80) 
+    {
+        return false;
+    }
+    value = (uint32_t(p[0]) << 21) | (uint32_t(p[1]) << 14) | (uint32_t(p[2]) << 7) | uint32_t(p[3]);
+    return true;
+}
+
+void appendUtf8(std::string& out, uint32_t codePoint) 
+{
+    if (codePoint < 0x80) 
+    {
+        out += static_cast<char>(codePoint);
+    }
+    else if (codePoint < 0x800) 
+    {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000) 
+    {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else 
+    {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+void appendLatin1(std::string& out, const char* data, size_t size) 
+{
+    for (size_t i = 0; i < size; ++i) 
+    {
+        appendUtf8(out, static_cast<unsigned char>(data[i]));
+    }
+}
+
+void appendUtf16(std::string& out, const char* data, size_t size, bool bigEndian) 
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    for (size_t i = 0; i + 1 < size; i += 2) 
+    {
+        uint32_t unit = bigEndian ? (p[i] << 8) | p[i + 1] : p[i] | (p[i + 1] << 8);
+        if (unit >= 0xD800 && unit < 0xDC00 && i + 3 < size) 
+        {
+            uint32_t low = bigEndian ? (p[i + 2] << 8) | p[i + 3] : p[i + 2] | (p[i + 3] << 8);
+            if (low >= 0xDC00 && low < 0xE000) 
+            {
+                appendUtf8(out, 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00));
+                i += 2;
+                continue;
+            }
+        }
+        appendUtf8(out, unit);
+    }
+}
+
+// Trailing spaces and NULs, as TagLib trims ID3v1 fields
+size_t trimmedLength(const char* data, size_t size) 
+{
+    size_t length = 0;
+    while (length < size && data[length] != '\0') 
+    {
+        ++length;
+    }
+    while (length > 0 && data[length - 1] == ' ') 
+    {
+        --length;
+    }
+    return length;
+}
+
+int parseYear(const std::string& text) 
+{
+    int year = 0;
+    size_t digits = 0;
+    while (digits < text.size() && digits < 4 && text[digits] >= '0' && text[digits] <= '9') 
+    {
+        year = year * 10 + (text[digits] - '0');
+        ++digits;
+    }
+    return digits == 4 ? year : 0;
+}
+
+// Decodes an ID3v2 text payload (encoding byte first); NUL-separated values are joined with a space
+std::string decodeText(const char* data, size_t size) 
+{
+    std::string result;
+    if (size < 1) 
+    {
+        return result;
+    }
+    
+    unsigned char encoding = static_cast<unsigned char>(data[0]);
+    const char* text = data + 1;
+    size_t length = size - 1;
+    size_t unitSize = (encoding == 1 || encoding == 2) ? 2 : 1;
+    bool bigEndian = encoding == 2;
+    
+    size_t start = 0;
+    while (start < length) 
+    {
+        size_t end = start;
+        while (end + unitSize <= length &&
+               !(text[end] == '\0' && (unitSize == 1 || text[end + 1] == '\0'))) 
+        {
+            end += unitSize;
+        }
+        end = std::min(end, length);
+        
+        const char* field = text + start;
+        size_t fieldSize = end - start;
+        
+        if (encoding == 1 && fieldSize >= 2) 
+        {
+            unsigned char b0 = static_cast<unsigned char>(field[0]);
+            unsigned char b1 = static_cast<unsigned char>(field[1]);
+            if (b0 == 0xFE && b1 == 0xFF) 
+            {
+                bigEndian = true;
+                field += 2;
+                fieldSize -= 2;
+            }
+            else if (b0 == 0xFF && b1 == 0xFE) 
+            {
+                bigEndian = false;
+                field += 2;
+                fieldSize -= 2;
+            }
+        }
+        
+        if (fieldSize > 0) 
+        {
+            if (!result.empty()) 
+            {
+                result += ' ';
+            }
+            if (encoding == 0) 
+            {
+                appendLatin1(result, field, fieldSize);
+            }
+            else if (encoding == 3) 
+            {
+                result.append(field, fieldSize);
+            }
+            else 
+            {
+                appendUtf16(result, field, fieldSize, bigEndian);
+            }
+        }
+        
+        start = end + unitSize;
+    }
+    
+    return result;
+}
+
+const char* genreName(int index) 
+{
+    return index >= 0 && index < ID3V1_GENRE_COUNT ? ID3V1_GENRES[index] : nullptr;
+}
+
+// TCON values may be ID3v1 genre numbers: "17" or "(17)"
+std::string resolveGenre(const std::string& value) 
+{
+    std::string result;
+    size_t start = 0;
+    
+    while (start <= value.size()) 
+    {
+        size_t end = value.find(' ', start);
+        if (end == std::string::npos) 
+        {
+            end = value.size();
+        }
+        std::string part = value.substr(start, end - start);
+        
+        std::string digits = part;
+        if (digits.size() > 2 && digits.front() == '(' && digits.back() == ')') 
+        {
+            digits = digits.substr(1, digits.size() - 2);
+        }
+        const char* name = nullptr;
+        if (!digits.empty() && digits.size() <= 3 &&
+            std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) 
+        {
+            name = genreName(std::stoi(digits));
+        }
+        
+        if (!part.empty()) 
+        {
+            if (!result.empty()) 
+            {
+                result += ' ';
+            }
+            result += name ? name : part;
+        }
+        start = end + 1;
+    }
+    
+    return result;
+}
+
+// Picture bytes of an APIC frame: everything after encoding, MIME type, type and description
+bool pictureSize(const char* data, size_t available, size_t frameSize, size_t& size) 
+{
+    if (available < 2) 
+    {
+        return false;
+    }
+    
+    unsigned char encoding = static_cast<unsigned char>(data[0]);
+    const char* mimeEnd = static_cast<const char*>(std::memchr(data + 1, '\0', available - 1));
+    if (!mimeEnd) 
+    {
+        return false;
+    }
+    
+    size_t pos = static_cast<size_t>(mimeEnd - data) + 2;     // NUL, then picture type
+    size_t unitSize = (encoding == 1 || encoding == 2) ? 2 : 1;
+    while (pos + unitSize <= available) 
+    {
+        if (data[pos] == '\0' && (unitSize == 1 || data[pos + 1] == '\0')) 
+        {
+            pos += unitSize;
+            if (pos > frameSize) 
+            {
+                return false;
+            }
+            size = frameSize - pos;
+            return true;
+        }
+        pos += unitSize;
+    }
+    return false;
+}
+
+struct Id3v2Result 
+{
+    bool present = false;
+    uintmax_t end = 0;          // First byte after the tag (and footer)
+};
+
+void setIfEmpty(std::string& field, std::string value) 
+{
+    if (field.empty()) 
+    {
+        field = std::move(value);
+    }
+}
+
+// Tag at offset, if any. False for tags TagLib should read.
+bool parseId3v2(TagByteSource& source, uintmax_t offset, NativeTags& tags, Id3v2Result& result) 
+{
+    result.end = offset;
+    
+    const char* header = source.view(offset, ID3V2_HEADER_SIZE);
+    if (!header || std::memcmp(header, "ID3", 3) != 0) 
+    {
+        return true;
+    }
+    
+    unsigned char major = static_cast<unsigned char>(header[3]);
+    unsigned char flags = static_cast<unsigned char>(header[5]);
+    uint32_t tagSize = 0;
+    
+    if ((major != 3 && major != 4) || !readSyncSafe(header + 6, tagSize)) 
+    {
+        return false;
+    }
+    if (flags & 0x80) 
+    {
+        // Unsynchronised tag
+        return false;
+    }
+    
+    result.present = true;
+    uintmax_t pos = offset + ID3V2_HEADER_SIZE;
+    uintmax_t end = pos + tagSize;
+    result.end = end + ((major == 4 && (flags & 0x10)) ? ID3V2_HEADER_SIZE : 0);
+    
+    if (flags & 0x40) 
+    {
+        const char* extended = source.view(pos, 4);
+        uint32_t extendedSize = 0;
+        if (!extended) 
+        {
+            return false;
+        }
+        if (major == 4) 
+        {
+            // Includes its own size field
+            if (!readSyncSafe(extended, extendedSize)) 
+            {
+                return false;
+            }
+            pos += extendedSize;
+        }
+        else 
+        {
+            pos += 4 + readBE32(extended);
+        }
+    }
+    
+    while (pos + ID3V2_HEADER_SIZE <= end) 
+    {
+        const char* frame = source.view(pos, ID3V2_HEADER_SIZE);
+        if (!frame) 
+        {
+            return false;
+        }
+        if (frame[0] == '\0') 
+        {
+            // Padding
+            break;
+        }
+        
+        char id[5] = { frame[0], frame[1], frame[2], frame[3], '\0' };
+        for (int i = 0; i < 4; ++i) 
+        {
+            if (!((id[i] >= 'A' && id[i] <= 'Z') || (id[i] >= '0' && id[i] <= '9'))) 
+            {
+                // Garbage after the last frame; TagLib stops here too
+                return true;
+            }
+        }
+        
+        uint32_t frameSize = 0;
+        if (major != 4 || !readSyncSafe(frame + 4, frameSize)) 
+        {
+            frameSize = readBE32(frame + 4);
+        }
+        unsigned char formatFlags = static_cast<unsigned char>(frame[9]);
+        uintmax_t body = pos + ID3V2_HEADER_SIZE;
+        pos = body + frameSize;
+        
+        if (pos > end) 
+        {
+            break;
+        }
+        
+        bool isText = std::strcmp(id, "TIT2") == 0 || std::strcmp(id, "TPE1") == 0 ||
+                      std::strcmp(id, "TALB") == 0 || std::strcmp(id, "TCON") == 0 ||
+                      std::strcmp(id, "TYER") == 0 || std::strcmp(id, "TDRC") == 0;
+        bool isPicture = std::strcmp(id, "APIC") == 0 && !tags.hasCoverArt;
+        if (!isText && !isPicture) 
+        {
+            continue;
+        }
+        
+        // Compressed, encrypted or unsynchronised frame
+        bool encoded = major == 4 ? (formatFlags & 0x0E) != 0 : (formatFlags & 0xC0) != 0;
+        if (encoded) 
+        {
+            return false;
+        }
+        
+        // Grouping id and (v2.4) data length indicator precede the payload
+        size_t prefix = 0;
+        if (major == 4) 
+        {
+            prefix += (formatFlags & 0x40) ? 1 : 0;
+            prefix += (formatFlags & 0x01) ? 4 : 0;
+        }
+        else 
+        {
+            prefix += (formatFlags & 0x20) ? 1 : 0;
+        }
+        if (prefix > frameSize) 
+        {
+            continue;
+        }
+        body += prefix;
+        size_t payloadSize = frameSize - prefix;
+        
+        if (isPicture) 
+        {
+            size_t headerSize = std::min(payloadSize, MAX_PICTURE_HEADER);
+            const char* picture = source.view(body, headerSize);
+            size_t size = 0;
+            if (picture && pictureSize(picture, headerSize, payloadSize, size)) 
+            {
+                tags.hasCoverArt = true;
+                tags.coverArtSize = size;
+            }
+            continue;
+        }
+        
+        if (payloadSize == 0 || payloadSize > MAX_TEXT_FRAME) 
+        {
+            continue;
+        }
+        const char* payload = source.view(body, payloadSize);
+        if (!payload) 
+        {
+            return false;
+        }
+        std::string text = decodeText(payload, payloadSize);
+        
+        switch (id[1]) 
+        {
+            case 'I':
+                setIfEmpty(tags.title, std::move(text));
+                break;
+            case 'P':
+                setIfEmpty(tags.artist, std::move(text));
+                break;
+            case 'A':
+                setIfEmpty(tags.album, std::move(text));
+                break;
+            case 'C':
+                setIfEmpty(tags.genre, resolveGenre(text));
+                break;
+            default:
+                // TYER, TDRC
+                if (tags.year == 0) 
+                {
+                    tags.year = parseYear(text);
+                }
+                break;
+        }
+    }
+    
+    return true;
+}
+
+// Fields of a 128-byte "TAG" block the ID3v2 tag left empty
+void applyId3v1(const char* block, NativeTags& tags) 
+{
+    auto field = [block](size_t offset, size_t size) 
+    {
+        std::string value;
+        appendLatin1(value, block + offset, trimmedLength(block + offset, size));
+        return value;
+    };
+    
+    setIfEmpty(tags.title, field(3, 30));
+    setIfEmpty(tags.artist, field(33, 30));
+    setIfEmpty(tags.album, field(63, 30));
+    if (tags.year == 0) 
+    {
+        tags.year = parseYear(field(93, 4));
+    }
+    if (tags.genre.empty()) 
+    {
+        const char* name = genreName(static_cast<unsigned char>(block[127]));
+        if (name) 
+        {
+            tags.genre = name;
+        }
+    }
+}
+
+struct MpegHeader 
+{
+    int version = 0;            // 0: MPEG-1, 1: MPEG-2, 2: MPEG-2.5
+    int layer = 0;              // 1..3
+    int bitrate = 0;            // kbps
+    int sampleRate = 0;
+    bool mono = false;
+    size_t frameLength = 0;
+    int samplesPerFrame = 0;
+};
+
+bool parseMpegHeader(const char* data, MpegHeader& header) 
+{
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data);
+    if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) 
+    {
+        return false;
+    }
+    
+    int versionBits = (p[1] >> 3) & 0x03;
+    int layerBits = (p[1] >> 1) & 0x03;
+    int bitrateIndex = p[2] >> 4;
+    int sampleRateIndex = (p[2] >> 2) & 0x03;
+    if (versionBits == 1 || layerBits == 0 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3) 
+    {
+        return false;
+    }
+    
+    header.version = versionBits == 3 ? 0 : (versionBits == 2 ? 1 : 2);
+    header.layer = 4 - layerBits;
+    int table = header.version == 0 ? header.layer - 1 : (header.layer == 1 ? 3 : 4);
+    header.bitrate = MPEG_BITRATES[table][bitrateIndex];
+    header.sampleRate = MPEG_SAMPLE_RATES[header.version][sampleRateIndex];
+    header.mono = (p[3] >> 6) == 3;
+    
+    int padding = (p[2] >> 1) & 0x01;
+    if (header.layer == 1) 
+    {
+        header.samplesPerFrame = 384;
+        header.frameLength = static_cast<size_t>((12 * header.bitrate * 1000 / header.sampleRate + padding) * 4);
+    }
+    else 
+    {
+        bool halfFrame = header.layer == 3 && header.version != 0;
+        header.samplesPerFrame = halfFrame ? 576 : 1152;
+        header.frameLength = static_cast<size_t>((halfFrame ? 72 : 144) * header.bitrate * 1000 / header.sampleRate + padding);
+    }
+    return header.frameLength > 4;
+}
+
+// First MPEG frame at or after offset whose successor (if inside the window) also looks valid
+bool findFirstFrame(TagByteSource& source, uintmax_t offset, uintmax_t& frameOffset, MpegHeader& header) 
+{
+    uintmax_t fileSize = source.size();
+    if (offset >= fileSize) 
+    {
+        return false;
+    }
+    
+    // Close to the tag first, which usually stays inside the bytes already read
+    size_t fullSize = static_cast<size_t>(std::min<uintmax_t>(FRAME_SYNC_WINDOW, fileSize - offset));
+    for (size_t windowSize : { std::min(FRAME_SYNC_PROBE, fullSize), fullSize }) 
+    {
+        const char* window = source.view(offset, windowSize);
+        if (!window) 
+        {
+            return false;
+        }
+        bool lastPass = windowSize == fullSize;
+        
+        for (size_t i = 0; i + 4 <= windowSize; ++i) 
+        {
+            if (static_cast<unsigned char>(window[i]) != 0xFF || !parseMpegHeader(window + i, header)) 
+            {
+                continue;
+            }
+            
+            size_t next = i + header.frameLength;
+            if (next + 4 <= windowSize) 
+            {
+                MpegHeader nextHeader;
+                if (!parseMpegHeader(window + next, nextHeader) ||
+                    nextHeader.version != header.version || nextHeader.layer != header.layer ||
+                    nextHeader.sampleRate != header.sampleRate) 
+                {
+                    continue;
+                }
+            }
+            else if (!lastPass) 
+            {
+                // Check its successor in the wider window
+                break;
+            }
+            
+            frameOffset = offset + i;
+            return true;
+        }
+        
+        if (lastPass) 
+        {
+            break;
+        }
+    }
+    return false;
+}
+
+bool parseMp3(TagByteSource& source, NativeTags& tags) 
+{
+    uintmax_t fileSize = source.size();
+    
+    Id3v2Result id3v2;
+    if (!parseId3v2(source, 0, tags, id3v2)) 
+    {
+        return false;
+    }
+    
+    // Tail: ID3v1, and APE tags which only TagLib reads
+    uintmax_t audioEnd = fileSize;
+    if (fileSize >= ID3V1_SIZE + APE_FOOTER_SIZE) 
+    {
+        const char* tail = source.view(fileSize - ID3V1_SIZE - APE_FOOTER_SIZE, ID3V1_SIZE + APE_FOOTER_SIZE);
+        if (!tail) 
+        {
+            return false;
+        }
+        const char* id3v1 = tail + APE_FOOTER_SIZE;
+        bool hasId3v1 = std::memcmp(id3v1, "TAG", 3) == 0;
+        if (std::memcmp(hasId3v1 ? tail : id3v1 + ID3V1_SIZE - APE_FOOTER_SIZE, "APETAGEX", 8) == 0) 
+        {
+            return false;
+        }
+        if (hasId3v1) 
+        {
+            applyId3v1(id3v1, tags);
+            audioEnd -= ID3V1_SIZE;
+        }
+    }
+    else if (fileSize >= ID3V1_SIZE) 
+    {
+        const char* id3v1 = source.view(fileSize - ID3V1_SIZE, ID3V1_SIZE);
+        if (id3v1 && std::memcmp(id3v1, "TAG", 3) == 0) 
+        {
+            applyId3v1(id3v1, tags);
+            audioEnd -= ID3V1_SIZE;
+        }
+    }
+    
+    uintmax_t frameOffset = 0;
+    MpegHeader header;
+    if (!findFirstFrame(source, id3v2.end, frameOffset, header)) 
+    {
+        return false;
+    }
+    
+    // Xing/Info sits after the side information, VBRI at a fixed offset
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    size_t sideInfo = header.version == 0 ? (header.mono ? 17 : 32) : (header.mono ? 9 : 17);
+    size_t probeSize = static_cast<size_t>(std::min<uintmax_t>(4 + 32 + 18, fileSize - frameOffset));
+    const char* probe = source.view(frameOffset, probeSize);
+    
+    if (probe && 4 + sideInfo + 16 <= probeSize &&
+        (std::memcmp(probe + 4 + sideInfo, "Xing", 4) == 0 || std::memcmp(probe + 4 + sideInfo, "Info", 4) == 0)) 
+    {
+        const char* xing = probe + 4 + sideInfo;
+        uint32_t xingFlags = readBE32(xing + 4);
+        const char* field = xing + 8;
+        if (xingFlags & 0x01) 
+        {
+            frames = readBE32(field);
+            field += 4;
+        }
+        if (xingFlags & 0x02) 
+        {
+            bytes = readBE32(field);
+        }
+    }
+    else if (probe && 4 + 32 + 18 <= probeSize && std::memcmp(probe + 36, "VBRI", 4) == 0) 
+    {
+        bytes = readBE32(probe + 36 + 10);
+        frames = readBE32(probe + 36 + 14);
+    }
+    
+    double lengthMs = 0.0;
+    if (frames > 0) 
+    {
+        lengthMs = static_cast<double>(frames) * header.samplesPerFrame * 1000.0 / header.sampleRate;
+        uintmax_t streamBytes = bytes > 0 ? bytes : audioEnd - frameOffset;
+        tags.bitrateKbps = lengthMs > 0 ? static_cast<int>(streamBytes * 8.0 / lengthMs + 0.5) : 0;
+    }
+    else 
+    {
+        tags.bitrateKbps = header.bitrate;
+        lengthMs = audioEnd > frameOffset ? (audioEnd - frameOffset) * 8.0 / header.bitrate : 0.0;
+    }
+    tags.durationSeconds = static_cast<int>(lengthMs + 0.5) / 1000;
+    
+    return true;
+}
+
+void applyInfoList(const char* data, size_t size, NativeTags& infoTags) 
+{
+    size_t pos = 4;     // "INFO"
+    while (pos + 8 <= size) 
+    {
+        const char* id = data + pos;
+        size_t chunkSize = readLE32(data + pos + 4);
+        size_t body = pos + 8;
+        if (chunkSize > size - body) 
+        {
+            break;
+        }
+        
+        const char* text = data + body;
+        size_t length = 0;
+        while (length < chunkSize && text[length] != '\0') 
+        {
+            ++length;
+        }
+        std::string value(text, length);
+        
+        if (std::memcmp(id, "INAM", 4) == 0) 
+        {
+            setIfEmpty(infoTags.title, std::move(value));
+        }
+        else if (std::memcmp(id, "IART", 4) == 0) 
+        {
+            setIfEmpty(infoTags.artist, std::move(value));
+        }
+        else if (std::memcmp(id, "IPRD", 4) == 0) 
+        {
+            setIfEmpty(infoTags.album, std::move(value));
+        }
+        else if (std::memcmp(id, "IGNR", 4) == 0) 
+        {
+            setIfEmpty(infoTags.genre, std::move(value));
+        }
+        else if (std::memcmp(id, "ICRD", 4) == 0 && infoTags.year == 0) 
+        {
+            infoTags.year = parseYear(value);
+        }
+        
+        pos = body + chunkSize + (chunkSize & 1);
+    }
+}
+
+bool parseWav(TagByteSource& source, NativeTags& tags) 
+{
+    uintmax_t fileSize = source.size();
+    const char* riff = source.view(0, 12);
+    if (!riff || std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) 
+    {
+        return false;
+    }
+    
+    bool hasFormat = false;
+    uint32_t byteRate = 0;
+    uintmax_t dataSize = 0;
+    NativeTags infoTags;
+    
+    uintmax_t pos = 12;
+    while (pos + 8 <= fileSize) 
+    {
+        const char* chunk = source.view(pos, 8);
+        if (!chunk) 
+        {
+            return false;
+        }
+        
+        char id[4] = { chunk[0], chunk[1], chunk[2], chunk[3] };
+        uintmax_t chunkSize = readLE32(chunk + 4);
+        uintmax_t body = pos + 8;
+        uintmax_t available = std::min<uintmax_t>(chunkSize, fileSize - body);
+        
+        if (std::memcmp(id, "fmt ", 4) == 0 && available >= 16) 
+        {
+            const char* format = source.view(body, 16);
+            if (!format) 
+            {
+                return false;
+            }
+            uint16_t formatTag = readLE16(format);
+            uint16_t channels = readLE16(format + 2);
+            uint32_t sampleRate = readLE32(format + 4);
+            uint16_t bitsPerSample = readLE16(format + 14);
+            
+            // PCM byte rate follows from the sample format; others trust the header
+            byteRate = (formatTag == 1 || formatTag == 0xFFFE)
+                ? sampleRate * channels * ((bitsPerSample + 7) / 8)
+                : readLE32(format + 8);
+            hasFormat = true;
+        }
+        else if (std::memcmp(id, "data", 4) == 0) 
+        {
+            dataSize = available;
+        }
+        else if (std::memcmp(id, "LIST", 4) == 0 && available >= 4 && available <= MAX_INFO_LIST) 
+        {
+            const char* list = source.view(body, static_cast<size_t>(available));
+            if (list && std::memcmp(list, "INFO", 4) == 0) 
+            {
+                applyInfoList(list, static_cast<size_t>(available), infoTags);
+            }
+        }
+        else if (std::memcmp(id, "id3 ", 4) == 0 || std::memcmp(id, "ID3 ", 4) == 0) 
+        {
+            Id3v2Result id3v2;
+            if (!parseId3v2(source, body, tags, id3v2)) 
+            {
+                return false;
+            }
+        }
+        
+        pos = body + chunkSize + (chunkSize & 1);
+    }
+    
+    if (!hasFormat) 
+    {
+        return false;
+    }
+    
+    // ID3v2 fields win over RIFF INFO, as in TagLib's WAV tag union
+    setIfEmpty(tags.title, std::move(infoTags.title));
+    setIfEmpty(tags.artist, std::move(infoTags.artist));
+    setIfEmpty(tags.album, std::move(infoTags.album));
+    setIfEmpty(tags.genre, std::move(infoTags.genre));
+    if (tags.year == 0) 
+    {
+        tags.year = infoTags.year;
+    }
+    
+    if (byteRate > 0) 
+    {
+        double lengthMs = dataSize * 1000.0 / byteRate;
+        tags.durationSeconds = static_cast<int>(lengthMs + 0.5) / 1000;
+        tags.bitrateKbps = static_cast<int>(byteRate * 8.0 / 1000.0 + 0.5);
+    }
+    return true;
+}
+
+} // namespace
+
+FileTagSource::FileTagSource(const std::string& filePath)
+    : m_filePath(filePath)
+    , m_fd(-1)
+    , m_openFailed(false)
+    , m_dropCache(false)
+    , m_hasSize(false)
+    , m_size(0)
+    , m_windowOffset(0)
+    , m_bytesRead(0)
+    , m_readCount(0) 
+{
+}
+
+FileTagSource::FileTagSource(const std::string& filePath, uintmax_t fileSize)
+    : FileTagSource(filePath) 
+{
+    m_hasSize = true;
+    m_size = fileSize;
+}
+
+FileTagSource::~FileTagSource() 
+{
+    if (m_fd >= 0) 
+    {
+        if (m_dropCache) 
+        {
+            ScanIoScheduler::dropPageCache(m_fd);
+        }
+        ::close(m_fd);
+    }
+}
+
+void FileTagSource::addPreloaded(uintmax_t offset, const std::vector<char>& bytes) 
+{
+    if (!bytes.empty()) 
+    {
+        m_preloaded.push_back({ offset, bytes.data(), bytes.size() });
+    }
+}
+
+bool FileTagSource::open() 
+{
+    if (m_fd >= 0) 
+    {
+        return true;
+    }
+    if (m_openFailed) 
+    {
+        return false;
+    }
+    
+    m_fd = ::open(m_filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) 
+    {
+        m_openFailed = true;
+        return false;
+    }
+    
+    if (!m_hasSize) 
+    {
+        struct stat st;
+        if (fstat(m_fd, &st) != 0) 
+        {
+            m_openFailed = true;
+            return false;
+        }
+        m_size = static_cast<uintmax_t>(st.st_size);
+        m_hasSize = true;
+    }
+    return true;
+}
+
+uintmax_t FileTagSource::size() 
+{
+    if (!m_hasSize) 
+    {
+        open();
+    }
+    return m_size;
+}
+
+const char* FileTagSource::view(uintmax_t offset, size_t length) 
+{
+    uintmax_t fileSize = size();
+    if (offset > fileSize || length > fileSize - offset) 
+    {
+        return nullptr;
+    }
+    
+    for (const Range& range : m_preloaded) 
+    {
+        if (offset >= range.offset && offset + length <= range.offset + range.size) 
+        {
+            return range.data + (offset - range.offset);
+        }
+    }
+    
+    if (offset >= m_windowOffset && offset + length <= m_windowOffset + m_window.size()) 
+    {
+        return m_window.data() + (offset - m_windowOffset);
+    }
+    
+    if (!open()) 
+    {
+        return nullptr;
+    }
+    
+    // Read at least MIN_READ_SIZE, shifted back near the end so one read covers the tail tags
+    size_t chunk = static_cast<size_t>(std::min<uintmax_t>(std::max(length, MIN_READ_SIZE), fileSize));
+    uintmax_t start = offset + chunk > fileSize ? fileSize - chunk : offset;
+    
+    m_window.resize(chunk);
+    size_t filled = 0;
+    while (filled < chunk) 
+    {
+        ssize_t got = pread(m_fd, m_window.data() + filled, chunk - filled, static_cast<off_t>(start + filled));
+        if (got <= 0) 
+        {
+            break;
+        }
+        filled += static_cast<size_t>(got);
+    }
+    m_window.resize(filled);
+    m_windowOffset = start;
+    m_bytesRead += filled;
+    m_readCount++;
+    
+    if (offset + length > start + filled) 
+    {
+        return nullptr;
+    }
+    return m_window.data() + (offset - start);
+}
+
+bool NativeTagParser::parse(TagByteSource& source, const std::string& extension, NativeTags& tags) 
+{
+    NativeTags parsed;
+    bool ok = false;
+    
+    if (extension == ".mp3") 
+    {
+        ok = parseMp3(source, parsed);
+    }
+    else if (extension == ".wav") 
+    {
+        ok = parseWav(source, parsed);
+    }
+    
+    if (ok) 
+    {
+        tags = std::move(parsed);
+    }
+    return ok;
+}
+
+bool NativeTagParser::parseFile(const std::string& filePath, NativeTags& tags) 
+{
+    std::string extension;
+    size_t dot = filePath.find_last_of('.');
+    if (dot != std::string::npos && filePath.find('/', dot) == std::string::npos) 
+    {
+        extension = filePath.substr(dot);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    }
+    
+    if (!isSupportedExtension(extension)) 
+    {
+        return false;
+    }
+    
+    FileTagSource source(filePath);
+    return parse(source, extension, tags);
+}
+
+bool NativeTagParser::isSupportedExtension(const std::string& extension) 
+{
+    return extension == ".mp3" || extension == ".wav";
+}
+
+} // namespace services
+} // namespace media_player
@@ -0,0 +1,307 @@
+// Project includes
+#include "services/ScanIoScheduler.h"
+
+// System includes
+#include <algorithm>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace media_player 
+{
+namespace services 
+{
+
+namespace 
+{
+
+constexpr double BURST_SECONDS = 0.25;                          // Bucket capacity, in seconds of budget
+constexpr auto PROBE_INTERVAL = std::chrono::milliseconds(100); // How often playback is checked
+constexpr auto MAX_SLEEP = std::chrono::milliseconds(20);       // Sleep slice, so stops are seen quickly
+
+#ifdef __linux__
+constexpr int IOPRIO_WHO_PROCESS = 1;                           // With who = 0: the calling thread
+constexpr int IOPRIO_CLASS_SHIFT = 13;
+constexpr int IOPRIO_CLASS_IDLE = 3;
+#endif
+
+// Per field, the lower of two limits where 0 means unlimited
+uint64_t tighter(uint64_t a, uint64_t b) 
+{
+    if (a == 0) return b;
+    if (b == 0) return a;
+    return std::min(a, b);
+}
+
+} // namespace
+
+ScanIoScheduler::ScanIoScheduler()
+    : m_lastRefill(Clock::now())
+    , m_probing(false)
+    , m_hasScanDevice(false)
+    , m_scanDevice(0)
+    , m_backingOff(false)
+    , m_throttledSeconds(0.0) 
+{
+}
+
+void ScanIoScheduler::setLimits(const ScanIoLimits& limits) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_limits = limits;
+    applyLimits(m_backingOff ? m_playbackLimits : m_limits, true);
+}
+
+void ScanIoScheduler::setPlaybackLimits(const ScanIoLimits& limits) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_playbackLimits = limits;
+    applyLimits(m_backingOff ? m_playbackLimits : m_limits, true);
+}
+
+void ScanIoScheduler::setPlaybackProbe(PlaybackProbe probe) 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_probe = std::move(probe);
+    m_lastProbe = Clock::time_point();
+}
+
+void ScanIoScheduler::beginScan(const std::string& rootPath) 
+{
+    struct stat st;
+    bool hasDevice = ::stat(rootPath.c_str(), &st) == 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hasScanDevice = hasDevice;
+        m_scanDevice = hasDevice ? static_cast<uint64_t>(st.st_dev) : 0;
+        m_throttledSeconds = 0.0;
+        m_lastProbe = Clock::time_point();
+        m_lastRefill = Clock::now();
+        applyLimits(m_backingOff ? m_playbackLimits : m_limits, true);
+    }
+    
+    refreshPlayback();
+}
+
+bool ScanIoScheduler::charge(uint64_t bytes, uint64_t ops, const std::atomic<bool>& stop) 
+{
+    refreshPlayback();
+    
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_bytes.rate == 0 && m_ops.rate == 0) 
+    {
+        return !stop;
+    }
+    
+    refill(Clock::now());
+    m_bytes.tokens -= m_bytes.rate > 0 ? static_cast<double>(bytes) : 0.0;
+    m_ops.tokens -= m_ops.rate > 0 ? static_cast<double>(ops) : 0.0;
+    
+    double wait = waitSeconds();
+    if (wait <= 0.0) 
+    {
+        return !stop;
+    }
+    
+    auto start = Clock::now();
+    while (wait > 0.0 && !stop) 
+    {
+        lock.unlock();
+        std::this_thread::sleep_for(std::min<Clock::duration>(
+            std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wait)), MAX_SLEEP));
+        
+        // Playback may start or stop while we wait
+        refreshPlayback();
+        
+        lock.lock();
+        refill(Clock::now());
+        wait = waitSeconds();
+    }
+    m_throttledSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+    
+    return !stop;
+}
+
+bool ScanIoScheduler::isBackingOff() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_backingOff;
+}
+
+bool ScanIoScheduler::isPlaybackFile(const std::string& filePath) const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_playbackPath.empty() && m_playbackPath == filePath;
+}
+
+double ScanIoScheduler::getThrottledSeconds() const 
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_throttledSeconds;
+}
+
+void ScanIoScheduler::dropPageCache(int fd) 
+{
+#ifdef POSIX_FADV_DONTNEED
+    if (fd >= 0) 
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+#else
+    (void)fd;
+#endif
+}
+
+void ScanIoScheduler::dropPageCache(const std::string& filePath) 
+{
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) 
+    {
+        dropPageCache(fd);
+        ::close(fd);
+    }
+}
+
+void ScanIoScheduler::refreshPlayback() 
+{
+    PlaybackProbe probe;
+    bool hasScanDevice = false;
+    uint64_t scanDevice = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto now = Clock::now();
+        if (!m_probe || m_probing || now - m_lastProbe < PROBE_INTERVAL) 
+        {
+            return;
+        }
+        m_probing = true;
+        m_lastProbe = now;
+        probe = m_probe;
+        hasScanDevice = m_hasScanDevice;
+        scanDevice = m_scanDevice;
+    }
+    
+    // The probe may take the player's locks; call it without holding ours
+    std::string playbackPath;
+    try 
+    {
+        playbackPath = probe();
+    }
+    catch (...) 
+    {
+    }
+    
+    bool sameDevice = false;
+    if (!playbackPath.empty()) 
+    {
+        // A device we cannot tell apart counts as shared
+        struct stat st;
+        sameDevice = !hasScanDevice || ::stat(playbackPath.c_str(), &st) != 0 ||
+                     static_cast<uint64_t>(st.st_dev) == scanDevice;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_probing = false;
+    m_playbackPath = playbackPath;
+    if (sameDevice != m_backingOff) 
+    {
+        m_backingOff = sameDevice;
+        applyLimits(m_backingOff ? m_playbackLimits : m_limits, false);
+    }
+}
+
+void ScanIoScheduler::applyLimits(const ScanIoLimits& limits, bool refill) 
+{
+    // While backing off, the normal limits still hold if they are tighter
+    uint64_t bytesRate = m_backingOff ? tighter(limits.bytesPerSecond, m_limits.bytesPerSecond) : limits.bytesPerSecond;
+    uint64_t opsRate = m_backingOff ? tighter(limits.opsPerSecond, m_limits.opsPerSecond) : limits.opsPerSecond;
+    
+    for (auto entry : { std::make_pair(&m_bytes, bytesRate), std::make_pair(&m_ops, opsRate) }) 
+    {
+        Bucket& bucket = *entry.first;
+        bucket.rate = entry.second;
+        
+        double capacity = static_cast<double>(bucket.rate) * BURST_SECONDS;
+        bucket.tokens = refill ? capacity : std::min(bucket.tokens, capacity);
+    }
+}
+
+void ScanIoScheduler::refill(Clock::time_point now) 
+{
+    double elapsed = std::chrono::duration<double>(now - m_lastRefill).count();
+    m_lastRefill = now;
+    
+    for (Bucket* bucket : { &m_bytes, &m_ops }) 
+    {
+        if (bucket->rate > 0) 
+        {
+            double capacity = static_cast<double>(bucket->rate) * BURST_SECONDS;
+            bucket->tokens = std::min(capacity, bucket->tokens + elapsed * static_cast<double>(bucket->rate));
+        }
+    }
+}
+
+double ScanIoScheduler::waitSeconds() const 
+{
+    double wait = 0.0;
+    for (const Bucket* bucket : { &m_bytes, &m_ops }) 
+    {
+        if (bucket->rate > 0 && bucket->tokens < 0.0) 
+        {
+            wait = std::max(wait, -bucket->tokens / static_cast<double>(bucket->rate));
+        }
+    }
+    return wait;
+}
+
+IdleIoPriorityScope::IdleIoPriorityScope(bool enabled)
+    : m_active(false)
+    , m_previous(0) 
+{
+#ifdef __linux__
+    if (!enabled) 
+    {
+        return;
+    }
+    
+    long previous = syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, 0);
+    if (previous >= 0 &&
+        syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT) == 0) 
+    {
+        m_active = true;
+        m_previous = static_cast<int>(previous);
+    }
+#else
+    (void)enabled;
+#endif
+}
+
+IdleIoPriorityScope::~IdleIoPriorityScope() 
+{
+#ifdef __linux__
+    if (m_active) 
+    {
+        syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, m_previous);
+    }
+#endif
+}
+
+int IdleIoPriorityScope::currentIoClass() 
+{
+#ifdef __linux__
+    long priority = syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, 0);
+    return priority < 0 ? -1 : static_cast<int>(priority >> IOPRIO_CLASS_SHIFT);
+#else
+    return -1;
+#endif
+}
+
+} // namespace services
+} // namespace media_player
@@ -0,0 +1,502 @@
+// Project includes
+#include "services/TagPrefetcher.h"
+#include "services/ScanIoScheduler.h"
+
+// System includes
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+namespace media_player 
+{
+namespace services 
+{
+
+namespace 
+{
+    constexpr unsigned RING_ENTRIES = 128;
+}
+
+#ifdef __linux__
+
+// Minimal io_uring: one submission queue, used synchronously (submit a
+// round of requests, wait for all of them). No liburing needed.
+struct TagPrefetcher::Ring 
+{
+    int fd = -1;
+    unsigned entries = 0;
+    
+    void* sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    void* cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+    
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    
+    unsigned pending = 0;
+    
+    bool setup(unsigned requestedEntries) 
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, requestedEntries, &params));
+        if (fd < 0) 
+        {
+            return false;
+        }
+        entries = params.sq_entries;
+        
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        
+        bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMmap) 
+        {
+            sqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+        
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) 
+        {
+            return false;
+        }
+        
+        if (singleMmap) 
+        {
+            cqRing = sqRing;
+        }
+        else 
+        {
+            cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          fd, IORING_OFF_CQ_RING);
+            if (cqRing == MAP_FAILED) 
+            {
+                return false;
+            }
+        }
+        
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) 
+        {
+            return false;
+        }
+        
+        char* sq = static_cast<char*>(sqRing);
+        char* cq = static_cast<char*>(cqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        
+        return true;
+    }
+    
+    ~Ring() 
+    {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        if (fd >= 0) close(fd);
+    }
+    
+    // Caller keeps a round within `entries`
+    io_uring_sqe* nextSqe(uint64_t userData) 
+    {
+        unsigned tail = *sqTail + pending;
+        unsigned index = tail & *sqMask;
+        
+        io_uring_sqe* sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->user_data = userData;
+        sqArray[index] = index;
+        pending++;
+        
+        return sqe;
+    }
+    
+    // Submits the queued requests and hands every completion to onComplete.
+    // False if the kernel refused some of them: those are dropped, but the
+    // ones it took are still waited for, so none of them outlives the call
+    // and the buffers it points at.
+    template<typename Handler>
+    bool submitAndWait(Handler onComplete) 
+    {
+        unsigned toSubmit = pending;
+        unsigned remaining = pending;
+        bool refused = false;
+        
+        __atomic_store_n(sqTail, *sqTail + pending, __ATOMIC_RELEASE);
+        pending = 0;
+        
+        while (remaining > 0) 
+        {
+            long submitted = syscall(__NR_io_uring_enter, fd, toSubmit, remaining,
+                                     IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted >= 0) 
+            {
+                toSubmit -= std::min<unsigned>(toSubmit, static_cast<unsigned>(submitted));
+            }
+            else if (errno != EINTR && toSubmit > 0) 
+            {
+                // Without SQPOLL the kernel reads the submission queue only
+                // inside io_uring_enter, so what it has not taken yet can be
+                // taken back
+                unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+                remaining -= *sqTail - head;
+                toSubmit = 0;
+                __atomic_store_n(sqTail, head, __ATOMIC_RELEASE);
+                refused = true;
+            }
+            else if (errno != EINTR) 
+            {
+                // Completions still land in the queue without us waiting
+                std::this_thread::yield();
+            }
+            
+            unsigned head = *cqHead;
+            unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+            
+            while (head != tail && remaining > 0) 
+            {
+                onComplete(cqes[head & *cqMask]);
+                head++;
+                remaining--;
+            }
+            
+            __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+        }
+        
+        return !refused;
+    }
+};
+
+TagPrefetcher::TagPrefetcher(size_t headBytes, size_t tailBytes)
+    : m_ring(std::make_unique<Ring>())
+    , m_headBytes(headBytes)
+    , m_tailBytes(tailBytes) 
+{
+    if (!m_ring->setup(RING_ENTRIES)) 
+    {
+        m_ring.reset();
+    }
+}
+
+#else
+
+struct TagPrefetcher::Ring 
+{
+};
+
+TagPrefetcher::TagPrefetcher(size_t headBytes, size_t tailBytes)
+    : m_headBytes(headBytes)
+    , m_tailBytes(tailBytes) 
+{
+}
+
+#endif
+
+TagPrefetcher::~TagPrefetcher() = default;
+
+bool TagPrefetcher::isAvailable() const 
+{
+    return m_ring != nullptr;
+}
+
+void TagPrefetcher::prefetch(std::vector<PrefetchedFile>& files) 
+{
+    if (!m_ring) 
+    {
+        return;
+    }
+    
+    // Open + statx of a file take two slots of a round
+    const size_t chunkSize = RING_ENTRIES / 2;
+    
+    for (size_t start = 0; m_ring && start < files.size(); start += chunkSize) 
+    {
+        prefetchChunk(files.data() + start, std::min(chunkSize, files.size() - start));
+    }
+}
+
+void TagPrefetcher::prefetchChunk(PrefetchedFile* files, size_t count) 
+{
+#ifdef __linux__
+    // user_data: file index in the high bits, request kind in the low ones
+    enum Request : uint64_t { OPEN = 0, STATX = 1, READ_HEAD = 2, READ_TAIL = 3 };
+    auto tag = [](size_t index, Request request) { return (static_cast<uint64_t>(index) << 2) | request; };
+    
+    std::vector<int> fds(count, -1);
+    std::vector<struct statx> statBuffers(count);
+    
+    // Round 1: open everything, statx what the walk did not stat
+    for (size_t i = 0; i < count; ++i) 
+    {
+        io_uring_sqe* open = m_ring->nextSqe(tag(i, OPEN));
+        open->opcode = IORING_OP_OPENAT;
+        open->fd = AT_FDCWD;
+        open->addr = reinterpret_cast<uint64_t>(files[i].path.c_str());
+        open->open_flags = O_RDONLY | O_CLOEXEC;
+        
+        if (!files[i].hasStat) 
+        {
+            io_uring_sqe* stat = m_ring->nextSqe(tag(i, STATX));
+            stat->opcode = IORING_OP_STATX;
+            stat->fd = AT_FDCWD;
+            stat->addr = reinterpret_cast<uint64_t>(files[i].path.c_str());
+            stat->len = STATX_SIZE | STATX_MTIME;
+            stat->addr2 = reinterpret_cast<uint64_t>(&statBuffers[i]);
+        }
+    }
+    
+    bool submitted = m_ring->submitAndWait([&](const io_uring_cqe& cqe) 
+    {
+        size_t i = cqe.user_data >> 2;
+        
+        if ((cqe.user_data & 3) == OPEN) 
+        {
+            fds[i] = cqe.res;
+        }
+        else if (cqe.res == 0) 
+        {
+            const struct statx& sx = statBuffers[i];
+            files[i].stat.size = sx.stx_size;
+            files[i].stat.lastModified = DirectoryReader::toFileTime(sx.stx_mtime.tv_sec, sx.stx_mtime.tv_nsec);
+            files[i].hasStat = true;
+        }
+    });
+    
+    // Round 2: head and tail reads, sized from the stat
+    for (size_t i = 0; submitted && i < count; ++i) 
+    {
+        PrefetchedFile& file = files[i];
+        
+        if (fds[i] < 0 || !file.hasStat) 
+        {
+            continue;
+        }
+        
+        uintmax_t size = file.stat.size;
+        file.head.resize(static_cast<size_t>(std::min<uintmax_t>(size, m_headBytes)));
+        file.tailOffset = std::max<uintmax_t>(file.head.size(), size > m_tailBytes ? size - m_tailBytes : 0);
+        file.tail.resize(static_cast<size_t>(size - file.tailOffset));
+        file.ok = true;
+        
+        if (!file.head.empty()) 
+        {
+            io_uring_sqe* read = m_ring->nextSqe(tag(i, READ_HEAD));
+            read->opcode = IORING_OP_READ;
+            read->fd = fds[i];
+            read->addr = reinterpret_cast<uint64_t>(file.head.data());
+            read->len = static_cast<uint32_t>(file.head.size());
+            read->off = 0;
+        }
+        
+        if (!file.tail.empty()) 
+        {
+            io_uring_sqe* read = m_ring->nextSqe(tag(i, READ_TAIL));
+            read->opcode = IORING_OP_READ;
+            read->fd = fds[i];
+            read->addr = reinterpret_cast<uint64_t>(file.tail.data());
+            read->len = static_cast<uint32_t>(file.tail.size());
+            read->off = file.tailOffset;
+        }
+    }
+    
+    submitted = submitted && m_ring->submitAndWait([&](const io_uring_cqe& cqe) 
+    {
+        PrefetchedFile& file = files[cqe.user_data >> 2];
+        std::vector<char>& buffer = (cqe.user_data & 3) == READ_HEAD ? file.head : file.tail;
+        
+        if (cqe.res < 0) 
+        {
+            file.ok = false;
+        }
+        else if (static_cast<size_t>(cqe.res) < buffer.size()) 
+        {
+            // File shrank since the stat; keep what is there
+            buffer.resize(static_cast<size_t>(cqe.res));
+        }
+    });
+    
+    if (!submitted) 
+    {
+        for (size_t i = 0; i < count; ++i) 
+        {
+            files[i].ok = false;
+        }
+        
+        // The rest of the files are read the blocking way
+        m_ring.reset();
+    }
+    
+    // Closing is cheap and needs no batching
+    for (size_t i = 0; i < count; ++i) 
+    {
+        if (fds[i] >= 0) 
+        {
+            if (files[i].dropCache) 
+            {
+                ScanIoScheduler::dropPageCache(fds[i]);
+            }
+            close(fds[i]);
+        }
+    }
+#else
+    (void)files;
+    (void)count;
+#endif
+}
+
+PrefetchedFileStream::PrefetchedFileStream(const PrefetchedFile& file)
+    : m_file(file)
+    , m_position(0)
+    , m_fd(-1)
+    , m_fallbackReads(0) 
+{
+}
+
+PrefetchedFileStream::~PrefetchedFileStream() 
+{
+    if (m_fd >= 0) 
+    {
+        close(m_fd);
+    }
+}
+
+TagLib::FileName PrefetchedFileStream::name() const 
+{
+    return m_file.path.c_str();
+}
+
+TagLib::ByteVector PrefetchedFileStream::readBlock(TagLibSize length) 
+{
+    uintmax_t size = m_file.stat.size;
+    
+    if (m_position >= size || length == 0) 
+    {
+        return TagLib::ByteVector();
+    }
+    
+    size_t count = static_cast<size_t>(std::min<uintmax_t>(length, size - m_position));
+    std::vector<char> out;
+    
+    if (!copyFrom(m_file.head, 0, m_position, count, out) &&
+        !copyFrom(m_file.tail, m_file.tailOffset, m_position, count, out)) 
+    {
+        // Outside the prefetched ranges: plain blocking read
+        if (m_fd < 0) 
+        {
+            m_fd = open(m_file.path.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+        
+        out.resize(count);
+        ssize_t got = m_fd >= 0 ? pread(m_fd, out.data(), count, static_cast<off_t>(m_position)) : -1;
+        out.resize(got > 0 ? static_cast<size_t>(got) : 0);
+        m_fallbackReads++;
+    }
+    
+    m_position += out.size();
+    return TagLib::ByteVector(out.data(), static_cast<unsigned int>(out.size()));
+}
+
+bool PrefetchedFileStream::copyFrom(const std::vector<char>& buffer, uintmax_t bufferOffset,
+                                    uintmax_t offset, size_t length, std::vector<char>& out) const 
+{
+    if (offset < bufferOffset || offset + length > bufferOffset + buffer.size()) 
+    {
+        return false;
+    }
+    
+    auto begin = buffer.begin() + static_cast<std::ptrdiff_t>(offset - bufferOffset);
+    out.assign(begin, begin + static_cast<std::ptrdiff_t>(length));
+    return true;
+}
+
+void PrefetchedFileStream::writeBlock(const TagLib::ByteVector& data) 
+{
+    (void)data;
+}
+
+void PrefetchedFileStream::insert(const TagLib::ByteVector& data, TagLibStart start, TagLibSize replace) 
+{
+    (void)data;
+    (void)start;
+    (void)replace;
+}
+
+void PrefetchedFileStream::removeBlock(TagLibStart start, TagLibSize length) 
+{
+    (void)start;
+    (void)length;
+}
+
+bool PrefetchedFileStream::readOnly() const 
+{
+    return true;
+}
+
+bool PrefetchedFileStream::isOpen() const 
+{
+    return true;
+}
+
+void PrefetchedFileStream::seek(TagLibOffset offset, Position p) 
+{
+    intmax_t base = 0;
+    
+    if (p == Current) 
+    {
+        base = static_cast<intmax_t>(m_position);
+    }
+    else if (p == End) 
+    {
+        base = static_cast<intmax_t>(m_file.stat.size);
+    }
+    
+    m_position = static_cast<uintmax_t>(std::max<intmax_t>(0, base + offset));
+}
+
+TagLibOffset PrefetchedFileStream::tell() const 
+{
+    return static_cast<TagLibOffset>(m_position);
+}
+
+TagLibOffset PrefetchedFileStream::length() 
+{
+    return static_cast<TagLibOffset>(m_file.stat.size);
+}
+
+void PrefetchedFileStream::truncate(TagLibOffset length) 
+{
+    (void)length;
+}
+
+} // namespace services
+} // namespace media_player
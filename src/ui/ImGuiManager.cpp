@@ -757,7 +757,8 @@ void ImGuiManager::renderScanProgress(const std::string& path, int current, int
     drawText(shortPath, boxX + 20, boxY + 50, m_theme.textDim, 12);
     
     // Progress bar
-    float progress = total > 0 ? static_cast<float>(current) / total : 0;
+    // Total is a running estimate while the tree is still being walked
+    float progress = total > 0 ? std::min(1.0f, static_cast<float>(current) / total) : 0;
     drawProgressBar(boxX + 20, boxY + 80, boxW - 40, 12, progress, 
                     m_theme.primary, m_theme.scrollbar);
     
@@ -783,6 +784,37 @@ void ImGuiManager::renderScanProgress(const std::string& path, int current, int
     }
 }
 
+void ImGuiManager::renderScanStatus(int current, int total, int firstTrackMs) {
+    // Between the app title and the search box
+    int statusX = 140;
+    int statusY = 8;
+    int barW = 160;
+    int barH = 6;
+    
+    float progress = total > 0 ? std::min(1.0f, static_cast<float>(current) / total) : 0;
+    std::string statusText = "Scanning... " + std::to_string(current) + " files";
+    drawText(statusText, statusX, statusY - 1, m_theme.textSecondary, 12);
+    drawProgressBar(statusX + 150, statusY + 4, barW, barH, progress, 
+                    m_theme.primary, m_theme.scrollbar);
+    
+    int cancelX = statusX + 150 + barW + 10;
+    int cancelW = 50;
+    bool cancelHover = isMouseOver(cancelX, 4, cancelW, MENU_BAR_HEIGHT - 8);
+    drawText("Cancel", cancelX, statusY - 1, cancelHover ? m_theme.error : m_theme.textDim, 12);
+    
+    // Only where it does not run into the search box
+    int metricX = cancelX + cancelW + 10;
+    if (firstTrackMs >= 0 && metricX + 140 < m_width - 250) {
+        drawText("First track: " + std::to_string(firstTrackMs) + " ms", metricX, statusY - 1, m_theme.textDim, 12);
+    }
+    
+    if (cancelHover && m_mouseClicked && m_onCancelScan)
+    {
+        m_onCancelScan();
+        m_mouseClicked = false;
+    }
+}
+
 void ImGuiManager::showUsbPopup(const std::string& path) {
     m_state.showUsbDialog = true;
     m_state.usbPath = path;
@@ -1140,7 +1172,7 @@ void ImGuiManager::renderOverlays() {
                     m_state.metadataEdit.fileSizeStr = std::to_string(sz) + " B";
                 int dur = media.getDuration();
                 m_state.metadataEdit.durationStr = (dur > 0) ? (std::to_string(dur / 60) + ":" + (dur % 60 < 10 ? "0" : "") + std::to_string(dur % 60)) : "-";
-                m_state.metadataEdit.title = media.getTitle().empty() ? media.getFileName() : media.getTitle();
+                m_state.metadataEdit.title = media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle();
                 m_state.metadataEdit.artist = media.getArtist().empty() ? "-" : media.getArtist();
                 m_state.metadataEdit.album = media.getAlbum().empty() ? "-" : media.getAlbum();
                 m_state.metadataEdit.genre = "-";
@@ -252,7 +252,7 @@ void UIManager::drawMediaItem(const models::MediaFileModel& media, int x, int y,
     
     // Filename
     int textX = x + 50;
-    drawText(media.getFileName(), textX, y + 10, Color::text(), 16);
+    drawText(std::string(media.getFileName()), textX, y + 10, Color::text(), 16);
     
     // File size
     std::stringstream ss;
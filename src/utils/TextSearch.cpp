@@ -0,0 +1,223 @@
+// Project includes
+#include "utils/TextSearch.h"
+
+// System includes
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TEXT_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+namespace media_player 
+{
+namespace utils 
+{
+
+namespace 
+{
+
+// Needle of at least two bytes, no longer than the haystack
+using FindFunction = size_t (*)(const char* haystack, size_t length, const char* needle, size_t needleLength);
+
+size_t findScalar(const char* haystack, size_t length, const char* needle, size_t needleLength) 
+{
+    return std::string_view(haystack, length).find(std::string_view(needle, needleLength));
+}
+
+#ifdef TEXT_SEARCH_X86
+
+// Bit i of a block mask is set where haystack[i] equals the first byte of
+// the needle and haystack[i + needleLength - 1] the last; only those
+// positions get the middle compared. The tail goes to the scalar search.
+__attribute__((target("sse2")))
+size_t findSse2(const char* haystack, size_t length, const char* needle, size_t needleLength) 
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needleLength - 1]);
+    size_t i = 0;
+    
+    for (; i + needleLength - 1 + 16 <= length; i += 16) 
+    {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needleLength - 1));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(first, blockFirst), _mm_cmpeq_epi8(last, blockLast))));
+        
+        while (mask != 0) 
+        {
+            uint32_t bit = static_cast<uint32_t>(__builtin_ctz(mask));
+            if (needleLength == 2 || std::memcmp(haystack + i + bit + 1, needle + 1, needleLength - 2) == 0) 
+            {
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    
+    size_t rest = findScalar(haystack + i, length - i, needle, needleLength);
+    return rest == TextSearch::npos ? TextSearch::npos : i + rest;
+}
+
+__attribute__((target("avx2")))
+size_t findAvx2(const char* haystack, size_t length, const char* needle, size_t needleLength) 
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needleLength - 1]);
+    size_t i = 0;
+    
+    // Two blocks per step keep more loads in flight on long runs without a hit
+    for (; i + needleLength - 1 + 64 <= length; i += 64) 
+    {
+        const char* low = haystack + i;
+        const char* high = haystack + i + needleLength - 1;
+        __m256i eq0 = _mm256_and_si256(_mm256_cmpeq_epi8(first, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low))),
+                                       _mm256_cmpeq_epi8(last, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(high))));
+        __m256i eq1 = _mm256_and_si256(_mm256_cmpeq_epi8(first, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low + 32))),
+                                       _mm256_cmpeq_epi8(last, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(high + 32))));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq0)) |
+                        (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(eq1))) << 32);
+        
+        while (mask != 0) 
+        {
+            uint32_t bit = static_cast<uint32_t>(__builtin_ctzll(mask));
+            if (needleLength == 2 || std::memcmp(haystack + i + bit + 1, needle + 1, needleLength - 2) == 0) 
+            {
+                return i + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    
+    // Less than two blocks left: finish 16 bytes at a time
+    size_t rest = findSse2(haystack + i, length - i, needle, needleLength);
+    return rest == TextSearch::npos ? TextSearch::npos : i + rest;
+}
+
+#endif
+
+bool isSupported(TextSearch::Kernel kernel) 
+{
+    switch (kernel) 
+    {
+        case TextSearch::Kernel::SCALAR:
+            return true;
+#ifdef TEXT_SEARCH_X86
+        case TextSearch::Kernel::SSE2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2");
+        case TextSearch::Kernel::AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+FindFunction functionOf(TextSearch::Kernel kernel) 
+{
+    switch (kernel) 
+    {
+#ifdef TEXT_SEARCH_X86
+        case TextSearch::Kernel::SSE2:
+            return findSse2;
+        case TextSearch::Kernel::AVX2:
+            return findAvx2;
+#endif
+        default:
+            return findScalar;
+    }
+}
+
+TextSearch::Kernel bestKernel() 
+{
+    if (isSupported(TextSearch::Kernel::AVX2)) 
+    {
+        return TextSearch::Kernel::AVX2;
+    }
+    if (isSupported(TextSearch::Kernel::SSE2)) 
+    {
+        return TextSearch::Kernel::SSE2;
+    }
+    return TextSearch::Kernel::SCALAR;
+}
+
+std::atomic<TextSearch::Kernel>& currentKernel() 
+{
+    static std::atomic<TextSearch::Kernel> kernel(bestKernel());
+    return kernel;
+}
+
+std::atomic<FindFunction>& currentFunction() 
+{
+    static std::atomic<FindFunction> function(functionOf(currentKernel().load()));
+    return function;
+}
+
+} // namespace
+
+size_t TextSearch::find(std::string_view haystack, std::string_view needle) 
+{
+    if (needle.empty()) 
+    {
+        return 0;
+    }
+    if (needle.size() > haystack.size()) 
+    {
+        return npos;
+    }
+    
+    // memchr is already vectorized for a single byte
+    if (needle.size() == 1) 
+    {
+        const void* hit = std::memchr(haystack.data(), needle[0], haystack.size());
+        return hit ? static_cast<size_t>(static_cast<const char*>(hit) - haystack.data()) : npos;
+    }
+    
+    FindFunction function = currentFunction().load(std::memory_order_relaxed);
+    return function(haystack.data(), haystack.size(), needle.data(), needle.size());
+}
+
+bool TextSearch::containsIgnoreCase(std::string_view text, std::string_view needle) 
+{
+    auto it = std::search(text.begin(), text.end(), needle.begin(), needle.end(),
+                          [](char a, char b) { return lowerAscii(a) == lowerAscii(b); });
+    return it != text.end() || needle.empty();
+}
+
+TextSearch::Kernel TextSearch::getKernel() 
+{
+    return currentKernel().load(std::memory_order_relaxed);
+}
+
+const char* TextSearch::getKernelName() 
+{
+    switch (getKernel()) 
+    {
+        case Kernel::AVX2:
+            return "avx2";
+        case Kernel::SSE2:
+            return "sse2";
+        default:
+            return "scalar";
+    }
+}
+
+bool TextSearch::setKernel(Kernel kernel) 
+{
+    if (!isSupported(kernel)) 
+    {
+        return false;
+    }
+    
+    currentKernel().store(kernel);
+    currentFunction().store(functionOf(kernel));
+    return true;
+}
+
+} // namespace utils
+} // namespace media_player
@@ -221,7 +221,7 @@ void ExploreScreen::render(ui::ImGuiManager& painter)
         int colArtist = x + static_cast<int>(w * 0.45);
         int colDuration = x + w - 70;
         
-        std::string title = media.getTitle().empty() ? media.getFileName() : media.getTitle();
+        std::string title = media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle();
         if (title.length() > 40) 
         {
             title = title.substr(0, 37) + "...";
@@ -542,7 +542,7 @@ void ExploreScreen::renderContextMenu(ui::ImGuiManager& painter)
                         
                         // Metadata từ MediaFileModel
                         state.metadataEdit.title = targetMedia->getTitle().empty() ? 
-                            targetMedia->getFileName() : targetMedia->getTitle();
+                            std::string(targetMedia->getFileName()) : targetMedia->getTitle();
                         state.metadataEdit.artist = targetMedia->getArtist().empty() ? 
                             "-" : targetMedia->getArtist();
                         state.metadataEdit.album = targetMedia->getAlbum().empty() ? 
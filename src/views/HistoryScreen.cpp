@@ -151,7 +151,7 @@ void HistoryScreen::render(ui::ImGuiManager& painter)
             // Check file existence
             bool fileExists = std::filesystem::exists(entry.media.getFilePath());
             std::string title = entry.media.getTitle().empty() 
-                ? entry.media.getFileName() 
+                ? std::string(entry.media.getFileName()) 
                 : entry.media.getTitle();
             
             if (!fileExists) 
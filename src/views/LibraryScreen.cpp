@@ -22,6 +22,8 @@ LibraryScreen::LibraryScreen(
     , m_queueController(queueController)
     , m_playbackController(playbackController)
     , m_playlistController(playlistController)
+    , m_currentMediaList(std::make_shared<const std::vector<models::MediaFileModel>>())
+    , m_rowsAscending(true)
     , m_currentPage(0)
     , m_selectedIndex(-1)
     , m_scrollOffset(0)
@@ -77,83 +79,47 @@ void LibraryScreen::render(ui::ImGuiManager& painter)
     }
     
     // 1. Filter List (Search & Sort)
-    // Only re-filter if list is empty or search changed? 
-    // Actually best to keep a filtered list or filter on demand.
-    // For now, let's filter on every frame or cache it? caching is better but `refreshMediaList` handles loading.
-    // Let's assume m_currentMediaList IS the filtered list for simplicity, updated when search changes.
-    // But m_currentMediaList is populated by `getAllMedia` initially.
-    // We should probably filter in-place or separate source vs display list.
-    // For now, let's use a local filtered vector like ImGuiManager did, BUT we should optimize this later.
-    // Refactoring: ImGuiManager logic was doing filtering every frame. Let's replicate that logic but maybe cleaner.
-    
-    // Actually, `m_currentMediaList` IS the source. We should define what to render.
-    // Let's just use m_currentMediaList as the SOURCE and create indices.
-    std::vector<size_t> filteredIndices;
-    filteredIndices.reserve(m_currentMediaList.size());
+    // The library keeps each sort order up to date; with a query the search
+    // index hands back the matches and the order of the snapshot it searched,
+    // which becomes m_currentMediaList. Rows are only rebuilt when one of
+    // them, or the direction, changed since the last frame.
+    // 0=Title, 1=Artist, 2=Album, 3=Duration
+    static const models::SortCriteria SORT_CRITERIA[] = {
+        models::SortCriteria::TITLE, models::SortCriteria::ARTIST,
+        models::SortCriteria::ALBUM, models::SortCriteria::DURATION
+    };
+    models::SortCriteria criteria = SORT_CRITERIA[std::clamp(m_sortField, 0, 3)];
     
-    for (size_t i = 0; i < m_currentMediaList.size(); i++) {
-        const auto& media = m_currentMediaList[i];
+    if (m_searchQuery.empty()) {
+        models::LibraryOrder sorted = m_libraryController->getSortOrder(criteria);
+        m_currentMediaList = sorted.media;
+        updateRows(sorted.positions, models::SearchResult());
+    } else {
+        // 0=All, 1=Title, 2=Artist, 3=Album
+        static const models::SearchFieldMask FILTER_FIELDS[] = {
+            models::SearchField::TAGS, models::SearchField::TITLE,
+            models::SearchField::ARTIST, models::SearchField::ALBUM
+        };
+        models::SearchFieldMask fields = FILTER_FIELDS[std::clamp(m_searchFilter, 0, 3)];
+        
+        m_search = m_libraryController->search(m_searchQuery, fields, &m_search, criteria);
+        m_currentMediaList = m_search.media;
         
-        if (m_searchQuery.empty()) {
-            filteredIndices.push_back(i);
+        // Nothing holds the query as typed: ask the controller for a
+        // typo-tolerant search and show its ranking once it is done
+        std::shared_ptr<const controllers::FuzzySearchAnswer> fuzzy;
+        if (m_search.result.positions.empty()) {
+            m_libraryController->requestFuzzySearch(m_searchQuery, fields);
+            fuzzy = m_libraryController->getFuzzyAnswer();
+        }
+        if (fuzzy && fuzzy->query == m_searchQuery && fuzzy->fields == fields) {
+            m_currentMediaList = fuzzy->search.media;
+            updateFuzzyRows(fuzzy);
         } else {
-             std::string query = m_searchQuery;
-             std::transform(query.begin(), query.end(), query.begin(), ::tolower);
-             
-             std::string title = media.getTitle().empty() ? media.getFileName() : media.getTitle();
-             std::transform(title.begin(), title.end(), title.begin(), ::tolower);
-             
-             std::string artist = media.getArtist();
-             std::transform(artist.begin(), artist.end(), artist.begin(), ::tolower);
-             
-             std::string album = media.getAlbum();
-             std::transform(album.begin(), album.end(), album.begin(), ::tolower);
-             
-             bool matches = false;
-             // 0=All, 1=Title, 2=Artist, 3=Album
-             switch (m_searchFilter) {
-                 case 0: // All
-                     matches = (title.find(query) != std::string::npos || 
-                                artist.find(query) != std::string::npos ||
-                                album.find(query) != std::string::npos);
-                     break;
-                 case 1: // Title
-                     matches = (title.find(query) != std::string::npos);
-                     break;
-                 case 2: // Artist
-                     matches = (artist.find(query) != std::string::npos);
-                     break;
-                 case 3: // Album
-                     matches = (album.find(query) != std::string::npos);
-                     break;
-             }
-             if (matches) filteredIndices.push_back(i);
+            updateRows(m_search.order, m_search.result);
         }
     }
-
-    // Sort Indices
-    if (!filteredIndices.empty()) {
-         std::stable_sort(filteredIndices.begin(), filteredIndices.end(), 
-            [&](size_t a, size_t b) {
-                const auto& mA = m_currentMediaList[a];
-                const auto& mB = m_currentMediaList[b];
-                int cmp = 0;
-                if (m_sortField == 0) { // Title
-                    std::string tA = mA.getTitle().empty() ? mA.getFileName() : mA.getTitle();
-                    std::string tB = mB.getTitle().empty() ? mB.getFileName() : mB.getTitle();
-                    cmp = tA.compare(tB);
-                } else if (m_sortField == 1) { // Artist
-                    cmp = mA.getArtist().compare(mB.getArtist());
-                } else if (m_sortField == 2) { // Album
-                    cmp = mA.getAlbum().compare(mB.getAlbum());
-                } else if (m_sortField == 3) { // Duration
-                    int dA = mA.getDuration();
-                    int dB = mB.getDuration();
-                    cmp = (dA < dB) ? -1 : ((dA > dB) ? 1 : 0);
-                }
-                return m_sortAscending ? (cmp < 0) : (cmp > 0);
-            });
-    }
+    const std::vector<size_t>& filteredIndices = m_rows;
 
     int filteredCount = static_cast<int>(filteredIndices.size());
     int totalPages = (filteredCount + ITEMS_PER_PAGE - 1) / ITEMS_PER_PAGE;
@@ -261,7 +227,7 @@ void LibraryScreen::render(ui::ImGuiManager& painter)
     
     for (int i = startIndex; i < endIndex; i++) {
         size_t index = filteredIndices[i];
-        const auto& media = m_currentMediaList[index];
+        const auto& media = (*m_currentMediaList)[index];
         
         int rowIdx = i - startIndex;
         int itemY = y + (rowIdx * 50) - m_scrollOffset;
@@ -278,8 +244,9 @@ void LibraryScreen::render(ui::ImGuiManager& painter)
         painter.drawRect(x, itemY, w, 50, rowBg);
         
         // Icon
-        const char* icon = media.isAudio() ? "~" : (media.isVideo() ? "*" : "?");
-        uint32_t iconColor = media.isUnsupported() ? theme.textDim : theme.textSecondary;
+        // Stale: the file was missing when last checked (e.g. device unplugged)
+        const char* icon = media.isStale() ? "x" : media.isAudio() ? "~" : (media.isVideo() ? "*" : "?");
+        uint32_t iconColor = media.isUnsupported() || media.isStale() ? theme.textDim : theme.textSecondary;
         if (selected) { // Should check if playing? But Library doesn't know playing state easily without PlaybackStateModel
             // For now just show arrow if selected
             painter.drawText(">", x + 15, itemY + 15, theme.success, 14);
@@ -288,8 +255,8 @@ void LibraryScreen::render(ui::ImGuiManager& painter)
         }
 
         // Text
-        uint32_t textCol = media.isUnsupported() ? theme.textDim : theme.textPrimary;
-        std::string title = media.getTitle().empty() ? media.getFileName() : media.getTitle();
+        uint32_t textCol = media.isUnsupported() || media.isStale() ? theme.textDim : theme.textPrimary;
+        std::string title = media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle();
         if (title.length() > 35) title = title.substr(0, 32) + "...";
         painter.drawText(title, colTitle + 50, itemY + 15, textCol, 14);
         
@@ -443,9 +410,9 @@ void LibraryScreen::render(ui::ImGuiManager& painter)
              if (itemHover) {
                  painter.drawRect(mx, iy, mw, itemH, theme.surfaceHover);
                  if (painter.isMouseClicked(mx, iy, mw, itemH)) {
-                     if (m_contextMenuIndex >= 0 && m_contextMenuIndex < static_cast<int>(m_currentMediaList.size())) {
+                     if (m_contextMenuIndex >= 0 && m_contextMenuIndex < static_cast<int>(m_currentMediaList->size())) {
                          // Use absolute index directly
-                         const auto& targetMedia = m_currentMediaList[m_contextMenuIndex];
+                         const auto& targetMedia = (*m_currentMediaList)[m_contextMenuIndex];
                          
                          if (i == 0) { // Add to Queue
                              if (m_queueController) m_queueController->addToQueue(targetMedia);
@@ -490,7 +457,7 @@ void LibraryScreen::render(ui::ImGuiManager& painter)
                              
                              // Basic metadata từ MediaFileModel
                              state.metadataEdit.title = targetMedia.getTitle().empty() ? 
-                                 targetMedia.getFileName() : targetMedia.getTitle();
+                                 std::string(targetMedia.getFileName()) : targetMedia.getTitle();
                              state.metadataEdit.artist = targetMedia.getArtist().empty() ? "-" : targetMedia.getArtist();
                              state.metadataEdit.album = targetMedia.getAlbum().empty() ? "-" : targetMedia.getAlbum();
                              state.metadataEdit.genre = "-";
@@ -540,7 +507,7 @@ bool LibraryScreen::handleInput(const SDL_Event& event)
         if (m_scrollOffset < 0) m_scrollOffset = 0;
         
         // Calculate max scroll based on items in current page
-        int itemsInPage = std::min(ITEMS_PER_PAGE, static_cast<int>(m_currentMediaList.size()) - m_currentPage * ITEMS_PER_PAGE);
+        int itemsInPage = std::min(ITEMS_PER_PAGE, static_cast<int>(m_currentMediaList->size()) - m_currentPage * ITEMS_PER_PAGE);
         int contentHeight = itemsInPage * 50; // 50px per item
         int listHeight = 400; // Approximate visible list height (adjust based on actual layout)
         int maxScroll = std::max(0, contentHeight - listHeight);
@@ -579,7 +546,7 @@ bool LibraryScreen::handleInput(const SDL_Event& event)
             return true;
         }
         else if (event.key.keysym.sym == SDLK_DOWN) {
-            if (m_selectedIndex < static_cast<int>(m_currentMediaList.size()) - 1) m_selectedIndex++;
+            if (m_selectedIndex < static_cast<int>(m_currentMediaList->size()) - 1) m_selectedIndex++;
             return true;
         }
     }
@@ -654,13 +621,91 @@ void LibraryScreen::addAllToQueue()
     // ...
 }
 
+void LibraryScreen::updateRows(const models::SortOrder& order, const models::SearchResult& matches) 
+{
+    if (order == m_rowsOrder && m_sortAscending == m_rowsAscending && matches.version == m_rowsMatches.version &&
+        matches.fields == m_rowsMatches.fields && matches.query == m_rowsMatches.query) 
+    {
+        return;
+    }
+    
+    m_rowsOrder = order;
+    m_rowsFuzzy.reset();
+    m_rowsAscending = m_sortAscending;
+    m_rowsMatches.query = matches.query;
+    m_rowsMatches.fields = matches.fields;
+    m_rowsMatches.version = matches.version;
+    m_rows.clear();
+    
+    if (!order) 
+    {
+        return;
+    }
+    
+    // Walk the order, keeping the matches when there is a query
+    std::vector<bool> matched;
+    if (!matches.query.empty()) 
+    {
+        matched.resize(order->size());
+        for (uint32_t position : matches.positions) 
+        {
+            matched[position] = true;
+        }
+        m_rows.reserve(matches.positions.size());
+    }
+    else 
+    {
+        m_rows.reserve(order->size());
+    }
+    
+    auto keep = [&](uint32_t position) 
+    {
+        if (matched.empty() || matched[position]) 
+        {
+            m_rows.push_back(position);
+        }
+    };
+    
+    if (m_sortAscending) 
+    {
+        std::for_each(order->begin(), order->end(), keep);
+    }
+    else 
+    {
+        std::for_each(order->rbegin(), order->rend(), keep);
+    }
+}
+
+void LibraryScreen::updateFuzzyRows(const std::shared_ptr<const controllers::FuzzySearchAnswer>& answer) 
+{
+    if (answer == m_rowsFuzzy) 
+    {
+        return;
+    }
+    
+    // Best match first, whatever the sort; the next updateRows rebuilds
+    m_rowsFuzzy = answer;
+    m_rowsOrder.reset();
+    m_rows.clear();
+    m_rows.reserve(answer->search.result.matches.size());
+    for (const auto& match : answer->search.result.matches) 
+    {
+        m_rows.push_back(match.position);
+    }
+}
+
 void LibraryScreen::refreshMediaList() 
 {
-    m_currentMediaList = m_libraryController->getAllMedia();
+    m_currentMediaList = m_libraryController->getSnapshot();
     m_currentPage = 0;
     // Reset sort/filter?
 }
 
+void LibraryScreen::reloadMediaList() 
+{
+    m_currentMediaList = m_libraryController->getSnapshot();
+}
+
  
 
 } // namespace views
@@ -275,7 +275,7 @@ void PlaylistScreen::render(ui::ImGuiManager& painter)
                     painter.consumeClick();
                 }
 
-                painter.drawText(media.getTitle().empty() ? media.getFileName() : media.getTitle(), x + 10, itemY + 10, theme.textPrimary, 14);
+                painter.drawText(media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle(), x + 10, itemY + 10, theme.textPrimary, 14);
                 painter.drawText(media.getArtist(), x + w/2, itemY + 10, theme.textSecondary, 14);
 
                 // Context Menu (Right Click)
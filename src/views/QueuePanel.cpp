@@ -152,7 +152,7 @@ void QueuePanel::render(ui::ImGuiManager& painter)
             painter.drawText(marker + std::to_string(i + 1), x + 10, itemY + 15, theme.textDim, 12);
             
             // Title
-            std::string title = media.getTitle().empty() ? media.getFileName() : media.getTitle();
+            std::string title = media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle();
             if (title.length() > 50) title = title.substr(0, 47) + "...";
             uint32_t titleColor = isCurrent ? theme.success : theme.textPrimary;
             painter.drawText(title, x + 40, itemY + 15, titleColor, 14);
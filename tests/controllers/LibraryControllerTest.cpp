@@ -4,6 +4,9 @@
 #include "services/IMetadataReader.h"
 #include "repositories/LibraryRepository.h"
 
+#include <chrono>
+#include <thread>
+
 using namespace media_player;
 
 class FakeMetadataReader : public services::IMetadataReader {
@@ -58,3 +61,22 @@ TEST_F(LibraryControllerTest, UpdateMetadataWritesAndUpdatesModel) {
     newMeta.setAlbum("nal");
     EXPECT_TRUE(controller->updateMetadata(media, newMeta));
 }
+
+TEST_F(LibraryControllerTest, FuzzySearchAnswersInBackground) {
+    models::MediaFileModel media("/tmp/beatles.mp3");
+    media.setTitle("Hey Jude");
+    media.setArtist("The Beatles");
+    libraryModel->addMedia(media);
+    
+    EXPECT_EQ(controller->getFuzzyAnswer(), nullptr);
+    controller->requestFuzzySearch("beatels", models::SearchField::TAGS);
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    std::shared_ptr<const controllers::FuzzySearchAnswer> answer;
+    while (!(answer = controller->getFuzzyAnswer()) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_NE(answer, nullptr);
+    EXPECT_EQ(answer->query, "beatels");
+    ASSERT_EQ(answer->search.result.matches.size(), 1u);
+}
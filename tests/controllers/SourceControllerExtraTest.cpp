@@ -19,6 +19,7 @@ public:
     MOCK_METHOD(bool, exists, (const std::string&), (override));
     MOCK_METHOD(bool, saveAll, (const std::vector<models::MediaFileModel>&), (override));
     MOCK_METHOD(void, clear, (), (override));
+    MOCK_METHOD(bool, replaceAll, (const std::vector<models::MediaFileModel>&), (override));
     MOCK_METHOD(size_t, count, (), (const, override));
 };
 
@@ -53,8 +54,9 @@ TEST(SourceControllerExtraTest, OnScanCompleteUpdatesLibraryAndRepo) {
     EXPECT_CALL(*scanner, setCompleteCallback(_)).WillOnce(testing::Invoke([&](auto f){ completeCb = f; }));
     auto libRepo = std::make_shared<MockLibraryRepository>();
     auto libModel = std::make_shared<models::LibraryModel>();
-    EXPECT_CALL(*libRepo, clear()).Times(1);
-    EXPECT_CALL(*libRepo, saveAll(_)).Times(1).WillOnce(testing::Return(true));
+    EXPECT_CALL(*libRepo, clear()).Times(0);
+    EXPECT_CALL(*libRepo, saveAll(_)).Times(0);
+    EXPECT_CALL(*libRepo, replaceAll(testing::SizeIs(2))).Times(1).WillOnce(testing::Return(true));
     controllers::SourceController controller(scanner, libRepo, libModel);
     ASSERT_TRUE(completeCb);
     std::vector<models::MediaFileModel> files{models::MediaFileModel("/tmp/a.mp3"), models::MediaFileModel("/tmp/b.mp3")};
@@ -70,6 +70,47 @@ TEST_F(SourceControllerTest, IsScanning) {
 #include <filesystem>
 #include <fstream>
 
+TEST_F(SourceControllerTest, ApplyLibraryChanges) {
+    auto dir = std::filesystem::temp_directory_path() / "MediaPlayerTest_ApplyChanges";
+    std::filesystem::create_directories(dir / "album");
+    std::ofstream(dir / "a.mp3") << "a";
+    std::ofstream(dir / "album" / "b.mp3") << "b";
+    std::ofstream(dir / "album" / "c.mp3") << "c";
+    
+    models::MediaFileModel a((dir / "a.mp3").string());
+    models::MediaFileModel b((dir / "album" / "b.mp3").string());
+    models::MediaFileModel c((dir / "album" / "c.mp3").string());
+    
+    EXPECT_CALL(*mockRepo, save(_)).Times(4).WillRepeatedly(Return(true));
+    
+    using services::LibraryChangeType;
+    size_t applied = controller->applyLibraryChanges({
+        { LibraryChangeType::FILE_ADDED, a.getFilePath(), a },
+        { LibraryChangeType::FILE_ADDED, b.getFilePath(), b },
+        { LibraryChangeType::FILE_ADDED, c.getFilePath(), c },
+        { LibraryChangeType::FILE_ADDED, "/no/media.mp3", std::nullopt },
+    });
+    EXPECT_EQ(applied, 3u);
+    EXPECT_EQ(realModel->getMediaCount(), 3u);
+    
+    // Modified entries are updated in place, not duplicated
+    a.setTitle("Retagged");
+    applied = controller->applyLibraryChanges({ { LibraryChangeType::FILE_MODIFIED, a.getFilePath(), a } });
+    EXPECT_EQ(applied, 1u);
+    EXPECT_EQ(realModel->getMediaCount(), 3u);
+    EXPECT_EQ(realModel->getMediaByPath(a.getFilePath())->getTitle(), "Retagged");
+    
+    applied = controller->applyLibraryChanges({
+        { LibraryChangeType::DIRECTORY_REMOVED, (dir / "album").string(), std::nullopt },
+        { LibraryChangeType::FILE_REMOVED, a.getFilePath(), std::nullopt },
+        { LibraryChangeType::RESCAN_NEEDED, dir.string(), std::nullopt },
+    });
+    EXPECT_EQ(applied, 3u);
+    EXPECT_TRUE(realModel->isEmpty());
+    
+    std::filesystem::remove_all(dir);
+}
+
 class SourceControllerUSBTest : public SourceControllerTest {
 protected:
     std::filesystem::path tempDir;
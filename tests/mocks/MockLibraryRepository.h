@@ -20,6 +20,7 @@ public:
     MOCK_METHOD(bool, exists, (const std::string& id), (override));
     MOCK_METHOD(bool, saveAll, (const std::vector<models::MediaFileModel>& mediaList), (override));
     MOCK_METHOD(void, clear, (), (override));
+    MOCK_METHOD(bool, replaceAll, (const std::vector<models::MediaFileModel>& mediaList), (override));
     MOCK_METHOD(size_t, count, (), (const, override));
     
     // Repository specific if needed, but usually interface is enough
@@ -0,0 +1,133 @@
+/**
+ * @file CollationTest.cpp
+ * @brief Unit test cho Collation::key — khóa sắp xếp theo bảng chữ cái tiếng
+ *        Việt: chữ cái trước, rồi dấu thanh, rồi hoa/thường; số so theo giá trị
+ *        — và Collation::fold, dạng bỏ dấu, chữ thường dùng khi tìm kiếm
+ */
+
+#include <gtest/gtest.h>
+#include "models/Collation.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace media_player::models;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+
+std::vector<std::string> sorted(std::vector<std::string> texts)
+{
+    std::sort(texts.begin(), texts.end(),
+              [](const std::string& a, const std::string& b) { return Collation::key(a) < Collation::key(b); });
+    return texts;
+}
+
+} // namespace
+
+// ============================================================================
+// Bảng chữ cái
+// ============================================================================
+
+TEST(CollationTest, FollowsTheVietnameseAlphabet)
+{
+    // So từng byte thì "Zoo" đứng trước "Ánh" và "Đà Lạt"
+    EXPECT_EQ(sorted({ "Zoo", "Đà Lạt", "Ánh", "Dũng", "Bình", "Anh" }),
+              (std::vector<std::string>{ "Anh", "Ánh", "Bình", "Dũng", "Đà Lạt", "Zoo" }));
+
+    EXPECT_EQ(sorted({ "ư", "u", "ơ", "ô", "o", "ê", "e", "â", "ă", "a" }),
+              (std::vector<std::string>{ "a", "ă", "â", "e", "ê", "o", "ô", "ơ", "u", "ư" }));
+}
+
+TEST(CollationTest, CaseOnlyBreaksTies)
+{
+    EXPECT_EQ(sorted({ "Banana", "apple", "Apple" }), (std::vector<std::string>{ "apple", "Apple", "Banana" }));
+    EXPECT_LT(Collation::key("ĐÀ"), Collation::key("đb"));
+}
+
+TEST(CollationTest, TonesInDictionaryOrder)
+{
+    EXPECT_EQ(sorted({ "ạ", "á", "ã", "ả", "à", "a" }),
+              (std::vector<std::string>{ "a", "à", "ả", "ã", "á", "ạ" }));
+
+    // Dấu thanh chỉ phân định khi các chữ cái giống nhau
+    EXPECT_LT(Collation::key("má"), Collation::key("mb"));
+}
+
+TEST(CollationTest, CombiningMarksMatchPrecomposedLetters)
+{
+    // "Sơn Tùng" viết bằng dấu tổ hợp (NFD), như tên tệp trên macOS
+    EXPECT_EQ(Collation::key("So\xCC\x9Bn Tu\xCC\x80ng"), Collation::key("Sơn Tùng"));
+    EXPECT_EQ(Collation::key("A\xCC\x81nh"), Collation::key("Ánh"));
+    EXPECT_EQ(Collation::key("a\xCC\x82\xCC\x80"), Collation::key("ầ"));
+}
+
+// ============================================================================
+// Số, ký hiệu và văn bản khác
+// ============================================================================
+
+TEST(CollationTest, NumbersCompareByValue)
+{
+    EXPECT_EQ(sorted({ "Track 10", "Track 2", "Track 1", "Track 02b" }),
+              (std::vector<std::string>{ "Track 1", "Track 2", "Track 02b", "Track 10" }));
+}
+
+TEST(CollationTest, SymbolsBeforeDigitsBeforeLetters)
+{
+    EXPECT_EQ(sorted({ "b", "9", "(intro)", "a b", "ab" }),
+              (std::vector<std::string>{ "(intro)", "9", "a b", "ab", "b" }));
+}
+
+TEST(CollationTest, OtherScriptsAndBadBytesStayOrdered)
+{
+    // Chữ không có trong bảng xếp sau chữ Latin, theo code point
+    EXPECT_EQ(sorted({ "日本", "Zed", "中文", "Ω" }), (std::vector<std::string>{ "Zed", "Ω", "中文", "日本" }));
+
+    // Byte không hợp lệ trong UTF-8 được đọc như Latin-1 (thẻ ID3 cũ)
+    EXPECT_EQ(Collation::key("\xC9t\xE9"), Collation::key("Été"));
+    EXPECT_FALSE(Collation::key("\xFF\xFE").empty());
+}
+
+TEST(CollationTest, PrefixSortsFirstAndEqualTextsShareAKey)
+{
+    EXPECT_LT(Collation::key("Love"), Collation::key("Love Story"));
+    EXPECT_LT(Collation::key("Lòve"), Collation::key("Love Story"));
+    EXPECT_EQ(Collation::key("Hello"), Collation::key(std::string("Hello")));
+    EXPECT_EQ(Collation::key(""), "");
+}
+
+// ============================================================================
+// Dạng tìm kiếm (fold)
+// ============================================================================
+
+TEST(CollationTest, FoldStripsCaseTonesAndMarks)
+{
+    EXPECT_EQ(Collation::fold("Sơn Tùng M-TP"), "son tung m-tp");
+    EXPECT_EQ(Collation::fold("ĐẶNG THỊ ẤM ỨC"), "dang thi am uc");
+    EXPECT_EQ(Collation::fold("Ưu Ăn Ĩ Ũ"), "uu an i u");
+    EXPECT_EQ(Collation::fold("Café Ñandú Øre"), "cafe nandu ore");
+}
+
+TEST(CollationTest, FoldMatchesAcrossNormalizationForms)
+{
+    // NFD và NFC cho cùng một dạng; dấu tổ hợp đứng riêng cũng bị bỏ
+    EXPECT_EQ(Collation::fold("So\xCC\x9Bn Tu\xCC\x80ng"), "son tung");
+    EXPECT_EQ(Collation::fold("a\xCC\x82\xCC\x80"), Collation::fold("ầ"));
+    EXPECT_EQ(Collation::fold("\xCC\x81x"), "x");
+}
+
+TEST(CollationTest, FoldKeepsOtherText)
+{
+    EXPECT_EQ(Collation::fold("日本 Ω ß ×"), "日本 Ω ß ×");
+    EXPECT_EQ(Collation::fold("\xC9t\xE9 \xFF"), "ete \xFF");
+    EXPECT_EQ(Collation::fold(std::string("a\0B", 3)), std::string("a\0b", 3));
+
+    std::string out = "x|";
+    Collation::fold("ÁB", out);
+    EXPECT_EQ(out, "x|ab");
+}
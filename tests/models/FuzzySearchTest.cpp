@@ -0,0 +1,429 @@
+/**
+ * @file FuzzySearchTest.cpp
+ * @brief Unit test cho FuzzySearch — tìm kiếm chịu lỗi gõ có xếp hạng
+ *
+ * Bao gồm: thuật toán bit-parallel của Myers đối chiếu với bảng quy hoạch
+ * động, tìm thấy tên gõ sai ("beatels", "adel helo"), thứ tự trọng số
+ * title > artist > album, thưởng theo số lần nghe, và việc dùng lại kết quả
+ * khi gõ thêm cùng giới hạn top-K cho đúng kết quả của một lượt xếp hạng đầy
+ * đủ, kể cả sau khi chỉ mục thay đổi.
+ */
+
+#include <gtest/gtest.h>
+#include "models/FuzzySearch.h"
+#include "models/SearchIndex.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player::models;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+
+MediaFileModel makeMedia(const std::string& path, const std::string& title, const std::string& artist = "",
+                         const std::string& album = "")
+{
+    MediaFileModel media(path, 1, fs::file_time_type());
+    media.setTitle(title);
+    media.setArtist(artist);
+    media.setAlbum(album);
+    return media;
+}
+
+// Bảng quy hoạch động: số lần sửa ít nhất để pattern thành một chuỗi con của
+// text, và vị trí kết thúc đầu tiên đạt được số đó
+int referenceDistance(const std::string& pattern, std::string_view text, size_t& end)
+{
+    std::vector<int> column(pattern.size() + 1);
+    for (size_t i = 0; i <= pattern.size(); ++i)
+    {
+        column[i] = static_cast<int>(i);
+    }
+
+    int best = column.back();
+    end = 0;
+    for (size_t j = 0; j < text.size(); ++j)
+    {
+        int diagonal = column[0];
+        for (size_t i = 1; i <= pattern.size(); ++i)
+        {
+            int up = column[i];
+            column[i] = std::min({ up + 1, column[i - 1] + 1, diagonal + (pattern[i - 1] == text[j] ? 0 : 1) });
+            diagonal = up;
+        }
+        if (column.back() < best)
+        {
+            best = column.back();
+            end = j + 1;
+        }
+    }
+    return best;
+}
+
+// Các từ của một chuỗi (tách theo dấu cách) cùng vị trí byte bắt đầu
+std::vector<std::pair<std::string, size_t>> splitWords(std::string_view text)
+{
+    std::vector<std::pair<std::string, size_t>> words;
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = std::min(text.find(' ', start), text.size());
+        if (end > start)
+        {
+            words.emplace_back(std::string(text.substr(start, end - start)), start);
+        }
+        start = end + 1;
+    }
+    return words;
+}
+
+// Xếp hạng đầy đủ theo định nghĩa, không cắt tỉa và không dùng lại gì
+std::vector<FuzzyMatch> referenceRanking(const SearchIndex& index, const std::string& query, SearchFieldMask fields,
+                                         const FuzzySearch::PlayCounts& plays)
+{
+    std::vector<FuzzyMatch> ranking;
+    std::vector<std::pair<std::string, size_t>> terms = splitWords(SearchIndex::normalize(query));
+    if (terms.empty())
+    {
+        return ranking;
+    }
+
+    for (uint32_t position = 0; position < index.size(); ++position)
+    {
+        int32_t total = 0;
+        bool all = true;
+
+        for (const auto& entry : terms)
+        {
+            const std::string& term = entry.first;
+            bool found = false;
+            int32_t best = 0;
+            for (size_t f = 0; f < SearchIndex::FIELD_COUNT; ++f)
+            {
+                if (!(fields & (1u << f)))
+                {
+                    continue;
+                }
+                for (const auto& word : splitWords(index.getField(position, f)))
+                {
+                    size_t end;
+                    int distance = referenceDistance(term, word.first, end);
+                    if (distance > FuzzySearch::maxDistance(term.size()))
+                    {
+                        continue;
+                    }
+                    size_t start = word.second + (end > term.size() ? end - term.size() : 0);
+                    int32_t score = FuzzySearch::FIELD_WEIGHT[f] - FuzzySearch::EDIT_PENALTY * distance -
+                                    static_cast<int32_t>(std::min<size_t>(start, FuzzySearch::MAX_OFFSET_PENALTY));
+                    if (!found || score > best)
+                    {
+                        best = score;
+                        found = true;
+                    }
+                }
+            }
+            if (!found)
+            {
+                all = false;
+                break;
+            }
+            total += best;
+        }
+
+        if (all)
+        {
+            auto it = plays.find(position);
+            total += it == plays.end() ? 0 : FuzzySearch::playBonus(it->second);
+            ranking.push_back(FuzzyMatch{ position, total });
+        }
+    }
+
+    std::sort(ranking.begin(), ranking.end(), [](const FuzzyMatch& a, const FuzzyMatch& b)
+    {
+        return a.score > b.score || (a.score == b.score && a.position < b.position);
+    });
+    return ranking;
+}
+
+void expectSameMatches(const std::vector<FuzzyMatch>& actual, const std::vector<FuzzyMatch>& expected,
+                       const std::string& query)
+{
+    ASSERT_EQ(actual.size(), expected.size()) << "query \"" << query << "\"";
+    for (size_t i = 0; i < actual.size(); ++i)
+    {
+        EXPECT_EQ(actual[i].position, expected[i].position) << "query \"" << query << "\", rank " << i;
+        EXPECT_EQ(actual[i].score, expected[i].score) << "query \"" << query << "\", rank " << i;
+    }
+}
+
+const char* WORDS[] = { "beatles", "adele", "hello", "yesterday", "rolling", "stones", "queen", "bohemian",
+                        "rhapsody", "love", "night", "tình", "yêu", "mưa", "biển", "remix", "live", "blue" };
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+// Thư viện ngẫu nhiên ghép từ WORDS, đôi khi gõ sai một ký tự
+std::vector<MediaFileModel> randomLibrary(size_t count, std::mt19937& rng)
+{
+    std::uniform_int_distribution<size_t> word(0, WORD_COUNT - 1);
+    std::uniform_int_distribution<int> percent(0, 99);
+    auto phrase = [&](int words)
+    {
+        std::string text;
+        for (int w = 0; w < words; ++w)
+        {
+            std::string next = WORDS[word(rng)];
+            if (percent(rng) < 20)
+            {
+                next[rng() % next.size()] = static_cast<char>('a' + rng() % 26);
+            }
+            text += (w ? " " : "") + next;
+        }
+        return text;
+    };
+
+    std::vector<MediaFileModel> list;
+    for (size_t i = 0; i < count; ++i)
+    {
+        list.push_back(makeMedia("/music/" + std::to_string(i) + ".mp3", phrase(1 + static_cast<int>(i % 3)),
+                                 phrase(1), phrase(2)));
+    }
+    return list;
+}
+
+} // namespace
+
+// ============================================================================
+// Myers
+// ============================================================================
+
+TEST(FuzzySearchTest, PatternMatchesDynamicProgramming)
+{
+    std::mt19937 rng(7);
+    auto randomText = [&](size_t length)
+    {
+        std::string text;
+        for (size_t i = 0; i < length; ++i)
+        {
+            text += static_cast<char>('a' + rng() % 4);
+        }
+        return text;
+    };
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        std::string pattern = randomText(1 + rng() % 64);
+        std::string text = randomText(rng() % 100);
+
+        size_t end = 0;
+        size_t expectedEnd = 0;
+        int expected = referenceDistance(pattern, text, expectedEnd);
+        EXPECT_EQ(FuzzyPattern(pattern).search(text, end), expected) << pattern << " in " << text;
+        EXPECT_EQ(end, expectedEnd) << pattern << " in " << text;
+    }
+}
+
+TEST(FuzzySearchTest, PatternCountsEachKindOfEdit)
+{
+    size_t end;
+    EXPECT_EQ(FuzzyPattern("beatles").search("the beatles", end), 0);
+    EXPECT_EQ(end, 11u);
+    EXPECT_EQ(FuzzyPattern("beatels").search("the beatles", end), 2);     // Hai chữ đổi chỗ
+    EXPECT_EQ(FuzzyPattern("beatle").search("the beatles", end), 0);
+    EXPECT_EQ(FuzzyPattern("beatlees").search("the beatles", end), 1);    // Thừa một chữ
+    EXPECT_EQ(FuzzyPattern("betles").search("the beatles", end), 1);      // Thiếu một chữ
+    EXPECT_EQ(FuzzyPattern("abc").search("", end), 3);
+}
+
+// ============================================================================
+// Xếp hạng
+// ============================================================================
+
+TEST(FuzzySearchTest, FindsMisspelledNames)
+{
+    SearchIndex index;
+    FuzzySearch fuzzy;
+    index.build({ makeMedia("/m/0.mp3", "Hey Jude", "The Beatles", "1"),
+                  makeMedia("/m/1.mp3", "Hello", "Adele", "25"),
+                  makeMedia("/m/2.mp3", "Yellow", "Coldplay", "Parachutes"),
+                  makeMedia("/m/3.mp3", "Rolling in the Deep", "Adele", "21") });
+
+    FuzzyResult beatles = fuzzy.search(index, "beatels", SearchField::TAGS, {});
+    ASSERT_EQ(beatles.matches.size(), 1u);
+    EXPECT_EQ(beatles.matches[0].position, 0u);
+
+    // Mọi từ đều phải khớp: "helo" loại "Rolling in the Deep", "adel" loại "Yellow"
+    FuzzyResult hello = fuzzy.search(index, "Adel Helo", SearchField::TAGS, {});
+    ASSERT_EQ(hello.matches.size(), 1u);
+    EXPECT_EQ(hello.matches[0].position, 1u);
+
+    EXPECT_TRUE(fuzzy.search(index, "adel zzzz", SearchField::TAGS, {}).matches.empty());
+}
+
+TEST(FuzzySearchTest, ShortTermsAllowFewerEdits)
+{
+    EXPECT_EQ(FuzzySearch::maxDistance(3), 0);
+    EXPECT_EQ(FuzzySearch::maxDistance(4), 1);
+    EXPECT_EQ(FuzzySearch::maxDistance(6), 1);
+    EXPECT_EQ(FuzzySearch::maxDistance(7), 2);
+
+    SearchIndex index;
+    FuzzySearch fuzzy;
+    index.build({ makeMedia("/m/0.mp3", "Abc"), makeMedia("/m/1.mp3", "Abd") });
+    FuzzyResult result = fuzzy.search(index, "abc", SearchField::TITLE, {});
+    ASSERT_EQ(result.matches.size(), 1u);
+    EXPECT_EQ(result.matches[0].position, 0u);
+}
+
+TEST(FuzzySearchTest, TitleOutranksArtistOutranksAlbum)
+{
+    SearchIndex index;
+    FuzzySearch fuzzy;
+    index.build({ makeMedia("/m/0.mp3", "Song", "Other", "River"),
+                  makeMedia("/m/1.mp3", "Song", "River", "Other"),
+                  makeMedia("/m/2.mp3", "River", "Other", "Other"),
+                  makeMedia("/m/3.mp3", "Long way to the river") });
+
+    FuzzyResult result = fuzzy.search(index, "rivr", SearchField::TAGS, {});
+    ASSERT_EQ(result.matches.size(), 4u);
+    EXPECT_EQ(result.matches[0].position, 2u);
+    EXPECT_EQ(result.matches[1].position, 3u);  // Cũng ở title nhưng khớp muộn hơn
+    EXPECT_EQ(result.matches[2].position, 1u);
+    EXPECT_EQ(result.matches[3].position, 0u);
+
+    // Chỉ xét các trường được hỏi
+    FuzzyResult albums = fuzzy.search(index, "rivr", SearchField::ALBUM, {});
+    ASSERT_EQ(albums.matches.size(), 1u);
+    EXPECT_EQ(albums.matches[0].position, 0u);
+}
+
+TEST(FuzzySearchTest, PlayCountsRaiseRank)
+{
+    SearchIndex index;
+    FuzzySearch fuzzy;
+    index.build({ makeMedia("/m/0.mp3", "Yesterday", "The Beatles"),
+                  makeMedia("/m/1.mp3", "Yesterday", "Cover Band") });
+
+    FuzzyResult unplayed = fuzzy.search(index, "yesterdy", SearchField::TITLE, {});
+    ASSERT_EQ(unplayed.matches.size(), 2u);
+    EXPECT_EQ(unplayed.matches[0].position, 0u);
+
+    FuzzyResult played = fuzzy.search(index, "yesterdy", SearchField::TITLE, { { 1u, 5u } });
+    ASSERT_EQ(played.matches.size(), 2u);
+    EXPECT_EQ(played.matches[0].position, 1u);
+    EXPECT_EQ(played.matches[0].score, unplayed.matches[1].score + FuzzySearch::playBonus(5));
+}
+
+// ============================================================================
+// Gõ từng phím và top-K
+// ============================================================================
+
+TEST(FuzzySearchTest, MatchesFullRankingAtAnyLimit)
+{
+    std::mt19937 rng(11);
+    SearchIndex index;
+    FuzzySearch fuzzy;
+    index.build(randomLibrary(3000, rng));
+
+    FuzzySearch::PlayCounts plays;
+    for (uint32_t i = 0; i < 300; ++i)
+    {
+        plays[static_cast<uint32_t>(rng() % 3000)] = 1 + rng() % 100;
+    }
+
+    const std::string QUERIES[] = { "beatels", "adel helo", "love nihgt", "tinh yeu", "rhapsdy queen", "xx" };
+    for (const auto& query : QUERIES)
+    {
+        std::vector<FuzzyMatch> expected = referenceRanking(index, query, SearchField::TAGS, plays);
+        for (size_t limit : { size_t(1), size_t(10), size_t(100), size_t(100000) })
+        {
+            FuzzyResult result = fuzzy.search(index, query, SearchField::TAGS, plays, limit);
+            std::vector<FuzzyMatch> top(expected.begin(),
+                                        expected.begin() + static_cast<std::ptrdiff_t>(std::min(limit, expected.size())));
+            expectSameMatches(result.matches, top, query);
+        }
+    }
+}
+
+TEST(FuzzySearchTest, TypingMatchesFreshSearch)
+{
+    std::mt19937 rng(13);
+    SearchIndex index;
+    FuzzySearch fuzzy;
+    index.build(randomLibrary(3000, rng));
+    FuzzySearch::PlayCounts plays = { { 5u, 40u }, { 77u, 3u }, { 1200u, 9u } };
+
+    // Gõ thêm, xóa bớt, sửa từ đầu rồi gõ tiếp, mỗi phím dùng lại kết quả của
+    // phím trước
+    const std::string TYPED[] = { "b", "be", "bea", "beat", "beate", "beatel", "beatels", "beatels ",
+                                  "beatels y", "beatels ye", "beatels yes", "beatels ye", "beatels y",
+                                  "beatels", "beatel", "beatelx", "adel", "adel h", "adel hel", "adel helo",
+                                  "adele helo", "adele helo live" };
+    for (size_t limit : { size_t(5), FuzzySearch::DEFAULT_LIMIT })
+    {
+        FuzzyResult previous;
+        for (const auto& query : TYPED)
+        {
+            FuzzyResult typed = fuzzy.search(index, query, SearchField::TAGS, plays, limit, &previous);
+            FuzzyResult fresh = fuzzy.search(index, query, SearchField::TAGS, plays, limit);
+            expectSameMatches(typed.matches, fresh.matches, query);
+            previous = std::move(typed);
+        }
+    }
+}
+
+TEST(FuzzySearchTest, IndexChangesDropThePreviousResult)
+{
+    SearchIndex index;
+    FuzzySearch fuzzy;
+    index.build({ makeMedia("/m/0.mp3", "Hello", "Adele") });
+    FuzzyResult before = fuzzy.search(index, "helo", SearchField::TAGS, {});
+    ASSERT_EQ(before.matches.size(), 1u);
+
+    index.append(makeMedia("/m/1.mp3", "Hello Again"));
+    FuzzyResult after = fuzzy.search(index, "helo", SearchField::TAGS, {}, FuzzySearch::DEFAULT_LIMIT, &before);
+    EXPECT_EQ(after.matches.size(), 2u);
+
+    index.erase(0);
+    FuzzyResult erased = fuzzy.search(index, "helo agan", SearchField::TAGS, {}, FuzzySearch::DEFAULT_LIMIT, &after);
+    ASSERT_EQ(erased.matches.size(), 1u);
+    EXPECT_EQ(erased.matches[0].position, 0u);
+}
+
+TEST(FuzzySearchTest, WordsGatheredFromCopiedFields)
+{
+    std::mt19937 rng(11);
+    SearchIndex index;
+    index.build(randomLibrary(2000, rng));
+
+    // Chủ sở hữu chỉ giữ khóa chỉ mục lúc sao chép các trường
+    FuzzyFields fields = FuzzySearch::copyFields(index);
+    ASSERT_EQ(fields.size(), index.size());
+    EXPECT_EQ(fields.getField(7, 1), index.getField(7, 1));
+
+    FuzzySearch copied;
+    EXPECT_FALSE(copied.hasWords(index.getVersion()));
+    copied.gatherWords(fields);
+    EXPECT_TRUE(copied.hasWords(index.getVersion()));
+
+    FuzzySearch direct;
+    for (const char* query : { "beatels", "adel helo", "yestrday" })
+    {
+        FuzzyResult expected = direct.search(index, query, SearchField::TAGS, {});
+        FuzzyResult result = copied.search(query, SearchField::TAGS, {});
+        EXPECT_EQ(result.version, expected.version);
+        expectSameMatches(result.matches, expected.matches, query);
+    }
+
+    // Chỉ mục đã đổi: từ cũ không còn là của phiên bản này
+    index.erase(0);
+    EXPECT_FALSE(copied.hasWords(index.getVersion()));
+}
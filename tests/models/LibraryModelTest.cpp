@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
 #include "models/LibraryModel.h"
 #include "models/MediaFileModel.h"
+#include "services/DirectoryReader.h"
 #include <filesystem>
 #include <fstream>
+#include <atomic>
+#include <thread>
 
 namespace fs = std::filesystem;
 using namespace media_player::models;
@@ -34,6 +37,13 @@ protected:
     fs::path audioFile;
     fs::path audioFile2;
     fs::path videoFile;
+    
+    // Record with its real size, as a scan produces it
+    static MediaFileModel scanned(const fs::path& path) {
+        media_player::services::FileStat stat;
+        media_player::services::DirectoryReader::statFile(path.string(), stat);
+        return MediaFileModel(path.string(), stat.size, stat.lastModified);
+    }
 };
 
 // ===================== Basic =====================
@@ -325,8 +335,8 @@ TEST_F(LibraryModelTest, GetTotalVideoFilesEmpty) {
 // ===================== GetTotalSize =====================
 
 TEST_F(LibraryModelTest, GetTotalSize) {
-    model.addMedia(MediaFileModel(audioFile.string()));
-    model.addMedia(MediaFileModel(videoFile.string()));
+    model.addMedia(scanned(audioFile));
+    model.addMedia(scanned(videoFile));
     
     // Files should have some size
     EXPECT_GT(model.getTotalSize(), 0);
@@ -335,3 +345,389 @@ TEST_F(LibraryModelTest, GetTotalSize) {
 TEST_F(LibraryModelTest, GetTotalSizeEmpty) {
     EXPECT_EQ(model.getTotalSize(), 0);
 }
+
+// ===================== Remove Under Directory =====================
+
+TEST_F(LibraryModelTest, RemoveMediaUnderDirectory) {
+    fs::create_directories(testDir / "album");
+    fs::create_directories(testDir / "album2");
+    std::ofstream(testDir / "album" / "a.mp3") << "a";
+    std::ofstream(testDir / "album2" / "b.mp3") << "b";
+    
+    model.addMedia(MediaFileModel(audioFile.string()));
+    model.addMedia(MediaFileModel((testDir / "album" / "a.mp3").string()));
+    model.addMedia(MediaFileModel((testDir / "album2" / "b.mp3").string()));
+    
+    // "album2" shares the prefix but is not inside "album"
+    EXPECT_EQ(model.removeMediaUnder((testDir / "album").string()), 1u);
+    EXPECT_EQ(model.getMediaCount(), 2u);
+    EXPECT_FALSE(model.getMediaByPath((testDir / "album" / "a.mp3").string()).has_value());
+    EXPECT_EQ(model.removeMediaUnder((testDir / "missing").string()), 0u);
+}
+
+// ===================== Snapshots =====================
+
+TEST_F(LibraryModelTest, SnapshotIsUnchangedByLaterWrites) {
+    model.addMedia(MediaFileModel(audioFile.string()));
+    MediaSnapshot before = model.getSnapshot();
+    
+    model.addMedia(MediaFileModel(audioFile2.string()));
+    model.removeMedia(audioFile.string());
+    
+    // The old snapshot is immutable; writers published new lists
+    ASSERT_EQ(before->size(), 1u);
+    EXPECT_EQ((*before)[0].getFilePath(), audioFile.string());
+    ASSERT_EQ(model.getSnapshot()->size(), 1u);
+    EXPECT_EQ((*model.getSnapshot())[0].getFilePath(), audioFile2.string());
+}
+
+TEST_F(LibraryModelTest, NoOpWritesKeepSnapshot) {
+    model.addMedia(MediaFileModel(audioFile.string()));
+    MediaSnapshot before = model.getSnapshot();
+    
+    model.addMedia(MediaFileModel(audioFile.string()));
+    model.addMediaBatch({MediaFileModel(audioFile.string())});
+    EXPECT_FALSE(model.removeMedia("/nonexistent.mp3"));
+    EXPECT_EQ(model.removeMediaUnder((testDir / "missing").string()), 0u);
+    
+    EXPECT_EQ(model.getSnapshot().get(), before.get());
+}
+
+TEST_F(LibraryModelTest, ReplaceAllDropsDuplicates) {
+    model.addMedia(MediaFileModel(videoFile.string()));
+    
+    model.replaceAll({
+        MediaFileModel(audioFile.string()),
+        MediaFileModel(audioFile2.string()),
+        MediaFileModel(audioFile.string())
+    });
+    
+    EXPECT_EQ(model.getMediaCount(), 2u);
+    EXPECT_FALSE(model.getMediaByPath(videoFile.string()).has_value());
+}
+
+TEST_F(LibraryModelTest, SetSnapshotSharesList) {
+    auto shared = std::make_shared<const std::vector<MediaFileModel>>(
+        std::vector<MediaFileModel>{MediaFileModel(audioFile.string())});
+    
+    model.setSnapshot(shared);
+    EXPECT_EQ(model.getSnapshot().get(), shared.get());
+    EXPECT_EQ(model.getMediaCount(), 1u);
+    
+    // A null snapshot means an empty library
+    model.setSnapshot(nullptr);
+    EXPECT_TRUE(model.isEmpty());
+}
+
+TEST_F(LibraryModelTest, ReadersIterateWhileWriterPublishes) {
+    constexpr int batches = 200;
+    constexpr int batchSize = 20;
+    std::atomic<bool> done(false);
+    
+    std::thread writer([this, &done]() {
+        for (int b = 0; b < batches; ++b) {
+            std::vector<MediaFileModel> batch;
+            for (int i = 0; i < batchSize; ++i) {
+                batch.emplace_back("/music/" + std::to_string(b) + "_" + std::to_string(i) + ".mp3", 1,
+                                   fs::file_time_type());
+            }
+            model.addMediaBatch(batch);
+        }
+        done = true;
+    });
+    
+    // Every snapshot a reader sees is a whole number of batches, never a torn list
+    size_t lastSize = 0;
+    while (!done) {
+        MediaSnapshot snapshot = model.getSnapshot();
+        EXPECT_EQ(snapshot->size() % batchSize, 0u);
+        EXPECT_GE(snapshot->size(), lastSize);
+        size_t total = 0;
+        for (const auto& media : *snapshot) {
+            total += media.getFileSize();
+        }
+        EXPECT_EQ(total, snapshot->size());
+        lastSize = snapshot->size();
+    }
+    writer.join();
+    
+    EXPECT_EQ(model.getMediaCount(), static_cast<size_t>(batches * batchSize));
+}
+
+// ===================== Path Index =====================
+
+TEST_F(LibraryModelTest, AddMediaBatchMovesRecordsIn) {
+    std::vector<MediaFileModel> batch;
+    batch.emplace_back("/music/a.mp3", 1, fs::file_time_type());
+    batch.emplace_back("/music/b.mp3", 2, fs::file_time_type());
+    batch.emplace_back("/music/a.mp3", 3, fs::file_time_type());
+    
+    model.addMediaBatch(std::move(batch));
+    
+    // The first record of a path wins, as with the copying overload
+    EXPECT_EQ(model.getMediaCount(), 2u);
+    EXPECT_EQ(model.getMediaByPath("/music/a.mp3")->getFileSize(), 1u);
+    EXPECT_EQ(model.getMediaByPath("/music/b.mp3")->getFileSize(), 2u);
+}
+
+TEST_F(LibraryModelTest, IndexFollowsRemovalsAndRenames) {
+    std::vector<MediaFileModel> batch;
+    for (int i = 0; i < 50; ++i) {
+        batch.emplace_back("/music/t" + std::to_string(i) + ".mp3", i, fs::file_time_type());
+    }
+    model.addMediaBatch(std::move(batch));
+    
+    EXPECT_TRUE(model.removeMedia("/music/t10.mp3"));
+    EXPECT_EQ(model.removeMediaUnder("/nowhere"), 0u);
+    EXPECT_TRUE(model.updateMedia("/music/t20.mp3",
+                                  MediaFileModel("/music/renamed.mp3", 20, fs::file_time_type())));
+    
+    // Every remaining path still resolves to its own record after the shift
+    EXPECT_FALSE(model.getMediaByPath("/music/t10.mp3").has_value());
+    EXPECT_FALSE(model.getMediaByPath("/music/t20.mp3").has_value());
+    EXPECT_EQ(model.getMediaByPath("/music/renamed.mp3")->getFileSize(), 20u);
+    for (int i = 0; i < 50; ++i) {
+        if (i == 10 || i == 20) continue;
+        auto media = model.getMediaByPath("/music/t" + std::to_string(i) + ".mp3");
+        ASSERT_TRUE(media.has_value()) << i;
+        EXPECT_EQ(media->getFileSize(), static_cast<size_t>(i));
+    }
+    
+    // Re-adding a removed path is allowed again
+    model.addMedia(MediaFileModel("/music/t10.mp3", 10, fs::file_time_type()));
+    EXPECT_EQ(model.getMediaCount(), 50u);
+}
+
+TEST_F(LibraryModelTest, MarkStale) {
+    model.addMedia(MediaFileModel("/music/a.mp3", 1, fs::file_time_type()));
+    model.addMedia(MediaFileModel("/music/b.mp3", 2, fs::file_time_type()));
+    model.addMedia(MediaFileModel("/music/c.mp3", 3, fs::file_time_type()));
+    
+    // Unknown paths are ignored
+    EXPECT_EQ(model.markStale({"/music/a.mp3", "/music/c.mp3", "/music/none.mp3"}), 2u);
+    EXPECT_EQ(model.getStaleCount(), 2u);
+    EXPECT_TRUE(model.getMediaByPath("/music/a.mp3")->isStale());
+    EXPECT_FALSE(model.getMediaByPath("/music/b.mp3")->isStale());
+    
+    // Already stale records are not counted again
+    EXPECT_EQ(model.markStale({"/music/a.mp3"}), 0u);
+    EXPECT_TRUE(model.contains("/music/c.mp3"));
+    EXPECT_FALSE(model.contains("/music/none.mp3"));
+}
+
+TEST_F(LibraryModelTest, IndexedSearchFollowsEdits) {
+    MediaFileModel hello("/music/hello.mp3", 1, fs::file_time_type());
+    hello.setTitle("Hello");
+    hello.setArtist("Adele");
+    MediaFileModel yesterday("/music/yesterday.mp3", 1, fs::file_time_type());
+    yesterday.setTitle("Yesterday");
+    yesterday.setArtist("The Beatles");
+    model.addMediaBatch({hello, yesterday});
+    
+    auto found = model.search("adele", SearchField::ARTIST);
+    ASSERT_EQ(found.result.positions.size(), 1u);
+    EXPECT_EQ((*found.media)[found.result.positions[0]].getTitle(), "Hello");
+    EXPECT_TRUE(model.search("adele", SearchField::TITLE).result.positions.empty());
+    
+    // Positions refer to the snapshot handed back, even after a removal
+    model.removeMedia("/music/hello.mp3");
+    found = model.search("yes", SearchField::TAGS);
+    ASSERT_EQ(found.result.positions.size(), 1u);
+    EXPECT_EQ((*found.media)[found.result.positions[0]].getFilePath(), "/music/yesterday.mp3");
+    
+    // Typing on narrows the previous result
+    auto narrowed = model.search("yest", SearchField::TAGS, &found);
+    EXPECT_EQ(narrowed.result.positions, found.result.positions);
+    
+    MediaFileModel retagged = yesterday;
+    retagged.setTitle("Let It Be");
+    model.updateMedia("/music/yesterday.mp3", retagged);
+    EXPECT_TRUE(model.search("yest", SearchField::TITLE, &narrowed).result.positions.empty());
+    EXPECT_EQ(model.search("let it", SearchField::TITLE).result.positions.size(), 1u);
+    
+    model.removeMediaUnder("/music");
+    EXPECT_TRUE(model.search("let", SearchField::TAGS).result.positions.empty());
+}
+
+TEST_F(LibraryModelTest, SearchIgnoresAccents) {
+    MediaFileModel song("/music/lac_troi.mp3", 1, fs::file_time_type());
+    song.setTitle("Lạc Trôi");
+    song.setArtist("Sơn Tùng M-TP");
+    model.addMedia(song);
+    
+    EXPECT_EQ(model.search("son tung", SearchField::ARTIST).result.positions.size(), 1u);
+    EXPECT_EQ(model.search("LAC TROI", SearchField::TITLE).result.positions.size(), 1u);
+    
+    // Folded keys are rebuilt when the tags change
+    MediaFileModel retagged = song;
+    retagged.setTitle("Nơi Này Có Anh");
+    model.updateMedia("/music/lac_troi.mp3", retagged);
+    EXPECT_TRUE(model.search("lac", SearchField::TITLE).result.positions.empty());
+    EXPECT_EQ(model.search("noi nay co anh", SearchField::TITLE).result.positions.size(), 1u);
+}
+
+TEST_F(LibraryModelTest, FuzzySearchRanksByPlays) {
+    MediaFileModel studio("/music/hello.mp3", 1, fs::file_time_type());
+    studio.setTitle("Hello");
+    studio.setArtist("Adele");
+    MediaFileModel live("/music/hello_live.mp3", 1, fs::file_time_type());
+    live.setTitle("Hello (Live)");
+    live.setArtist("Adele");
+    model.addMediaBatch({studio, live});
+    
+    // Play counts come keyed by id and are mapped onto the snapshot
+    LibraryFuzzySearch fresh = model.fuzzySearch("adel helo", SearchField::TAGS, {});
+    ASSERT_EQ(fresh.result.matches.size(), 2u);
+    EXPECT_EQ((*fresh.media)[fresh.result.matches[0].position].getFilePath(), "/music/hello.mp3");
+    
+    LibraryFuzzySearch played = model.fuzzySearch("adel helo", SearchField::TAGS, {{MediaId::fromPath(live.getFilePath()), 12}},
+                                                  FuzzySearch::DEFAULT_LIMIT, &fresh);
+    ASSERT_EQ(played.result.matches.size(), 2u);
+    EXPECT_EQ((*played.media)[played.result.matches[0].position].getFilePath(), "/music/hello_live.mp3");
+}
+
+TEST_F(LibraryModelTest, ApplyChangesMatchesSingleEdits) {
+    auto track = [](int i, const std::string& dir, const std::string& title) {
+        MediaFileModel media("/music/" + dir + "/t" + std::to_string(i) + ".mp3", 1, fs::file_time_type());
+        media.setTitle(title + " " + std::to_string(i));
+        media.setArtist(i % 2 ? "Đen" : "Adele");
+        return media;
+    };
+    auto paths = [](const std::vector<MediaFileModel>& list) {
+        std::vector<std::string> result;
+        for (const auto& media : list) {
+            result.push_back(media.getFilePath() + "|" + media.getTitle());
+        }
+        return result;
+    };
+    
+    std::vector<MediaFileModel> initial;
+    for (int i = 0; i < 30; ++i) {
+        initial.push_back(track(i, i < 10 ? "old" : "keep", "Song"));
+    }
+    LibraryModel single;
+    model.addMediaBatch(initial);
+    single.addMediaBatch(initial);
+    
+    // Orders and search kept from before the batch have to follow it
+    model.getSortOrder(SortCriteria::TITLE);
+    model.getSortOrder(SortCriteria::ARTIST);
+    model.getSortOrder(SortCriteria::DATE_ADDED);
+    model.search("song", SearchField::TITLE);
+    
+    std::vector<LibraryEdit> edits = {
+        { LibraryEdit::Type::REMOVE_UNDER, "/music/old", std::nullopt },
+        { LibraryEdit::Type::PUT, "", track(12, "keep", "Retagged") },
+        { LibraryEdit::Type::REMOVE, "/music/keep/t15.mp3", std::nullopt },
+        { LibraryEdit::Type::PUT, "", track(40, "new", "Added") },
+        { LibraryEdit::Type::PUT, "", track(41, "new", "Added") },
+        { LibraryEdit::Type::REMOVE, "/music/new/t41.mp3", std::nullopt },
+        { LibraryEdit::Type::REMOVE, "/music/missing.mp3", std::nullopt },
+    };
+    EXPECT_EQ(model.applyChanges(edits), 15u);
+    
+    single.removeMediaUnder("/music/old");
+    single.updateMedia("/music/keep/t12.mp3", track(12, "keep", "Retagged"));
+    single.removeMedia("/music/keep/t15.mp3");
+    single.addMedia(track(40, "new", "Added"));
+    single.addMedia(track(41, "new", "Added"));
+    single.removeMedia("/music/new/t41.mp3");
+    
+    EXPECT_EQ(paths(model.getAllMedia()), paths(single.getAllMedia()));
+    for (auto criteria : { SortCriteria::TITLE, SortCriteria::ARTIST, SortCriteria::DATE_ADDED }) {
+        EXPECT_EQ(paths(model.getSorted(criteria)), paths(single.getSorted(criteria)));
+    }
+    for (const char* query : { "song", "retagged", "added" }) {
+        EXPECT_EQ(model.search(query, SearchField::TITLE).result.positions,
+                  single.search(query, SearchField::TITLE).result.positions);
+    }
+    EXPECT_TRUE(model.contains("/music/new/t40.mp3"));
+    EXPECT_FALSE(model.contains("/music/keep/t15.mp3"));
+    
+    // Removed and put back in the same batch: the record stays, retagged
+    EXPECT_EQ(model.applyChanges({
+        { LibraryEdit::Type::REMOVE, "/music/keep/t20.mp3", std::nullopt },
+        { LibraryEdit::Type::PUT, "", track(20, "keep", "Back") },
+    }), 2u);
+    EXPECT_EQ(model.getMediaByPath("/music/keep/t20.mp3")->getTitle(), "Back 20");
+    EXPECT_EQ(model.search("back", SearchField::TITLE).result.positions.size(), 1u);
+    
+    // Nothing to apply: the snapshot is kept
+    auto before = model.getSnapshot();
+    EXPECT_EQ(model.applyChanges({ { LibraryEdit::Type::REMOVE, "/music/missing.mp3", std::nullopt } }), 0u);
+    EXPECT_EQ(model.getSnapshot(), before);
+}
+
+TEST_F(LibraryModelTest, StagedChangesPublishOnceWorthACopy) {
+    auto puts = [](int first, int count) {
+        std::vector<LibraryEdit> edits;
+        for (int i = first; i < first + count; ++i) {
+            std::string path = "/music/t" + std::to_string(i) + ".mp3";
+            edits.push_back({ LibraryEdit::Type::PUT, path, MediaFileModel(path, 1, fs::file_time_type()) });
+        }
+        return edits;
+    };
+    
+    // Empty library: the first tracks show up right away
+    EXPECT_EQ(model.stageChanges(puts(0, 10)), 10u);
+    EXPECT_EQ(model.getMediaCount(), 10u);
+    
+    // Less than half the library waits, and is not visible yet
+    EXPECT_EQ(model.stageChanges(puts(10, 3)), 0u);
+    EXPECT_EQ(model.getStagedCount(), 3u);
+    EXPECT_EQ(model.getMediaCount(), 10u);
+    EXPECT_FALSE(model.contains("/music/t10.mp3"));
+    
+    // Together with the next batch it is worth a publish
+    EXPECT_EQ(model.stageChanges(puts(13, 2)), 5u);
+    EXPECT_EQ(model.getStagedCount(), 0u);
+    EXPECT_EQ(model.getMediaCount(), 15u);
+    EXPECT_TRUE(model.contains("/music/t10.mp3"));
+    
+    EXPECT_EQ(model.stageChanges(puts(15, 1)), 0u);
+    EXPECT_EQ(model.publishStaged(), 1u);
+    EXPECT_EQ(model.getMediaCount(), 16u);
+    EXPECT_EQ(model.publishStaged(), 0u);
+    
+    // Replacing the library drops what was staged for the old one
+    EXPECT_EQ(model.stageChanges(puts(16, 1)), 0u);
+    model.clear();
+    EXPECT_EQ(model.getStagedCount(), 0u);
+    EXPECT_EQ(model.publishStaged(), 0u);
+    EXPECT_TRUE(model.isEmpty());
+}
+
+TEST_F(LibraryModelTest, SortOrderFollowsEdits) {
+    MediaFileModel b("/music/b.mp3", 1, fs::file_time_type());
+    b.setTitle("Bài Ca");
+    b.setArtist("Zed");
+    MediaFileModel a("/music/a.mp3", 1, fs::file_time_type());
+    a.setTitle("Anh");
+    a.setArtist("Đen");
+    model.addMediaBatch({b, a});
+    
+    auto order = model.getSortOrder(SortCriteria::TITLE);
+    ASSERT_EQ(order.positions->size(), 2u);
+    EXPECT_EQ((*order.media)[order.positions->front()].getTitle(), "Anh");
+    
+    // The same order comes back until the library changes
+    EXPECT_EQ(model.getSortOrder(SortCriteria::TITLE).positions, order.positions);
+    
+    MediaFileModel c("/music/c.mp3", 1, fs::file_time_type());
+    c.setTitle("Ánh");
+    model.addMedia(c);
+    model.removeMedia("/music/a.mp3");
+    
+    auto titles = model.getSorted(SortCriteria::TITLE, true);
+    ASSERT_EQ(titles.size(), 2u);
+    EXPECT_EQ(titles[0].getTitle(), "Ánh");
+    EXPECT_EQ(titles[1].getTitle(), "Bài Ca");
+    
+    auto artists = model.getSorted(SortCriteria::ARTIST, false);
+    EXPECT_EQ(artists[0].getArtist(), "Zed");
+    
+    // A search can bring the order of the snapshot it searched
+    auto found = model.search("b", SearchField::TITLE, nullptr, SortCriteria::DATE_ADDED);
+    ASSERT_TRUE(found.order);
+    EXPECT_EQ(found.order->size(), found.media->size());
+}
@@ -0,0 +1,242 @@
+/**
+ * @file MediaCatalogTest.cpp
+ * @brief Unit test cho MediaCatalog/MediaHandle: mỗi đường dẫn một bản ghi,
+ *        handle dùng chung, cập nhật thấy ngay ở hàng đợi, playlist, lịch sử
+ */
+
+#include <gtest/gtest.h>
+#include "models/MediaCatalog.h"
+#include "models/QueueModel.h"
+#include "models/PlaylistModel.h"
+#include "models/HistoryModel.h"
+
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace media_player::models;
+namespace fs = std::filesystem;
+
+namespace
+{
+
+MediaFileModel makeMedia(const std::string& path, const std::string& title, int64_t modified = 1000)
+{
+    MediaFileModel media(path, 4096, fs::file_time_type(fs::file_time_type::duration(modified)));
+    media.setTitle(title);
+    media.setArtist("Artist");
+    return media;
+}
+
+} // namespace
+
+// ============================================================================
+// Catalog riêng
+// ============================================================================
+
+TEST(MediaCatalogTest, InternSharesOneRecordPerPath)
+{
+    MediaCatalog catalog;
+
+    MediaHandle first = catalog.intern(makeMedia("/music/a.mp3", "A"));
+    MediaHandle second = catalog.intern(makeMedia("/music/a.mp3", "A"));
+    MediaHandle other = catalog.intern(makeMedia("/music/b.mp3", "B"));
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_NE(first, other);
+    EXPECT_EQ(first.getFilePath(), "/music/a.mp3");
+    EXPECT_EQ(catalog.size(), 2u);
+}
+
+TEST(MediaCatalogTest, UpdateReachesEveryHandle)
+{
+    MediaCatalog catalog;
+    MediaHandle first = catalog.intern(makeMedia("/music/a.mp3", "Old"));
+    MediaHandle second = catalog.intern(makeMedia("/music/a.mp3", "Old"));
+
+    auto before = first.get();
+    EXPECT_TRUE(catalog.update(makeMedia("/music/a.mp3", "New")));
+
+    EXPECT_EQ(first.get()->getTitle(), "New");
+    EXPECT_EQ(second.materialize().getTitle(), "New");
+    // Người đang giữ bản ghi cũ vẫn đọc được nó
+    EXPECT_EQ(before->getTitle(), "Old");
+}
+
+TEST(MediaCatalogTest, UpdateOfUnheldPathIsIgnored)
+{
+    MediaCatalog catalog;
+
+    EXPECT_FALSE(catalog.update(makeMedia("/music/a.mp3", "A")));
+    EXPECT_FALSE(catalog.find("/music/a.mp3"));
+    EXPECT_EQ(catalog.size(), 0u);
+}
+
+TEST(MediaCatalogTest, StaleCopyDoesNotUndoAnEdit)
+{
+    MediaCatalog catalog;
+    MediaFileModel stale = makeMedia("/music/a.mp3", "Old");
+    MediaHandle handle = catalog.intern(stale);
+    catalog.update(makeMedia("/music/a.mp3", "Edited"));
+
+    catalog.intern(stale);
+    EXPECT_EQ(handle.get()->getTitle(), "Edited");
+
+    // Bản ghi quét lại sau khi file đổi trên đĩa thì được nhận
+    catalog.intern(makeMedia("/music/a.mp3", "Rescanned", 2000));
+    EXPECT_EQ(handle.get()->getTitle(), "Rescanned");
+}
+
+TEST(MediaCatalogTest, ScannedRecordReplacesRestoredPath)
+{
+    MediaCatalog catalog;
+    // Playlist/lịch sử khôi phục từ file chỉ có đường dẫn, chưa stat
+    MediaHandle restored = catalog.intern(MediaFileModel("/music/a.mp3"));
+
+    catalog.intern(makeMedia("/music/a.mp3", "Tagged"));
+
+    EXPECT_EQ(restored.get()->getTitle(), "Tagged");
+    EXPECT_EQ(restored.get()->getFileSize(), 4096u);
+}
+
+TEST(MediaCatalogTest, EntryGoesAwayWithLastHandle)
+{
+    MediaCatalog catalog;
+    {
+        MediaHandle handle = catalog.intern(makeMedia("/music/a.mp3", "A"));
+        EXPECT_TRUE(catalog.find("/music/a.mp3"));
+    }
+
+    EXPECT_FALSE(catalog.find("/music/a.mp3"));
+    EXPECT_EQ(catalog.size(), 0u);
+
+    // Đường dẫn giữ lại lần nữa thì có bản ghi mới
+    MediaHandle again = catalog.intern(makeMedia("/music/a.mp3", "Again"));
+    EXPECT_EQ(again.get()->getTitle(), "Again");
+}
+
+TEST(MediaCatalogTest, ExpiredEntriesArePruned)
+{
+    MediaCatalog catalog;
+    MediaHandle kept = catalog.intern(makeMedia("/music/kept.mp3", "Kept"));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        catalog.intern(makeMedia("/music/" + std::to_string(i) + ".mp3", "T"));
+    }
+
+    EXPECT_EQ(catalog.size(), 1u);
+    EXPECT_EQ(catalog.find("/music/kept.mp3"), kept);
+}
+
+TEST(MediaCatalogTest, MarkStaleFlagsHeldRecords)
+{
+    MediaCatalog catalog;
+    MediaHandle handle = catalog.intern(makeMedia("/music/a.mp3", "A"));
+
+    // Đường dẫn không ai giữ thì bỏ qua
+    EXPECT_EQ(catalog.markStale({ "/music/a.mp3", "/music/none.mp3" }), 1u);
+    EXPECT_TRUE(handle.get()->isStale());
+    EXPECT_EQ(handle.get()->getTitle(), "A");
+    EXPECT_EQ(catalog.getFilePaths(), std::vector<std::string>{ "/music/a.mp3" });
+
+    // File xuất hiện lại: bản quét mới thay bản ghi đã đánh dấu
+    catalog.intern(makeMedia("/music/a.mp3", "A"));
+    EXPECT_FALSE(handle.get()->isStale());
+}
+
+TEST(MediaCatalogTest, NullHandleIsEmpty)
+{
+    MediaHandle handle;
+
+    EXPECT_FALSE(handle);
+    EXPECT_EQ(handle.get(), nullptr);
+    EXPECT_TRUE(handle.getFilePath().empty());
+    EXPECT_TRUE(handle.materialize().getFilePath().empty());
+}
+
+TEST(MediaCatalogTest, ReadersSeeWholeRecordsDuringUpdates)
+{
+    MediaCatalog catalog;
+    MediaHandle handle = catalog.intern(makeMedia("/music/a.mp3", "0"));
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+
+    std::thread reader([&]()
+    {
+        while (!done)
+        {
+            auto record = handle.get();
+            if (!record || record->getFilePath() != "/music/a.mp3" || record->getArtist() != "Artist")
+            {
+                torn++;
+            }
+        }
+    });
+
+    for (int i = 1; i <= 2000; ++i)
+    {
+        catalog.update(makeMedia("/music/a.mp3", std::to_string(i)));
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    EXPECT_EQ(handle.get()->getTitle(), "2000");
+}
+
+// ============================================================================
+// Hàng đợi, playlist và lịch sử dùng catalog chung
+// ============================================================================
+
+TEST(MediaCatalogTest, TagEditShowsInQueuePlaylistAndHistory)
+{
+    const std::string path = "/music/catalog_shared_edit.mp3";
+    MediaFileModel original = makeMedia(path, "Before");
+
+    QueueModel queue;
+    queue.addToEnd(original);
+
+    PlaylistModel playlist("Edits");
+    playlist.addItem(original);
+    PlaylistModel playlistCopy = playlist;
+
+    HistoryModel history(nullptr, 10);
+    history.addEntry(original);
+
+    MediaFileModel edited = original;
+    edited.setTitle("After");
+    EXPECT_TRUE(MediaCatalog::getShared()->update(edited));
+
+    EXPECT_EQ(queue.getItemAt(0)->getTitle(), "After");
+    EXPECT_EQ(queue.getCurrentItem()->getTitle(), "After");
+    EXPECT_EQ(playlist.getItemAt(0)->getTitle(), "After");
+    EXPECT_EQ(playlistCopy.getItems()[0].getTitle(), "After");
+    EXPECT_EQ(history.getLastPlayed()->media.getTitle(), "After");
+}
+
+TEST(MediaCatalogTest, QueueSharesPlaylistHandles)
+{
+    PlaylistModel playlist("Big");
+    for (int i = 0; i < 100; ++i)
+    {
+        playlist.addItem(makeMedia("/music/catalog_big_" + std::to_string(i) + ".mp3", "T"));
+    }
+
+    QueueModel queue;
+    for (const auto& handle : playlist.getHandles())
+    {
+        queue.addToEnd(handle);
+    }
+
+    std::vector<MediaHandle> queued = queue.getHandles();
+    ASSERT_EQ(queued.size(), 100u);
+    for (size_t i = 0; i < queued.size(); ++i)
+    {
+        EXPECT_EQ(queued[i].get(), playlist.getHandles()[i].get());
+    }
+    EXPECT_TRUE(queue.contains("/music/catalog_big_42.mp3"));
+    EXPECT_FALSE(queue.contains("/music/catalog_big_100.mp3"));
+}
@@ -41,6 +41,17 @@ TEST_F(MediaFileModelTest, ConstructorWithPath) {
     EXPECT_EQ(file.getExtension(), ".mp3");
 }
 
+TEST_F(MediaFileModelTest, ConstructorWithKnownStat) {
+    auto mtime = fs::last_write_time(testFile);
+    models::MediaFileModel file(testFile.string(), 1234, mtime);
+    
+    // Takes the given stat instead of reading the file
+    EXPECT_EQ(file.getFileName(), "test.mp3");
+    EXPECT_EQ(file.getFileSize(), 1234u);
+    EXPECT_EQ(file.getLastModified(), mtime);
+    EXPECT_TRUE(file.isAudio());
+}
+
 // ===================== Media Type Detection =====================
 
 TEST_F(MediaFileModelTest, DetermineMediaTypeAudio) {
@@ -159,9 +170,24 @@ TEST_F(MediaFileModelTest, DeserializeInvalid) {
 
 // ===================== File Size / Last Modified =====================
 
-TEST_F(MediaFileModelTest, FileSize) {
+TEST_F(MediaFileModelTest, PathConstructorDoesNoIo) {
     models::MediaFileModel file(testFile.string());
-    EXPECT_GT(file.getFileSize(), 0);
+    
+    // Size and mtime come from a scan; existence is MediaValidator's job
+    EXPECT_EQ(file.getFileSize(), 0u);
+    EXPECT_EQ(file.getLastModified(), fs::file_time_type());
+    EXPECT_FALSE(file.isStale());
+    EXPECT_TRUE(file.isValid());
+}
+
+TEST_F(MediaFileModelTest, StaleFlag) {
+    models::MediaFileModel file("/gone/song.mp3");
+    file.setStale(true);
+    
+    models::MediaFileModel copy = file;
+    EXPECT_TRUE(copy.isStale());
+    copy.setStale(false);
+    EXPECT_FALSE(copy.isStale());
 }
 
 // ===================== getFileName / getExtension =====================
@@ -177,3 +203,38 @@ TEST_F(MediaFileModelTest, ExtensionWithMultipleDots) {
     EXPECT_EQ(file.getFileName(), "my.song.mp3");
     EXPECT_EQ(file.getExtension(), ".mp3");
 }
+
+TEST_F(MediaFileModelTest, NameExtensionAndDirectoryAreViewsIntoPath) {
+    models::MediaFileModel file("/music/album/.hidden", 1, fs::file_time_type());
+    EXPECT_EQ(file.getDirectory(), "/music/album/");
+    EXPECT_EQ(file.getFileName(), ".hidden");
+    EXPECT_EQ(file.getExtension(), "");
+    
+    models::MediaFileModel bare("track.mp3", 1, fs::file_time_type());
+    EXPECT_EQ(bare.getDirectory(), "");
+    EXPECT_EQ(bare.getFileName(), "track.mp3");
+    
+    // Views stay valid across copies: they are rebuilt from the copy's own path
+    models::MediaFileModel copy = file;
+    file = bare;
+    EXPECT_EQ(copy.getFileName(), ".hidden");
+    EXPECT_EQ(copy.getDirectory().data(), copy.getFilePath().data());
+}
+
+// ===================== Interned Tags =====================
+
+TEST_F(MediaFileModelTest, ArtistAndAlbumAreShared) {
+    models::MediaFileModel first("/music/a.mp3", 1, fs::file_time_type());
+    models::MediaFileModel second("/music/b.mp3", 1, fs::file_time_type());
+    first.setArtist(std::string("Sơn Tùng M-TP"));
+    second.setArtist("Sơn Tùng M-TP");
+    first.setAlbum("m-tp M-TP");
+    
+    EXPECT_EQ(&first.getArtist(), &second.getArtist());
+    EXPECT_EQ(first.getAlbum(), "m-tp M-TP");
+    EXPECT_EQ(second.getAlbum(), "");
+    
+    second.setArtist("Đen");
+    EXPECT_EQ(first.getArtist(), "Sơn Tùng M-TP");
+    EXPECT_EQ(second.getArtist(), "Đen");
+}
@@ -0,0 +1,66 @@
+/**
+ * @file MediaIdTest.cpp
+ * @brief Unit test cho MediaId: hash XXH64 ổn định giữa các bản build,
+ *        chuyển đổi qua lại với chuỗi "media_<số>"
+ */
+
+#include <gtest/gtest.h>
+#include "models/MediaId.h"
+
+#include <string>
+#include <unordered_set>
+
+using namespace media_player::models;
+
+// ============================================================================
+// Hash
+// ============================================================================
+
+TEST(MediaIdTest, MatchesReferenceXxh64)
+{
+    // Giá trị tham chiếu của XXH64 (seed 0): id không được đổi giữa các bản build
+    EXPECT_EQ(MediaId::fromPath("").value(), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(MediaId::fromPath("a").value(), 0xD24EC4F1A98C6E5BULL);
+    EXPECT_EQ(MediaId::fromPath("abc").value(), 0x44BC2CF5AD770999ULL);
+    // Dài hơn 32 byte: đi qua vòng lặp bốn làn
+    EXPECT_EQ(MediaId::fromPath("Nobody inspects the spammish repetition").value(), 0xFBCEA83C8A378BF1ULL);
+}
+
+TEST(MediaIdTest, DistinctPathsGetDistinctIds)
+{
+    std::unordered_set<MediaId> ids;
+    for (int i = 0; i < 100000; ++i)
+    {
+        ids.insert(MediaId::fromPath("/home/user/Music/Album/" + std::to_string(i) + ".mp3"));
+    }
+
+    EXPECT_EQ(ids.size(), 100000u);
+    EXPECT_EQ(MediaId::fromPath("/music/a.mp3"), MediaId::fromPath(std::string("/music/a.mp3")));
+    EXPECT_NE(MediaId::fromPath("/music/a.mp3"), MediaId::fromPath("/music/A.mp3"));
+}
+
+// ============================================================================
+// Dạng chuỗi
+// ============================================================================
+
+TEST(MediaIdTest, TextRoundTrips)
+{
+    MediaId id = MediaId::fromPath("/music/a.mp3");
+
+    EXPECT_EQ(id.toString(), "media_" + std::to_string(id.value()));
+    ASSERT_TRUE(MediaId::parse(id.toString()).has_value());
+    EXPECT_EQ(*MediaId::parse(id.toString()), id);
+    EXPECT_EQ(MediaId::parse("media_18446744073709551615")->value(), UINT64_MAX);
+}
+
+TEST(MediaIdTest, ParseRejectsMalformedText)
+{
+    EXPECT_FALSE(MediaId::parse(""));
+    EXPECT_FALSE(MediaId::parse("media_"));
+    EXPECT_FALSE(MediaId::parse("media_12x"));
+    EXPECT_FALSE(MediaId::parse("media_-1"));
+    EXPECT_FALSE(MediaId::parse("song1.mp3"));
+    // Vượt quá UINT64_MAX
+    EXPECT_FALSE(MediaId::parse("media_18446744073709551616"));
+    EXPECT_FALSE(MediaId::parse("media_123456789012345678901"));
+}
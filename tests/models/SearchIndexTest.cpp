@@ -0,0 +1,473 @@
+/**
+ * @file SearchIndexTest.cpp
+ * @brief Unit test cho SearchIndex — chỉ mục trigram dùng khi tìm kiếm
+ *
+ * Bao gồm: khớp theo trường (mask), không phân biệt hoa thường và dấu, truy vấn
+ * ngắn hơn một trigram, thu hẹp kết quả khi gõ thêm, cập nhật tăng dần
+ * (append/assign/erase/eraseSwap), một chuỗi thao tác ngẫu nhiên đối chiếu
+ * với phép quét tuyến tính, và các kernel tìm chuỗi con (TextSearch) cùng
+ * vùng văn bản liền khối (TextArena) mà chỉ mục dựa vào.
+ */
+
+#include <gtest/gtest.h>
+#include "models/SearchIndex.h"
+#include "models/Collation.h"
+#include "models/MediaFileModel.h"
+#include "utils/TextArena.h"
+#include "utils/TextSearch.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player::models;
+using media_player::utils::TextArena;
+using media_player::utils::TextSearch;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+
+MediaFileModel makeMedia(const std::string& path, const std::string& title, const std::string& artist = "",
+                         const std::string& album = "")
+{
+    MediaFileModel media(path, 1, fs::file_time_type());
+    media.setTitle(title);
+    media.setArtist(artist);
+    media.setAlbum(album);
+    return media;
+}
+
+std::string folded(const std::string& text)
+{
+    return Collation::fold(text);
+}
+
+// Lọc tuyến tính: gấp chữ từng trường rồi tìm chuỗi con
+std::vector<uint32_t> linearSearch(const std::vector<MediaFileModel>& list, const std::string& query,
+                                   SearchFieldMask fields)
+{
+    std::vector<uint32_t> positions;
+    std::string needle = folded(query);
+
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+        const MediaFileModel& media = list[i];
+        std::string title = media.getTitle().empty() ? std::string(media.getFileName()) : media.getTitle();
+        bool hit = ((fields & SearchField::TITLE) && folded(title).find(needle) != std::string::npos) ||
+                   ((fields & SearchField::ARTIST) && folded(media.getArtist()).find(needle) != std::string::npos) ||
+                   ((fields & SearchField::ALBUM) && folded(media.getAlbum()).find(needle) != std::string::npos) ||
+                   ((fields & SearchField::FILE_NAME) &&
+                    folded(std::string(media.getFileName())).find(needle) != std::string::npos);
+        if (hit)
+        {
+            positions.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    return positions;
+}
+
+std::vector<MediaFileModel> sampleLibrary()
+{
+    return {
+        makeMedia("/music/lac_troi.mp3", "Lạc Trôi", "Sơn Tùng M-TP", "m-tp M-TP"),
+        makeMedia("/music/hello.mp3", "Hello", "Adele", "25"),
+        makeMedia("/music/yesterday.flac", "Yesterday", "The Beatles", "Help!"),
+        makeMedia("/music/untitled_track.mp3", "", "Unknown", "Demos"),
+    };
+}
+
+// Các kernel CPU này chạy được, kernel đang dùng được trả lại khi hết phạm vi
+class KernelRestorer
+{
+public:
+    KernelRestorer()
+        : m_kernel(TextSearch::getKernel())
+    {
+    }
+
+    ~KernelRestorer()
+    {
+        TextSearch::setKernel(m_kernel);
+    }
+
+    static std::vector<TextSearch::Kernel> available()
+    {
+        std::vector<TextSearch::Kernel> kernels;
+        for (auto kernel : { TextSearch::Kernel::SCALAR, TextSearch::Kernel::SSE2, TextSearch::Kernel::AVX2 })
+        {
+            if (TextSearch::setKernel(kernel))
+            {
+                kernels.push_back(kernel);
+            }
+        }
+        return kernels;
+    }
+
+private:
+    TextSearch::Kernel m_kernel;
+};
+
+} // namespace
+
+// ============================================================================
+// Khớp theo trường
+// ============================================================================
+
+TEST(SearchIndexTest, FieldMasksSelectWhereToLook)
+{
+    SearchIndex index;
+    index.build(sampleLibrary());
+
+    EXPECT_EQ(index.search("hello", SearchField::TAGS).positions, std::vector<uint32_t>{ 1 });
+    EXPECT_EQ(index.search("adele", SearchField::TITLE).positions, std::vector<uint32_t>{});
+    EXPECT_EQ(index.search("adele", SearchField::ARTIST).positions, std::vector<uint32_t>{ 1 });
+    EXPECT_EQ(index.search("help", SearchField::ALBUM).positions, std::vector<uint32_t>{ 2 });
+    EXPECT_EQ(index.search("help", SearchField::TITLE | SearchField::ARTIST).positions, std::vector<uint32_t>{});
+    EXPECT_EQ(index.search(".flac", SearchField::FILE_NAME).positions, std::vector<uint32_t>{ 2 });
+    EXPECT_TRUE(index.search("hello", 0).positions.empty());
+}
+
+TEST(SearchIndexTest, MissingTitleFallsBackToFileName)
+{
+    SearchIndex index;
+    index.build(sampleLibrary());
+
+    EXPECT_EQ(index.search("untitled", SearchField::TITLE).positions, std::vector<uint32_t>{ 3 });
+}
+
+TEST(SearchIndexTest, IgnoresCaseAndAccents)
+{
+    SearchIndex index;
+    index.build(sampleLibrary());
+
+    EXPECT_EQ(index.search("BEATLES", SearchField::TAGS).positions, std::vector<uint32_t>{ 2 });
+    EXPECT_EQ(index.search("SƠN TÙNG", SearchField::ARTIST).positions, std::vector<uint32_t>{ 0 });
+    EXPECT_EQ(index.search("son tung", SearchField::ARTIST).positions, std::vector<uint32_t>{ 0 });
+    EXPECT_EQ(index.search("lac troi", SearchField::TITLE).positions, std::vector<uint32_t>{ 0 });
+    EXPECT_EQ(index.search("trôi", SearchField::TITLE).positions, std::vector<uint32_t>{ 0 });
+    EXPECT_EQ(SearchIndex::normalize("AbC-Đ"), "abc-d");
+}
+
+TEST(SearchIndexTest, FoldedFieldsKeepTheirBounds)
+{
+    SearchIndex index;
+    // Gấp chữ làm các trường ngắn lại; ranh giới trường phải tính sau khi gấp
+    index.build({ makeMedia("/music/a.mp3", "Ướt Ấm Ầm", "Đạt", "Ờ") });
+
+    EXPECT_EQ(index.search("uot am am", SearchField::TITLE).positions.size(), 1u);
+    EXPECT_EQ(index.search("dat", SearchField::ARTIST).positions.size(), 1u);
+    EXPECT_TRUE(index.search("dat", SearchField::TITLE).positions.empty());
+    EXPECT_EQ(index.search("o", SearchField::ALBUM).positions.size(), 1u);
+    EXPECT_TRUE(index.search("amd", SearchField::TAGS).positions.empty());
+}
+
+TEST(SearchIndexTest, FieldsDoNotRunIntoEachOther)
+{
+    SearchIndex index;
+    index.build({ makeMedia("/music/a.mp3", "abc", "def") });
+
+    // "cde" chỉ có nếu ghép title với artist
+    EXPECT_TRUE(index.search("cde", SearchField::TAGS).positions.empty());
+    EXPECT_EQ(index.search("c", SearchField::TAGS).positions.size(), 1u);
+}
+
+TEST(SearchIndexTest, ShortAndEmptyQueries)
+{
+    SearchIndex index;
+    index.build(sampleLibrary());
+
+    EXPECT_EQ(index.search("", SearchField::TAGS).positions, (std::vector<uint32_t>{ 0, 1, 2, 3 }));
+    EXPECT_EQ(index.search("y", SearchField::TITLE).positions, std::vector<uint32_t>{ 2 });
+    EXPECT_EQ(index.search("he", SearchField::TAGS).positions, (std::vector<uint32_t>{ 1, 2 }));
+}
+
+// ============================================================================
+// Thu hẹp khi gõ thêm
+// ============================================================================
+
+TEST(SearchIndexTest, TypingNarrowsThePreviousResult)
+{
+    SearchIndex index;
+    std::vector<MediaFileModel> list;
+    for (int i = 0; i < 300; ++i)
+    {
+        list.push_back(makeMedia("/music/" + std::to_string(i) + ".mp3", "Song " + std::to_string(i), "Artist"));
+    }
+    index.build(list);
+
+    SearchResult result = index.search("s", SearchField::TAGS);
+    for (const std::string query : { "so", "son", "song", "song ", "song 1", "song 12" })
+    {
+        result = index.search(query, SearchField::TAGS, &result);
+        EXPECT_EQ(result.positions, linearSearch(list, query, SearchField::TAGS)) << query;
+    }
+    EXPECT_EQ(result.positions.size(), 11u);
+
+    // Xóa bớt ký tự: không thu hẹp được, tìm lại từ chỉ mục
+    result = index.search("song 1", SearchField::TAGS, &result);
+    EXPECT_EQ(result.positions.size(), 111u);
+}
+
+TEST(SearchIndexTest, ResultOfAnotherVersionIsNotNarrowed)
+{
+    SearchIndex index;
+    index.build(sampleLibrary());
+
+    SearchResult result = index.search("hel", SearchField::TAGS);
+    index.append(makeMedia("/music/helium.mp3", "Helium", "Sia"));
+    EXPECT_NE(result.version, index.getVersion());
+
+    result = index.search("heli", SearchField::TAGS, &result);
+    EXPECT_EQ(result.positions, std::vector<uint32_t>{ 4 });
+}
+
+// ============================================================================
+// Cập nhật tăng dần
+// ============================================================================
+
+TEST(SearchIndexTest, AssignReplacesTheText)
+{
+    SearchIndex index;
+    index.build(sampleLibrary());
+
+    index.assign(1, makeMedia("/music/hello.mp3", "Someone Like You", "Adele"));
+
+    EXPECT_TRUE(index.search("hello", SearchField::TITLE).positions.empty());
+    EXPECT_EQ(index.search("someone", SearchField::TITLE).positions, std::vector<uint32_t>{ 1 });
+    EXPECT_EQ(index.search("adele", SearchField::ARTIST).positions, std::vector<uint32_t>{ 1 });
+}
+
+TEST(SearchIndexTest, EraseShiftsAndEraseSwapMovesLast)
+{
+    SearchIndex index;
+    index.build(sampleLibrary());
+
+    index.erase(0);
+    EXPECT_EQ(index.size(), 3u);
+    EXPECT_EQ(index.search("beatles", SearchField::ARTIST).positions, std::vector<uint32_t>{ 1 });
+    EXPECT_TRUE(index.search("sơn", SearchField::ARTIST).positions.empty());
+
+    // Mục cuối (untitled) dời vào chỗ của hello
+    index.eraseSwap(0);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.search("untitled", SearchField::TITLE).positions, std::vector<uint32_t>{ 0 });
+    EXPECT_EQ(index.search("beatles", SearchField::ARTIST).positions, std::vector<uint32_t>{ 1 });
+
+    // Vị trí của mục đã xóa được dùng lại cho mục mới
+    index.append(makeMedia("/music/new.mp3", "Hello Again"));
+    EXPECT_EQ(index.search("hello", SearchField::TITLE).positions, std::vector<uint32_t>{ 2 });
+}
+
+TEST(SearchIndexTest, EraseSeveralPositionsKeepsOrder)
+{
+    SearchIndex index;
+    std::vector<MediaFileModel> list;
+    for (int i = 0; i < 10; ++i)
+    {
+        list.push_back(makeMedia("/music/" + std::to_string(i) + ".mp3", "Track " + std::to_string(i)));
+    }
+    index.build(list);
+
+    index.erase(std::vector<uint32_t>{ 1, 2, 5, 9 });
+    EXPECT_EQ(index.size(), 6u);
+    EXPECT_EQ(index.search("track", SearchField::TITLE).positions, (std::vector<uint32_t>{ 0, 1, 2, 3, 4, 5 }));
+    EXPECT_EQ(index.search("track 6", SearchField::TITLE).positions, std::vector<uint32_t>{ 3 });
+}
+
+// ============================================================================
+// Ngẫu nhiên, đối chiếu với quét tuyến tính
+// ============================================================================
+
+TEST(SearchIndexTest, RandomEditsMatchLinearScan)
+{
+    static const char* WORDS[] = { "love", "song", "night", "blue", "tình", "yêu", "rock", "Hello", "LOVELY", "nights" };
+    std::mt19937 random(99);
+    auto phrase = [&]()
+    {
+        return std::string(WORDS[random() % 10]) + " " + WORDS[random() % 10];
+    };
+
+    SearchIndex index;
+    std::vector<MediaFileModel> list;
+
+    for (int step = 0; step < 6000; ++step)
+    {
+        int op = static_cast<int>(random() % 10);
+        MediaFileModel media = makeMedia("/music/" + std::to_string(step) + ".mp3", phrase(), phrase(), phrase());
+
+        if (op < 5 || list.empty())
+        {
+            index.append(media);
+            list.push_back(media);
+        }
+        else if (op < 7)
+        {
+            size_t position = random() % list.size();
+            index.assign(position, media);
+            list[position] = media;
+        }
+        else if (op < 8)
+        {
+            size_t position = random() % list.size();
+            index.erase(position);
+            list.erase(list.begin() + static_cast<std::ptrdiff_t>(position));
+        }
+        else
+        {
+            size_t position = random() % list.size();
+            index.eraseSwap(position);
+            list[position] = list.back();
+            list.pop_back();
+        }
+
+        if (step % 200 == 0)
+        {
+            for (const std::string query : { "love", "ly", "nights", "tình y", "o", "g b" })
+            {
+                for (SearchFieldMask fields : { SearchField::TAGS, SearchField::ARTIST, SearchField::FILE_NAME })
+                {
+                    ASSERT_EQ(index.search(query, fields).positions, linearSearch(list, query, fields))
+                        << "step " << step << " query " << query;
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Kernel tìm chuỗi con và TextArena
+// ============================================================================
+
+TEST(SearchIndexTest, KernelsFindAcrossBlockBoundaries)
+{
+    KernelRestorer restorer;
+    std::mt19937 random(7);
+
+    for (auto kernel : KernelRestorer::available())
+    {
+        ASSERT_TRUE(TextSearch::setKernel(kernel));
+
+        for (size_t needleLength : { 1, 2, 3, 5, 16, 17, 33, 40 })
+        {
+            std::string needle;
+            for (size_t i = 0; i < needleLength; ++i)
+            {
+                needle.push_back(static_cast<char>('a' + random() % 3));
+            }
+
+            // Kim ở mọi vị trí, kể cả vắt qua ranh giới khối 16/32 byte
+            for (size_t length = 0; length < 100; ++length)
+            {
+                std::string haystack;
+                for (size_t i = 0; i < length; ++i)
+                {
+                    haystack.push_back(static_cast<char>('a' + random() % 4));
+                }
+
+                for (size_t at = 0; at + needleLength <= length; at += 7)
+                {
+                    std::string text = haystack;
+                    text.replace(at, needleLength, needle);
+                    ASSERT_EQ(TextSearch::find(text, needle), text.find(needle))
+                        << TextSearch::getKernelName() << " length " << length << " at " << at;
+                }
+                ASSERT_EQ(TextSearch::find(haystack, needle), haystack.find(needle)) << TextSearch::getKernelName();
+            }
+        }
+
+        EXPECT_EQ(TextSearch::find("abc", ""), 0u);
+        EXPECT_EQ(TextSearch::find("", "a"), TextSearch::npos);
+        EXPECT_EQ(TextSearch::find("ab", "abc"), TextSearch::npos);
+    }
+}
+
+TEST(SearchIndexTest, EveryKernelMatchesLinearScan)
+{
+    static const char* WORDS[] = { "love", "song", "night", "blue", "tình", "yêu", "rock", "Hello", "LOVELY" };
+    KernelRestorer restorer;
+    std::mt19937 random(3);
+
+    SearchIndex index;
+    std::vector<MediaFileModel> list;
+    for (int i = 0; i < 500; ++i)
+    {
+        std::string title;
+        for (int w = 0; w < 1 + static_cast<int>(random() % 8); ++w)
+        {
+            title += std::string(WORDS[random() % 9]) + " ";
+        }
+        list.push_back(makeMedia("/music/" + std::to_string(i) + ".mp3", title, WORDS[random() % 9]));
+    }
+    index.build(list);
+
+    for (auto kernel : KernelRestorer::available())
+    {
+        ASSERT_TRUE(TextSearch::setKernel(kernel));
+
+        for (const std::string query : { "o", "ly", "love", "night blue", "ELY l", "tình", "zz" })
+        {
+            for (SearchFieldMask fields : { SearchField::TAGS, SearchField::ARTIST, SearchField::FILE_NAME })
+            {
+                ASSERT_EQ(index.search(query, fields).positions, linearSearch(list, query, fields))
+                    << TextSearch::getKernelName() << " query " << query;
+            }
+        }
+    }
+}
+
+TEST(SearchIndexTest, ArenaScanSkipsReplacedText)
+{
+    TextArena arena;
+    uint32_t a = arena.add("red blue");
+    uint32_t b = arena.add("green");
+    uint32_t c = arena.add("blueberry blue");
+
+    arena.assign(b, "light blue");
+    arena.remove(a);
+
+    std::vector<std::pair<uint32_t, size_t>> hits;
+    arena.scan("blue", [&](uint32_t id, size_t offset)
+    {
+        hits.emplace_back(id, offset);
+        return false;
+    });
+
+    // Bản cũ của a và b không còn được tính; b mới nằm sau c trong vùng nhớ
+    std::vector<std::pair<uint32_t, size_t>> expected = { { c, 0 }, { c, 10 }, { b, 6 } };
+    EXPECT_EQ(hits, expected);
+    EXPECT_EQ(arena.size(), 2u);
+    EXPECT_EQ(arena.get(b), "light blue");
+
+    // Kim không vắt qua ranh giới bản ghi
+    bool crossed = false;
+    arena.scan(std::string_view("blue\0light", 10), [&](uint32_t, size_t) { return crossed = true; });
+    arena.scan("bluelight", [&](uint32_t, size_t) { return crossed = true; });
+    EXPECT_FALSE(crossed);
+
+    // Id được dùng lại, văn bản vẫn đúng sau khi dồn vùng nhớ
+    EXPECT_EQ(arena.add("blue moon"), a);
+    for (int i = 0; i < 20000; ++i)
+    {
+        arena.assign(b, "light blue " + std::to_string(i));
+    }
+    EXPECT_EQ(arena.get(a), "blue moon");
+    EXPECT_EQ(arena.get(b), "light blue 19999");
+    EXPECT_EQ(arena.get(c), "blueberry blue");
+
+    std::vector<uint32_t> ids;
+    arena.scan("blue", [&](uint32_t id, size_t)
+    {
+        ids.push_back(id);
+        return true;
+    });
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids, (std::vector<uint32_t>{ a, b, c }));
+}
@@ -0,0 +1,233 @@
+/**
+ * @file SortIndexTest.cpp
+ * @brief Unit test cho SortIndex — thứ tự sắp xếp được giữ theo từng tiêu chí
+ *
+ * Bao gồm: sắp xếp theo từng SortCriteria, thứ tự chỉ được dựng khi cần,
+ * gộp bản ghi mới (append), sửa (assign), xóa (erase) và một chuỗi thao tác
+ * ngẫu nhiên đối chiếu với việc sắp xếp lại từ đầu.
+ */
+
+#include <gtest/gtest.h>
+#include "models/SortIndex.h"
+#include "models/Collation.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player::models;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+
+MediaFileModel makeMedia(const std::string& path, const std::string& title, const std::string& artist = "",
+                         int duration = 0)
+{
+    MediaFileModel media(path, 1, fs::file_time_type());
+    media.setTitle(title);
+    media.setArtist(artist);
+    media.setDuration(duration);
+    return media;
+}
+
+std::vector<std::string> titlesOf(const std::vector<MediaFileModel>& list, const SortOrder& order)
+{
+    std::vector<std::string> titles;
+    for (uint32_t position : *order)
+    {
+        titles.push_back(list[position].getTitle());
+    }
+    return titles;
+}
+
+// Sắp xếp lại từ đầu, bằng nhau thì giữ thứ tự trong danh sách
+std::vector<uint32_t> sortedByTitle(const std::vector<MediaFileModel>& list)
+{
+    std::vector<uint32_t> positions(list.size());
+    std::iota(positions.begin(), positions.end(), 0u);
+    std::stable_sort(positions.begin(), positions.end(), [&](uint32_t a, uint32_t b)
+    {
+        return Collation::key(list[a].getTitle()) < Collation::key(list[b].getTitle());
+    });
+    return positions;
+}
+
+std::vector<MediaFileModel> sampleLibrary()
+{
+    return {
+        makeMedia("/music/3.mp3", "Đêm Trăng", "Hà Anh Tuấn", 240),
+        makeMedia("/music/1.mp3", "Bống Bống Bang Bang", "365", 200),
+        makeMedia("/music/2.mp3", "Anh Ơi", "Đen", 180),
+        makeMedia("/music/4.mp3", "Zombie", "Anh Tú", 300),
+    };
+}
+
+} // namespace
+
+// ============================================================================
+// Tiêu chí
+// ============================================================================
+
+TEST(SortIndexTest, OrdersByEachCriteria)
+{
+    SortIndex index;
+    std::vector<MediaFileModel> list = sampleLibrary();
+    index.build(list);
+
+    EXPECT_EQ(titlesOf(list, index.getOrder(SortCriteria::TITLE, list)),
+              (std::vector<std::string>{ "Anh Ơi", "Bống Bống Bang Bang", "Đêm Trăng", "Zombie" }));
+    EXPECT_EQ(titlesOf(list, index.getOrder(SortCriteria::ARTIST, list)),
+              (std::vector<std::string>{ "Bống Bống Bang Bang", "Zombie", "Anh Ơi", "Đêm Trăng" }));
+    EXPECT_EQ(*index.getOrder(SortCriteria::DURATION, list), (std::vector<uint32_t>{ 2, 1, 0, 3 }));
+    EXPECT_EQ(*index.getOrder(SortCriteria::FILE_NAME, list), (std::vector<uint32_t>{ 1, 2, 0, 3 }));
+    EXPECT_EQ(*index.getOrder(SortCriteria::DATE_ADDED, list), (std::vector<uint32_t>{ 0, 1, 2, 3 }));
+}
+
+TEST(SortIndexTest, EqualKeysKeepListOrder)
+{
+    SortIndex index;
+    std::vector<MediaFileModel> list = {
+        makeMedia("/music/a.mp3", "Same", "B"),
+        makeMedia("/music/b.mp3", "Other", "A"),
+        makeMedia("/music/c.mp3", "Same", "A"),
+    };
+
+    EXPECT_EQ(*index.getOrder(SortCriteria::TITLE, list), (std::vector<uint32_t>{ 1, 0, 2 }));
+}
+
+TEST(SortIndexTest, OrdersAreOnlyRebuiltWhenTheyChange)
+{
+    SortIndex index;
+    std::vector<MediaFileModel> list = sampleLibrary();
+    index.build(list);
+
+    SortOrder title = index.getOrder(SortCriteria::TITLE, list);
+    SortOrder artist = index.getOrder(SortCriteria::ARTIST, list);
+    EXPECT_EQ(index.getOrder(SortCriteria::TITLE, list), title);
+
+    // Chỉ đổi nghệ sĩ: thứ tự theo tên bài vẫn là vector cũ
+    list[0].setArtist("Adele");
+    index.assign(list, 0);
+    EXPECT_EQ(index.getOrder(SortCriteria::TITLE, list), title);
+    EXPECT_NE(index.getOrder(SortCriteria::ARTIST, list), artist);
+    EXPECT_EQ(*index.getOrder(SortCriteria::ARTIST, list), (std::vector<uint32_t>{ 1, 0, 3, 2 }));
+
+    // Người giữ thứ tự cũ vẫn thấy nguyên như trước
+    EXPECT_EQ(artist->back(), 0u);
+}
+
+// ============================================================================
+// Cập nhật tăng dần
+// ============================================================================
+
+TEST(SortIndexTest, AppendMergesNewRecords)
+{
+    SortIndex index;
+    std::vector<MediaFileModel> list = sampleLibrary();
+    index.getOrder(SortCriteria::TITLE, list);
+
+    list.push_back(makeMedia("/music/5.mp3", "Chạy Ngay Đi"));
+    list.push_back(makeMedia("/music/6.mp3", "Ánh Nắng"));
+    index.append(list, 4);
+
+    // Chữ cái quyết định trước dấu thanh: "Ánh N" trước "Anh Ơ"
+    EXPECT_EQ(titlesOf(list, index.getOrder(SortCriteria::TITLE, list)),
+              (std::vector<std::string>{ "Ánh Nắng", "Anh Ơi", "Bống Bống Bang Bang", "Chạy Ngay Đi", "Đêm Trăng",
+                                         "Zombie" }));
+    EXPECT_EQ(index.getOrder(SortCriteria::DATE_ADDED, list)->size(), 6u);
+}
+
+TEST(SortIndexTest, EraseDropsAndRenumbers)
+{
+    SortIndex index;
+    std::vector<MediaFileModel> list = sampleLibrary();
+    index.getOrder(SortCriteria::TITLE, list);
+    index.getOrder(SortCriteria::DATE_ADDED, list);
+
+    // Xóa "Bống Bống Bang Bang" (1) và "Zombie" (3)
+    list.erase(list.begin() + 3);
+    list.erase(list.begin() + 1);
+    index.erase(list, { 1, 3 });
+
+    EXPECT_EQ(*index.getOrder(SortCriteria::TITLE, list), (std::vector<uint32_t>{ 1, 0 }));
+    EXPECT_EQ(*index.getOrder(SortCriteria::DATE_ADDED, list), (std::vector<uint32_t>{ 0, 1 }));
+}
+
+TEST(SortIndexTest, ClearForgetsEveryOrder)
+{
+    SortIndex index;
+    std::vector<MediaFileModel> list = sampleLibrary();
+    index.getOrder(SortCriteria::TITLE, list);
+
+    index.clear();
+    std::vector<MediaFileModel> other = { makeMedia("/music/x.mp3", "X") };
+    EXPECT_EQ(*index.getOrder(SortCriteria::TITLE, other), std::vector<uint32_t>{ 0 });
+}
+
+// ============================================================================
+// Ngẫu nhiên, đối chiếu với sắp xếp lại
+// ============================================================================
+
+TEST(SortIndexTest, RandomEditsMatchAFullSort)
+{
+    static const char* WORDS[] = { "Anh", "Ánh", "anh", "Em", "Đi", "Dì", "Track 2", "Track 10", "ơi", "Ôi" };
+    std::mt19937 random(7);
+
+    SortIndex index;
+    std::vector<MediaFileModel> list;
+    index.getOrder(SortCriteria::TITLE, list);
+
+    for (int step = 0; step < 3000; ++step)
+    {
+        int op = static_cast<int>(random() % 10);
+        MediaFileModel media = makeMedia("/music/" + std::to_string(step) + ".mp3",
+                                         std::string(WORDS[random() % 10]) + " " + WORDS[random() % 10]);
+
+        if (op < 5 || list.empty())
+        {
+            size_t first = list.size();
+            size_t count = 1 + random() % 4;
+            for (size_t i = 0; i < count; ++i)
+            {
+                list.push_back(media);
+            }
+            index.append(list, first);
+        }
+        else if (op < 8)
+        {
+            size_t position = random() % list.size();
+            list[position] = media;
+            index.assign(list, position);
+        }
+        else
+        {
+            std::vector<uint32_t> erased;
+            for (uint32_t p = 0; p < list.size(); ++p)
+            {
+                if (random() % 8 == 0)
+                {
+                    erased.push_back(p);
+                }
+            }
+            for (auto it = erased.rbegin(); it != erased.rend(); ++it)
+            {
+                list.erase(list.begin() + *it);
+            }
+            index.erase(list, erased);
+        }
+
+        if (step % 100 == 0)
+        {
+            ASSERT_EQ(*index.getOrder(SortCriteria::TITLE, list), sortedByTitle(list)) << "step " << step;
+        }
+    }
+}
@@ -4,7 +4,7 @@
  *
  * Bao gồm: addEntry, remove, getRecentHistory, getAllHistory, setHistory,
  * clear, count, wasRecentlyPlayed, getLastPlayed, getPreviousPlayed,
- * getPlayedBefore, serialize/deserialize round-trip, edge cases.
+ * getPlayedBefore, serialize/deserialize round-trip, ghi nền, edge cases.
  */
 
 #include <gtest/gtest.h>
@@ -15,6 +15,7 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <memory>
 
 namespace fs = std::filesystem;
 using namespace media_player::repositories;
@@ -535,3 +536,30 @@ TEST_F(HistoryRepositoryTest, SerializationPreservesMetadata)
     EXPECT_EQ(history[0].media.getTitle(), "My Song Title");
     EXPECT_EQ(history[0].media.getArtist(), "My Artist");
 }
+
+// ============================================================================
+// Background Persistence
+// ============================================================================
+
+TEST_F(HistoryRepositoryTest, EntriesAreWrittenInBackground)
+{
+    auto persistence = std::make_shared<PersistenceService>(std::chrono::hours(1), std::chrono::hours(1));
+    std::string historyFile = m_storagePath + "/history.dat";
+    {
+        HistoryRepository repo(m_storagePath, 100, persistence);
+        repo.addEntry(makeMedia(1));
+        repo.addEntry(makeMedia(2));
+        repo.addEntry(makeMedia(3));
+
+        // addEntry không đụng tới đĩa; destructor flush phần còn chờ
+        EXPECT_FALSE(fs::exists(historyFile));
+        EXPECT_EQ(persistence->getPendingCount(), 1u);
+    }
+
+    EXPECT_TRUE(fs::exists(historyFile));
+    EXPECT_FALSE(fs::exists(historyFile + ".tmp"));
+    EXPECT_EQ(persistence->getWriteCount(), 1u);
+
+    HistoryRepository repo2(m_storagePath, 100, persistence);
+    EXPECT_EQ(repo2.count(), 3);
+}
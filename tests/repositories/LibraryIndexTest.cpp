@@ -0,0 +1,282 @@
+/**
+ * @file LibraryIndexTest.cpp
+ * @brief Unit tests cho LibraryIndex — bảng băm địa chỉ mở của thư viện
+ *
+ * Bao gồm: put/find/replace, xóa dời mục cuối vào chỗ trống, eraseUnder,
+ * chỉ mục phụ theo loại/nghệ sĩ/album, tổng kích thước, và một chuỗi thao tác
+ * ngẫu nhiên đối chiếu với std::map.
+ */
+
+#include <gtest/gtest.h>
+#include "repositories/LibraryIndex.h"
+#include "models/MediaFileModel.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <random>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace media_player::repositories;
+using namespace media_player::models;
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+namespace
+{
+
+MediaFileModel makeMedia(const std::string& path, size_t size, const std::string& artist = "",
+                         const std::string& album = "")
+{
+    MediaFileModel media(path, size, fs::file_time_type(fs::file_time_type::duration(42)));
+    media.setArtist(artist);
+    media.setAlbum(album);
+    return media;
+}
+
+std::vector<std::string> pathsOf(const LibraryIndex& index, const std::vector<uint32_t>& positions)
+{
+    std::vector<std::string> paths;
+    for (uint32_t position : positions)
+    {
+        paths.push_back(index.at(position).getFilePath());
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+} // namespace
+
+// ============================================================================
+// Put / Find
+// ============================================================================
+
+TEST(LibraryIndexTest, PutFindAndReplace)
+{
+    LibraryIndex index;
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.find("/music/a.mp3"), LibraryIndex::npos);
+
+    auto first = index.put(makeMedia("/music/a.mp3", 10));
+    auto second = index.put(makeMedia("/music/b.wav", 20));
+    EXPECT_TRUE(first.second);
+    EXPECT_TRUE(second.second);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.find("/music/a.mp3"), first.first);
+    EXPECT_EQ(index.find(MediaId::fromPath("/music/b.wav")), second.first);
+
+    // Cùng đường dẫn: thay thế tại chỗ, tổng kích thước cập nhật theo
+    auto replaced = index.put(makeMedia("/music/a.mp3", 15));
+    EXPECT_FALSE(replaced.second);
+    EXPECT_EQ(replaced.first, first.first);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.at(replaced.first).getFileSize(), 15u);
+    EXPECT_EQ(index.getTotalSize(), 35u);
+}
+
+TEST(LibraryIndexTest, GrowsPastInitialCapacity)
+{
+    LibraryIndex index;
+    for (int i = 0; i < 5000; ++i)
+    {
+        index.put(makeMedia("/music/track_" + std::to_string(i) + ".mp3", 1));
+    }
+
+    EXPECT_EQ(index.size(), 5000u);
+    EXPECT_EQ(index.getTotalSize(), 5000u);
+    for (int i = 0; i < 5000; ++i)
+    {
+        size_t position = index.find("/music/track_" + std::to_string(i) + ".mp3");
+        ASSERT_NE(position, LibraryIndex::npos);
+        EXPECT_EQ(index.at(position).getFilePath(), "/music/track_" + std::to_string(i) + ".mp3");
+    }
+}
+
+TEST(LibraryIndexTest, PathsSharingAnIdKeepSeparateEntries)
+{
+    LibraryIndex index;
+    const MediaId shared(42);
+
+    // Ép hai đường dẫn khác nhau vào cùng một id để giả lập va chạm
+    auto first = index.put(shared, makeMedia("/music/a.mp3", 1));
+    auto second = index.put(shared, makeMedia("/music/b.mp3", 2));
+    EXPECT_TRUE(second.second);
+    EXPECT_NE(first.first, second.first);
+    EXPECT_EQ(index.find(shared, "/music/a.mp3"), first.first);
+    EXPECT_EQ(index.find(shared, "/music/b.mp3"), second.first);
+    EXPECT_EQ(index.find(shared, "/music/c.mp3"), LibraryIndex::npos);
+
+    // Tra theo id trả về mục đầu tiên
+    EXPECT_EQ(index.find(shared), first.first);
+
+    // Thay thế chỉ đụng đúng đường dẫn
+    index.put(shared, makeMedia("/music/b.mp3", 5));
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.getTotalSize(), 6u);
+
+    // Xóa mục đầu: mục còn lại vẫn tìm thấy, kể cả qua id
+    index.eraseAt(index.find(shared, "/music/a.mp3"));
+    ASSERT_EQ(index.size(), 1u);
+    EXPECT_EQ(index.find(shared), index.find(shared, "/music/b.mp3"));
+    EXPECT_EQ(index.at(index.find(shared)).getFileSize(), 5u);
+}
+
+// ============================================================================
+// Erase
+// ============================================================================
+
+TEST(LibraryIndexTest, EraseMovesLastEntryIntoHole)
+{
+    LibraryIndex index;
+    index.put(makeMedia("/music/a.mp3", 1, "X"));
+    index.put(makeMedia("/music/b.mp3", 2, "Y"));
+    index.put(makeMedia("/music/c.mp3", 4, "X"));
+
+    EXPECT_TRUE(index.erase("/music/a.mp3"));
+    EXPECT_FALSE(index.erase("/music/a.mp3"));
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_EQ(index.find("/music/a.mp3"), LibraryIndex::npos);
+
+    // Mục cuối được dời lên: bảng băm và chỉ mục phụ trỏ đúng vị trí mới
+    size_t moved = index.find("/music/c.mp3");
+    ASSERT_NE(moved, LibraryIndex::npos);
+    EXPECT_EQ(index.at(moved).getFilePath(), "/music/c.mp3");
+    EXPECT_EQ(pathsOf(index, index.findByArtist("X")), std::vector<std::string>{ "/music/c.mp3" });
+    EXPECT_EQ(index.getTotalSize(), 6u);
+}
+
+TEST(LibraryIndexTest, EraseUnderRemovesPrefixOnly)
+{
+    LibraryIndex index;
+    index.put(makeMedia("/music/rock/a.mp3", 1));
+    index.put(makeMedia("/music/rock/b.mp3", 1));
+    index.put(makeMedia("/music/rockabilly/c.mp3", 1));
+    index.put(makeMedia("/music/pop/d.mp3", 1));
+
+    EXPECT_EQ(index.eraseUnder("/music/rock/"), 2u);
+    EXPECT_EQ(index.size(), 2u);
+    EXPECT_NE(index.find("/music/rockabilly/c.mp3"), LibraryIndex::npos);
+    EXPECT_NE(index.find("/music/pop/d.mp3"), LibraryIndex::npos);
+}
+
+TEST(LibraryIndexTest, ClearResetsIndexesAndAggregates)
+{
+    LibraryIndex index;
+    index.put(makeMedia("/music/a.mp3", 10, "X", "Y"));
+    index.clear();
+
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_EQ(index.getTotalSize(), 0u);
+    EXPECT_EQ(index.countByType(MediaType::AUDIO), 0u);
+    EXPECT_TRUE(index.findByArtist("X").empty());
+
+    index.put(makeMedia("/music/a.mp3", 10));
+    EXPECT_NE(index.find("/music/a.mp3"), LibraryIndex::npos);
+}
+
+// ============================================================================
+// Secondary indexes
+// ============================================================================
+
+TEST(LibraryIndexTest, SecondaryIndexesFollowRetagging)
+{
+    LibraryIndex index;
+    index.put(makeMedia("/music/a.mp3", 1, "Sơn Tùng", "Sky Decade"));
+    index.put(makeMedia("/music/b.mp3", 1, "Sơn Tùng", "m-tp"));
+    index.put(makeMedia("/music/c.flac", 1, "Đen", "m-tp"));
+
+    EXPECT_EQ(index.countByType(MediaType::AUDIO), 2u);
+    EXPECT_EQ(index.countByType(MediaType::UNSUPPORTED), 1u);
+    EXPECT_EQ(pathsOf(index, index.findByType(MediaType::UNSUPPORTED)), std::vector<std::string>{ "/music/c.flac" });
+    EXPECT_EQ(index.findByArtist("Sơn Tùng").size(), 2u);
+    EXPECT_EQ(index.findByAlbum("m-tp").size(), 2u);
+    EXPECT_TRUE(index.findByArtist("Unknown").empty());
+
+    // Đổi tag: mục chuyển sang danh sách mới, danh sách rỗng biến mất
+    size_t position = index.find("/music/a.mp3");
+    index.assign(position, makeMedia("/music/a.mp3", 1, "Đen", "m-tp"));
+
+    EXPECT_EQ(pathsOf(index, index.findByArtist("Sơn Tùng")), std::vector<std::string>{ "/music/b.mp3" });
+    EXPECT_EQ(index.findByArtist("Đen").size(), 2u);
+    EXPECT_TRUE(index.findByAlbum("Sky Decade").empty());
+    EXPECT_EQ(index.findByAlbum("m-tp").size(), 3u);
+}
+
+// ============================================================================
+// Randomized against std::map
+// ============================================================================
+
+TEST(LibraryIndexTest, RandomOperationsMatchReferenceMap)
+{
+    LibraryIndex index;
+    std::map<std::string, MediaFileModel> reference;
+    std::mt19937 random(1234);
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        std::string dir = "/music/d" + std::to_string(random() % 8) + "/";
+        std::string path = dir + "t" + std::to_string(random() % 400) + (random() % 4 == 0 ? ".flac" : ".mp3");
+        int op = static_cast<int>(random() % 10);
+
+        if (op < 6)
+        {
+            MediaFileModel media = makeMedia(path, random() % 1000, "A" + std::to_string(random() % 5),
+                                             "B" + std::to_string(random() % 7));
+            index.put(media);
+            reference.insert_or_assign(path, media);
+        }
+        else if (op < 9)
+        {
+            EXPECT_EQ(index.erase(path), reference.erase(path) == 1);
+        }
+        else if (step % 50 == 0)
+        {
+            size_t erased = index.eraseUnder(dir);
+            size_t expected = 0;
+            for (auto it = reference.begin(); it != reference.end(); )
+            {
+                if (it->first.compare(0, dir.size(), dir) == 0)
+                {
+                    it = reference.erase(it);
+                    expected++;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            EXPECT_EQ(erased, expected);
+        }
+    }
+
+    ASSERT_EQ(index.size(), reference.size());
+
+    uint64_t totalSize = 0;
+    size_t audio = 0;
+    std::map<std::string, size_t> byArtist;
+    for (const auto& pair : reference)
+    {
+        size_t position = index.find(pair.first);
+        ASSERT_NE(position, LibraryIndex::npos);
+        EXPECT_EQ(index.at(position).getFileSize(), pair.second.getFileSize());
+        totalSize += pair.second.getFileSize();
+        audio += pair.second.getType() == MediaType::AUDIO;
+        byArtist[pair.second.getArtist()]++;
+    }
+
+    EXPECT_EQ(index.getTotalSize(), totalSize);
+    EXPECT_EQ(index.countByType(MediaType::AUDIO), audio);
+    EXPECT_EQ(index.countByType(MediaType::UNSUPPORTED), reference.size() - audio);
+    for (const auto& pair : byArtist)
+    {
+        const auto& positions = index.findByArtist(pair.first);
+        EXPECT_EQ(positions.size(), pair.second);
+        for (uint32_t position : positions)
+        {
+            EXPECT_EQ(index.at(position).getArtist(), pair.first);
+        }
+    }
+}
@@ -0,0 +1,209 @@
+/**
+ * @file LibraryJournalTest.cpp
+ * @brief Unit tests cho LibraryJournal — write-ahead log của thư viện
+ *
+ * Bao gồm: encode/append/replay theo thứ tự, đuôi bị cắt do crash,
+ * byte rác sau record cuối, header lạ, truncate, rotate, discard.
+ */
+
+#include <gtest/gtest.h>
+#include "repositories/LibraryJournal.h"
+#include "models/MediaFileModel.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player::repositories;
+using namespace media_player::models;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class LibraryJournalTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir = fs::temp_directory_path() / "MediaPlayerTest_LibraryJournal";
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+        fs::create_directories(m_testDir);
+        m_journalPath = (m_testDir / "library.journal").string();
+    }
+
+    void TearDown() override
+    {
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+    }
+
+    MediaFileModel makeMedia(const std::string& name, const std::string& title)
+    {
+        MediaFileModel media((m_testDir / name).string(), 42,
+                             fs::file_time_type(fs::file_time_type::duration(987654321)));
+        media.setTitle(title);
+        media.setAlbum("Album");
+        media.setDuration(200);
+        return media;
+    }
+
+    std::vector<LibraryJournalEntry> replayAll(uint64_t* validBytes = nullptr)
+    {
+        std::vector<LibraryJournalEntry> entries;
+        uint64_t valid = LibraryJournal::replay(m_journalPath, [&entries](const LibraryJournalEntry& entry)
+        {
+            entries.push_back(entry);
+        });
+        if (validBytes)
+        {
+            *validBytes = valid;
+        }
+        return entries;
+    }
+
+    fs::path m_testDir;
+    std::string m_journalPath;
+};
+
+// ============================================================================
+// Append / Replay
+// ============================================================================
+
+TEST_F(LibraryJournalTest, ReplayReturnsRecordsInOrder)
+{
+    {
+        LibraryJournal journal(m_journalPath);
+        std::string records;
+        LibraryJournal::encodePut(records, makeMedia("a.mp3", "Tiêu đề"));
+        LibraryJournal::encodeRemove(records, (m_testDir / "b.mp3").string());
+        ASSERT_TRUE(journal.append(records));
+
+        records.clear();
+        LibraryJournal::encodeRemoveUnder(records, (m_testDir / "old/").string());
+        LibraryJournal::encodeClear(records);
+        ASSERT_TRUE(journal.append(records));
+        EXPECT_EQ(journal.size(), fs::file_size(m_journalPath));
+    }
+
+    uint64_t valid = 0;
+    auto entries = replayAll(&valid);
+    EXPECT_EQ(valid, fs::file_size(m_journalPath));
+    ASSERT_EQ(entries.size(), 4u);
+
+    EXPECT_EQ(entries[0].op, LibraryJournalOp::PUT);
+    EXPECT_EQ(entries[0].media.getTitle(), "Tiêu đề");
+    EXPECT_EQ(entries[0].media.getAlbum(), "Album");
+    EXPECT_EQ(entries[0].media.getFileSize(), 42u);
+    EXPECT_EQ(entries[0].media.getDuration(), 200);
+    EXPECT_EQ(entries[0].media.getLastModified().time_since_epoch().count(), 987654321);
+
+    EXPECT_EQ(entries[1].op, LibraryJournalOp::REMOVE);
+    EXPECT_EQ(entries[1].path, (m_testDir / "b.mp3").string());
+    EXPECT_EQ(entries[2].op, LibraryJournalOp::REMOVE_UNDER);
+    EXPECT_EQ(entries[3].op, LibraryJournalOp::CLEAR);
+}
+
+TEST_F(LibraryJournalTest, MissingFileReplaysNothing)
+{
+    EXPECT_TRUE(replayAll().empty());
+    EXPECT_EQ(LibraryJournal(m_journalPath).size(), 0u);
+}
+
+// ============================================================================
+// Crash recovery
+// ============================================================================
+
+TEST_F(LibraryJournalTest, TornTailIsDroppedAndTruncated)
+{
+    LibraryJournal journal(m_journalPath);
+    std::string records;
+    LibraryJournal::encodePut(records, makeMedia("a.mp3", "A"));
+    ASSERT_TRUE(journal.append(records));
+    uint64_t intact = journal.size();
+
+    // Record thứ hai chỉ ghi được một nửa
+    records.clear();
+    LibraryJournal::encodePut(records, makeMedia("b.mp3", "B"));
+    journal.close();
+    {
+        std::ofstream file(m_journalPath, std::ios::binary | std::ios::app);
+        file.write(records.data(), records.size() / 2);
+    }
+
+    uint64_t valid = 0;
+    auto entries = replayAll(&valid);
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(valid, intact);
+
+    // Sau truncate, record mới nối tiếp đúng chỗ và replay được
+    ASSERT_TRUE(journal.truncate(valid));
+    EXPECT_EQ(fs::file_size(m_journalPath), intact);
+    records.clear();
+    LibraryJournal::encodeRemove(records, (m_testDir / "a.mp3").string());
+    ASSERT_TRUE(journal.append(records));
+    EXPECT_EQ(replayAll().size(), 2u);
+}
+
+TEST_F(LibraryJournalTest, CorruptRecordStopsReplay)
+{
+    {
+        LibraryJournal journal(m_journalPath);
+        std::string records;
+        LibraryJournal::encodePut(records, makeMedia("a.mp3", "A"));
+        LibraryJournal::encodePut(records, makeMedia("b.mp3", "B"));
+        ASSERT_TRUE(journal.append(records));
+    }
+
+    // Lật một byte trong payload của record cuối
+    uintmax_t size = fs::file_size(m_journalPath);
+    {
+        std::fstream file(m_journalPath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(size - 2));
+        file.put('#');
+    }
+
+    auto entries = replayAll();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].media.getTitle(), "A");
+}
+
+TEST_F(LibraryJournalTest, ForeignHeaderReplaysNothing)
+{
+    std::ofstream(m_journalPath) << "not a journal at all";
+
+    uint64_t valid = 1;
+    EXPECT_TRUE(replayAll(&valid).empty());
+    EXPECT_EQ(valid, 0u);
+}
+
+// ============================================================================
+// Rotate / Discard
+// ============================================================================
+
+TEST_F(LibraryJournalTest, RotateStartsNewJournal)
+{
+    LibraryJournal journal(m_journalPath);
+    std::string records;
+    LibraryJournal::encodeClear(records);
+    ASSERT_TRUE(journal.append(records));
+
+    std::string rotated = m_journalPath + ".compacting";
+    ASSERT_TRUE(journal.rotateTo(rotated));
+    EXPECT_EQ(journal.size(), 0u);
+    EXPECT_TRUE(fs::exists(rotated));
+    EXPECT_FALSE(fs::exists(m_journalPath));
+
+    ASSERT_TRUE(journal.append(records));
+    EXPECT_EQ(replayAll().size(), 1u);
+
+    journal.discard();
+    EXPECT_FALSE(fs::exists(m_journalPath));
+    EXPECT_EQ(journal.size(), 0u);
+}
@@ -4,15 +4,23 @@
  *
  * Bao gồm: save, findById, findAll, update, remove, exists,
  * saveAll, clear, count, findByPath, findByType, searchByFileName,
- * countByType, getTotalSize, serialize/deserialize round-trip.
+ * countByType, getTotalSize, findByArtist/findByAlbum, serialize/deserialize round-trip,
+ * journal replay, replaceAll, compaction, getSnapshot.
  */
 
 #include <gtest/gtest.h>
 #include "repositories/LibraryRepository.h"
+#include "repositories/LibraryJournal.h"
 #include "models/MediaFileModel.h"
+#include "models/MediaId.h"
+#include "services/DirectoryReader.h"
+#include "services/MediaValidator.h"
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <thread>
 
 namespace fs = std::filesystem;
 using namespace media_player::repositories;
@@ -62,9 +70,13 @@ protected:
     }
 
     /// Tạo MediaFileModel từ dummy file
+    // Bản ghi có size/mtime thật, như khi quét
     MediaFileModel makeMedia(const std::string& name)
     {
-        return MediaFileModel((m_testDir / name).string());
+        std::string path = (m_testDir / name).string();
+        media_player::services::FileStat stat;
+        media_player::services::DirectoryReader::statFile(path, stat);
+        return MediaFileModel(path, stat.size, stat.lastModified);
     }
 
     fs::path m_testDir;
@@ -185,6 +197,31 @@ TEST_F(LibraryRepositoryTest, RemoveNonExisting)
     EXPECT_FALSE(repo.remove("nonexistent_id"));
 }
 
+TEST_F(LibraryRepositoryTest, RemoveByPath)
+{
+    LibraryRepository repo(m_storagePath);
+    repo.save(makeMedia("song1.mp3"));
+    repo.save(makeMedia("song2.mp3"));
+
+    EXPECT_TRUE(repo.removeByPath((m_testDir / "song1.mp3").string()));
+    EXPECT_FALSE(repo.removeByPath((m_testDir / "song1.mp3").string()));
+    EXPECT_EQ(repo.count(), 1);
+}
+
+TEST_F(LibraryRepositoryTest, RemoveUnderPath)
+{
+    fs::create_directories(m_testDir / "album");
+    createDummyFile(m_testDir / "album" / "track.mp3");
+
+    LibraryRepository repo(m_storagePath);
+    repo.save(makeMedia("song1.mp3"));
+    repo.save(MediaFileModel((m_testDir / "album" / "track.mp3").string()));
+
+    EXPECT_EQ(repo.removeUnderPath((m_testDir / "album").string()), 1u);
+    EXPECT_EQ(repo.count(), 1);
+    EXPECT_EQ(repo.removeUnderPath((m_testDir / "album").string()), 0u);
+}
+
 // ============================================================================
 // exists
 // ============================================================================
@@ -357,6 +394,62 @@ TEST_F(LibraryRepositoryTest, GetTotalSizeEmpty)
     EXPECT_EQ(repo.getTotalSize(), 0);
 }
 
+TEST_F(LibraryRepositoryTest, StatisticsFollowEveryMutation)
+{
+    LibraryRepository repo(m_storagePath);
+    repo.saveAll({ makeMedia("song1.mp3"), makeMedia("song2.mp3"), makeMedia("song3.wav") });
+
+    // "content_a" + "content_ab" + "content_abc"
+    EXPECT_EQ(repo.getTotalSize(), 30);
+    EXPECT_EQ(repo.countByType(MediaType::AUDIO), 3u);
+
+    repo.removeByPath((m_testDir / "song2.mp3").string());
+    EXPECT_EQ(repo.getTotalSize(), 20);
+    EXPECT_EQ(repo.countByType(MediaType::AUDIO), 2u);
+
+    repo.replaceAll({ makeMedia("song1.mp3") });
+    EXPECT_EQ(repo.getTotalSize(), 9);
+    EXPECT_EQ(repo.findByType(MediaType::AUDIO).size(), 1u);
+
+    repo.clear();
+    EXPECT_EQ(repo.getTotalSize(), 0);
+    EXPECT_EQ(repo.countByType(MediaType::AUDIO), 0u);
+}
+
+TEST_F(LibraryRepositoryTest, FindByArtistAndAlbum)
+{
+    LibraryRepository repo(m_storagePath);
+    MediaFileModel song1 = makeMedia("song1.mp3");
+    song1.setArtist("Mỹ Tâm");
+    song1.setAlbum("Tâm");
+    MediaFileModel song2 = makeMedia("song2.mp3");
+    song2.setArtist("Mỹ Tâm");
+    song2.setAlbum("Ước Gì");
+    repo.saveAll({ song1, song2, makeMedia("song3.wav") });
+
+    EXPECT_EQ(repo.findByArtist("Mỹ Tâm").size(), 2u);
+    ASSERT_EQ(repo.findByAlbum("Tâm").size(), 1u);
+    EXPECT_EQ(repo.findByAlbum("Tâm")[0].getFilePath(), song1.getFilePath());
+    EXPECT_TRUE(repo.findByArtist("Unknown").empty());
+
+    song2.setArtist("Hà Anh Tuấn");
+    repo.update(song2);
+    EXPECT_EQ(repo.findByArtist("Mỹ Tâm").size(), 1u);
+    EXPECT_EQ(repo.findByArtist("Hà Anh Tuấn").size(), 1u);
+}
+
+TEST_F(LibraryRepositoryTest, MalformedIdsAreNotFound)
+{
+    LibraryRepository repo(m_storagePath);
+    repo.save(makeMedia("song1.mp3"));
+
+    EXPECT_FALSE(repo.exists("media_"));
+    EXPECT_FALSE(repo.exists("media_12x"));
+    EXPECT_FALSE(repo.exists("song1.mp3"));
+    EXPECT_FALSE(repo.remove("media_abc"));
+    EXPECT_EQ(repo.count(), 1);
+}
+
 // ============================================================================
 // Serialize / Deserialize Round-Trip
 // ============================================================================
@@ -385,12 +478,285 @@ TEST_F(LibraryRepositoryTest, SaveToDiskExplicit)
     EXPECT_TRUE(fs::exists(m_storagePath + "/library.dat"));
 }
 
+TEST_F(LibraryRepositoryTest, SaveAndLoadKeepsMetadata)
+{
+    MediaFileModel media = makeMedia("song1.mp3");
+    media.setTitle("Hà Nội mùa thu");
+    media.setArtist("Artist | with pipe");
+    media.setAlbum("Album");
+    media.setDuration(245);
+    {
+        LibraryRepository repo(m_storagePath);
+        repo.save(media);
+    }
+
+    // Snapshot mang theo size, mtime và tag: không cần stat lại file
+    fs::remove(m_testDir / "song1.mp3");
+    LibraryRepository repo2(m_storagePath);
+    auto loaded = repo2.findByPath(media.getFilePath());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->getTitle(), "Hà Nội mùa thu");
+    EXPECT_EQ(loaded->getArtist(), "Artist | with pipe");
+    EXPECT_EQ(loaded->getAlbum(), "Album");
+    EXPECT_EQ(loaded->getDuration(), 245);
+    EXPECT_EQ(loaded->getFileSize(), media.getFileSize());
+    EXPECT_EQ(loaded->getLastModified(), media.getLastModified());
+    EXPECT_EQ(loaded->getType(), MediaType::AUDIO);
+}
+
+TEST_F(LibraryRepositoryTest, LoadsLegacyTextLibrary)
+{
+    fs::create_directories(m_storagePath);
+    {
+        std::ofstream file(m_storagePath + "/library.dat");
+        file << "LIBRARY_VERSION:1.0\nCOUNT:2\nENTRIES:\n";
+        file << (m_testDir / "song1.mp3").string() << "|song1.mp3|.mp3|0|9\n";
+        file << (m_testDir / "missing.mp3").string() << "|missing.mp3|.mp3|0|9\n";
+    }
+
+    // Định dạng cũ: nạp không stat từng mục; file mất được validator báo sau
+    LibraryRepository repo(m_storagePath);
+    EXPECT_EQ(repo.count(), 2);
+    EXPECT_EQ(repo.getTotalSize(), 18);
+    auto song = repo.findByPath((m_testDir / "song1.mp3").string());
+    ASSERT_TRUE(song.has_value());
+    EXPECT_EQ(song->getFileSize(), 9u);
+
+    std::vector<std::string> paths;
+    for (const auto& media : *repo.getSnapshot())
+    {
+        paths.push_back(media.getFilePath());
+    }
+    media_player::services::MediaValidator validator;
+    EXPECT_EQ(validator.findMissing(paths), std::vector<std::string>{ (m_testDir / "missing.mp3").string() });
+
+    // Lần lưu kế tiếp chuyển sang snapshot nhị phân
+    EXPECT_TRUE(repo.saveToDisk());
+    LibraryRepository repo2(m_storagePath);
+    EXPECT_EQ(repo2.count(), 2);
+    EXPECT_EQ(repo2.getTotalSize(), 18);
+}
+
 TEST_F(LibraryRepositoryTest, LoadFromEmptyStorage)
 {
     LibraryRepository repo(m_storagePath);
     EXPECT_EQ(repo.count(), 0);
 }
 
+// ============================================================================
+// Journal & Compaction
+// ============================================================================
+
+TEST_F(LibraryRepositoryTest, MutationsSurviveRestartThroughJournal)
+{
+    {
+        LibraryRepository repo(m_storagePath);
+        repo.save(makeMedia("song1.mp3"));
+        repo.save(makeMedia("song2.mp3"));
+        repo.save(makeMedia("song3.wav"));
+        repo.removeByPath((m_testDir / "song2.mp3").string());
+    }
+
+    // Không có snapshot: mọi thay đổi nằm trong journal
+    EXPECT_FALSE(fs::exists(m_storagePath + "/library.dat"));
+    EXPECT_TRUE(fs::exists(m_storagePath + "/library.journal"));
+
+    LibraryRepository repo2(m_storagePath);
+    EXPECT_EQ(repo2.count(), 2);
+    EXPECT_FALSE(repo2.findByPath((m_testDir / "song2.mp3").string()).has_value());
+}
+
+TEST_F(LibraryRepositoryTest, UnchangedEntriesAreNotJournaled)
+{
+    LibraryRepository repo(m_storagePath);
+    repo.save(makeMedia("song1.mp3"));
+    repo.save(makeMedia("song2.mp3"));
+    ASSERT_TRUE(repo.flush());
+    uint64_t size = repo.getJournalSize();
+    EXPECT_GT(size, 0u);
+
+    repo.save(makeMedia("song1.mp3"));
+    repo.saveAll({ makeMedia("song1.mp3"), makeMedia("song2.mp3") });
+    repo.update(makeMedia("song2.mp3"));
+    ASSERT_TRUE(repo.flush());
+    EXPECT_EQ(repo.getJournalSize(), size);
+}
+
+TEST_F(LibraryRepositoryTest, ReplaceAllJournalsOnlyTheDifference)
+{
+    {
+        LibraryRepository repo(m_storagePath);
+        repo.saveAll({ makeMedia("song1.mp3"), makeMedia("song2.mp3"), makeMedia("song3.wav") });
+        ASSERT_TRUE(repo.saveToDisk());
+        EXPECT_EQ(repo.getJournalSize(), 0u);
+
+        MediaFileModel retagged = makeMedia("song2.mp3");
+        retagged.setTitle("Retagged");
+        repo.replaceAll({ makeMedia("song1.mp3"), retagged });
+        ASSERT_TRUE(repo.flush());
+
+        // Một PUT và một REMOVE, không ghi lại cả thư viện
+        EXPECT_EQ(repo.count(), 2);
+        EXPECT_GT(repo.getJournalSize(), 0u);
+        EXPECT_LT(repo.getJournalSize(), 512u);
+    }
+
+    LibraryRepository repo2(m_storagePath);
+    EXPECT_EQ(repo2.count(), 2);
+    EXPECT_FALSE(repo2.findByPath((m_testDir / "song3.wav").string()).has_value());
+    auto loaded = repo2.findByPath((m_testDir / "song2.mp3").string());
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->getTitle(), "Retagged");
+}
+
+TEST_F(LibraryRepositoryTest, ShutdownDoesNotRewriteSnapshot)
+{
+    {
+        LibraryRepository repo(m_storagePath);
+        repo.save(makeMedia("song1.mp3"));
+        ASSERT_TRUE(repo.saveToDisk());
+    }
+    auto snapshotTime = fs::last_write_time(m_storagePath + "/library.dat");
+    auto snapshotSize = fs::file_size(m_storagePath + "/library.dat");
+    {
+        LibraryRepository repo(m_storagePath);
+        repo.save(makeMedia("song2.mp3"));
+        repo.clear();
+        repo.save(makeMedia("song3.wav"));
+    }
+
+    EXPECT_EQ(fs::last_write_time(m_storagePath + "/library.dat"), snapshotTime);
+    EXPECT_EQ(fs::file_size(m_storagePath + "/library.dat"), snapshotSize);
+
+    LibraryRepository repo(m_storagePath);
+    EXPECT_EQ(repo.count(), 1);
+    EXPECT_TRUE(repo.findByPath((m_testDir / "song3.wav").string()).has_value());
+}
+
+TEST_F(LibraryRepositoryTest, BackgroundCompactionFoldsJournal)
+{
+    LibraryRepository repo(m_storagePath);
+    repo.setCompactThreshold(1);
+    repo.save(makeMedia("song1.mp3"));
+    repo.save(makeMedia("song2.mp3"));
+    repo.removeUnderPath((m_testDir / "nothing_here").string());
+    ASSERT_TRUE(repo.flush());
+
+    for (int i = 0; i < 200 && repo.getCompactionCount() == 0; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_GT(repo.getCompactionCount(), 0u);
+
+    // Dồn tay phần còn lại rồi nạp lại chỉ từ snapshot
+    ASSERT_TRUE(repo.compact());
+    EXPECT_TRUE(fs::exists(m_storagePath + "/library.dat"));
+    EXPECT_FALSE(fs::exists(m_storagePath + "/library.journal"));
+    EXPECT_FALSE(fs::exists(m_storagePath + "/library.journal.compacting"));
+
+    LibraryRepository repo2(m_storagePath);
+    EXPECT_EQ(repo2.count(), 2);
+}
+
+TEST_F(LibraryRepositoryTest, InterruptedCompactionIsRecovered)
+{
+    {
+        LibraryRepository repo(m_storagePath);
+        repo.save(makeMedia("song1.mp3"));
+        repo.save(makeMedia("song2.mp3"));
+    }
+
+    // Giả lập tắt máy giữa chừng: journal đã được đổi tên nhưng chưa dồn vào snapshot
+    fs::rename(m_storagePath + "/library.journal", m_storagePath + "/library.journal.compacting");
+    {
+        LibraryJournal journal(m_storagePath + "/library.journal");
+        std::string records;
+        LibraryJournal::encodeRemove(records, (m_testDir / "song1.mp3").string());
+        ASSERT_TRUE(journal.append(records));
+    }
+
+    LibraryRepository repo(m_storagePath);
+    EXPECT_EQ(repo.count(), 1);
+    EXPECT_TRUE(repo.findByPath((m_testDir / "song2.mp3").string()).has_value());
+
+    ASSERT_TRUE(repo.compact());
+    EXPECT_FALSE(fs::exists(m_storagePath + "/library.journal.compacting"));
+    ASSERT_TRUE(repo.compact());
+
+    LibraryRepository repo2(m_storagePath);
+    EXPECT_EQ(repo2.count(), 1);
+}
+
+TEST_F(LibraryRepositoryTest, CompactionLeavesUnreadableSnapshotAlone)
+{
+    {
+        LibraryRepository repo(m_storagePath);
+        repo.save(makeMedia("song1.mp3"));
+        repo.save(makeMedia("song2.mp3"));
+        ASSERT_TRUE(repo.saveToDisk());
+    }
+
+    // Snapshot của một phiên bản mới hơn: sửa trường version ngay sau magic
+    std::string snapshotPath = m_storagePath + "/library.dat";
+    auto patchVersion = [&](uint32_t delta)
+    {
+        std::fstream file(snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t version = 0;
+        file.seekg(8);
+        file.read(reinterpret_cast<char*>(&version), sizeof(version));
+        version += delta;
+        file.seekp(8);
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    };
+    patchVersion(1);
+    auto snapshotSize = fs::file_size(snapshotPath);
+    {
+        LibraryRepository repo(m_storagePath);
+        EXPECT_EQ(repo.count(), 0);
+        repo.setCompactThreshold(1);
+        repo.save(makeMedia("song3.wav"));
+        ASSERT_TRUE(repo.flush());
+
+        // Không dồn journal lên snapshot không đọc được
+        EXPECT_FALSE(repo.compact());
+        EXPECT_EQ(repo.getCompactionCount(), 0u);
+    }
+    EXPECT_EQ(fs::file_size(snapshotPath), snapshotSize);
+    EXPECT_TRUE(fs::exists(m_storagePath + "/library.journal"));
+
+    // Khi snapshot đọc được trở lại thì không mất gì
+    patchVersion(static_cast<uint32_t>(-1));
+    LibraryRepository repo(m_storagePath);
+    EXPECT_EQ(repo.count(), 3);
+}
+
+TEST_F(LibraryRepositoryTest, MutationsAreQueuedUntilFlushed)
+{
+    auto persistence = std::make_shared<PersistenceService>(std::chrono::hours(1), std::chrono::hours(1));
+    {
+        LibraryRepository repo(m_storagePath, persistence);
+        repo.save(makeMedia("song1.mp3"));
+        repo.save(makeMedia("song2.mp3"));
+        repo.removeByPath((m_testDir / "song1.mp3").string());
+
+        // Chưa có I/O trên luồng gọi; cả loạt thay đổi là một lần append
+        EXPECT_FALSE(fs::exists(m_storagePath + "/library.journal"));
+        EXPECT_EQ(repo.getJournalSize(), 0u);
+        EXPECT_EQ(persistence->getPendingCount(), 1u);
+
+        ASSERT_TRUE(repo.flush());
+        EXPECT_GT(repo.getJournalSize(), 0u);
+        EXPECT_EQ(persistence->getWriteCount(), 1u);
+
+        // Bản ghi còn chờ được ghi khi repository bị hủy
+        repo.save(makeMedia("song3.wav"));
+    }
+
+    LibraryRepository repo2(m_storagePath, persistence);
+    EXPECT_EQ(repo2.count(), 2);
+    EXPECT_FALSE(repo2.findByPath((m_testDir / "song1.mp3").string()).has_value());
+}
+
 // ============================================================================
 // findById — using generated ID
 // ============================================================================
@@ -401,15 +767,30 @@ TEST_F(LibraryRepositoryTest, FindByIdFound)
     auto media = makeMedia("song1.mp3");
     repo.save(media);
 
-    // Sử dụng cùng thuật toán hash để tạo ID
-    std::hash<std::string> hasher;
-    std::string id = "media_" + std::to_string(hasher(media.getFilePath()));
+    // ID là MediaId của đường dẫn ở dạng chuỗi
+    std::string id = MediaId::fromPath(media.getFilePath()).toString();
 
     auto found = repo.findById(id);
     ASSERT_TRUE(found.has_value());
     EXPECT_EQ(found->getFilePath(), media.getFilePath());
 }
 
+TEST_F(LibraryRepositoryTest, LookupsByMediaIdSkipTheText)
+{
+    LibraryRepository repo(m_storagePath);
+    auto media = makeMedia("song1.mp3");
+    repo.save(media);
+
+    MediaId id = MediaId::fromPath(media.getFilePath());
+    ASSERT_TRUE(repo.findById(id).has_value());
+    EXPECT_EQ(repo.findById(id)->getFilePath(), media.getFilePath());
+    EXPECT_TRUE(repo.exists(id));
+    EXPECT_FALSE(repo.exists(MediaId::fromPath("/nowhere.mp3")));
+
+    EXPECT_TRUE(repo.remove(id));
+    EXPECT_FALSE(repo.exists(id));
+}
+
 TEST_F(LibraryRepositoryTest, FindByIdNotFound)
 {
     LibraryRepository repo(m_storagePath);
@@ -427,8 +808,7 @@ TEST_F(LibraryRepositoryTest, RemoveExistingById)
     auto media = makeMedia("song1.mp3");
     repo.save(media);
 
-    std::hash<std::string> hasher;
-    std::string id = "media_" + std::to_string(hasher(media.getFilePath()));
+    std::string id = MediaId::fromPath(media.getFilePath()).toString();
 
     EXPECT_TRUE(repo.remove(id));
     EXPECT_EQ(repo.count(), 0);
@@ -444,8 +824,7 @@ TEST_F(LibraryRepositoryTest, ExistsByIdTrue)
     auto media = makeMedia("song1.mp3");
     repo.save(media);
 
-    std::hash<std::string> hasher;
-    std::string id = "media_" + std::to_string(hasher(media.getFilePath()));
+    std::string id = MediaId::fromPath(media.getFilePath()).toString();
 
     EXPECT_TRUE(repo.exists(id));
 }
@@ -478,3 +857,35 @@ TEST_F(LibraryRepositoryTest, CountByTypeMatchesFindByType)
     auto found = repo.findByType(MediaType::AUDIO);
     EXPECT_EQ(count, found.size());
 }
+
+// ============================================================================
+// Snapshot
+// ============================================================================
+
+TEST_F(LibraryRepositoryTest, SnapshotIsSharedUntilNextChange)
+{
+    LibraryRepository repo(m_storagePath);
+    repo.save(makeMedia("song1.mp3"));
+
+    MediaSnapshot first = repo.getSnapshot();
+    ASSERT_EQ(first->size(), 1u);
+    // Không có thay đổi: cùng một danh sách, không sao chép lại
+    EXPECT_EQ(repo.getSnapshot().get(), first.get());
+
+    // Lưu lại mục không đổi cũng không tạo snapshot mới
+    repo.saveAll({ makeMedia("song1.mp3") });
+    EXPECT_EQ(repo.getSnapshot().get(), first.get());
+
+    repo.save(makeMedia("song2.mp3"));
+    MediaSnapshot second = repo.getSnapshot();
+    EXPECT_NE(second.get(), first.get());
+    EXPECT_EQ(second->size(), 2u);
+
+    // Người giữ snapshot cũ vẫn thấy phiên bản cũ
+    EXPECT_EQ(first->size(), 1u);
+
+    repo.removeByPath((m_testDir / "song1.mp3").string());
+    EXPECT_EQ(repo.getSnapshot()->size(), 1u);
+    EXPECT_EQ(repo.findAll().size(), 1u);
+    EXPECT_EQ(second->size(), 2u);
+}
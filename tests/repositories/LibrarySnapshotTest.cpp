@@ -0,0 +1,151 @@
+/**
+ * @file LibrarySnapshotTest.cpp
+ * @brief Unit tests cho LibrarySnapshot — định dạng nhị phân của library.dat
+ *
+ * Bao gồm: write/open round-trip, đọc tại chỗ qua mmap, file rỗng,
+ * file text cũ, header sai version, bảng record bị cắt cụt.
+ */
+
+#include <gtest/gtest.h>
+#include "repositories/LibrarySnapshot.h"
+#include "models/MediaFileModel.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using namespace media_player::repositories;
+using namespace media_player::models;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class LibrarySnapshotTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir = fs::temp_directory_path() / "MediaPlayerTest_LibrarySnapshot";
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+        fs::create_directories(m_testDir);
+        m_snapshotPath = (m_testDir / "library.dat").string();
+    }
+
+    void TearDown() override
+    {
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+    }
+
+    /// MediaFileModel không cần file thật (size/mtime truyền vào)
+    MediaFileModel makeMedia(const std::string& name, size_t size, const std::string& title)
+    {
+        MediaFileModel media((m_testDir / name).string(), size,
+                             fs::file_time_type(fs::file_time_type::duration(123456789)));
+        media.setTitle(title);
+        media.setArtist("Artist");
+        media.setDuration(static_cast<int>(size));
+        return media;
+    }
+
+    bool writeSnapshot(const std::vector<MediaFileModel>& media)
+    {
+        std::vector<const MediaFileModel*> pointers;
+        for (const auto& item : media)
+        {
+            pointers.push_back(&item);
+        }
+        return LibrarySnapshot::write(m_snapshotPath, pointers);
+    }
+
+    fs::path m_testDir;
+    std::string m_snapshotPath;
+};
+
+// ============================================================================
+// Round-trip
+// ============================================================================
+
+TEST_F(LibrarySnapshotTest, WriteAndOpenRoundTrip)
+{
+    ASSERT_TRUE(writeSnapshot({ makeMedia("a.mp3", 10, "Alpha"), makeMedia("b.wav", 20, "") }));
+    EXPECT_TRUE(LibrarySnapshot::isSnapshotFile(m_snapshotPath));
+    EXPECT_FALSE(fs::exists(m_snapshotPath + ".tmp"));
+
+    LibrarySnapshot snapshot;
+    ASSERT_TRUE(snapshot.open(m_snapshotPath));
+    ASSERT_EQ(snapshot.size(), 2u);
+    EXPECT_EQ(snapshot.path(0), (m_testDir / "a.mp3").string());
+
+    MediaFileModel first = snapshot.toMedia(0);
+    EXPECT_EQ(first.getTitle(), "Alpha");
+    EXPECT_EQ(first.getArtist(), "Artist");
+    EXPECT_EQ(first.getFileSize(), 10u);
+    EXPECT_EQ(first.getDuration(), 10);
+    EXPECT_EQ(first.getLastModified().time_since_epoch().count(), 123456789);
+    EXPECT_EQ(first.getType(), MediaType::AUDIO);
+
+    MediaFileModel second = snapshot.toMedia(1);
+    EXPECT_EQ(second.getTitle(), "");
+    EXPECT_EQ(second.getType(), MediaType::AUDIO);
+    EXPECT_EQ(snapshot.record(1).type, static_cast<uint8_t>(MediaType::AUDIO));
+}
+
+TEST_F(LibrarySnapshotTest, EmptyLibrary)
+{
+    ASSERT_TRUE(writeSnapshot({}));
+
+    LibrarySnapshot snapshot;
+    ASSERT_TRUE(snapshot.open(m_snapshotPath));
+    EXPECT_EQ(snapshot.size(), 0u);
+}
+
+// ============================================================================
+// File không hợp lệ
+// ============================================================================
+
+TEST_F(LibrarySnapshotTest, RejectsLegacyTextFile)
+{
+    std::ofstream(m_snapshotPath) << "LIBRARY_VERSION:1.0\nCOUNT:0\nENTRIES:\n";
+
+    LibrarySnapshot snapshot;
+    EXPECT_FALSE(LibrarySnapshot::isSnapshotFile(m_snapshotPath));
+    EXPECT_FALSE(snapshot.open(m_snapshotPath));
+    EXPECT_FALSE(snapshot.isOpen());
+}
+
+TEST_F(LibrarySnapshotTest, RejectsMissingFile)
+{
+    LibrarySnapshot snapshot;
+    EXPECT_FALSE(snapshot.open(m_snapshotPath));
+    EXPECT_FALSE(LibrarySnapshot::isSnapshotFile(m_snapshotPath));
+}
+
+TEST_F(LibrarySnapshotTest, RejectsOtherVersion)
+{
+    ASSERT_TRUE(writeSnapshot({ makeMedia("a.mp3", 10, "Alpha") }));
+    {
+        std::fstream file(m_snapshotPath, std::ios::in | std::ios::out | std::ios::binary);
+        uint32_t version = LibrarySnapshot::VERSION + 1;
+        file.seekp(offsetof(LibrarySnapshotHeader, version));
+        file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+
+    LibrarySnapshot snapshot;
+    EXPECT_FALSE(snapshot.open(m_snapshotPath));
+}
+
+TEST_F(LibrarySnapshotTest, RejectsTruncatedRecordTable)
+{
+    ASSERT_TRUE(writeSnapshot({ makeMedia("a.mp3", 10, "Alpha"), makeMedia("b.mp3", 20, "Beta") }));
+    fs::resize_file(m_snapshotPath, sizeof(LibrarySnapshotHeader) + sizeof(LibrarySnapshotRecord));
+
+    LibrarySnapshot snapshot;
+    EXPECT_FALSE(snapshot.open(m_snapshotPath));
+}
@@ -0,0 +1,229 @@
+/**
+ * @file PersistenceServiceTest.cpp
+ * @brief Unit tests cho PersistenceService — luồng ghi nền dùng chung của các repository
+ *
+ * Bao gồm: gộp một loạt thay đổi thành một lần ghi, giới hạn độ trễ tối đa,
+ * flush theo key và flush toàn bộ, writer của cùng key không chạy song song,
+ * destructor chạy phần còn chờ, ghi file nguyên tử.
+ */
+
+#include <gtest/gtest.h>
+#include "repositories/PersistenceService.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace media_player::repositories;
+using namespace std::chrono_literals;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class PersistenceServiceTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir = fs::temp_directory_path() / "MediaPlayerTest_Persistence";
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+        fs::create_directories(m_testDir);
+    }
+
+    void TearDown() override
+    {
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+    }
+
+    /// Chờ tối đa timeout cho tới khi service đã ghi ít nhất count lần
+    static bool waitForWrites(const PersistenceService& service, size_t count, std::chrono::milliseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (service.getWriteCount() < count && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(5ms);
+        }
+        return service.getWriteCount() >= count;
+    }
+
+    static std::string readFile(const fs::path& path)
+    {
+        std::ifstream file(path);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    fs::path m_testDir;
+};
+
+// ============================================================================
+// Coalescing
+// ============================================================================
+
+TEST_F(PersistenceServiceTest, BurstIsCoalescedIntoOneWrite)
+{
+    PersistenceService service(50ms, 10s);
+    std::atomic<int> written{ -1 };
+
+    for (int i = 0; i < 200; ++i)
+    {
+        service.markDirty("playlist", [&written, i]() { written = i; return true; });
+    }
+    EXPECT_EQ(service.getPendingCount(), 1u);
+
+    ASSERT_TRUE(waitForWrites(service, 1, 5s));
+    std::this_thread::sleep_for(100ms);
+
+    // Chỉ writer cuối cùng chạy, và chỉ một lần
+    EXPECT_EQ(service.getWriteCount(), 1u);
+    EXPECT_EQ(written, 199);
+    EXPECT_EQ(service.getPendingCount(), 0u);
+}
+
+TEST_F(PersistenceServiceTest, MaxDelayBoundsDebouncing)
+{
+    // Đánh dấu liên tục nhanh hơn độ trễ gộp: vẫn phải ghi trước khi loạt kết thúc
+    PersistenceService service(100ms, 150ms);
+    auto end = std::chrono::steady_clock::now() + 600ms;
+
+    while (std::chrono::steady_clock::now() < end)
+    {
+        service.markDirty("history", []() { return true; });
+        std::this_thread::sleep_for(10ms);
+    }
+
+    EXPECT_GE(service.getWriteCount(), 1u);
+}
+
+TEST_F(PersistenceServiceTest, KeysAreWrittenIndependently)
+{
+    PersistenceService service(1h, 1h);
+    std::atomic<int> writes{ 0 };
+
+    service.markDirty("a", [&writes]() { writes++; return true; });
+    service.markDirty("b", [&writes]() { writes++; return true; });
+    EXPECT_EQ(service.getPendingCount(), 2u);
+
+    ASSERT_TRUE(service.flush("a"));
+    EXPECT_EQ(writes, 1);
+    EXPECT_EQ(service.getPendingCount(), 1u);
+}
+
+// ============================================================================
+// Flush
+// ============================================================================
+
+TEST_F(PersistenceServiceTest, FlushRunsPendingWriterOnCaller)
+{
+    PersistenceService service(1h, 1h);
+    std::thread::id writerThread;
+
+    service.markDirty("library", [&writerThread]() { writerThread = std::this_thread::get_id(); return true; });
+    EXPECT_EQ(service.getWriteCount(), 0u);
+
+    EXPECT_TRUE(service.flush("library"));
+    EXPECT_EQ(writerThread, std::this_thread::get_id());
+    EXPECT_EQ(service.getWriteCount(), 1u);
+
+    // Không còn gì chờ: flush không chạy lại writer
+    EXPECT_TRUE(service.flush("library"));
+    EXPECT_TRUE(service.flush("unknown"));
+    EXPECT_EQ(service.getWriteCount(), 1u);
+}
+
+TEST_F(PersistenceServiceTest, FlushReportsFailedWriter)
+{
+    PersistenceService service(1h, 1h);
+    service.markDirty("ok", []() { return true; });
+    service.markDirty("fails", []() { return false; });
+    service.markDirty("throws", []() -> bool { throw std::runtime_error("disk full"); });
+
+    EXPECT_FALSE(service.flush());
+    EXPECT_EQ(service.getWriteCount(), 3u);
+    EXPECT_EQ(service.getPendingCount(), 0u);
+}
+
+TEST_F(PersistenceServiceTest, DestructorRunsPendingWriters)
+{
+    bool written = false;
+    {
+        PersistenceService service(1h, 1h);
+        service.markDirty("history", [&written]() { written = true; return true; });
+    }
+    EXPECT_TRUE(written);
+}
+
+TEST_F(PersistenceServiceTest, WritersOfOneKeyNeverOverlap)
+{
+    PersistenceService service(0ms, 0ms);
+    std::atomic<int> active{ 0 };
+    std::atomic<bool> overlapped{ false };
+
+    auto writer = [&active, &overlapped]()
+    {
+        if (++active > 1)
+        {
+            overlapped = true;
+        }
+        std::this_thread::sleep_for(2ms);
+        --active;
+        return true;
+    };
+
+    // Luồng nền và các lời gọi flush tranh nhau cùng một key
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&service, &writer]()
+        {
+            for (int i = 0; i < 25; ++i)
+            {
+                service.markDirty("playlist", writer);
+                service.flush("playlist");
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_TRUE(service.flush());
+    EXPECT_FALSE(overlapped);
+    EXPECT_GT(service.getWriteCount(), 0u);
+}
+
+// ============================================================================
+// writeFileAtomically
+// ============================================================================
+
+TEST_F(PersistenceServiceTest, WriteFileAtomicallyReplacesContents)
+{
+    fs::path path = m_testDir / "history.dat";
+    std::ofstream(path) << "old contents that are longer";
+
+    ASSERT_TRUE(PersistenceService::writeFileAtomically(path.string(), "new"));
+    EXPECT_EQ(readFile(path), "new");
+    EXPECT_FALSE(fs::exists(path.string() + ".tmp"));
+}
+
+TEST_F(PersistenceServiceTest, WriteFileAtomicallyFailsForMissingDirectory)
+{
+    fs::path path = m_testDir / "missing" / "history.dat";
+
+    EXPECT_FALSE(PersistenceService::writeFileAtomically(path.string(), "data"));
+    EXPECT_FALSE(fs::exists(path));
+}
@@ -4,7 +4,7 @@
  *
  * Bao gồm: save, findById, findAll, update, remove, exists,
  * saveAll, clear, count, findByName, searchByName,
- * serialize/deserialize round-trip, edge cases.
+ * serialize/deserialize round-trip, ghi nền qua PersistenceService, edge cases.
  */
 
 #include <gtest/gtest.h>
@@ -12,8 +12,10 @@
 #include "models/PlaylistModel.h"
 #include "models/MediaFileModel.h"
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 
 namespace fs = std::filesystem;
 using namespace media_player::repositories;
@@ -427,3 +429,50 @@ TEST_F(PlaylistRepositoryTest, SaveOverwriteExisting)
     ASSERT_TRUE(found.has_value());
     EXPECT_EQ(found->getName(), "Version 2");
 }
+
+// ============================================================================
+// Background Persistence
+// ============================================================================
+
+TEST_F(PlaylistRepositoryTest, EditsAreCoalescedIntoOneBackgroundWrite)
+{
+    // Độ trễ rất dài: chỉ flush mới ghi, nên kiểm tra được không có I/O tức thì
+    auto persistence = std::make_shared<PersistenceService>(std::chrono::hours(1), std::chrono::hours(1));
+    std::string filePath = m_storagePath + "/pl_burst.playlist";
+    {
+        PlaylistRepository repo(m_storagePath, persistence);
+        for (int i = 0; i < 200; ++i)
+        {
+            repo.save(makePlaylist("Edit " + std::to_string(i), "pl_burst"));
+        }
+
+        EXPECT_FALSE(fs::exists(filePath));
+        EXPECT_EQ(persistence->getPendingCount(), 1u);
+
+        ASSERT_TRUE(persistence->flush());
+        EXPECT_TRUE(fs::exists(filePath));
+        EXPECT_EQ(persistence->getWriteCount(), 1u);
+    }
+
+    PlaylistRepository repo2(m_storagePath, persistence);
+    auto found = repo2.findById("pl_burst");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->getName(), "Edit 199");
+}
+
+TEST_F(PlaylistRepositoryTest, RemoveDeletesFileInBackground)
+{
+    auto persistence = std::make_shared<PersistenceService>(std::chrono::hours(1), std::chrono::hours(1));
+    PlaylistRepository repo(m_storagePath, persistence);
+    repo.save(makePlaylist("Keep", "pl_keep"));
+    repo.save(makePlaylist("Drop", "pl_drop"));
+    ASSERT_TRUE(repo.saveToDisk());
+    ASSERT_TRUE(fs::exists(m_storagePath + "/pl_drop.playlist"));
+
+    repo.remove("pl_drop");
+    EXPECT_TRUE(fs::exists(m_storagePath + "/pl_drop.playlist"));
+
+    ASSERT_TRUE(persistence->flush());
+    EXPECT_FALSE(fs::exists(m_storagePath + "/pl_drop.playlist"));
+    EXPECT_TRUE(fs::exists(m_storagePath + "/pl_keep.playlist"));
+}
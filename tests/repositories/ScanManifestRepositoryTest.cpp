@@ -0,0 +1,235 @@
+/**
+ * @file ScanManifestRepositoryTest.cpp
+ * @brief Unit tests cho ScanManifestRepository — manifest (path, size, mtime, tags) cho incremental rescan
+ *
+ * Bao gồm: fromMedia/matches/applyTo, find, put, replaceRoot, countUnder,
+ * clear, count, serialize/deserialize round-trip, file hỏng.
+ */
+
+#include <gtest/gtest.h>
+#include "repositories/ScanManifestRepository.h"
+#include "models/MediaFileModel.h"
+#include "services/DirectoryReader.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+using namespace media_player::repositories;
+using namespace media_player::models;
+
+// ============================================================================
+// Test Fixture
+// ============================================================================
+
+class ScanManifestRepositoryTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_testDir = fs::temp_directory_path() / "MediaPlayerTest_ScanManifest";
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+        fs::create_directories(m_testDir / "music");
+
+        createDummyFile(m_testDir / "music" / "song1.mp3", "content_a");
+        createDummyFile(m_testDir / "music" / "song2.mp3", "content_ab");
+
+        m_storagePath = (m_testDir / "manifest_storage").string();
+    }
+
+    void TearDown() override
+    {
+        if (fs::exists(m_testDir))
+        {
+            fs::remove_all(m_testDir);
+        }
+    }
+
+    void createDummyFile(const fs::path& path, const std::string& content)
+    {
+        std::ofstream ofs(path);
+        ofs << content;
+        ofs.close();
+    }
+
+    // Bản ghi kèm size/mtime thật, như khi quét
+    MediaFileModel scanned(const std::string& path)
+    {
+        media_player::services::FileStat stat;
+        media_player::services::DirectoryReader::statFile(path, stat);
+        return MediaFileModel(path, stat.size, stat.lastModified);
+    }
+
+    ScanManifestEntry makeEntry(const std::string& path, const std::string& title)
+    {
+        ScanManifestEntry entry;
+        entry.filePath = path;
+        entry.fileSize = 42;
+        entry.lastModified = 1234567;
+        entry.title = title;
+        entry.artist = "Artist";
+        entry.album = "Album";
+        entry.duration = 180;
+        return entry;
+    }
+
+    fs::path m_testDir;
+    std::string m_storagePath;
+};
+
+// ============================================================================
+// ScanManifestEntry
+// ============================================================================
+
+TEST_F(ScanManifestRepositoryTest, EntryMatchesUnchangedFile)
+{
+    MediaFileModel media = scanned((m_testDir / "music" / "song1.mp3").string());
+    media.setTitle("Title");
+
+    auto entry = ScanManifestEntry::fromMedia(media);
+    EXPECT_EQ(entry.filePath, media.getFilePath());
+    EXPECT_EQ(entry.fileSize, media.getFileSize());
+    EXPECT_EQ(entry.title, "Title");
+    EXPECT_TRUE(entry.matches(scanned(media.getFilePath())));
+}
+
+TEST_F(ScanManifestRepositoryTest, EntryDoesNotMatchChangedFile)
+{
+    std::string path = (m_testDir / "music" / "song1.mp3").string();
+    auto entry = ScanManifestEntry::fromMedia(scanned(path));
+
+    createDummyFile(path, "content_changed_and_longer");
+    EXPECT_FALSE(entry.matches(scanned(path)));
+}
+
+TEST_F(ScanManifestRepositoryTest, EntryAppliesTags)
+{
+    MediaFileModel media((m_testDir / "music" / "song1.mp3").string());
+    makeEntry(media.getFilePath(), "Cached").applyTo(media);
+
+    EXPECT_EQ(media.getTitle(), "Cached");
+    EXPECT_EQ(media.getArtist(), "Artist");
+    EXPECT_EQ(media.getAlbum(), "Album");
+    EXPECT_EQ(media.getDuration(), 180);
+}
+
+// ============================================================================
+// Lookup & Update
+// ============================================================================
+
+TEST_F(ScanManifestRepositoryTest, PutAndFind)
+{
+    ScanManifestRepository repo(m_storagePath);
+    repo.put(makeEntry("/a/b.mp3", "B"));
+
+    auto found = repo.find("/a/b.mp3");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->title, "B");
+    EXPECT_FALSE(repo.find("/a/c.mp3").has_value());
+    EXPECT_EQ(repo.count(), 1u);
+}
+
+TEST_F(ScanManifestRepositoryTest, ReplaceRootDropsDeletedEntries)
+{
+    ScanManifestRepository repo(m_storagePath);
+    repo.put(makeEntry("/music/old.mp3", "Old"));
+    repo.put(makeEntry("/music/keep.mp3", "Keep"));
+    repo.put(makeEntry("/music2/other.mp3", "Other"));
+
+    repo.replaceRoot("/music", { makeEntry("/music/keep.mp3", "Keep"), makeEntry("/music/new.mp3", "New") });
+
+    EXPECT_FALSE(repo.find("/music/old.mp3").has_value());
+    EXPECT_TRUE(repo.find("/music/keep.mp3").has_value());
+    EXPECT_TRUE(repo.find("/music/new.mp3").has_value());
+    // "/music2" shares the prefix but is a different root
+    EXPECT_TRUE(repo.find("/music2/other.mp3").has_value());
+    EXPECT_EQ(repo.count(), 3u);
+}
+
+TEST_F(ScanManifestRepositoryTest, CountUnderRoot)
+{
+    ScanManifestRepository repo(m_storagePath);
+    repo.put(makeEntry("/music/a.mp3", "A"));
+    repo.put(makeEntry("/music/sub/b.mp3", "B"));
+    repo.put(makeEntry("/music2/c.mp3", "C"));
+
+    EXPECT_EQ(repo.countUnder("/music"), 2u);
+    EXPECT_EQ(repo.countUnder("/music/"), 2u);
+    EXPECT_EQ(repo.countUnder("/music2"), 1u);
+    EXPECT_EQ(repo.countUnder("/other"), 0u);
+}
+
+TEST_F(ScanManifestRepositoryTest, Clear)
+{
+    ScanManifestRepository repo(m_storagePath);
+    repo.put(makeEntry("/a/b.mp3", "B"));
+    repo.clear();
+    EXPECT_EQ(repo.count(), 0u);
+}
+
+// ============================================================================
+// Persistence
+// ============================================================================
+
+TEST_F(ScanManifestRepositoryTest, SaveAndLoadRoundTrip)
+{
+    {
+        ScanManifestRepository repo(m_storagePath);
+        repo.put(makeEntry("/a/one.mp3", "One"));
+        auto noTags = makeEntry("/a/two.mp3", "");
+        noTags.artist.clear();
+        noTags.album.clear();
+        repo.put(noTags);
+        EXPECT_TRUE(repo.saveToDisk());
+    }
+
+    ScanManifestRepository loaded(m_storagePath);
+    EXPECT_EQ(loaded.count(), 2u);
+
+    auto one = loaded.find("/a/one.mp3");
+    ASSERT_TRUE(one.has_value());
+    EXPECT_EQ(one->fileSize, 42u);
+    EXPECT_EQ(one->lastModified, 1234567);
+    EXPECT_EQ(one->title, "One");
+    EXPECT_EQ(one->artist, "Artist");
+    EXPECT_EQ(one->album, "Album");
+    EXPECT_EQ(one->duration, 180);
+
+    auto two = loaded.find("/a/two.mp3");
+    ASSERT_TRUE(two.has_value());
+    EXPECT_TRUE(two->title.empty());
+    EXPECT_TRUE(two->album.empty());
+}
+
+TEST_F(ScanManifestRepositoryTest, TabsInTagsAreSanitized)
+{
+    {
+        ScanManifestRepository repo(m_storagePath);
+        repo.put(makeEntry("/a/tab.mp3", "Left\tRight"));
+    }
+
+    ScanManifestRepository loaded(m_storagePath);
+    auto entry = loaded.find("/a/tab.mp3");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->title, "Left Right");
+    EXPECT_EQ(entry->artist, "Artist");
+}
+
+TEST_F(ScanManifestRepositoryTest, MalformedLinesAreSkipped)
+{
+    fs::create_directories(m_storagePath);
+    {
+        std::ofstream ofs(m_storagePath + "/scan_manifest.dat");
+        ofs << "MANIFEST_VERSION:1.0\nCOUNT:3\nENTRIES:\n";
+        ofs << "/a/good.mp3\t10\t20\t30\tT\tA\tB\n";
+        ofs << "/a/bad.mp3\tnot_a_number\t20\t30\n";
+        ofs << "garbage\n";
+    }
+
+    ScanManifestRepository repo(m_storagePath);
+    EXPECT_EQ(repo.count(), 1u);
+    EXPECT_TRUE(repo.find("/a/good.mp3").has_value());
+}
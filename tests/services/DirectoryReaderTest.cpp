@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "services/DirectoryReader.h"
+#include <filesystem>
+#include <fstream>
+#include <algorithm>
+#include <map>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+using namespace testing;
+
+class DirectoryReaderTest : public TestWithParam<services::DirectoryBackend> {
+protected:
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "MediaPlayerTest_DirectoryReader";
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+        fs::create_directories(testDir / "album");
+        fs::create_directories(testDir / ".hidden");
+        createFile(testDir / "song.mp3", "0123456789");
+        createFile(testDir / "cover.jpg", "jpg");
+        createFile(testDir / "album" / "track.flac", "flac");
+        createFile(testDir / ".hidden" / "secret.mp3", "x");
+    }
+
+    void TearDown() override {
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+    }
+
+    void createFile(const fs::path& path, const std::string& content) {
+        std::ofstream ofs(path);
+        ofs << content;
+    }
+    
+    struct Listing {
+        std::vector<std::string> dirs;
+        std::map<std::string, const services::FileStat*> files;
+        std::map<std::string, services::FileStat> stats;
+        bool ok = false;
+    };
+    
+    Listing list(const fs::path& dir) {
+        Listing result;
+        services::DirectoryReader reader(GetParam());
+        result.ok = reader.read(dir.string(),
+            [](const std::string& name) { return name.size() > 4 && name.substr(name.size() - 4) != ".jpg"; },
+            [&](const std::string& path) { result.dirs.push_back(path); },
+            [&](const std::string& path, const services::FileStat* stat) {
+                result.files[path] = stat;
+                if (stat) result.stats[path] = *stat;
+            });
+        std::sort(result.dirs.begin(), result.dirs.end());
+        return result;
+    }
+
+    fs::path testDir;
+};
+
+TEST_P(DirectoryReaderTest, ListsVisibleDirectoriesAndFilteredFiles) {
+    auto listing = list(testDir);
+    ASSERT_TRUE(listing.ok);
+    
+    ASSERT_EQ(listing.dirs.size(), 1u);
+    EXPECT_EQ(listing.dirs[0], (testDir / "album").string());
+    
+    ASSERT_EQ(listing.files.size(), 1u);
+    EXPECT_EQ(listing.files.begin()->first, (testDir / "song.mp3").string());
+}
+
+TEST_P(DirectoryReaderTest, StatMatchesFilesystem) {
+    auto listing = list(testDir);
+    auto path = (testDir / "song.mp3").string();
+    
+    if (GetParam() == services::DirectoryBackend::PORTABLE) {
+        // Left to MediaFileModel
+        EXPECT_EQ(listing.files[path], nullptr);
+        return;
+    }
+    
+    ASSERT_TRUE(listing.stats.count(path));
+    EXPECT_EQ(listing.stats[path].size, 10u);
+    EXPECT_EQ(listing.stats[path].lastModified, fs::last_write_time(path));
+}
+
+TEST_P(DirectoryReaderTest, FollowsSymlinks) {
+    fs::create_directory_symlink(testDir / "album", testDir / "linked");
+    fs::create_symlink(testDir / "song.mp3", testDir / "album" / "alias.mp3");
+    
+    auto root = list(testDir);
+    EXPECT_NE(std::find(root.dirs.begin(), root.dirs.end(), (testDir / "linked").string()), root.dirs.end());
+    
+    auto album = list(testDir / "album");
+    auto alias = (testDir / "album" / "alias.mp3").string();
+    ASSERT_TRUE(album.files.count(alias));
+    if (GetParam() == services::DirectoryBackend::GETDENTS) {
+        EXPECT_EQ(album.stats[alias].size, 10u);
+    }
+}
+
+TEST_P(DirectoryReaderTest, MissingDirectoryFails) {
+    EXPECT_FALSE(list(testDir / "missing").ok);
+    EXPECT_FALSE(list(testDir / "song.mp3").ok);
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, DirectoryReaderTest,
+    Values(services::DirectoryBackend::PORTABLE, services::DirectoryBackend::GETDENTS));
@@ -5,6 +5,8 @@
 #include <fstream>
 #include <thread>
 #include <chrono>
+#include <algorithm>
+#include <stdexcept>
 
 namespace fs = std::filesystem;
 using namespace media_player;
@@ -259,3 +261,423 @@ TEST_F(FileScannerTest, DepthZero) {
         EXPECT_FALSE(file.getFilePath().find("subdir") != std::string::npos);
     }
 }
+
+// ===================== Parallel Scan =====================
+
+TEST_F(FileScannerTest, ThreadCountClampedToOne) {
+    scanner.setThreadCount(0);
+    EXPECT_EQ(scanner.getThreadCount(), 1);
+    scanner.setThreadCount(8);
+    EXPECT_EQ(scanner.getThreadCount(), 8);
+}
+
+TEST_F(FileScannerTest, ParallelMatchesSequential) {
+    for (int d = 0; d < 5; ++d) {
+        auto dir = testDir / ("album" + std::to_string(d)) / "disc1";
+        fs::create_directories(dir);
+        for (int i = 0; i < 12; ++i) {
+            createFile(dir / ("track" + std::to_string(i) + ".mp3"));
+        }
+    }
+    
+    scanner.setThreadCount(1);
+    auto sequential = scanner.scanDirectorySync(testDir.string());
+    
+    services::FileScanner parallelScanner;
+    parallelScanner.setThreadCount(4);
+    auto parallel = parallelScanner.scanDirectorySync(testDir.string());
+    
+    ASSERT_EQ(sequential.size(), parallel.size());
+    std::vector<std::string> seqPaths, parPaths;
+    for (const auto& f : sequential) seqPaths.push_back(f.getFilePath());
+    for (const auto& f : parallel) parPaths.push_back(f.getFilePath());
+    std::sort(seqPaths.begin(), seqPaths.end());
+    EXPECT_EQ(seqPaths, parPaths); // Parallel results come back sorted by path
+}
+
+TEST_F(FileScannerTest, ParallelRespectsDepthAndHiddenDirs) {
+    fs::create_directories(testDir / ".hidden");
+    createFile(testDir / ".hidden" / "secret.mp3");
+    fs::create_directories(testDir / "subdir" / "deeper");
+    createFile(testDir / "subdir" / "deeper" / "deep.mp3");
+    
+    scanner.setThreadCount(4);
+    scanner.setMaxDepth(1);
+    auto files = scanner.scanDirectorySync(testDir.string());
+    
+    bool foundNested = false;
+    for (const auto& file : files) {
+        EXPECT_NE(file.getFileName(), "secret.mp3");
+        EXPECT_NE(file.getFileName(), "deep.mp3");
+        if (file.getFileName() == "nested.flac") foundNested = true;
+    }
+    EXPECT_TRUE(foundNested);
+}
+
+TEST_F(FileScannerTest, ParallelProgressCallback3) {
+    for (int i = 0; i < 30; ++i) {
+        createFile(testDir / ("p" + std::to_string(i) + ".mp3"));
+    }
+    std::atomic<int> maxCount{0};
+    scanner.setThreadCount(4);
+    scanner.setProgressCallback([&](int count, int, const std::string&) {
+        if (count > maxCount) maxCount = count;
+    });
+    auto files = scanner.scanDirectorySync(testDir.string());
+    EXPECT_GE(maxCount, 30);
+    EXPECT_LE(maxCount, static_cast<int>(files.size()));
+}
+
+TEST_F(FileScannerTest, ParallelAsyncScanCompletes) {
+    std::atomic<bool> scanComplete{false};
+    std::atomic<size_t> found{0};
+    scanner.setThreadCount(4);
+    scanner.setCompleteCallback([&](std::vector<models::MediaFileModel> results) {
+        found = results.size();
+        scanComplete = true;
+    });
+    scanner.scanDirectory(testDir.string());
+    for (int i = 0; i < 50 && !scanComplete; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    EXPECT_TRUE(scanComplete);
+    EXPECT_GE(found.load(), 3u);
+}
+
+// ===================== Pipelined Scan =====================
+
+TEST_F(FileScannerTest, MetadataWorkerCountClampedToZero) {
+    scanner.setMetadataWorkerCount(-3);
+    EXPECT_EQ(scanner.getMetadataWorkerCount(), 0);
+    scanner.setMetadataWorkerCount(2);
+    EXPECT_EQ(scanner.getMetadataWorkerCount(), 2);
+}
+
+TEST_F(FileScannerTest, PipelinedMatchesInline) {
+    for (int i = 0; i < 40; ++i) {
+        createFile(testDir / ("pipe" + std::to_string(i) + ".mp3"));
+    }
+    
+    scanner.setThreadCount(1);
+    scanner.setMetadataWorkerCount(0);
+    auto inlineFiles = scanner.scanDirectorySync(testDir.string());
+    
+    services::FileScanner pipelined;
+    pipelined.setThreadCount(2);
+    pipelined.setMetadataWorkerCount(3);
+    auto pipeFiles = pipelined.scanDirectorySync(testDir.string());
+    
+    std::vector<std::string> inlinePaths, pipePaths;
+    for (const auto& f : inlineFiles) inlinePaths.push_back(f.getFilePath());
+    for (const auto& f : pipeFiles) pipePaths.push_back(f.getFilePath());
+    std::sort(inlinePaths.begin(), inlinePaths.end());
+    EXPECT_EQ(inlinePaths, pipePaths);
+}
+
+TEST_F(FileScannerTest, DirectoryBackendsAgree) {
+    fs::create_directories(testDir / "deep" / "er");
+    createFile(testDir / "deep" / "a.mp3");
+    createFile(testDir / "deep" / "er" / "b.flac");
+    
+    scanner.setDirectoryBackend(services::DirectoryBackend::PORTABLE);
+    EXPECT_EQ(scanner.getDirectoryBackend(), services::DirectoryBackend::PORTABLE);
+    auto portable = scanner.scanDirectorySync(testDir.string());
+    
+    services::FileScanner fast;
+    fast.setDirectoryBackend(services::DirectoryBackend::GETDENTS);
+    auto listed = fast.scanDirectorySync(testDir.string());
+    
+    // Same files, and the stat taken during the walk matches MediaFileModel's own
+    ASSERT_EQ(portable.size(), listed.size());
+    for (size_t i = 0; i < portable.size(); ++i) {
+        EXPECT_EQ(portable[i].getFilePath(), listed[i].getFilePath());
+        EXPECT_EQ(portable[i].getFileSize(), listed[i].getFileSize());
+        EXPECT_EQ(portable[i].getLastModified(), listed[i].getLastModified());
+    }
+}
+
+TEST_F(FileScannerTest, TagPrefetchMatchesBlockingReads) {
+    for (int i = 0; i < 50; ++i) {
+        createFile(testDir / ("pf" + std::to_string(i) + ".mp3"));
+    }
+    
+    scanner.setTagPrefetch(false);
+    EXPECT_FALSE(scanner.isTagPrefetchEnabled());
+    auto blocking = scanner.scanDirectorySync(testDir.string());
+    EXPECT_EQ(scanner.getPrefetchedCount(), 0);
+    
+    services::FileScanner prefetching;
+    prefetching.setTagPrefetch(true);
+    auto prefetched = prefetching.scanDirectorySync(testDir.string());
+    
+    ASSERT_EQ(blocking.size(), prefetched.size());
+    for (size_t i = 0; i < blocking.size(); ++i) {
+        EXPECT_EQ(blocking[i].getFilePath(), prefetched[i].getFilePath());
+        EXPECT_EQ(blocking[i].getFileSize(), prefetched[i].getFileSize());
+        EXPECT_EQ(blocking[i].getLastModified(), prefetched[i].getLastModified());
+    }
+    
+    // Every file went through io_uring, or none did (no io_uring here)
+    int count = prefetching.getPrefetchedCount();
+    EXPECT_TRUE(count == 0 || count == static_cast<int>(prefetched.size()));
+}
+
+TEST_F(FileScannerTest, NativeTagParserReadsTags) {
+    // ID3v2.3 tag with a title, then 116 CBR frames of 417 bytes (128 kbps, ~3 s)
+    std::string title = "Native";
+    std::string frame = std::string("TIT2\0\0\0", 7) + static_cast<char>(title.size() + 1) +
+                        std::string(3, '\0') + title;
+    std::string tag = std::string("ID3\x03\0\0\0\0\0", 9) + static_cast<char>(frame.size()) + frame;
+    std::string audio;
+    for (int i = 0; i < 116; ++i) {
+        std::string mpeg("\xFF\xFB\x90\x00", 4);
+        mpeg.resize(417, '\0');
+        audio += mpeg;
+    }
+    std::ofstream(testDir / "tagged.mp3", std::ios::binary) << tag << audio;
+
+    auto findTagged = [](const std::vector<models::MediaFileModel>& files) {
+        return std::find_if(files.begin(), files.end(), [](const models::MediaFileModel& media) {
+            return media.getFileName() == "tagged.mp3";
+        });
+    };
+
+    for (bool prefetch : { false, true }) {
+        services::FileScanner nativeScanner;
+        nativeScanner.setTagPrefetch(prefetch);
+        EXPECT_TRUE(nativeScanner.isNativeTagParserEnabled());
+        auto files = nativeScanner.scanDirectorySync(testDir.string());
+
+        auto tagged = findTagged(files);
+        ASSERT_NE(tagged, files.end());
+        EXPECT_EQ(tagged->getTitle(), "Native");
+        EXPECT_EQ(tagged->getDuration(), 3);
+        EXPECT_EQ(nativeScanner.getNativeTagCount(), 1);  // The dummy files go to TagLib
+    }
+
+    scanner.setNativeTagParser(false);
+    auto files = scanner.scanDirectorySync(testDir.string());
+    EXPECT_EQ(scanner.getNativeTagCount(), 0);
+    EXPECT_NE(findTagged(files), files.end());
+}
+
+TEST_F(FileScannerTest, PipelinedEmitsBatches) {
+    for (int i = 0; i < 25; ++i) {
+        createFile(testDir / ("batch" + std::to_string(i) + ".mp3"));
+    }
+    
+    std::vector<size_t> batchSizes;
+    scanner.setMetadataWorkerCount(2);
+    scanner.setBatchSize(10);
+    scanner.setBatchCallback([&](std::vector<models::MediaFileModel> batch) {
+        batchSizes.push_back(batch.size());
+    });
+    auto files = scanner.scanDirectorySync(testDir.string());
+    
+    ASSERT_FALSE(batchSizes.empty());
+    size_t total = 0;
+    for (size_t i = 0; i < batchSizes.size(); ++i) {
+        total += batchSizes[i];
+        if (i + 1 < batchSizes.size()) {
+            EXPECT_EQ(batchSizes[i], 10u); // Only the last batch may be partial
+        }
+    }
+    // The callback owns the records; the scanner only keeps their paths
+    EXPECT_TRUE(files.empty());
+    EXPECT_EQ(total, scanner.takeStreamedPaths().size());
+    EXPECT_EQ(scanner.getLastPipelineStats().batchCount, batchSizes.size());
+    
+    // The first batch goes out before the scan is over
+    auto stats = scanner.getLastPipelineStats();
+    EXPECT_GT(stats.firstBatchSeconds, 0.0);
+    EXPECT_LE(stats.firstBatchSeconds, stats.elapsedSeconds);
+}
+
+TEST_F(FileScannerTest, PipelineStatsCountStages) {
+    for (int i = 0; i < 20; ++i) {
+        createFile(testDir / ("stat" + std::to_string(i) + ".mp3"));
+    }
+    
+    scanner.setMetadataWorkerCount(2);
+    auto files = scanner.scanDirectorySync(testDir.string());
+    auto stats = scanner.getLastPipelineStats();
+    
+    // png and the uppercase .WAV never leave the walk stage
+    EXPECT_GE(stats.discovery.itemsOut, stats.metadata.itemsOut);
+    EXPECT_EQ(stats.metadata.itemsOut, files.size());
+    EXPECT_EQ(stats.sink.itemsOut, files.size());
+    EXPECT_GT(stats.pathQueueHighWater, 0u);
+    EXPECT_GT(stats.elapsedSeconds, 0.0);
+    EXPECT_GE(stats.discovery.blockedSeconds, 0.0);
+    EXPECT_GE(stats.metadata.starvedSeconds, 0.0);
+}
+
+TEST_F(FileScannerTest, PipelinedStopScan) {
+    for (int i = 0; i < 200; ++i) {
+        createFile(testDir / ("stop" + std::to_string(i) + ".mp3"));
+    }
+    
+    scanner.setMetadataWorkerCount(2);
+    scanner.scanDirectory(testDir.string());
+    scanner.stopScanning();
+    EXPECT_FALSE(scanner.isScanning());
+}
+
+TEST_F(FileScannerTest, PipelinedSurvivesThrowingBatchCallback) {
+    for (int i = 0; i < 300; ++i) {
+        createFile(testDir / ("throw" + std::to_string(i) + ".mp3"));
+    }
+    
+    // The sink stops draining while the walk and readers still have work
+    std::atomic<bool> completed{false};
+    scanner.setMetadataWorkerCount(2);
+    scanner.setBatchSize(1);
+    scanner.setBatchCallback([](std::vector<models::MediaFileModel>) {
+        throw std::runtime_error("sink failed");
+    });
+    scanner.setCompleteCallback([&](std::vector<models::MediaFileModel>) {
+        completed = true;
+    });
+    scanner.scanDirectory(testDir.string());
+    for (int i = 0; i < 50 && scanner.isScanning(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    
+    EXPECT_FALSE(scanner.isScanning());
+    EXPECT_FALSE(completed);
+}
+
+// ===================== Scan Manifest =====================
+
+TEST_F(FileScannerTest, ManifestReusesTagsForUnchangedFiles) {
+    auto manifest = std::make_shared<repositories::ScanManifestRepository>((testDir / ".manifest").string());
+    scanner.setScanManifest(manifest);
+    
+    auto first = scanner.scanDirectorySync(testDir.string());
+    EXPECT_EQ(scanner.getReusedTagCount(), 0);
+    EXPECT_EQ(manifest->count(), first.size());
+    
+    // Tags recorded in the manifest come back without reading the file
+    std::string songPath = (testDir / "song1.mp3").string();
+    auto entry = manifest->find(songPath);
+    ASSERT_TRUE(entry.has_value());
+    entry->title = "Cached Title";
+    manifest->put(*entry);
+    
+    auto second = scanner.scanDirectorySync(testDir.string());
+    EXPECT_EQ(scanner.getReusedTagCount(), static_cast<int>(second.size()));
+    auto it = std::find_if(second.begin(), second.end(), [&](const models::MediaFileModel& m) {
+        return m.getFilePath() == songPath;
+    });
+    ASSERT_NE(it, second.end());
+    EXPECT_EQ(it->getTitle(), "Cached Title");
+}
+
+TEST_F(FileScannerTest, ManifestRereadsChangedAndDropsDeletedFiles) {
+    auto manifest = std::make_shared<repositories::ScanManifestRepository>((testDir / ".manifest").string());
+    scanner.setScanManifest(manifest);
+    scanner.scanDirectorySync(testDir.string());
+    
+    std::string changedPath = (testDir / "song1.mp3").string();
+    auto entry = manifest->find(changedPath);
+    ASSERT_TRUE(entry.has_value());
+    entry->title = "Stale Title";
+    manifest->put(*entry);
+    {
+        std::ofstream ofs(changedPath);
+        ofs << "content with a different size";
+    }
+    fs::remove(testDir / "video.mp4");
+    
+    auto files = scanner.scanDirectorySync(testDir.string());
+    EXPECT_EQ(scanner.getReusedTagCount(), static_cast<int>(files.size()) - 1);
+    for (const auto& file : files) {
+        EXPECT_NE(file.getTitle(), "Stale Title");
+    }
+    EXPECT_FALSE(manifest->find((testDir / "video.mp4").string()).has_value());
+    EXPECT_EQ(manifest->count(), files.size());
+}
+
+TEST_F(FileScannerTest, StreamedScanKeepsManifestCurrent) {
+    auto manifest = std::make_shared<repositories::ScanManifestRepository>((testDir / ".manifest").string());
+    scanner.setScanManifest(manifest);
+    scanner.setMetadataWorkerCount(2);
+    size_t streamed = 0;
+    scanner.setBatchCallback([&](std::vector<models::MediaFileModel> batch) {
+        streamed += batch.size();
+    });
+    
+    scanner.scanDirectorySync(testDir.string());
+    EXPECT_EQ(manifest->count(), streamed);
+    
+    // Entries of files deleted since drop out, as with a non-streamed scan
+    fs::remove(testDir / "video.mp4");
+    streamed = 0;
+    scanner.scanDirectorySync(testDir.string());
+    EXPECT_FALSE(manifest->find((testDir / "video.mp4").string()).has_value());
+    EXPECT_EQ(manifest->count(), streamed);
+    EXPECT_EQ(scanner.getReusedTagCount(), static_cast<int>(streamed));
+}
+
+// ===================== Streaming Progress =====================
+
+TEST_F(FileScannerTest, FinalProgressReportsExactTotal) {
+    for (int d = 0; d < 4; ++d) {
+        auto dir = testDir / ("artist" + std::to_string(d));
+        fs::create_directories(dir);
+        for (int i = 0; i < 7; ++i) {
+            createFile(dir / ("t" + std::to_string(i) + ".mp3"));
+        }
+    }
+    
+    std::atomic<int> lastCount{0};
+    std::atomic<int> lastTotal{0};
+    std::atomic<bool> totalBelowCount{false};
+    scanner.setProgressCallback([&](int count, int total, const std::string&) {
+        if (total < count) totalBelowCount = true;
+        lastCount = count;
+        lastTotal = total;
+    });
+    auto files = scanner.scanDirectorySync(testDir.string());
+    
+    EXPECT_FALSE(totalBelowCount);
+    EXPECT_EQ(lastCount, static_cast<int>(files.size()));
+    EXPECT_EQ(lastTotal, static_cast<int>(files.size()));
+}
+
+TEST_F(FileScannerTest, RescanSeedsTotalFromPreviousCount) {
+    for (int i = 0; i < 30; ++i) {
+        createFile(testDir / ("seed" + std::to_string(i) + ".mp3"));
+    }
+    auto first = scanner.scanDirectorySync(testDir.string());
+    
+    std::atomic<int> firstTotal{-1};
+    scanner.setProgressCallback([&](int, int total, const std::string&) {
+        int expected = -1;
+        firstTotal.compare_exchange_strong(expected, total);
+    });
+    scanner.scanDirectorySync(testDir.string());
+    
+    // The very first report already knows the size of the library
+    EXPECT_GE(firstTotal, static_cast<int>(first.size()));
+}
+
+TEST_F(FileScannerTest, ManifestSeedsTotalForNewScanner) {
+    for (int i = 0; i < 30; ++i) {
+        createFile(testDir / ("seed" + std::to_string(i) + ".mp3"));
+    }
+    auto manifest = std::make_shared<repositories::ScanManifestRepository>((testDir / ".manifest").string());
+    scanner.setScanManifest(manifest);
+    auto first = scanner.scanDirectorySync(testDir.string());
+    
+    services::FileScanner fresh;
+    fresh.setScanManifest(manifest);
+    std::atomic<int> firstTotal{-1};
+    fresh.setProgressCallback([&](int, int total, const std::string&) {
+        int expected = -1;
+        firstTotal.compare_exchange_strong(expected, total);
+    });
+    fresh.scanDirectorySync(testDir.string());
+    
+    EXPECT_GE(firstTotal, static_cast<int>(first.size()));
+}
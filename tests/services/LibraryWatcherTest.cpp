@@ -0,0 +1,187 @@
+#include <gtest/gtest.h>
+#include "services/LibraryWatcher.h"
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+using namespace testing;
+
+class LibraryWatcherTest : public Test {
+protected:
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "MediaPlayerTest_LibraryWatcher";
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+        fs::create_directories(testDir / "album");
+        createFile(testDir / "album" / "existing.mp3");
+        
+        scanner = std::make_shared<services::FileScanner>();
+        watcher = std::make_unique<services::LibraryWatcher>(scanner);
+        watcher->setSettleDelay(20);
+        watcher->setChangeCallback([this](std::vector<services::LibraryChange> batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& change : batch) {
+                changes.push_back(std::move(change));
+            }
+        });
+    }
+
+    void TearDown() override {
+        watcher.reset();
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+    }
+
+    void createFile(const fs::path& path) {
+        std::ofstream ofs(path);
+        ofs << "dummy content";
+        ofs.close();
+    }
+    
+    // Waits until a change of the given type for path has been reported
+    bool waitFor(services::LibraryChangeType type, const fs::path& path) {
+        for (int i = 0; i < 100; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& change : changes) {
+                    if (change.type == type && change.path == path.string()) return true;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return false;
+    }
+    
+    std::vector<services::LibraryChange> snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return changes;
+    }
+
+    fs::path testDir;
+    std::shared_ptr<services::FileScanner> scanner;
+    std::unique_ptr<services::LibraryWatcher> watcher;
+    std::mutex mutex;
+    std::vector<services::LibraryChange> changes;
+};
+
+TEST_F(LibraryWatcherTest, StartRequiresDirectory) {
+    EXPECT_FALSE(watcher->start((testDir / "missing").string()));
+    EXPECT_FALSE(watcher->start((testDir / "album" / "existing.mp3").string()));
+    EXPECT_FALSE(watcher->isWatching());
+}
+
+TEST_F(LibraryWatcherTest, StartWatchesEverySubdirectory) {
+    fs::create_directories(testDir / "album" / "disc2");
+    fs::create_directories(testDir / ".hidden");
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    EXPECT_TRUE(watcher->isWatching());
+    EXPECT_EQ(watcher->getRootPath(), testDir.string());
+    EXPECT_EQ(watcher->getWatchCount(), 3u); // root, album, album/disc2
+    
+    watcher->stop();
+    EXPECT_FALSE(watcher->isWatching());
+    EXPECT_EQ(watcher->getWatchCount(), 0u);
+}
+
+TEST_F(LibraryWatcherTest, StopsAtScannerDepth) {
+    fs::create_directories(testDir / "album" / "disc2");
+    scanner->setMaxDepth(1);
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    EXPECT_EQ(watcher->getWatchCount(), 2u); // root, album; disc2 was never scanned
+    
+    // A directory created at the limit is not watched either
+    fs::create_directories(testDir / "album" / "disc3");
+    createFile(testDir / "album" / "disc2" / "deep.mp3");
+    auto marker = testDir / "album" / "marker.mp3";
+    createFile(marker);
+    
+    ASSERT_TRUE(waitFor(services::LibraryChangeType::FILE_ADDED, marker));
+    EXPECT_EQ(watcher->getWatchCount(), 2u);
+    for (const auto& change : snapshot()) {
+        EXPECT_EQ(change.path.find("deep.mp3"), std::string::npos);
+    }
+}
+
+TEST_F(LibraryWatcherTest, ReportsAddedFileWithMedia) {
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    auto path = testDir / "album" / "new.mp3";
+    createFile(path);
+    
+    ASSERT_TRUE(waitFor(services::LibraryChangeType::FILE_ADDED, path));
+    auto all = snapshot();
+    auto it = std::find_if(all.begin(), all.end(), [&](const services::LibraryChange& c) {
+        return c.path == path.string();
+    });
+    ASSERT_TRUE(it->media.has_value());
+    EXPECT_EQ(it->media->getFileName(), "new.mp3");
+}
+
+TEST_F(LibraryWatcherTest, IgnoresNonMediaFiles) {
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    createFile(testDir / "album" / "cover.jpg");
+    auto marker = testDir / "album" / "marker.mp3";
+    createFile(marker);
+    
+    ASSERT_TRUE(waitFor(services::LibraryChangeType::FILE_ADDED, marker));
+    for (const auto& change : snapshot()) {
+        EXPECT_EQ(change.path.find("cover.jpg"), std::string::npos);
+    }
+}
+
+TEST_F(LibraryWatcherTest, ReportsModifiedFile) {
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    auto path = testDir / "album" / "existing.mp3";
+    {
+        std::ofstream ofs(path, std::ios::app);
+        ofs << "more";
+    }
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::FILE_MODIFIED, path));
+}
+
+TEST_F(LibraryWatcherTest, ReportsRemovedFile) {
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    auto path = testDir / "album" / "existing.mp3";
+    fs::remove(path);
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::FILE_REMOVED, path));
+}
+
+TEST_F(LibraryWatcherTest, RenameIsRemoveAndAdd) {
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    auto from = testDir / "album" / "existing.mp3";
+    auto to = testDir / "album" / "renamed.mp3";
+    fs::rename(from, to);
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::FILE_REMOVED, from));
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::FILE_ADDED, to));
+}
+
+TEST_F(LibraryWatcherTest, DirectoryMovedInReportsItsFiles) {
+    auto outside = fs::temp_directory_path() / "MediaPlayerTest_LibraryWatcher_Outside";
+    fs::remove_all(outside);
+    fs::create_directories(outside / "cd1");
+    createFile(outside / "cd1" / "a.mp3");
+    createFile(outside / "b.flac");
+    
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    fs::rename(outside, testDir / "newalbum");
+    
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::FILE_ADDED, testDir / "newalbum" / "cd1" / "a.mp3"));
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::FILE_ADDED, testDir / "newalbum" / "b.flac"));
+    
+    // The new subtree is watched too
+    auto later = testDir / "newalbum" / "cd1" / "later.mp3";
+    createFile(later);
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::FILE_ADDED, later));
+}
+
+TEST_F(LibraryWatcherTest, DirectoryRemovedIsReportedOnce) {
+    ASSERT_TRUE(watcher->start(testDir.string()));
+    fs::remove_all(testDir / "album");
+    EXPECT_TRUE(waitFor(services::LibraryChangeType::DIRECTORY_REMOVED, testDir / "album"));
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "services/MediaValidator.h"
+#include "services/DirectoryReader.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+using namespace testing;
+
+class MediaValidatorTest : public Test {
+protected:
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "MediaPlayerTest_MediaValidator";
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+        fs::create_directories(testDir);
+    }
+
+    void TearDown() override {
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+    }
+
+    // Every third path is missing
+    std::vector<std::string> makePaths(size_t count, std::vector<std::string>& missing) {
+        std::vector<std::string> paths;
+        for (size_t i = 0; i < count; ++i) {
+            fs::path path = testDir / ("track_" + std::to_string(i) + ".mp3");
+            if (i % 3 == 0) {
+                missing.push_back(path.string());
+            } else {
+                std::ofstream(path) << "data";
+            }
+            paths.push_back(path.string());
+        }
+        return paths;
+    }
+
+    fs::path testDir;
+};
+
+TEST_F(MediaValidatorTest, FindMissingKeepsInputOrder) {
+    std::vector<std::string> missing;
+    auto paths = makePaths(500, missing);
+
+    services::MediaValidator validator(4);
+    EXPECT_EQ(validator.findMissing(paths), missing);
+    EXPECT_TRUE(validator.findMissing({}).empty());
+}
+
+TEST_F(MediaValidatorTest, DirectoryCountsAsMissing) {
+    fs::create_directories(testDir / "album.mp3");
+
+    services::MediaValidator validator;
+    auto missing = validator.findMissing({ (testDir / "album.mp3").string() });
+    EXPECT_EQ(missing.size(), 1u);
+}
+
+TEST_F(MediaValidatorTest, ReportsMissingPathsInBatches) {
+    std::vector<std::string> expected;
+    auto paths = makePaths(1000, expected);
+
+    std::mutex mutex;
+    std::vector<std::string> reported;
+    int callbacks = 0;
+
+    services::MediaValidator validator(2);
+    validator.setBatchSize(100);
+    validator.setResultCallback([&](std::vector<std::string> missing) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reported.insert(reported.end(), missing.begin(), missing.end());
+        callbacks++;
+    });
+
+    ASSERT_TRUE(validator.start(paths));
+    validator.wait();
+
+    EXPECT_FALSE(validator.isRunning());
+    EXPECT_EQ(reported, expected);
+    EXPECT_EQ(callbacks, 10);
+    EXPECT_EQ(validator.getCheckedCount(), 1000u);
+    EXPECT_EQ(validator.getMissingCount(), expected.size());
+}
+
+TEST_F(MediaValidatorTest, NoCallbackWhenEverythingExists) {
+    std::ofstream(testDir / "a.mp3") << "data";
+    int callbacks = 0;
+
+    services::MediaValidator validator;
+    validator.setResultCallback([&](std::vector<std::string>) { callbacks++; });
+
+    ASSERT_TRUE(validator.start({ (testDir / "a.mp3").string() }));
+    validator.wait();
+
+    EXPECT_EQ(callbacks, 0);
+    EXPECT_EQ(validator.getCheckedCount(), 1u);
+}
+
+TEST_F(MediaValidatorTest, StopAbandonsRemainingBatches) {
+    std::vector<std::string> missing;
+    auto paths = makePaths(3000, missing);
+
+    services::MediaValidator validator(1);
+    validator.setBatchSize(1);
+    ASSERT_TRUE(validator.start(paths));
+    validator.stop();
+
+    EXPECT_FALSE(validator.isRunning());
+    EXPECT_LE(validator.getCheckedCount(), paths.size());
+
+    // A new run can start once the previous one is over
+    ASSERT_TRUE(validator.start({ paths[0] }));
+    validator.wait();
+    EXPECT_EQ(validator.getCheckedCount(), 1u);
+    EXPECT_EQ(validator.getMissingCount(), 1u);
+}
+
+TEST_F(MediaValidatorTest, StatFileReadsSizeOfRegularFiles) {
+    std::ofstream(testDir / "a.mp3") << "12345";
+
+    services::FileStat stat;
+    ASSERT_TRUE(services::DirectoryReader::statFile((testDir / "a.mp3").string(), stat));
+    EXPECT_EQ(stat.size, 5u);
+    EXPECT_EQ(stat.lastModified, fs::last_write_time(testDir / "a.mp3"));
+
+    EXPECT_FALSE(services::DirectoryReader::statFile((testDir / "none.mp3").string(), stat));
+    EXPECT_FALSE(services::DirectoryReader::statFile(testDir.string(), stat));
+}
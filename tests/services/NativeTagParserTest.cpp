@@ -0,0 +1,288 @@
+#include <gtest/gtest.h>
+#include "services/NativeTagParser.h"
+#include "services/MetadataReader.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+using namespace testing;
+
+namespace {
+
+// MPEG-1 Layer III, 128 kbps, 44.1 kHz, stereo: 417-byte frames
+const size_t FRAME_LENGTH = 417;
+
+std::string be32(uint32_t value) {
+    return { static_cast<char>(value >> 24), static_cast<char>(value >> 16),
+             static_cast<char>(value >> 8), static_cast<char>(value) };
+}
+
+std::string le32(uint32_t value) {
+    return { static_cast<char>(value), static_cast<char>(value >> 8),
+             static_cast<char>(value >> 16), static_cast<char>(value >> 24) };
+}
+
+std::string le16(uint16_t value) {
+    return { static_cast<char>(value), static_cast<char>(value >> 8) };
+}
+
+std::string syncSafe(uint32_t value) {
+    return { static_cast<char>((value >> 21) & 0x7F), static_cast<char>((value >> 14) & 0x7F),
+             static_cast<char>((value >> 7) & 0x7F), static_cast<char>(value & 0x7F) };
+}
+
+std::string frame(int major, const std::string& id, const std::string& payload, char formatFlags = 0) {
+    uint32_t size = static_cast<uint32_t>(payload.size());
+    return id + (major == 4 ? syncSafe(size) : be32(size)) + std::string(1, '\0') +
+           std::string(1, formatFlags) + payload;
+}
+
+std::string tag(int major, const std::string& frames, char flags = 0, size_t padding = 64) {
+    std::string body = frames + std::string(padding, '\0');
+    return std::string("ID3") + static_cast<char>(major) + '\0' + flags +
+           syncSafe(static_cast<uint32_t>(body.size())) + body;
+}
+
+std::string latin1(const std::string& text) {
+    return std::string(1, '\0') + text;
+}
+
+std::string mpegFrame(const std::string& infoAt36 = "") {
+    std::string data("\xFF\xFB\x90\x00", 4);
+    data.resize(FRAME_LENGTH, '\0');
+    data.replace(36, infoAt36.size(), infoAt36);
+    return data;
+}
+
+std::string mpegFrames(size_t count) {
+    std::string data;
+    for (size_t i = 0; i < count; ++i) {
+        data += mpegFrame();
+    }
+    return data;
+}
+
+std::string id3v1(const std::string& title, const std::string& artist, const std::string& album,
+                  const std::string& year, unsigned char genre) {
+    auto field = [](const std::string& text, size_t size) {
+        std::string value = text;
+        value.resize(size, '\0');
+        return value;
+    };
+    return "TAG" + field(title, 30) + field(artist, 30) + field(album, 30) + field(year, 4) +
+           field("", 30) + std::string(1, static_cast<char>(genre));
+}
+
+std::string wav(uint32_t dataBytes, const std::string& extraChunks) {
+    std::string format = le16(1) + le16(2) + le32(44100) + le32(44100 * 4) + le16(4) + le16(16);
+    std::string body = "WAVE" + std::string("fmt ") + le32(16) + format + extraChunks +
+                       "data" + le32(dataBytes) + std::string(dataBytes, '\0');
+    return "RIFF" + le32(static_cast<uint32_t>(body.size())) + body;
+}
+
+std::string chunk(const std::string& id, const std::string& payload) {
+    std::string data = id + le32(static_cast<uint32_t>(payload.size())) + payload;
+    if (payload.size() % 2) {
+        data += '\0';
+    }
+    return data;
+}
+
+} // namespace
+
+class NativeTagParserTest : public Test {
+protected:
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "MediaPlayerTest_NativeTagParser";
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+        fs::create_directories(testDir);
+    }
+
+    void TearDown() override {
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+    }
+
+    std::string write(const std::string& name, const std::string& content) {
+        fs::path path = testDir / name;
+        std::ofstream(path, std::ios::binary) << content;
+        return path.string();
+    }
+
+    bool parse(const std::string& name, const std::string& content, services::NativeTags& tags) {
+        return services::NativeTagParser::parseFile(write(name, content), tags);
+    }
+
+    fs::path testDir;
+};
+
+TEST_F(NativeTagParserTest, Id3v23TextFramesAndCbrDuration) {
+    // Latin-1 title with a non-ASCII byte, UTF-16 artist with BOM, numeric genre
+    std::string artist = std::string("\x01\xFF\xFE", 3) + std::string("S\0\xF4\0n\0", 6);
+    std::string frames = frame(3, "TIT2", latin1("Caf\xE9")) + frame(3, "TPE1", artist) +
+                         frame(3, "TALB", latin1("Album")) + frame(3, "TCON", latin1("(17)")) +
+                         frame(3, "TYER", latin1("2019"));
+
+    services::NativeTags tags;
+    ASSERT_TRUE(parse("v23.mp3", tag(3, frames) + mpegFrames(116), tags));
+    EXPECT_EQ(tags.title, "Caf\xC3\xA9");
+    EXPECT_EQ(tags.artist, "S\xC3\xB4n");
+    EXPECT_EQ(tags.album, "Album");
+    EXPECT_EQ(tags.genre, "Rock");
+    EXPECT_EQ(tags.year, 2019);
+    EXPECT_EQ(tags.bitrateKbps, 128);
+    EXPECT_EQ(tags.durationSeconds, 3);     // 116 * 417 bytes at 128 kbps
+    EXPECT_FALSE(tags.hasCoverArt);
+}
+
+TEST_F(NativeTagParserTest, Id3v24SyncSafeSizesAndUtf8) {
+    // Longer than 127 bytes, so a plain size would read differently
+    std::string longTitle(200, 'x');
+    std::string frames = frame(4, "TIT2", std::string(1, '\x03') + longTitle) +
+                         frame(4, "TPE1", std::string("\x03" "A\0B", 4)) +
+                         frame(4, "TDRC", latin1("2021-03-04"));
+
+    services::NativeTags tags;
+    ASSERT_TRUE(parse("v24.mp3", tag(4, frames) + mpegFrames(10), tags));
+    EXPECT_EQ(tags.title, longTitle);
+    EXPECT_EQ(tags.artist, "A B");
+    EXPECT_EQ(tags.year, 2021);
+}
+
+TEST_F(NativeTagParserTest, XingFrameCountGivesDuration) {
+    std::string xing = "Xing" + be32(0x03) + be32(1000) + be32(500000);
+
+    services::NativeTags tags;
+    ASSERT_TRUE(parse("xing.mp3", tag(3, frame(3, "TIT2", latin1("V"))) + mpegFrame(xing) + mpegFrames(5), tags));
+    EXPECT_EQ(tags.durationSeconds, 26);    // 1000 * 1152 / 44100
+    EXPECT_EQ(tags.bitrateKbps, 153);       // 500000 bytes over 26.12 s
+}
+
+TEST_F(NativeTagParserTest, VbriFrameCountGivesDuration) {
+    std::string vbri = "VBRI" + std::string("\0\x01\0\0\0\x50", 6) + be32(1000000) + be32(2000);
+
+    services::NativeTags tags;
+    ASSERT_TRUE(parse("vbri.mp3", mpegFrame(vbri) + mpegFrames(5), tags));
+    EXPECT_EQ(tags.durationSeconds, 52);    // 2000 * 1152 / 44100
+}
+
+TEST_F(NativeTagParserTest, Id3v1FillsFieldsMissingFromId3v2) {
+    std::string content = tag(3, frame(3, "TIT2", latin1("From v2"))) + mpegFrames(10) +
+                          id3v1("From v1", "Artist v1", "Album v1", "1999", 13);
+
+    services::NativeTags tags;
+    ASSERT_TRUE(parse("v1.mp3", content, tags));
+    EXPECT_EQ(tags.title, "From v2");
+    EXPECT_EQ(tags.artist, "Artist v1");
+    EXPECT_EQ(tags.album, "Album v1");
+    EXPECT_EQ(tags.year, 1999);
+    EXPECT_EQ(tags.genre, "Pop");
+}
+
+TEST_F(NativeTagParserTest, CoverArtIsMeasuredNotRead) {
+    std::string picture(300 * 1024, '\x7F');
+    std::string apic = std::string("\0image/jpeg\0\x03" "cover\0", 19) + picture;
+    std::string frames = frame(3, "APIC", apic) + frame(3, "TIT2", latin1("After art"));
+    std::string path = write("art.mp3", tag(3, frames) + mpegFrames(10));
+
+    services::FileTagSource source(path);
+    services::NativeTags tags;
+    ASSERT_TRUE(services::NativeTagParser::parse(source, ".mp3", tags));
+    EXPECT_TRUE(tags.hasCoverArt);
+    EXPECT_EQ(tags.coverArtSize, picture.size());
+    EXPECT_EQ(tags.title, "After art");
+
+    // Header windows only; the picture itself is skipped
+    EXPECT_LT(source.getBytesRead(), picture.size() / 4);
+}
+
+TEST_F(NativeTagParserTest, PreloadedBytesNeedNoReads) {
+    std::string content = tag(3, frame(3, "TIT2", latin1("Cached"))) + mpegFrames(10);
+    std::string path = write("cached.mp3", content);
+    std::vector<char> bytes(content.begin(), content.end());
+
+    services::FileTagSource source(path, content.size());
+    source.addPreloaded(0, bytes);
+    services::NativeTags tags;
+    ASSERT_TRUE(services::NativeTagParser::parse(source, ".mp3", tags));
+    EXPECT_EQ(tags.title, "Cached");
+    EXPECT_EQ(source.getBytesRead(), 0u);
+}
+
+TEST_F(NativeTagParserTest, WavInfoChunkAndDuration) {
+    std::string info = "INFO" + chunk("INAM", std::string("Wave title\0", 11)) +
+                       chunk("IART", std::string("Wave artist\0", 12)) +
+                       chunk("IPRD", std::string("Wave album\0", 11)) +
+                       chunk("ICRD", std::string("2005\0", 5));
+
+    services::NativeTags tags;
+    ASSERT_TRUE(parse("info.wav", wav(44100 * 4 * 3, chunk("LIST", info)), tags));
+    EXPECT_EQ(tags.title, "Wave title");
+    EXPECT_EQ(tags.artist, "Wave artist");
+    EXPECT_EQ(tags.album, "Wave album");
+    EXPECT_EQ(tags.year, 2005);
+    EXPECT_EQ(tags.durationSeconds, 3);
+    EXPECT_EQ(tags.bitrateKbps, 1411);
+}
+
+TEST_F(NativeTagParserTest, WavId3ChunkWinsOverInfo) {
+    std::string info = "INFO" + chunk("INAM", std::string("Info title\0", 11)) +
+                       chunk("IART", std::string("Info artist\0", 12));
+    std::string id3 = tag(3, frame(3, "TIT2", latin1("Id3 title")));
+
+    services::NativeTags tags;
+    ASSERT_TRUE(parse("id3.wav", wav(0, chunk("LIST", info) + chunk("id3 ", id3)), tags));
+    EXPECT_EQ(tags.title, "Id3 title");
+    EXPECT_EQ(tags.artist, "Info artist");
+    EXPECT_EQ(tags.durationSeconds, 0);
+}
+
+TEST_F(NativeTagParserTest, ExoticFilesAreLeftToTagLib) {
+    services::NativeTags tags;
+
+    // ID3v2.2
+    std::string v22 = std::string("ID3\x02\0\0", 6) + syncSafe(16) + std::string(16, '\0');
+    EXPECT_FALSE(parse("v22.mp3", v22 + mpegFrames(5), tags));
+
+    // Unsynchronised tag
+    EXPECT_FALSE(parse("unsync.mp3", tag(3, frame(3, "TIT2", latin1("U")), '\x80') + mpegFrames(5), tags));
+
+    // Compressed text frame
+    EXPECT_FALSE(parse("zlib.mp3", tag(3, frame(3, "TIT2", latin1("Z"), '\x80')) + mpegFrames(5), tags));
+
+    // APE tag at the end
+    std::string ape = "APETAGEX" + std::string(24, '\0');
+    EXPECT_FALSE(parse("ape.mp3", mpegFrames(5) + ape, tags));
+
+    // No MPEG audio after the tag
+    EXPECT_FALSE(parse("dummy.mp3", "dummy", tags));
+
+    // No fmt chunk, other formats
+    EXPECT_FALSE(parse("nofmt.wav", "RIFF" + le32(4) + "WAVE", tags));
+    EXPECT_FALSE(parse("song.flac", "fLaC", tags));
+    EXPECT_FALSE(services::NativeTagParser::parseFile((testDir / "missing.mp3").string(), tags));
+}
+
+TEST_F(NativeTagParserTest, MetadataReaderReportsCoverArt) {
+    std::string picture(5000, '\x11');
+    std::string apic = std::string("\0image/png\0\x03\0", 13) + picture;
+    std::string frames = frame(3, "TIT2", latin1("Title")) + frame(3, "TCON", latin1("Jazz")) +
+                         frame(3, "APIC", apic);
+    std::string path = write("reader.mp3", tag(3, frames) + mpegFrames(116));
+
+    services::MetadataReader reader;
+    auto metadata = reader.readMetadata(path);
+    ASSERT_NE(metadata, nullptr);
+    EXPECT_EQ(metadata->getTitle(), "Title");
+    EXPECT_EQ(metadata->getGenre(), "Jazz");
+    EXPECT_EQ(metadata->getCustomTag("duration").value_or(""), "3");
+    EXPECT_EQ(metadata->getCustomTag("bitrate").value_or(""), "128");
+    EXPECT_EQ(metadata->getCustomTag("cover_art_available").value_or(""), "true");
+    EXPECT_EQ(metadata->getCustomTag("cover_art_size").value_or(""), std::to_string(picture.size()));
+}
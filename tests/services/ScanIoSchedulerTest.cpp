@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include "services/ScanIoScheduler.h"
+#include "services/FileScanner.h"
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+using namespace testing;
+
+class ScanIoSchedulerTest : public Test {
+protected:
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "MediaPlayerTest_ScanIoScheduler";
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+        fs::create_directories(testDir);
+        std::ofstream(testDir / "playing.mp3") << "dummy content";
+    }
+
+    void TearDown() override {
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+    }
+
+    double secondsToCharge(services::ScanIoScheduler& scheduler, uint64_t bytes, uint64_t ops) {
+        auto start = std::chrono::steady_clock::now();
+        EXPECT_TRUE(scheduler.charge(bytes, ops, stop));
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    fs::path testDir;
+    std::atomic<bool> stop{false};
+};
+
+TEST_F(ScanIoSchedulerTest, UnlimitedNeverWaits) {
+    services::ScanIoScheduler scheduler;
+    scheduler.beginScan(testDir.string());
+
+    EXPECT_LT(secondsToCharge(scheduler, 1ull << 40, 1000000), 0.05);
+    EXPECT_EQ(scheduler.getThrottledSeconds(), 0.0);
+}
+
+TEST_F(ScanIoSchedulerTest, OpsLimitSpacesOutCharges) {
+    services::ScanIoScheduler scheduler;
+    scheduler.setLimits({ 0, 1000 });
+    scheduler.beginScan(testDir.string());
+
+    // A quarter second of burst, then the rate applies
+    EXPECT_LT(secondsToCharge(scheduler, 0, 250), 0.05);
+    EXPECT_GE(secondsToCharge(scheduler, 0, 200), 0.15);
+    EXPECT_GT(scheduler.getThrottledSeconds(), 0.1);
+}
+
+TEST_F(ScanIoSchedulerTest, BytesLimitSpacesOutCharges) {
+    services::ScanIoScheduler scheduler;
+    scheduler.setLimits({ 1024 * 1024, 0 });
+    scheduler.beginScan(testDir.string());
+
+    EXPECT_LT(secondsToCharge(scheduler, 256 * 1024, 1), 0.05);
+    EXPECT_GE(secondsToCharge(scheduler, 256 * 1024, 1), 0.2);
+}
+
+TEST_F(ScanIoSchedulerTest, StopInterruptsWait) {
+    services::ScanIoScheduler scheduler;
+    scheduler.setLimits({ 0, 10 });
+    scheduler.beginScan(testDir.string());
+
+    std::thread stopper([this]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        stop = true;
+    });
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(scheduler.charge(0, 100, stop));     // Would wait ~10 s
+    stopper.join();
+    EXPECT_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 1.0);
+}
+
+TEST_F(ScanIoSchedulerTest, BacksOffWhilePlayingFromScannedDevice) {
+    std::string playing;
+    services::ScanIoScheduler scheduler;
+    scheduler.setPlaybackLimits({ 0, 1000 });
+    scheduler.setPlaybackProbe([&playing]() { return playing; });
+    scheduler.beginScan(testDir.string());
+
+    // Nothing plays: unlimited
+    EXPECT_FALSE(scheduler.isBackingOff());
+    EXPECT_LT(secondsToCharge(scheduler, 0, 1000), 0.05);
+
+    // Playing from the same device: the playback budget applies after the next probe
+    playing = (testDir / "playing.mp3").string();
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    scheduler.charge(0, 0, stop);
+    EXPECT_TRUE(scheduler.isBackingOff());
+    EXPECT_TRUE(scheduler.isPlaybackFile(playing));
+    EXPECT_FALSE(scheduler.isPlaybackFile((testDir / "other.mp3").string()));
+    secondsToCharge(scheduler, 0, 250);
+    EXPECT_GE(secondsToCharge(scheduler, 0, 100), 0.05);
+
+    // Playback stopped: back to full speed
+    playing.clear();
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    scheduler.charge(0, 0, stop);
+    EXPECT_FALSE(scheduler.isBackingOff());
+    EXPECT_LT(secondsToCharge(scheduler, 0, 10000), 0.05);
+}
+
+TEST_F(ScanIoSchedulerTest, PlaybackFromOtherDeviceDoesNotBackOff) {
+#ifdef __linux__
+    services::ScanIoScheduler scheduler;
+    scheduler.setPlaybackLimits({ 0, 10 });
+    scheduler.setPlaybackProbe([]() { return std::string("/proc/self/status"); });  // procfs, not the temp dir's device
+    scheduler.beginScan(testDir.string());
+
+    EXPECT_FALSE(scheduler.isBackingOff());
+    EXPECT_LT(secondsToCharge(scheduler, 0, 1000), 0.05);
+#else
+    GTEST_SKIP() << "Needs /proc";
+#endif
+}
+
+TEST_F(ScanIoSchedulerTest, IdlePriorityScopeRestoresClass) {
+    int before = services::IdleIoPriorityScope::currentIoClass();
+    {
+        services::IdleIoPriorityScope scope(true);
+        if (!scope.isActive()) GTEST_SKIP() << "ioprio_set unavailable";
+        EXPECT_EQ(services::IdleIoPriorityScope::currentIoClass(), 3);
+
+        // Threads started inside the scope inherit it
+        int childClass = -1;
+        std::thread child([&childClass]() { childClass = services::IdleIoPriorityScope::currentIoClass(); });
+        child.join();
+        EXPECT_EQ(childClass, 3);
+    }
+    EXPECT_EQ(services::IdleIoPriorityScope::currentIoClass(), before);
+
+    services::IdleIoPriorityScope disabled(false);
+    EXPECT_FALSE(disabled.isActive());
+}
+
+TEST_F(ScanIoSchedulerTest, ScannerHonoursOpsLimit) {
+    for (int i = 0; i < 20; ++i) {
+        std::ofstream(testDir / ("track" + std::to_string(i) + ".mp3")) << "dummy content";
+    }
+
+    services::FileScanner scanner;
+    scanner.setIoLimits({ 0, 100 }, { 0, 100 });
+    auto start = std::chrono::steady_clock::now();
+    auto files = scanner.scanDirectorySync(testDir.string());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // 21 files: listing + stats + tag reads well over the 25-op burst
+    EXPECT_EQ(files.size(), 21u);
+    EXPECT_GT(scanner.getIoThrottledSeconds(), 0.0);
+    EXPECT_GT(seconds, 0.1);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "services/TagPrefetcher.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using namespace media_player;
+using namespace testing;
+
+class TagPrefetcherTest : public Test {
+protected:
+    void SetUp() override {
+        testDir = fs::temp_directory_path() / "MediaPlayerTest_TagPrefetcher";
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+        fs::create_directories(testDir);
+        
+        // Byte i of the file is 'a' + i % 26, so any range can be checked
+        for (size_t i = 0; i < 10000; ++i) {
+            content.push_back(static_cast<char>('a' + i % 26));
+        }
+        std::ofstream(testDir / "large.mp3", std::ios::binary) << content;
+        std::ofstream(testDir / "small.mp3", std::ios::binary) << content.substr(0, 100);
+    }
+
+    void TearDown() override {
+        if (fs::exists(testDir)) {
+            fs::remove_all(testDir);
+        }
+    }
+    
+    services::PrefetchedFile prefetchOne(services::TagPrefetcher& prefetcher, const fs::path& path) {
+        std::vector<services::PrefetchedFile> files(1);
+        files[0].path = path.string();
+        prefetcher.prefetch(files);
+        return files[0];
+    }
+
+    fs::path testDir;
+    std::string content;
+};
+
+TEST_F(TagPrefetcherTest, ReadsHeadAndTail) {
+    services::TagPrefetcher prefetcher(1024, 256);
+    if (!prefetcher.isAvailable()) GTEST_SKIP() << "io_uring unavailable";
+    
+    auto file = prefetchOne(prefetcher, testDir / "large.mp3");
+    ASSERT_TRUE(file.ok);
+    ASSERT_TRUE(file.hasStat);
+    EXPECT_EQ(file.stat.size, content.size());
+    EXPECT_EQ(file.stat.lastModified, fs::last_write_time(testDir / "large.mp3"));
+    
+    EXPECT_EQ(std::string(file.head.begin(), file.head.end()), content.substr(0, 1024));
+    EXPECT_EQ(file.tailOffset, content.size() - 256);
+    EXPECT_EQ(std::string(file.tail.begin(), file.tail.end()), content.substr(content.size() - 256));
+}
+
+TEST_F(TagPrefetcherTest, SmallFileFitsInHead) {
+    services::TagPrefetcher prefetcher(1024, 256);
+    if (!prefetcher.isAvailable()) GTEST_SKIP() << "io_uring unavailable";
+    
+    auto file = prefetchOne(prefetcher, testDir / "small.mp3");
+    ASSERT_TRUE(file.ok);
+    EXPECT_EQ(file.head.size(), 100u);
+    EXPECT_TRUE(file.tail.empty());
+}
+
+TEST_F(TagPrefetcherTest, KnownStatIsKept) {
+    services::TagPrefetcher prefetcher(1024, 256);
+    if (!prefetcher.isAvailable()) GTEST_SKIP() << "io_uring unavailable";
+    
+    std::vector<services::PrefetchedFile> files(1);
+    files[0].path = (testDir / "large.mp3").string();
+    files[0].hasStat = true;
+    files[0].stat.size = 2000;  // Only this much gets read
+    prefetcher.prefetch(files);
+    
+    ASSERT_TRUE(files[0].ok);
+    EXPECT_EQ(files[0].tailOffset, 1744u);
+    EXPECT_EQ(files[0].tail.size(), 256u);
+}
+
+TEST_F(TagPrefetcherTest, MissingFileIsNotOk) {
+    services::TagPrefetcher prefetcher(1024, 256);
+    if (!prefetcher.isAvailable()) GTEST_SKIP() << "io_uring unavailable";
+    
+    std::vector<services::PrefetchedFile> files(3);
+    files[0].path = (testDir / "small.mp3").string();
+    files[1].path = (testDir / "missing.mp3").string();
+    files[2].path = (testDir / "large.mp3").string();
+    prefetcher.prefetch(files);
+    
+    EXPECT_TRUE(files[0].ok);
+    EXPECT_FALSE(files[1].ok);
+    EXPECT_TRUE(files[2].ok);
+}
+
+TEST_F(TagPrefetcherTest, ManyFilesInOneCall) {
+    services::TagPrefetcher prefetcher(64, 16);
+    if (!prefetcher.isAvailable()) GTEST_SKIP() << "io_uring unavailable";
+    
+    // More than one submission round
+    std::vector<services::PrefetchedFile> files(150);
+    for (auto& file : files) file.path = (testDir / "large.mp3").string();
+    prefetcher.prefetch(files);
+    
+    for (const auto& file : files) {
+        ASSERT_TRUE(file.ok);
+        EXPECT_EQ(std::string(file.head.begin(), file.head.end()), content.substr(0, 64));
+    }
+}
+
+TEST_F(TagPrefetcherTest, StreamServesPrefetchedRanges) {
+    services::PrefetchedFile file;
+    file.path = (testDir / "large.mp3").string();
+    file.hasStat = true;
+    file.stat.size = content.size();
+    file.ok = true;
+    file.head.assign(content.begin(), content.begin() + 1024);
+    file.tailOffset = content.size() - 256;
+    file.tail.assign(content.begin() + static_cast<long>(file.tailOffset), content.end());
+    
+    services::PrefetchedFileStream stream(file);
+    EXPECT_EQ(stream.length(), static_cast<long>(content.size()));
+    
+    auto head = stream.readBlock(10);
+    EXPECT_EQ(std::string(head.data(), head.size()), content.substr(0, 10));
+    EXPECT_EQ(stream.tell(), 10);
+    
+    stream.seek(-128, TagLib::IOStream::End);
+    auto tail = stream.readBlock(500);  // Clipped at end of file
+    EXPECT_EQ(std::string(tail.data(), tail.size()), content.substr(content.size() - 128));
+    EXPECT_EQ(stream.getFallbackReads(), 0u);
+    
+    // Between head and tail: read from the file
+    stream.seek(5000);
+    auto middle = stream.readBlock(20);
+    EXPECT_EQ(std::string(middle.data(), middle.size()), content.substr(5000, 20));
+    EXPECT_EQ(stream.getFallbackReads(), 1u);
+}